@@ -0,0 +1,118 @@
+/**
+ *      @file BarrierBench.cpp
+ *
+ *      @brief Microbenchmark of the barriers of the cluster advance threads.
+ *
+ *      Emulates the synchronization of Cluster::runAdvance() and Cluster::advanceThread():
+ *      the main thread and one thread per cluster meet at a barrier a number of times
+ *      per advance window (5 when the inter clusters phases run, 2 when they are merged),
+ *      optionally doing some work between the barriers. Prints the cost per advance
+ *      window of the Barrier and the SpinBarrier.
+ *
+ *      TO USE:
+ *
+ *      $ make barrierbench
+ *      $ ./barrierbench [number of clusters] [number of windows] [work per phase]
+ *
+ *      The number of clusters defaults to the number of cores minus one, the number
+ *      of windows to 100000, and the work per phase (number of loop iterations each
+ *      thread spins between two barriers) to 0.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include "Barrier.hpp"
+#include "SpinBarrier.hpp"
+
+using namespace std;
+
+// Keeps the emulated work from being optimized out
+static volatile unsigned long g_sink;
+
+/*
+ *  Emulate the work of a thread between two barriers.
+ *
+ *  @param  work    Number of loop iterations.
+ */
+static void doWork(int work)
+{
+    unsigned long sum = 0;
+    for (int i = 0; i < work; i++) {
+        sum += i * i;
+    }
+    g_sink = sum;
+}
+
+/*
+ *  Run the advance windows on the main thread and the cluster threads.
+ *
+ *  @param  barrier         The barrier to synchronize the threads.
+ *  @param  nClusters       Number of cluster threads.
+ *  @param  nWindows        Number of advance windows.
+ *  @param  syncsPerWindow  Number of barriers per advance window.
+ *  @param  work            Work of each cluster thread between two barriers.
+ *  @return nanoseconds per advance window.
+ */
+static double runWindows(IBarrier *barrier, int nClusters, int nWindows, int syncsPerWindow, int work)
+{
+    vector<thread> threads;
+    for (int iCluster = 0; iCluster < nClusters; iCluster++) {
+        threads.push_back(thread([=] {
+            for (int iWindow = 0; iWindow < nWindows; iWindow++) {
+                for (int iSync = 0; iSync < syncsPerWindow; iSync++) {
+                    doWork(work);
+                    barrier->Sync();
+                }
+            }
+        }));
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int iWindow = 0; iWindow < nWindows; iWindow++) {
+        for (int iSync = 0; iSync < syncsPerWindow; iSync++) {
+            barrier->Sync();
+        }
+    }
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    return chrono::duration<double, nano>(end - start).count() / nWindows;
+}
+
+int main(int argc, char *argv[])
+{
+    int nCores = thread::hardware_concurrency();
+    int nClusters = argc > 1 ? atoi(argv[1]) : max(nCores - 1, 1);
+    int nWindows = argc > 2 ? atoi(argv[2]) : 100000;
+    int work = argc > 3 ? atoi(argv[3]) : 0;
+
+    if (nClusters < 1 || nWindows < 1 || work < 0) {
+        cerr << "Usage: " << argv[0] << " [number of clusters] [number of windows] [work per phase]" << endl;
+        return -1;
+    }
+
+    cout << "cores: " << nCores << ", clusters: " << nClusters
+         << ", windows: " << nWindows << ", work per phase: " << work << endl;
+    cout << setw(10) << "barrier" << setw(18) << "syncs/window" << setw(18) << "ns/window" << endl;
+
+    // 5 barriers per window with the inter clusters phases, 2 when they are merged
+    const int syncsPerWindow[] = { 5, 2 };
+    for (int i = 0; i < 2; i++) {
+        Barrier barrier(nClusters + 1);
+        double ns = runWindows(&barrier, nClusters, nWindows, syncsPerWindow[i], work);
+        cout << setw(10) << "mutex" << setw(18) << syncsPerWindow[i] << setw(18) << fixed << setprecision(1) << ns << endl;
+
+        SpinBarrier spinBarrier(nClusters + 1);
+        ns = runWindows(&spinBarrier, nClusters, nWindows, syncsPerWindow[i], work);
+        cout << setw(10) << "spin" << setw(18) << syncsPerWindow[i] << setw(18) << fixed << setprecision(1) << ns << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ *      @file BenchNeurons.h
+ *
+ *      @brief Neuron properties of the benchmark runs (NeuronBench.cpp, ClusterBench.cpp).
+ *
+ *      The neurons of a benchmark run are set up without a parameter file:
+ *      the values of the test configurations, with a spread of the noise and
+ *      of the initial membrane voltages so that the neurons don't all fire at
+ *      the same steps.
+ */
+
+#pragma once
+
+#include <cmath>
+#include "AllLIFNeurons.h"
+#include "AllIZHNeurons.h"
+
+/**
+ *  Set the properties of the IF neurons: the values of the test configurations,
+ *  with a spread of the noise and of the initial membrane voltages.
+ *
+ *  @param  pNeuronsProps   The neurons properties.
+ *  @param  nNeurons        Number of neurons.
+ *  @param  Vthresh         Threshold voltage.
+ *  @param  Vreset          Reset voltage.
+ *  @param  Inoise          Noise current.
+ *  @param  deltaT          Inner simulation step duration.
+ */
+inline void setIFNeuronsProps(AllIFNeuronsProps *pNeuronsProps, int nNeurons, BGFLOAT Vthresh, BGFLOAT Vreset, BGFLOAT Inoise, BGFLOAT deltaT)
+{
+    MTRand rng(1);
+
+    for (int i = 0; i < nNeurons; i++) {
+        pNeuronsProps->setNeuronPropDefaults(i);
+        pNeuronsProps->Vthresh[i] = Vthresh;
+        pNeuronsProps->Vreset[i] = Vreset;
+        pNeuronsProps->Inoise[i] = Inoise * rng.inRange(1.0, 1.5);
+        pNeuronsProps->Vm[i] = rng.inRange(Vreset, Vthresh);
+
+        // as AllIFNeuronsProps::initNeuronPropConstsFromParamValues()
+        BGFLOAT &Tau = pNeuronsProps->Tau[i];
+        BGFLOAT &Rm = pNeuronsProps->Rm[i];
+        pNeuronsProps->C1[i] = exp( -deltaT / Tau );
+        pNeuronsProps->C2[i] = Rm * ( 1 - pNeuronsProps->C1[i] );
+        pNeuronsProps->I0[i] = 13.5e-09 + pNeuronsProps->Vrest[i] / Rm;
+    }
+}
+
+/**
+ *  Set the properties of the LIF neurons of a benchmark run.
+ *
+ *  @param  neurons   The neurons.
+ *  @param  nNeurons  Number of neurons.
+ *  @param  deltaT    Inner simulation step duration.
+ *  @return the maximum magnitude of the synapse weights for the neurons.
+ */
+inline BGFLOAT setNeuronsProps(AllLIFNeurons &neurons, int nNeurons, BGFLOAT deltaT)
+{
+    setIFNeuronsProps(static_cast<AllIFNeuronsProps*>(neurons.m_pNeuronsProps), nNeurons, 15.0e-03, 13.5e-03, 1.0e-09, deltaT);
+    return 1.0e-09;
+}
+
+/**
+ *  Set the properties of the Izhikevich neurons of a benchmark run.
+ *
+ *  @param  neurons   The neurons.
+ *  @param  nNeurons  Number of neurons.
+ *  @param  deltaT    Inner simulation step duration.
+ *  @return the maximum magnitude of the synapse weights for the neurons.
+ */
+inline BGFLOAT setNeuronsProps(AllIZHNeurons &neurons, int nNeurons, BGFLOAT deltaT)
+{
+    AllIZHNeuronsProps *pNeuronsProps = static_cast<AllIZHNeuronsProps*>(neurons.m_pNeuronsProps);
+    setIFNeuronsProps(pNeuronsProps, nNeurons, 30.0e-03, -0.065, 0.5e-06, deltaT);
+
+    MTRand rng(2);
+    for (int i = 0; i < nNeurons; i++) {
+        pNeuronsProps->Aconst[i] = 0.02;
+        pNeuronsProps->Bconst[i] = 0.2;
+        pNeuronsProps->Cconst[i] = rng.inRange(-65, -50);
+        pNeuronsProps->Dconst[i] = rng.inRange(2, 8);
+        pNeuronsProps->u[i] = 0;
+        pNeuronsProps->C3[i] = deltaT * 1000;
+    }
+    return 0.5e-07;
+}
@@ -0,0 +1,336 @@
+/**
+ *      @file ClusterBench.cpp
+ *
+ *      @brief Benchmark of the specialized clusters (SpecializedCluster.h).
+ *
+ *      For each pair of neurons and synapses classes registered in
+ *      FClassOfCategory, builds a random network of one cluster twice, and
+ *      advances one with the generic SingleThreadedCluster and the other with
+ *      the SpecializedCluster of the pair: the neurons, the synapses and the
+ *      spike queues, by windows of minSynapticTransDelay steps as in
+ *      Cluster::advanceThread(). Both runs start from the same state and the
+ *      same noise seed; prints the simulation steps per second, the firing rate
+ *      and whether the final states (membrane voltages, psr and weights) are
+ *      identical. The pairs whose synapses have no back propagation are also run
+ *      with the event driven synapse advance, and every pair with the ring spike
+ *      delivery (AxonalSpikeRings.h). The pairs without back propagation are also
+ *      run with the counter noise generator, step by step ("counter") and with
+ *      the blocked advance of the window (SimConfig advanceOrder, "blocked").
+ *
+ *      TO USE:
+ *
+ *      $ make clusterbench
+ *      $ ./clusterbench [number of neurons] [synapses per neuron] [number of steps]
+ *
+ *      The number of neurons defaults to 2000, the number of synapses per neuron
+ *      to 100, and the number of steps to 10000 (one epoch of 1 s).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include "SpecializedCluster.h"
+#include "SynapseIndexMap.h"
+#include "BenchNeurons.h"
+#include "AllDSSynapses.h"
+#include "AllSTDPSynapses.h"
+#include "AllDynamicSTDPSynapses.h"
+#include "AxonalSpikeRings.h"
+#include "Philox.h"
+
+using namespace std;
+
+/*
+ *  Make one LIF neuron in ten an endogenously active (starter) neuron, so that
+ *  the network fires before its synapses have learnt anything.
+ *
+ *  @param  neurons   The neurons.
+ *  @param  nNeurons  Number of neurons.
+ */
+static void setStarterNeurons(AllLIFNeurons &neurons, int nNeurons)
+{
+    AllIFNeuronsProps *pNeuronsProps = static_cast<AllIFNeuronsProps*>(neurons.m_pNeuronsProps);
+    for (int i = 0; i < nNeurons; i += 10) {
+        pNeuronsProps->Vthresh[i] = 13.565e-03;
+    }
+}
+
+static void setStarterNeurons(AllIZHNeurons &neurons, int nNeurons)
+{
+    // (the Izhikevich neurons of the benchmark fire without starter neurons)
+}
+
+/*
+ *  A network of one cluster.
+ */
+struct Network
+{
+    SimulationInfo sim_info;
+    ClusterInfo clr_info;
+    AxonalSpikeRings spikeRings;
+    vector<Cluster *> vtClr;
+    vector<ClusterInfo *> vtClrInfo;
+};
+
+/*
+ *  Build a random network: every neuron receives nSynapses synapses from
+ *  random neurons, and one neuron in five is inhibitory.
+ *
+ *  @param  net          The network.
+ *  @param  nNeurons     Number of neurons.
+ *  @param  nSynapses    Number of synapses per neuron.
+ *  @param  mode         The synapse advance: "dense", "event" (event driven), "ring" (dense, ring spike delivery),
+ *                       "counter" (dense, counter noise) or "blocked" (dense, counter noise, blocked advance).
+ *  @param  specialized  True to use the specialized cluster.
+ */
+template <class Neurons, class Synapses>
+static void setupNetwork(Network &net, int nNeurons, int nSynapses, const string &mode, bool specialized)
+{
+    // the synapses are created at the first step of the run (see runSteps())
+    g_simulationStep = 0;
+
+    SimulationInfo &sim_info = net.sim_info;
+    sim_info.epochDuration = 1.0;
+    sim_info.maxFiringRate = 200;
+    // (the synapse index map asserts that the synapses of a neuron don't fill its space)
+    sim_info.maxSynapsesPerNeuron = nSynapses + 1;
+    sim_info.totalNeurons = nNeurons;
+    sim_info.numClusters = 1;
+    sim_info.noiseGenerator = (mode == "counter" || mode == "blocked") ? COUNTER_NOISE : NORM_NOISE;
+    sim_info.blockedAdvance = mode == "blocked";
+
+    ClusterInfo &clr_info = net.clr_info;
+    clr_info.totalClusterNeurons = nNeurons;
+    clr_info.normRand = new Norm(0, 1, 1);
+    clr_info.rng = new MTRand(1);
+    net.spikeRings.initSpikeRings(nNeurons, sim_info.minSynapticTransDelay);
+    clr_info.spikeRings = &net.spikeRings;
+    // the noise buffer is allocated first, because the neurons keep a pointer to it
+    if (sim_info.noiseGenerator == COUNTER_NOISE) {
+        clr_info.counterRand = new Philox(1);
+        clr_info.randNoise = new BGFLOAT[nNeurons];
+    }
+
+    Neurons *neurons = new Neurons();
+    neurons->createNeuronsProps();
+    neurons->setupNeurons(&sim_info, &clr_info);
+    BGFLOAT maxWeight = setNeuronsProps(*neurons, nNeurons, sim_info.deltaT);
+    setStarterNeurons(*neurons, nNeurons);
+
+    Synapses *synapses = new Synapses();
+    synapses->createSynapsesProps();
+    static_cast<AllSpikingSynapsesProps*>(synapses->m_pSynapsesProps)->eventDrivenAdvance = mode == "event";
+    static_cast<AllSpikingSynapsesProps*>(synapses->m_pSynapsesProps)->ringSpikeDelivery = mode == "ring";
+    synapses->setupSynapses(&sim_info, &clr_info);
+
+    BGFLOAT *summation_map = neurons->m_pNeuronsProps->summation_map;
+    AllSTDPSynapsesProps *pSTDPSynapsesProps = dynamic_cast<AllSTDPSynapsesProps*>(synapses->m_pSynapsesProps);
+    MTRand rng(3);
+    for (int iNeuron = 0; iNeuron < nNeurons; iNeuron++) {
+        for (int i = 0; i < nSynapses; i++) {
+            int src_neuron = rng.inRange(0, nNeurons - 1e-3);
+            bool srcInh = src_neuron % 5 == 0;
+            bool destInh = iNeuron % 5 == 0;
+            synapseType type = srcInh ? (destInh ? II : IE) : (destInh ? EI : EE);
+
+            BGSIZE iSyn;
+            synapses->addSynapse(iSyn, type, src_neuron, iNeuron, &summation_map[iNeuron], sim_info.deltaT, iNeuron);
+            synapses->m_pSynapsesProps->W[iSyn] = srcInh ? rng.inRange(-maxWeight, 0) : rng.inRange(0, maxWeight);
+            if (pSTDPSynapsesProps != NULL) {
+                // the learning saturates at the weights of the network instead of the default 1.0
+                pSTDPSynapsesProps->Wex[iSyn] = srcInh ? -maxWeight : maxWeight;
+            }
+        }
+    }
+
+    SingleThreadedCluster *cluster;
+    if (specialized) {
+        cluster = new SpecializedCluster<Neurons, Synapses>(neurons, synapses);
+    } else {
+        cluster = new SingleThreadedCluster(neurons, synapses);
+    }
+    cluster->setupAdvanceOrder(&sim_info, &clr_info);
+    net.vtClr.push_back(cluster);
+    net.vtClrInfo.push_back(&clr_info);
+
+    // (without the synapse counts that createSynapseImap() prints)
+    streambuf *coutBuf = cout.rdbuf(NULL);
+    SynapseIndexMap::createSynapseImap(&sim_info, net.vtClr, net.vtClrInfo);
+    cout.rdbuf(coutBuf);
+}
+
+/*
+ *  Advance the network for a number of steps, as Cluster::advanceThread().
+ *
+ *  @param  net       The network.
+ *  @param  nSteps    Number of steps.
+ *  @param  nSpikes   Number of spikes fired.
+ *  @return seconds spent advancing the network.
+ */
+static double runSteps(Network &net, int nSteps, uint64_t &nSpikes)
+{
+    SimulationInfo &sim_info = net.sim_info;
+    ClusterInfo &clr_info = net.clr_info;
+    Cluster *cluster = net.vtClr[0];
+    AllSpikingNeuronsProps *pNeuronsProps = static_cast<AllSpikingNeuronsProps*>(dynamic_cast<AllNeurons*>(cluster->m_neurons)->m_pNeuronsProps);
+    int nStepsPerEpoch = static_cast<int>(sim_info.epochDuration / sim_info.deltaT);
+    double seconds = 0;
+
+    nSpikes = 0;
+    g_simulationStep = 0;
+    while (g_simulationStep < static_cast<uint64_t>(nSteps)) {
+        // the window ends at the end of an epoch, as in Simulator::advanceUntilGrowth()
+        int iStep = min(nSteps - g_simulationStep, nStepsPerEpoch - g_simulationStep % nStepsPerEpoch);
+        iStep = min(iStep, sim_info.minSynapticTransDelay);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        cluster->advanceWindow(&sim_info, &clr_info, iStep);
+        cluster->advanceSpikeQueue(&sim_info, &clr_info, iStep);
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        g_simulationStep += iStep;
+
+        // the recorder clears the spike counts at the end of each epoch
+        if (g_simulationStep % nStepsPerEpoch == 0 || g_simulationStep == static_cast<uint64_t>(nSteps)) {
+            for (int i = 0; i < clr_info.totalClusterNeurons; i++) {
+                nSpikes += pNeuronsProps->spikeCount[i];
+            }
+            pNeuronsProps->clearSpikeCounts(&sim_info, &clr_info, NULL);
+        }
+    }
+
+    return seconds;
+}
+
+/*
+ *  Check if two runs end in the same state.
+ *
+ *  @param  a         A network.
+ *  @param  b         The other network.
+ *  @return true if the membrane voltages, the refractory steps, and the psr
+ *          and the weights of the synapses in use are identical.
+ */
+static bool sameState(const Network &a, const Network &b)
+{
+    const AllIFNeuronsProps *neuronsA = static_cast<AllIFNeuronsProps*>(dynamic_cast<AllNeurons*>(a.vtClr[0]->m_neurons)->m_pNeuronsProps);
+    const AllIFNeuronsProps *neuronsB = static_cast<AllIFNeuronsProps*>(dynamic_cast<AllNeurons*>(b.vtClr[0]->m_neurons)->m_pNeuronsProps);
+    const AllSynapsesProps *synapsesA = dynamic_cast<AllSynapses*>(a.vtClr[0]->m_synapses)->m_pSynapsesProps;
+    const AllSynapsesProps *synapsesB = dynamic_cast<AllSynapses*>(b.vtClr[0]->m_synapses)->m_pSynapsesProps;
+
+    for (int i = 0; i < a.clr_info.totalClusterNeurons; i++) {
+        if (neuronsA->Vm[i] != neuronsB->Vm[i] || neuronsA->nStepsInRefr[i] != neuronsB->nStepsInRefr[i]) {
+            return false;
+        }
+    }
+    BGSIZE maxTotalSynapses = synapsesA->maxSynapsesPerNeuron * synapsesA->count_neurons;
+    for (BGSIZE iSyn = 0; iSyn < maxTotalSynapses; iSyn++) {
+        if (synapsesA->in_use[iSyn] != synapsesB->in_use[iSyn]) {
+            return false;
+        }
+        if (synapsesA->in_use[iSyn] && (synapsesA->psr[iSyn] != synapsesB->psr[iSyn] || synapsesA->W[iSyn] != synapsesB->W[iSyn])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ *  Release a network.
+ *
+ *  @param  net       The network.
+ */
+static void cleanupNetwork(Network &net)
+{
+    Cluster *cluster = net.vtClr[0];
+    cluster->m_neurons->cleanupNeurons();
+    cluster->m_synapses->cleanupSynapses();
+    delete cluster;
+    delete net.clr_info.normRand;
+    delete net.clr_info.rng;
+    delete net.clr_info.counterRand;
+    delete[] net.clr_info.randNoise;
+}
+
+/*
+ *  Run the benchmark of a pair of neurons and synapses classes.
+ *
+ *  @param  name         Name of the pair.
+ *  @param  nNeurons     Number of neurons.
+ *  @param  nSynapses    Number of synapses per neuron.
+ *  @param  nSteps       Number of steps.
+ *  @param  mode         The synapse advance: "dense", "event", "ring", "counter" or "blocked".
+ */
+template <class Neurons, class Synapses>
+static void benchPair(const char *name, int nNeurons, int nSynapses, int nSteps, const char *mode)
+{
+    Network generic, specialized;
+    setupNetwork<Neurons, Synapses>(generic, nNeurons, nSynapses, mode, false);
+    setupNetwork<Neurons, Synapses>(specialized, nNeurons, nSynapses, mode, true);
+
+    uint64_t genericSpikes, specializedSpikes;
+    double genericSeconds = runSteps(generic, nSteps, genericSpikes);
+    double specializedSeconds = runSteps(specialized, nSteps, specializedSpikes);
+
+    bool same = genericSpikes == specializedSpikes && sameState(generic, specialized);
+    double rate = genericSpikes / (nSteps * generic.sim_info.deltaT) / nNeurons;
+
+    cout << setw(30) << name << setw(8) << mode
+         << setw(10) << fixed << setprecision(1) << rate
+         << setw(14) << nSteps / genericSeconds
+         << setw(14) << nSteps / specializedSeconds
+         << setw(10) << setprecision(2) << genericSeconds / specializedSeconds
+         << setw(12) << (same ? "yes" : "NO") << endl;
+
+    cleanupNetwork(generic);
+    cleanupNetwork(specialized);
+}
+
+int main(int argc, char *argv[])
+{
+    int nNeurons = argc > 1 ? atoi(argv[1]) : 2000;
+    int nSynapses = argc > 2 ? atoi(argv[2]) : 100;
+    int nSteps = argc > 3 ? atoi(argv[3]) : 10000;
+
+    if (nNeurons < 1 || nSynapses < 1 || nSteps < 1) {
+        cerr << "Usage: " << argv[0] << " [number of neurons] [synapses per neuron] [number of steps]" << endl;
+        return -1;
+    }
+
+    cout << "neurons: " << nNeurons << ", synapses per neuron: " << nSynapses << ", steps: " << nSteps << endl;
+    cout << setw(30) << "pair" << setw(8) << "mode" << setw(10) << "rate Hz"
+         << setw(14) << "generic st/s" << setw(14) << "special st/s"
+         << setw(10) << "speedup" << setw(12) << "identical" << endl;
+
+    benchPair<AllLIFNeurons, AllSpikingSynapses>("LIF/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "dense");
+    benchPair<AllLIFNeurons, AllSpikingSynapses>("LIF/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "event");
+    benchPair<AllLIFNeurons, AllSpikingSynapses>("LIF/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "ring");
+    benchPair<AllLIFNeurons, AllSpikingSynapses>("LIF/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "counter");
+    benchPair<AllLIFNeurons, AllSpikingSynapses>("LIF/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "blocked");
+    benchPair<AllLIFNeurons, AllDSSynapses>("LIF/AllDSSynapses", nNeurons, nSynapses, nSteps, "dense");
+    benchPair<AllLIFNeurons, AllDSSynapses>("LIF/AllDSSynapses", nNeurons, nSynapses, nSteps, "event");
+    benchPair<AllLIFNeurons, AllDSSynapses>("LIF/AllDSSynapses", nNeurons, nSynapses, nSteps, "ring");
+    benchPair<AllLIFNeurons, AllDSSynapses>("LIF/AllDSSynapses", nNeurons, nSynapses, nSteps, "counter");
+    benchPair<AllLIFNeurons, AllDSSynapses>("LIF/AllDSSynapses", nNeurons, nSynapses, nSteps, "blocked");
+    benchPair<AllLIFNeurons, AllSTDPSynapses>("LIF/AllSTDPSynapses", nNeurons, nSynapses, nSteps, "dense");
+    benchPair<AllLIFNeurons, AllSTDPSynapses>("LIF/AllSTDPSynapses", nNeurons, nSynapses, nSteps, "ring");
+    benchPair<AllLIFNeurons, AllDynamicSTDPSynapses>("LIF/AllDynamicSTDPSynapses", nNeurons, nSynapses, nSteps, "dense");
+    benchPair<AllLIFNeurons, AllDynamicSTDPSynapses>("LIF/AllDynamicSTDPSynapses", nNeurons, nSynapses, nSteps, "ring");
+    benchPair<AllIZHNeurons, AllSpikingSynapses>("IZH/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "dense");
+    benchPair<AllIZHNeurons, AllSpikingSynapses>("IZH/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "event");
+    benchPair<AllIZHNeurons, AllSpikingSynapses>("IZH/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "ring");
+    benchPair<AllIZHNeurons, AllSpikingSynapses>("IZH/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "counter");
+    benchPair<AllIZHNeurons, AllSpikingSynapses>("IZH/AllSpikingSynapses", nNeurons, nSynapses, nSteps, "blocked");
+    benchPair<AllIZHNeurons, AllDSSynapses>("IZH/AllDSSynapses", nNeurons, nSynapses, nSteps, "dense");
+    benchPair<AllIZHNeurons, AllDSSynapses>("IZH/AllDSSynapses", nNeurons, nSynapses, nSteps, "event");
+    benchPair<AllIZHNeurons, AllDSSynapses>("IZH/AllDSSynapses", nNeurons, nSynapses, nSteps, "ring");
+    benchPair<AllIZHNeurons, AllDSSynapses>("IZH/AllDSSynapses", nNeurons, nSynapses, nSteps, "counter");
+    benchPair<AllIZHNeurons, AllDSSynapses>("IZH/AllDSSynapses", nNeurons, nSynapses, nSteps, "blocked");
+    benchPair<AllIZHNeurons, AllSTDPSynapses>("IZH/AllSTDPSynapses", nNeurons, nSynapses, nSteps, "dense");
+    benchPair<AllIZHNeurons, AllSTDPSynapses>("IZH/AllSTDPSynapses", nNeurons, nSynapses, nSteps, "ring");
+    benchPair<AllIZHNeurons, AllDynamicSTDPSynapses>("IZH/AllDynamicSTDPSynapses", nNeurons, nSynapses, nSteps, "dense");
+    benchPair<AllIZHNeurons, AllDynamicSTDPSynapses>("IZH/AllDynamicSTDPSynapses", nNeurons, nSynapses, nSteps, "ring");
+
+    return 0;
+}
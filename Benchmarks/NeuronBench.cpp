@@ -0,0 +1,153 @@
+/**
+ *      @file NeuronBench.cpp
+ *
+ *      @brief Microbenchmark of the host neuron kernels.
+ *
+ *      Advances a population of LIF neurons and a population of Izhikevich neurons
+ *      with the scalar reference (AllSpikingNeurons::advanceNeuronsBatch(), one
+ *      advanceNeuron() call per neuron) and with the kernels selected by the build
+ *      (the vectorized kernels of AllIFNeurons when CSIMD is avx2 or avx512).
+ *      Both runs start from the same state and the same noise seed; prints the
+ *      neurons advanced per second and whether the final states are identical.
+ *
+ *      TO USE:
+ *
+ *      $ make neuronbench
+ *      $ ./neuronbench [number of neurons] [number of steps]
+ *
+ *      The number of neurons defaults to 10000, and the number of steps to 10000
+ *      (one epoch of 1 s).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include "BenchNeurons.h"
+
+using namespace std;
+
+/*
+ *  Advance the neurons for a number of steps.
+ *
+ *  @param  neurons     The neurons.
+ *  @param  sim_info    SimulationInfo of the run.
+ *  @param  clr_info    ClusterInfo of the run.
+ *  @param  nSteps      Number of steps.
+ *  @param  reference   True to use the scalar reference.
+ *  @return seconds spent advancing the neurons.
+ */
+static double runSteps(AllSpikingNeurons &neurons, SimulationInfo &sim_info, ClusterInfo &clr_info, int nSteps, bool reference)
+{
+    AllSpikingNeuronsProps *pNeuronsProps = static_cast<AllSpikingNeuronsProps*>(neurons.m_pNeuronsProps);
+    int maxSpikes = (int) ((sim_info.epochDuration * sim_info.maxFiringRate));
+    int nStepsPerEpoch = static_cast<int>(sim_info.epochDuration / sim_info.deltaT);
+    int nNeurons = clr_info.totalClusterNeurons;
+    Norm normRand(0, 1, 1);
+    double seconds = 0;
+
+    for (int iStep = 0; iStep < nSteps; iStep++) {
+        g_simulationStep = iStep;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        if (reference) {
+            neurons.AllSpikingNeurons::advanceNeuronsBatch(0, nNeurons, maxSpikes, sim_info.deltaT, g_simulationStep, &normRand);
+        } else {
+            neurons.advanceNeuronsBatch(0, nNeurons, maxSpikes, sim_info.deltaT, g_simulationStep, &normRand);
+        }
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        // the recorder clears the spike counts at the end of each epoch
+        if ((iStep + 1) % nStepsPerEpoch == 0) {
+            g_simulationStep = iStep + 1;
+            pNeuronsProps->clearSpikeCounts(&sim_info, &clr_info, NULL);
+        }
+    }
+
+    return seconds;
+}
+
+/*
+ *  Check if two runs end in the same state.
+ *
+ *  @param  a         Neurons properties of a run.
+ *  @param  b         Neurons properties of the other run.
+ *  @param  nNeurons  Number of neurons.
+ *  @return true if the membrane voltages, refractory steps and spike counts are identical.
+ */
+static bool sameState(const AllIFNeuronsProps *a, const AllIFNeuronsProps *b, int nNeurons)
+{
+    for (int i = 0; i < nNeurons; i++) {
+        if (a->Vm[i] != b->Vm[i] || a->nStepsInRefr[i] != b->nStepsInRefr[i] || a->spikeCount[i] != b->spikeCount[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ *  Run the benchmark of a neuron model.
+ *
+ *  @param  name      Name of the model.
+ *  @param  nNeurons  Number of neurons.
+ *  @param  nSteps    Number of steps.
+ */
+template <class Neurons>
+static void benchModel(const char *name, int nNeurons, int nSteps)
+{
+    SimulationInfo sim_info;
+    sim_info.epochDuration = 1.0;
+    sim_info.maxFiringRate = 200;
+
+    ClusterInfo clr_info;
+    clr_info.totalClusterNeurons = nNeurons;
+
+    Neurons reference, batch;
+    reference.createNeuronsProps();
+    reference.setupNeurons(&sim_info, &clr_info);
+    setNeuronsProps(reference, nNeurons, sim_info.deltaT);
+    batch.createNeuronsProps();
+    batch.setupNeurons(&sim_info, &clr_info);
+    setNeuronsProps(batch, nNeurons, sim_info.deltaT);
+
+    double referenceSeconds = runSteps(reference, sim_info, clr_info, nSteps, true);
+    double batchSeconds = runSteps(batch, sim_info, clr_info, nSteps, false);
+
+    bool same = sameState(static_cast<AllIFNeuronsProps*>(reference.m_pNeuronsProps), static_cast<AllIFNeuronsProps*>(batch.m_pNeuronsProps), nNeurons);
+    double neuronSteps = static_cast<double>(nNeurons) * nSteps;
+
+    cout << setw(8) << name
+         << setw(16) << fixed << setprecision(1) << neuronSteps / referenceSeconds / 1e6
+         << setw(16) << neuronSteps / batchSeconds / 1e6
+         << setw(10) << setprecision(2) << referenceSeconds / batchSeconds
+         << setw(12) << (same ? "yes" : "NO") << endl;
+
+    reference.cleanupNeurons();
+    batch.cleanupNeurons();
+}
+
+int main(int argc, char *argv[])
+{
+    int nNeurons = argc > 1 ? atoi(argv[1]) : 10000;
+    int nSteps = argc > 2 ? atoi(argv[2]) : 10000;
+
+    if (nNeurons < 1 || nSteps < 1) {
+        cerr << "Usage: " << argv[0] << " [number of neurons] [number of steps]" << endl;
+        return -1;
+    }
+
+#if defined(IF_NEURONS_SIMD_WIDTH)
+    int width = IF_NEURONS_SIMD_WIDTH;
+#else
+    int width = 1;
+#endif
+    cout << "neurons: " << nNeurons << ", steps: " << nSteps << ", neurons per vector: " << width << endl;
+    cout << setw(8) << "model" << setw(16) << "scalar Mn/s" << setw(16) << "batch Mn/s"
+         << setw(10) << "speedup" << setw(12) << "identical" << endl;
+
+    benchModel<AllLIFNeurons>("LIF", nNeurons, nSteps);
+    benchModel<AllIZHNeurons>("IZH", nNeurons, nSteps);
+
+    return 0;
+}
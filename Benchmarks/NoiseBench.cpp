@@ -0,0 +1,228 @@
+/**
+ *      @file NoiseBench.cpp
+ *
+ *      @brief Statistical test and throughput benchmark of the noise generators.
+ *
+ *      Draws the same number of normally distributed random numbers from Norm
+ *      (one call per number), from BatchNorm (a buffer per step, as the
+ *      clusters do with the batch noise generator) and from Philox (one
+ *      counter per neuron and step, as the clusters do with the counter noise
+ *      generator), and prints for each:
+ *      - the numbers generated per second;
+ *      - the z-scores of the mean, variance, skewness, excess kurtosis,
+ *        fraction beyond 3 sigma and autocorrelations at lags 1, 16 and 32
+ *        (lag 16 pairs the two numbers of a BatchNorm lane, lag 32 the
+ *        consecutive numbers of a lane);
+ *      - the chi-square of a histogram of 64 equiprobable bins (63 degrees of
+ *        freedom).
+ *      A statistic fails if its z-score is above 5 in magnitude (for the chi-square,
+ *      the z-score of the chi-square distribution). Exits with 1 if BatchNorm or
+ *      Philox fails.
+ *
+ *      TO USE:
+ *
+ *      $ make noisebench
+ *      $ ./noisebench [buffer size] [number of buffers]
+ *
+ *      The buffer size (number of neurons of a cluster) defaults to 10000, and the
+ *      number of buffers to 1000.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include "Norm.h"
+#include "BatchNorm.h"
+#include "Philox.h"
+
+using namespace std;
+
+//! Number of bins of the chi-square test.
+#define NUM_BINS 64
+
+//! Magnitude of the z-score above which a statistic fails.
+#define MAX_Z_SCORE 5.0
+
+/*
+ *  Accumulates the statistics of a sequence of numbers.
+ */
+class NoiseStats
+{
+    public:
+        NoiseStats() : n(0), sum1(0), sum2(0), sum3(0), sum4(0), nTails(0)
+        {
+            for (int i = 0; i < NUM_LAGS; i++) {
+                lagSums[i] = 0;
+            }
+            for (int i = 0; i < NUM_BINS; i++) {
+                bins[i] = 0;
+            }
+
+            // upper edges of the equiprobable bins, by bisection of the normal CDF
+            for (int i = 0; i < NUM_BINS - 1; i++) {
+                double p = static_cast<double>(i + 1) / NUM_BINS;
+                double lo = -10, hi = 10;
+                for (int k = 0; k < 100; k++) {
+                    double mid = (lo + hi) / 2;
+                    (0.5 * erfc(-mid / sqrt(2.0)) < p ? lo : hi) = mid;
+                }
+                edges[i] = (lo + hi) / 2;
+            }
+        }
+
+        /*
+         *  Add the numbers of a buffer.
+         *
+         *  @param  numbers   The numbers.
+         *  @param  count     Number of numbers.
+         */
+        void add(const BGFLOAT *numbers, int count)
+        {
+            for (int i = 0; i < count; i++) {
+                double x = numbers[i];
+                double x2 = x * x;
+                sum1 += x;
+                sum2 += x2;
+                sum3 += x2 * x;
+                sum4 += x2 * x2;
+                nTails += fabs(x) > 3;
+
+                for (int k = 0; k < NUM_LAGS; k++) {
+                    if (n >= static_cast<uint64_t>(lags[k])) {
+                        lagSums[k] += x * history[(n - lags[k]) % HISTORY_SIZE];
+                    }
+                }
+                history[n % HISTORY_SIZE] = x;
+
+                int lo = 0, hi = NUM_BINS - 1;
+                while (lo < hi) {
+                    int mid = (lo + hi) / 2;
+                    if (x <= edges[mid]) {
+                        hi = mid;
+                    } else {
+                        lo = mid + 1;
+                    }
+                }
+                bins[lo]++;
+                n++;
+            }
+        }
+
+        /*
+         *  Print the z-scores of the statistics.
+         *
+         *  @param  name      Name of the generator.
+         *  @param  rate      Numbers generated per second.
+         *  @return true if all the statistics pass.
+         */
+        bool print(const char *name, double rate) const
+        {
+            double N = static_cast<double>(n);
+            double mean = sum1 / N;
+            double var = sum2 / N - mean * mean;
+            double skew = (sum3 / N - 3 * mean * sum2 / N + 2 * mean * mean * mean) / pow(var, 1.5);
+            double m4 = sum4 / N - 4 * mean * sum3 / N + 6 * mean * mean * sum2 / N - 3 * mean * mean * mean * mean;
+            double kurt = m4 / (var * var) - 3;
+            double pTails = erfc(3 / sqrt(2.0));
+
+            double chi2 = 0;
+            for (int i = 0; i < NUM_BINS; i++) {
+                double expected = N / NUM_BINS;
+                chi2 += (bins[i] - expected) * (bins[i] - expected) / expected;
+            }
+
+            double z[5 + NUM_LAGS + 1];
+            z[0] = mean * sqrt(N);
+            z[1] = (var - 1) / sqrt(2 / N);
+            z[2] = skew / sqrt(6 / N);
+            z[3] = kurt / sqrt(24 / N);
+            z[4] = (nTails / N - pTails) / sqrt(pTails * (1 - pTails) / N);
+            for (int k = 0; k < NUM_LAGS; k++) {
+                z[5 + k] = lagSums[k] / (N - lags[k]) * sqrt(N - lags[k]);
+            }
+            z[5 + NUM_LAGS] = (chi2 - (NUM_BINS - 1)) / sqrt(2.0 * (NUM_BINS - 1));
+
+            bool pass = true;
+            cout << setw(10) << name << setw(10) << fixed << setprecision(1) << rate / 1e6;
+            for (int i = 0; i < 5 + NUM_LAGS + 1; i++) {
+                cout << setw(8) << setprecision(2) << z[i];
+                pass = pass && fabs(z[i]) <= MAX_Z_SCORE;
+            }
+            cout << setw(8) << (pass ? "pass" : "FAIL") << endl;
+
+            return pass;
+        }
+
+    private:
+        //! Number of autocorrelation lags.
+        static const int NUM_LAGS = 3;
+        //! Size of the history of the numbers (above the largest lag).
+        static const int HISTORY_SIZE = 64;
+        //! The autocorrelation lags.
+        static const int lags[NUM_LAGS];
+
+        uint64_t n;
+        double sum1, sum2, sum3, sum4;
+        uint64_t nTails;
+        double lagSums[NUM_LAGS];
+        double history[HISTORY_SIZE];
+        double edges[NUM_BINS - 1];
+        uint64_t bins[NUM_BINS];
+};
+
+const int NoiseStats::lags[NoiseStats::NUM_LAGS] = { 1, 16, 32 };
+
+int main(int argc, char *argv[])
+{
+    int bufferSize = argc > 1 ? atoi(argv[1]) : 10000;
+    int nBuffers = argc > 2 ? atoi(argv[2]) : 1000;
+
+    if (bufferSize < 1 || nBuffers < 1) {
+        cerr << "Usage: " << argv[0] << " [buffer size] [number of buffers]" << endl;
+        return -1;
+    }
+
+    vector<BGFLOAT> buffer(bufferSize);
+    Norm normRand(0, 1, 1);
+    BatchNorm batchNormRand(1);
+    Philox counterRand(1);
+    NoiseStats normStats, batchStats, counterStats;
+    double normSeconds = 0, batchSeconds = 0, counterSeconds = 0;
+
+    for (int iBuffer = 0; iBuffer < nBuffers; iBuffer++) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < bufferSize; i++) {
+            buffer[i] = normRand();
+        }
+        normSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        normStats.add(buffer.data(), bufferSize);
+
+        start = chrono::steady_clock::now();
+        batchNormRand.fill(buffer.data(), bufferSize);
+        batchSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        batchStats.add(buffer.data(), bufferSize);
+
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < bufferSize; i++) {
+            buffer[i] = counterRand.normal(PHILOX_STREAM_NOISE, i, iBuffer);
+        }
+        counterSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        counterStats.add(buffer.data(), bufferSize);
+    }
+
+    double count = static_cast<double>(bufferSize) * nBuffers;
+    cout << "numbers: " << bufferSize << " x " << nBuffers << ", z-scores (fail above " << MAX_Z_SCORE << ")" << endl;
+    cout << setw(10) << "generator" << setw(10) << "Mnum/s" << setw(8) << "mean" << setw(8) << "var"
+         << setw(8) << "skew" << setw(8) << "kurt" << setw(8) << ">3sd" << setw(8) << "lag1"
+         << setw(8) << "lag16" << setw(8) << "lag32" << setw(8) << "chi2" << endl;
+    normStats.print("Norm", count / normSeconds);
+    bool pass = batchStats.print("BatchNorm", count / batchSeconds);
+    pass = counterStats.print("Philox", count / counterSeconds) && pass;
+    cout << "speedup: BatchNorm " << setprecision(2) << normSeconds / batchSeconds
+         << ", Philox " << normSeconds / counterSeconds << endl;
+
+    return pass ? 0 : 1;
+}
@@ -1,10 +1,18 @@
 #include "ConnGrowth.h"
+#include "Checkpoint.h"
 #include "ParseParamError.h"
 #include "IAllSynapses.h"
 #include "XmlGrowthRecorder.h"
+#include "BinaryGrowthRecorder.h"
 #ifdef USE_HDF5
 #include "Hdf5GrowthRecorder.h"
 #endif
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+//! Synapse index of a pair of neurons which is not connected.
+static const BGSIZE NO_SYNAPSE = numeric_limits<BGSIZE>::max();
 
 /* ------------- CONNECTIONS STRUCT ------------ *\
  * Below all of the resources for the various
@@ -46,6 +54,8 @@
 \* --------------------------------------------- */
 ConnGrowth::ConnGrowth() : Connections()
 {
+    m_sparseGrowth = true;
+    m_sparseMargin = 1.0;
     radii = NULL;
     rates = NULL;
     radiiSize = 0;
@@ -89,16 +99,33 @@ void ConnGrowth::setupConnections(const SimulationInfo *sim_info, Layout *layout
     // Initialize the Barrier Synchnonize object for updateConnections.
     m_barrierUpdateConnections = new Barrier(vtClr.size() + 1);
 #else // !USE_GPU
-    W = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, num_neurons, num_neurons, 0);
     radii = new VectorMatrix(MATRIX_TYPE, MATRIX_INIT, 1, num_neurons, m_growth.startRadius);
     rates = new VectorMatrix(MATRIX_TYPE, MATRIX_INIT, 1, num_neurons, 0);
-    delta = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, num_neurons, num_neurons);
-    area = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, num_neurons, num_neurons, 0);
     outgrowth = new VectorMatrix(MATRIX_TYPE, MATRIX_INIT, 1, num_neurons);
     deltaR = new VectorMatrix(MATRIX_TYPE, MATRIX_INIT, 1, num_neurons);
 
-    // Init connection frontier distance change matrix with the current distances
-    (*delta) = (*layout->dist);
+    if (m_sparseGrowth) {
+        // The sparse engine only keeps the pairs that may overlap,
+        // which are collected at the first update.
+        m_candBegin.clear();
+        m_candNeuron.clear();
+        m_candArea.clear();
+        m_candRadii.clear();
+        m_candChanged.clear();
+        m_candSlot.clear();
+        m_nMappedSynapses.clear();
+    } else {
+        W = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, num_neurons, num_neurons, 0);
+        delta = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, num_neurons, num_neurons);
+        area = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, num_neurons, num_neurons, 0);
+
+        // Init connection frontier distance change matrix with the current distances
+        for (int i = 0; i < num_neurons; i++) {
+            for (int j = 0; j < num_neurons; j++) {
+                (*delta)(i, j) = layout->dist(i, j);
+            }
+        }
+    }
 #endif // !USE_GPU
 }
 
@@ -119,6 +146,14 @@ void ConnGrowth::cleanupConnections()
     if (area != NULL) delete area;
     if (outgrowth != NULL) delete outgrowth;
     if (deltaR != NULL) delete deltaR;
+
+    m_candBegin.clear();
+    m_candNeuron.clear();
+    m_candArea.clear();
+    m_candRadii.clear();
+    m_candChanged.clear();
+    m_candSlot.clear();
+    m_nMappedSynapses.clear();
 #endif // !USE_GPU
 
     radii = NULL;
@@ -226,6 +261,22 @@ bool ConnGrowth::readParameters(const TiXmlElement& element)
 	else if(element.ValueStr().compare("startRadius") == 0){
             m_growth.startRadius = atof(element.GetText());
         }
+	else if(element.ValueStr().compare("growthMode") == 0){
+            string mode = element.GetText();
+            if (mode.compare("sparse") == 0) {
+                m_sparseGrowth = true;
+            } else if (mode.compare("dense") == 0) {
+                m_sparseGrowth = false;
+            } else {
+                throw ParseParamError("growthMode", "Invalid growthMode value (must be sparse or dense).");
+            }
+        }
+	else if(element.ValueStr().compare("sparseMargin") == 0){
+            m_sparseMargin = atof(element.GetText());
+            if (m_sparseMargin <= 0) {
+                throw ParseParamError("sparseMargin", "Invalid non-positive Growth param 'sparseMargin' value.");
+            }
+        }
 	
 	if(m_growth.epsilon != 0){
 	    m_growth.maxRate = m_growth.targetRate / m_growth.epsilon;
@@ -250,7 +301,9 @@ void ConnGrowth::printParameters(ostream &output) const
            << ", rho: " << m_growth.rho
            << ", targetRate: " << m_growth.targetRate << "," << endl
            << "\tminRadius: " << m_growth.minRadius
-           << ", startRadius: " << m_growth.startRadius
+           << ", startRadius: " << m_growth.startRadius << "," << endl
+           << "\tgrowthMode: " << (m_sparseGrowth ? "sparse" : "dense")
+           << ", sparseMargin: " << m_sparseMargin
            << endl;
 
 }
@@ -268,18 +321,29 @@ void ConnGrowth::updateConnections(const SimulationInfo *sim_info, Layout *layou
 {
     // Update Connections data
     updateConns(sim_info, vtClr, vtClrInfo);
- 
-    // Update the distance between frontiers of Neurons
-    updateFrontiers(sim_info->totalNeurons, layout);
-
-    // Update the areas of overlap in between Neurons
-    updateOverlap(sim_info->totalNeurons, layout);
- 
-    // Update the weight of the Synapses in the simulation
-    updateSynapsesWeights(sim_info, layout, vtClr, vtClrInfo);
-
-    // Create synapse index maps
-    SynapseIndexMap::createSynapseImap(sim_info, vtClr, vtClrInfo);
+
+    if (m_sparseGrowth) {
+        // Collect the pairs which may overlap
+        updateCandidates(sim_info->totalNeurons, layout);
+
+        // Update the areas of overlap in between candidate pairs
+        updateSparseOverlap(sim_info->totalNeurons, layout);
+
+        // Update the weight of the Synapses in the simulation
+        updateSparseSynapsesWeights(sim_info, layout, vtClr, vtClrInfo);
+    } else {
+        // Update the distance between frontiers of Neurons
+        updateFrontiers(sim_info->totalNeurons, layout);
+
+        // Update the areas of overlap in between Neurons
+        updateOverlap(sim_info->totalNeurons, layout);
+
+        // Update the weight of the Synapses in the simulation
+        updateSynapsesWeights(sim_info, layout, vtClr, vtClrInfo);
+    }
+
+    // Patch synapse index maps with the added and removed synapses
+    SynapseIndexMap::updateSynapseImap(sim_info, vtClr, vtClrInfo);
 }
 
 /*
@@ -325,7 +389,7 @@ void ConnGrowth::updateFrontiers(const int num_neurons, Layout *layout)
     // Update distance between frontiers
     for (int unit = 0; unit < num_neurons - 1; unit++) {
         for (int i = unit + 1; i < num_neurons; i++) {
-            (*delta)(unit, i) = (*layout->dist)(unit, i) - ((*radii)[unit] + (*radii)[i]);
+            (*delta)(unit, i) = layout->dist(unit, i) - ((*radii)[unit] + (*radii)[i]);
             (*delta)(i, unit) = (*delta)(unit, i);
         }
     }
@@ -347,37 +411,45 @@ void ConnGrowth::updateOverlap(BGFLOAT num_neurons, Layout *layout)
                 (*area)(i, j) = 0.0;
 
                 if ((*delta)(i, j) < 0) {
-                        BGFLOAT lenAB = (*layout->dist)(i, j);
-                        BGFLOAT r1 = (*radii)[i];
-                        BGFLOAT r2 = (*radii)[j];
-
-                    if (lenAB + min(r1, r2) <= max(r1, r2)) {
-                        (*area)(i, j) = pi * min(r1, r2) * min(r1, r2); // Completely overlapping unit
-#ifdef LOGFILE
-                        logFile << "Completely overlapping (i, j, r1, r2, area): "
-                            << i << ", " << j << ", " << r1 << ", " << r2 << ", " << *pAarea(i, j) << endl;
-#endif // LOGFILE
-                        } else {
-                                // Partially overlapping unit
-                                BGFLOAT lenAB2 = (*layout->dist2)(i, j);
-                                BGFLOAT r12 = r1 * r1;
-                                BGFLOAT r22 = r2 * r2;
-
-                                BGFLOAT cosCBA = (r22 + lenAB2 - r12) / (2.0 * r2 * lenAB);
-                                BGFLOAT angCBA = acos(cosCBA);
-                                BGFLOAT angCBD = 2.0 * angCBA;
-
-                                BGFLOAT cosCAB = (r12 + lenAB2 - r22) / (2.0 * r1 * lenAB);
-                                BGFLOAT angCAB = acos(cosCAB);
-                                BGFLOAT angCAD = 2.0 * angCAB;
-
-                                (*area)(i, j) = 0.5 * (r22 * (angCBD - sin(angCBD)) + r12 * (angCAD - sin(angCAD)));
-                        }
+                        BGFLOAT lenAB = layout->dist(i, j);
+                        BGFLOAT lenAB2 = layout->dist2(i, j);
+
+                        (*area)(i, j) = overlapArea(lenAB, lenAB2, (*radii)[i], (*radii)[j]);
                 }
         }
     }
 }
 
+/*
+ *  Calculate the area of overlap of two overlapping connectivity regions.
+ *
+ *  @param  lenAB   Distance between the two neurons.
+ *  @param  lenAB2  Distance squared between the two neurons.
+ *  @param  r1      Radius of the source neuron.
+ *  @param  r2      Radius of the destination neuron.
+ *  @return the area of overlap.
+ */
+BGFLOAT ConnGrowth::overlapArea(BGFLOAT lenAB, BGFLOAT lenAB2, BGFLOAT r1, BGFLOAT r2)
+{
+    if (lenAB + min(r1, r2) <= max(r1, r2)) {
+        return pi * min(r1, r2) * min(r1, r2); // Completely overlapping unit
+    }
+
+    // Partially overlapping unit
+    BGFLOAT r12 = r1 * r1;
+    BGFLOAT r22 = r2 * r2;
+
+    BGFLOAT cosCBA = (r22 + lenAB2 - r12) / (2.0 * r2 * lenAB);
+    BGFLOAT angCBA = acos(cosCBA);
+    BGFLOAT angCBD = 2.0 * angCBA;
+
+    BGFLOAT cosCAB = (r12 + lenAB2 - r22) / (2.0 * r1 * lenAB);
+    BGFLOAT angCAB = acos(cosCAB);
+    BGFLOAT angCAD = 2.0 * angCAB;
+
+    return 0.5 * (r22 * (angCBD - sin(angCBD)) + r12 * (angCAD - sin(angCAD)));
+}
+
 /*
  *  Update the weight of the Synapses in the simulation.
  *
@@ -399,69 +471,71 @@ void ConnGrowth::updateSynapsesWeights(const SimulationInfo *sim_info, Layout *l
     int removed = 0;
     int added = 0;
 
+    // source neuron to synapse index lookup of a destination neuron
+    vector<BGSIZE> slotOf(num_neurons, NO_SYNAPSE);
+
     DEBUG(cout << "adjusting weights" << endl;)
 
     // Scale and add sign to the areas
-    // visit each neuron 'a'
-    for (int src_neuron = 0; src_neuron < num_neurons; src_neuron++) {
-
-        // destination neurons of each cluster
-        for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
-            AllNeurons *neurons = dynamic_cast<AllNeurons*>(vtClr[iCluster]->m_neurons);
-            AllNeuronsProps *pNeuronsProps = neurons->m_pNeuronsProps;
-            AllSynapses *synapses = dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses);
-            AllSynapsesProps *pSynapsesProps = synapses->m_pSynapsesProps;
-
-            // and each destination neuron 'b'
-            int dest_neuron = vtClrInfo[iCluster]->clusterNeuronsBegin;
-            int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
-            for (int iNeuron = 0; iNeuron < totalClusterNeurons; dest_neuron++, iNeuron++) {
-                // visit each synapse at (xa,ya)
-                bool connected = false;
-                synapseType type = synapses->synType(layout->neuron_type_map, src_neuron, dest_neuron);
+    // destination neurons of each cluster
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+        AllNeurons *neurons = dynamic_cast<AllNeurons*>(vtClr[iCluster]->m_neurons);
+        AllNeuronsProps *pNeuronsProps = neurons->m_pNeuronsProps;
+        AllSynapses *synapses = dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses);
+        AllSynapsesProps *pSynapsesProps = synapses->m_pSynapsesProps;
 
-                // for each existing synapse
-                BGSIZE synapse_counts = pSynapsesProps->synapse_counts[iNeuron];
-                BGSIZE synapse_adjusted = 0;
-                BGSIZE iSyn = sim_info->maxSynapsesPerNeuron * (iNeuron);
-                for (BGSIZE synapse_index = 0; synapse_adjusted < synapse_counts; synapse_index++, iSyn++) {
-                    if (pSynapsesProps->in_use[iSyn] == true) {
-                        // if there is a synapse between a and b
-                        if (pSynapsesProps->sourceNeuronLayoutIndex[iSyn] == src_neuron) {
-                            connected = true;
-                            adjusted++;
-                            // adjust the strength of the synapse or remove
-                            // it from the synapse map if it has gone below
-                            // zero.
-                            if ((*W)(src_neuron, dest_neuron) < 0) {
-                                removed++;
-                                synapses->eraseSynapse(iNeuron, iSyn);
-                            } else {
-                                // adjust
-                                // SYNAPSE_STRENGTH_ADJUSTMENT is 1.0e-8;
-                                pSynapsesProps->W[iSyn] = (*W)(src_neuron, dest_neuron) *
-                                    synapses->synSign(type) * AllSynapses::SYNAPSE_STRENGTH_ADJUSTMENT;
-
-                                DEBUG_MID(cout << "weight of rgSynapseMap" <<
-                                       "[" <<synapse_index<<"]: " <<
-                                       pSynapsesProps->W[iSyn] << endl;);
-                            }
-                        }
-                        synapse_adjusted++;
-                    }
+        // and each destination neuron 'b'
+        int dest_neuron = vtClrInfo[iCluster]->clusterNeuronsBegin;
+        int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
+        for (int iNeuron = 0; iNeuron < totalClusterNeurons; dest_neuron++, iNeuron++) {
+            // index the existing synapses by their source neuron
+            BGSIZE synapse_counts = pSynapsesProps->synapse_counts[iNeuron];
+            BGSIZE synapse_adjusted = 0;
+            BGSIZE iSyn = sim_info->maxSynapsesPerNeuron * (iNeuron);
+            for (BGSIZE synapse_index = 0; synapse_adjusted < synapse_counts; synapse_index++, iSyn++) {
+                if (pSynapsesProps->in_use[iSyn] == true) {
+                    slotOf[pSynapsesProps->sourceNeuronLayoutIndex[iSyn]] = iSyn;
+                    synapse_adjusted++;
                 }
+            }
 
+            // visit each neuron 'a'
+            for (int src_neuron = 0; src_neuron < num_neurons; src_neuron++) {
+                BGSIZE iSyn = slotOf[src_neuron];
+
+                // if there is a synapse between a and b
+                if (iSyn != NO_SYNAPSE) {
+                    slotOf[src_neuron] = NO_SYNAPSE;
+                    adjusted++;
+                    // adjust the strength of the synapse or remove
+                    // it from the synapse map if it has gone below
+                    // zero.
+                    if ((*W)(src_neuron, dest_neuron) < 0) {
+                        removed++;
+                        synapses->eraseSynapse(iNeuron, iSyn);
+                    } else {
+                        // adjust
+                        // SYNAPSE_STRENGTH_ADJUSTMENT is 1.0e-8;
+                        synapseType type = synapses->synType(layout->neuron_type_map, src_neuron, dest_neuron);
+                        pSynapsesProps->W[iSyn] = (*W)(src_neuron, dest_neuron) *
+                            synapses->synSign(type) * AllSynapses::SYNAPSE_STRENGTH_ADJUSTMENT;
+
+                        DEBUG_MID(cout << "weight of rgSynapseMap" <<
+                               "[" << iSyn << "]: " <<
+                               pSynapsesProps->W[iSyn] << endl;);
+                    }
+                }
                 // if not connected and weight(a,b) > 0, add a new synapse from a to b
-                if (!connected && ((*W)(src_neuron, dest_neuron) > 0)) {
+                else if (((*W)(src_neuron, dest_neuron) > 0) &&
+                        pSynapsesProps->synapse_counts[iNeuron] < pSynapsesProps->maxSynapsesPerNeuron) {
+                    synapseType type = synapses->synType(layout->neuron_type_map, src_neuron, dest_neuron);
 
                     // locate summation point
                     BGFLOAT* sum_point = &( pNeuronsProps->summation_map[iNeuron] );
                     added++;
-    
-                    BGSIZE iSyn;
+
                     synapses->addSynapse(iSyn, type, src_neuron, dest_neuron, sum_point, sim_info->deltaT, iNeuron);
                     pSynapsesProps->W[iSyn] = (*W)(src_neuron, dest_neuron) * synapses->synSign(type) * AllSynapses::SYNAPSE_STRENGTH_ADJUSTMENT;
-
                 }
             }
         }
@@ -473,6 +547,228 @@ void ConnGrowth::updateSynapsesWeights(const SimulationInfo *sim_info, Layout *l
     DEBUG (cout << "added: " << added << endl << endl << endl;)
 
 }
+
+/*
+ *  Rebuild the list of candidate pairs (pairs whose distance is within
+ *  the sum of their radii plus m_sparseMargin) when any radius has grown
+ *  by more than half of the margin since the last build.
+ *  Candidates are collected through the spatial index of the layout.
+ *
+ *  @param  num_neurons Number of neurons to update.
+ *  @param  layout      Layout information of the neunal network.
+ */
+void ConnGrowth::updateCandidates(const int num_neurons, Layout *layout)
+{
+    // A pair which is not a candidate can't overlap until the sum of
+    // its radii has grown by more than the margin.
+    bool rebuild = m_candBegin.empty();
+    for (int i = 0; !rebuild && i < num_neurons; i++) {
+        if ((*radii)[i] - m_candRadii[i] > m_sparseMargin / 2) {
+            rebuild = true;
+        }
+    }
+    if (!rebuild) {
+        return;
+    }
+
+    DEBUG(cout << "Rebuilding overlap candidates..." << endl;)
+
+    m_candRadii.resize(num_neurons);
+    BGFLOAT maxRadius = 0;
+    for (int i = 0; i < num_neurons; i++) {
+        m_candRadii[i] = (*radii)[i];
+        maxRadius = max(maxRadius, m_candRadii[i]);
+    }
+
+    // collect the candidates of each neuron through the spatial index of the layout
+    vector<int> neighbors;
+    m_candBegin.assign(num_neurons + 1, 0);
+    m_candNeuron.clear();
+    for (int i = 0; i < num_neurons; i++) {
+        layout->getNeighborsInRange(i, m_candRadii[i] + maxRadius + m_sparseMargin, neighbors);
+        // the neighbors are in ascending order, which is the order the synapses are added
+        for (BGSIZE k = 0; k < neighbors.size(); k++) {
+            int j = neighbors[k];
+            if (layout->dist(i, j) < m_candRadii[i] + m_candRadii[j] + m_sparseMargin) {
+                m_candNeuron.push_back(j);
+            }
+        }
+        m_candBegin[i + 1] = m_candNeuron.size();
+    }
+    m_candArea.assign(m_candNeuron.size(), 0);
+    m_candChanged.assign(m_candNeuron.size(), true);
+
+    // the synapses have to be associated with the new candidates
+    m_candSlot.assign(m_candNeuron.size(), NO_SYNAPSE);
+    m_nMappedSynapses.assign(num_neurons, NO_SYNAPSE);
+
+    DEBUG(cout << "overlap candidates: " << m_candNeuron.size() << endl;)
+}
+
+/*
+ *  Update the areas of overlap of the candidate pairs
+ *  (sparse counterpart of updateFrontiers and updateOverlap).
+ *
+ *  @param  num_neurons Number of neurons to update.
+ *  @param  layout      Layout information of the neunal network.
+ */
+void ConnGrowth::updateSparseOverlap(const int num_neurons, Layout *layout)
+{
+    DEBUG(cout << "computing areas of overlap" << endl;)
+
+    for (int dest_neuron = 0; dest_neuron < num_neurons; dest_neuron++) {
+        for (BGSIZE k = m_candBegin[dest_neuron]; k < m_candBegin[dest_neuron + 1]; k++) {
+            int src_neuron = m_candNeuron[k];
+            BGFLOAT lenAB2 = layout->dist2(src_neuron, dest_neuron);
+            BGFLOAT lenAB = sqrt(lenAB2);
+            BGFLOAT r1 = (*radii)[src_neuron];
+            BGFLOAT r2 = (*radii)[dest_neuron];
+
+            // distance between frontiers
+            BGFLOAT delta = lenAB - (r1 + r2);
+
+            BGFLOAT area = 0.0;
+            if (delta < 0) {
+                area = overlapArea(lenAB, lenAB2, r1, r2);
+            }
+            if (area != m_candArea[k]) {
+                m_candChanged[k] = true;
+            }
+            m_candArea[k] = area;
+        }
+    }
+}
+
+/*
+ *  Associate the existing synapses of a destination neuron with its candidate pairs
+ *  (the source neuron to synapse index lookup of the neuron).
+ *  Synapses whose source is not a candidate don't overlap, so their weights are cleared.
+ *
+ *  @param  sim_info     SimulationInfo to refer from.
+ *  @param  layout       Layout information of the neunal network.
+ *  @param  synapses     Synapses of the cluster of the destination neuron.
+ *  @param  dest_neuron  Layout index of the destination neuron.
+ *  @param  iNeuron      Index of the destination neuron in the cluster.
+ */
+void ConnGrowth::mapSynapses(const SimulationInfo *sim_info, Layout *layout, AllSynapses *synapses, int dest_neuron, int iNeuron)
+{
+    AllSynapsesProps *pSynapsesProps = synapses->m_pSynapsesProps;
+    vector<int>::iterator rowBegin = m_candNeuron.begin() + m_candBegin[dest_neuron];
+    vector<int>::iterator rowEnd = m_candNeuron.begin() + m_candBegin[dest_neuron + 1];
+
+    fill(m_candSlot.begin() + m_candBegin[dest_neuron], m_candSlot.begin() + m_candBegin[dest_neuron + 1], NO_SYNAPSE);
+
+    // for each existing synapse
+    BGSIZE synapse_counts = pSynapsesProps->synapse_counts[iNeuron];
+    BGSIZE synapse_adjusted = 0;
+    BGSIZE iSyn = sim_info->maxSynapsesPerNeuron * (iNeuron);
+    for (BGSIZE synapse_index = 0; synapse_adjusted < synapse_counts; synapse_index++, iSyn++) {
+        if (pSynapsesProps->in_use[iSyn] == true) {
+            int src_neuron = pSynapsesProps->sourceNeuronLayoutIndex[iSyn];
+            vector<int>::iterator it = lower_bound(rowBegin, rowEnd, src_neuron);
+            if (it != rowEnd && *it == src_neuron) {
+                m_candSlot[m_candBegin[dest_neuron] + (it - rowBegin)] = iSyn;
+            } else {
+                BGFLOAT weight = 0.0;
+                synapseType type = synapses->synType(layout->neuron_type_map, src_neuron, dest_neuron);
+                pSynapsesProps->W[iSyn] = weight * synapses->synSign(type) * AllSynapses::SYNAPSE_STRENGTH_ADJUSTMENT;
+            }
+            synapse_adjusted++;
+        }
+    }
+
+    m_nMappedSynapses[dest_neuron] = synapse_counts;
+}
+
+/*
+ *  Update the weight of the Synapses in the simulation from the
+ *  areas of overlap of the candidate pairs.
+ *  Only the pairs whose area of overlap has changed are visited,
+ *  unless the synapses change their weights by themselves.
+ *
+ *  @param  sim_info    SimulationInfo to refer from.
+ *  @param  layout      Layout information of the neunal network.
+ *  @param  vtClr       Vector of Cluster class objects.
+ *  @param  vtClrInfo   Vector of ClusterInfo.
+ */
+void ConnGrowth::updateSparseSynapsesWeights(const SimulationInfo *sim_info, Layout *layout, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
+{
+    int adjusted = 0;
+    int removed = 0;
+    int added = 0;
+
+    DEBUG(cout << "adjusting weights" << endl;)
+
+    // destination neurons of each cluster
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+        AllNeurons *neurons = dynamic_cast<AllNeurons*>(vtClr[iCluster]->m_neurons);
+        AllNeuronsProps *pNeuronsProps = neurons->m_pNeuronsProps;
+        AllSynapses *synapses = dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses);
+        AllSynapsesProps *pSynapsesProps = synapses->m_pSynapsesProps;
+
+        // weights changed by a learning rule are reset to the areas every epoch
+        bool plastic = synapses->isWeightPlastic();
+
+        int dest_neuron = vtClrInfo[iCluster]->clusterNeuronsBegin;
+        int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
+        for (int iNeuron = 0; iNeuron < totalClusterNeurons; dest_neuron++, iNeuron++) {
+            // rebuild the lookup when synapses were added or removed somewhere else
+            // (e.g. loaded from a serialization file)
+            bool remapped = false;
+            if (plastic || m_nMappedSynapses[dest_neuron] != pSynapsesProps->synapse_counts[iNeuron]) {
+                mapSynapses(sim_info, layout, synapses, dest_neuron, iNeuron);
+                remapped = true;
+            }
+
+            // the sources are in ascending order, which is the order the synapses are added
+            for (BGSIZE k = m_candBegin[dest_neuron]; k < m_candBegin[dest_neuron + 1]; k++) {
+                BGFLOAT weight = m_candArea[k];
+                BGSIZE iSyn = m_candSlot[k];
+
+                // if there is a synapse between a and b
+                if (iSyn != NO_SYNAPSE) {
+                    if (!m_candChanged[k] && !remapped) {
+                        continue;
+                    }
+
+                    adjusted++;
+                    // adjust the strength of the synapse or remove
+                    // it from the synapse map if it has gone below
+                    // zero.
+                    if (weight < 0) {
+                        removed++;
+                        synapses->eraseSynapse(iNeuron, iSyn);
+                        m_candSlot[k] = NO_SYNAPSE;
+                        m_nMappedSynapses[dest_neuron]--;
+                    } else {
+                        synapseType type = synapses->synType(layout->neuron_type_map, m_candNeuron[k], dest_neuron);
+                        pSynapsesProps->W[iSyn] = weight *
+                            synapses->synSign(type) * AllSynapses::SYNAPSE_STRENGTH_ADJUSTMENT;
+                    }
+                }
+                // if not connected and weight(a,b) > 0, add a new synapse from a to b
+                else if (weight > 0 && pSynapsesProps->synapse_counts[iNeuron] < pSynapsesProps->maxSynapsesPerNeuron) {
+                    int src_neuron = m_candNeuron[k];
+                    synapseType type = synapses->synType(layout->neuron_type_map, src_neuron, dest_neuron);
+
+                    // locate summation point
+                    BGFLOAT* sum_point = &( pNeuronsProps->summation_map[iNeuron] );
+                    added++;
+
+                    synapses->addSynapse(iSyn, type, src_neuron, dest_neuron, sum_point, sim_info->deltaT, iNeuron);
+                    pSynapsesProps->W[iSyn] = weight * synapses->synSign(type) * AllSynapses::SYNAPSE_STRENGTH_ADJUSTMENT;
+                    m_candSlot[k] = iSyn;
+                    m_nMappedSynapses[dest_neuron]++;
+                }
+                m_candChanged[k] = false;
+            }
+        }
+    }
+
+    DEBUG (cout << "adjusted: " << adjusted << endl;)
+    DEBUG (cout << "removed: " << removed << endl;)
+    DEBUG (cout << "added: " << added << endl << endl << endl;)
+}
 #endif // !USE_GPU
 
 /*
@@ -490,6 +786,9 @@ IRecorder* ConnGrowth::createRecorder(const SimulationInfo *simInfo)
     if (simInfo->stateOutputFileName.find(".xml") != string::npos) {
         simRecorder = new XmlGrowthRecorder(simInfo);
     }
+    else if (simInfo->stateOutputFileName.find(".bgspk") != string::npos) {
+        simRecorder = new BinaryGrowthRecorder(simInfo);
+    }
 #ifdef USE_HDF5
     else if (simInfo->stateOutputFileName.find(".h5") != string::npos) {
         simRecorder = new Hdf5GrowthRecorder(simInfo);
@@ -505,6 +804,81 @@ IRecorder* ConnGrowth::createRecorder(const SimulationInfo *simInfo)
     return simRecorder;
 }
 
+/*
+ *  Add radii to a binary checkpoint.
+ *
+ *  @param  writer    The checkpoint writer.
+ */
+void ConnGrowth::checkpoint(CheckpointWriter &writer) const {
+#if defined(USE_GPU)
+    writer.addSection(CKPT_RADII, 0, radii, sizeof(BGFLOAT), radiiSize, 1);
+#else // !USE_GPU
+    writer.addSection(CKPT_RADII, 0, &(*radii)[0], sizeof(BGFLOAT), radiiSize, 1);
+#endif // !USE_GPU
+}
+
+/*
+ *  Restore radii from a binary checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @return true if successful, false if the section is missing or
+ *          does not match radiiSize.
+ */
+bool ConnGrowth::restore(const CheckpointReader &reader) {
+    const BGFLOAT *radiiData = static_cast<const BGFLOAT *>(reader.getSection(CKPT_RADII, 0, sizeof(BGFLOAT), radiiSize, 1));
+
+    if (radiiData == NULL) {
+        cerr << "Failed restoring radii. Please verify totalNeurons data member in SimulationInfo class." << endl;
+        return false;
+    }
+
+#if defined(USE_GPU)
+    memcpy(radii, radiiData, radiiSize * sizeof(BGFLOAT));
+#else // !USE_GPU
+    memcpy(&(*radii)[0], radiiData, radiiSize * sizeof(BGFLOAT));
+#endif // !USE_GPU
+
+    return true;
+}
+
+#if !defined(USE_GPU)
+/*
+ *  Add radii and rates to a periodic checkpoint.
+ *  The weights, areas and distances are computed from the radii at every
+ *  epoch, and are not written.
+ *
+ *  @param  writer    The checkpoint writer.
+ */
+void ConnGrowth::checkpointState(CheckpointWriter &writer) const {
+    checkpoint(writer);
+    writer.addArray(CKPT_RATES, 0, &(*rates)[0], radiiSize);
+}
+
+/*
+ *  Restore radii and rates from a periodic checkpoint.
+ *  The candidate pair list of the sparse growth is cleared, so that it is
+ *  rebuilt from the restored radii and synapses at the next update.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool ConnGrowth::restoreState(const CheckpointReader &reader) {
+    if (!restore(reader) || !reader.restoreArray(CKPT_RATES, 0, &(*rates)[0], radiiSize)) {
+        return false;
+    }
+
+    m_candBegin.clear();
+    m_candNeuron.clear();
+    m_candArea.clear();
+    m_candRadii.clear();
+    m_candChanged.clear();
+    m_candSlot.clear();
+    m_nMappedSynapses.clear();
+
+    return true;
+}
+#endif // !USE_GPU
+
 /**
  *  Prints radii 
  *  (either on CPU or GPU)
@@ -84,6 +84,9 @@
 class Barrier;
 #endif // USE_GPU
 
+class CheckpointWriter;
+class CheckpointReader;
+
 /**
  * cereal
  */
@@ -170,6 +173,39 @@ class ConnGrowth : public Connections
         template<class Archive>
         void load(Archive & archive);  
 
+        /**
+         *  Add radii to a binary checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         */
+        void checkpoint(CheckpointWriter &writer) const;
+
+        /**
+         *  Restore radii from a binary checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @return true if successful, false if the section is missing or
+         *          does not match radiiSize.
+         */
+        bool restore(const CheckpointReader &reader);
+
+#if !defined(USE_GPU)
+        /**
+         *  Add radii and rates to a periodic checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         */
+        virtual void checkpointState(CheckpointWriter &writer) const;
+
+        /**
+         *  Restore radii and rates from a periodic checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader);
+#endif // !USE_GPU
+
         /**
          *  Prints radii 
          *  (either on CPU or GPU)
@@ -238,6 +274,63 @@ class ConnGrowth : public Connections
          *  @param  layout      Layout information of the neunal network.
          */
         void updateOverlap(BGFLOAT num_neurons, Layout *layout);
+
+        /**
+         *  Rebuild the list of candidate pairs (pairs whose distance is within
+         *  the sum of their radii plus m_sparseMargin) when any radius has grown
+         *  by more than half of the margin since the last build.
+         *  Candidates are collected through the spatial index of the layout.
+         *
+         *  @param  num_neurons Number of neurons to update.
+         *  @param  layout      Layout information of the neunal network.
+         */
+        void updateCandidates(const int num_neurons, Layout *layout);
+
+        /**
+         *  Update the areas of overlap of the candidate pairs
+         *  (sparse counterpart of updateFrontiers and updateOverlap).
+         *
+         *  @param  num_neurons Number of neurons to update.
+         *  @param  layout      Layout information of the neunal network.
+         */
+        void updateSparseOverlap(const int num_neurons, Layout *layout);
+
+        /**
+         *  Associate the existing synapses of a destination neuron with its candidate pairs
+         *  (the source neuron to synapse index lookup of the neuron).
+         *  Synapses whose source is not a candidate don't overlap, so their weights are cleared.
+         *
+         *  @param  sim_info     SimulationInfo to refer from.
+         *  @param  layout       Layout information of the neunal network.
+         *  @param  synapses     Synapses of the cluster of the destination neuron.
+         *  @param  dest_neuron  Layout index of the destination neuron.
+         *  @param  iNeuron      Index of the destination neuron in the cluster.
+         */
+        void mapSynapses(const SimulationInfo *sim_info, Layout *layout, AllSynapses *synapses, int dest_neuron, int iNeuron);
+
+        /**
+         *  Update the weight of the Synapses in the simulation from the
+         *  areas of overlap of the candidate pairs.
+         *  Only the pairs whose area of overlap has changed are visited,
+         *  unless the synapses change their weights by themselves.
+         *
+         *  @param  sim_info    SimulationInfo to refer from.
+         *  @param  layout      Layout information of the neunal network.
+         *  @param  vtClr       Vector of Cluster class objects.
+         *  @param  vtClrInfo   Vector of ClusterInfo.
+         */
+        void updateSparseSynapsesWeights(const SimulationInfo *sim_info, Layout *layout, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
+
+        /**
+         *  Calculate the area of overlap of two overlapping connectivity regions.
+         *
+         *  @param  lenAB   Distance between the two neurons.
+         *  @param  lenAB2  Distance squared between the two neurons.
+         *  @param  r1      Radius of the source neuron.
+         *  @param  r2      Radius of the destination neuron.
+         *  @return the area of overlap.
+         */
+        static BGFLOAT overlapArea(BGFLOAT lenAB, BGFLOAT lenAB2, BGFLOAT r1, BGFLOAT r2);
 #endif // !USE_GPU
 
     public:
@@ -291,9 +384,36 @@ class ConnGrowth : public Connections
         //! displacement of neuron radii
         VectorMatrix *deltaR;
 
+        //! begin index of each neuron's row in the candidate pair list (num_neurons + 1 entries)
+        vector<BGSIZE> m_candBegin;
+
+        //! candidate source neurons of each destination neuron (sorted ascending in each row)
+        vector<int> m_candNeuron;
+
+        //! areas of overlap of the candidate pairs
+        vector<BGFLOAT> m_candArea;
+
+        //! neuron radii when the candidate pair list was built
+        vector<BGFLOAT> m_candRadii;
+
+        //! true if the area of overlap of the candidate pair has changed since the last weights update
+        vector<bool> m_candChanged;
+
+        //! synapse index of each candidate pair (source neuron to synapse index lookup)
+        vector<BGSIZE> m_candSlot;
+
+        //! number of synapses of each destination neuron known to the lookup
+        vector<BGSIZE> m_nMappedSynapses;
+
 #endif // !USE_GPU
 
 private:
+        //! true if the sparse, radius-bounded growth engine is used (CPU only)
+        bool m_sparseGrowth;
+
+        //! safety margin added to the sum of radii when collecting candidate pairs
+        BGFLOAT m_sparseMargin;
+
 #if defined(USE_GPU)
         //! Barrier Synchnonize object for updateConnections
         static Barrier *m_barrierUpdateConnections;
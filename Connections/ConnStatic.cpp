@@ -2,6 +2,7 @@
 #include "ParseParamError.h"
 #include "IAllSynapses.h"
 #include "XmlRecorder.h"
+#include "BinaryRecorder.h"
 #ifdef USE_HDF5
 #include "Hdf5Recorder.h"
 #endif
@@ -34,32 +35,22 @@ ConnStatic::~ConnStatic()
 void ConnStatic::setupConnections(const SimulationInfo *sim_info, Layout *layout, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
 {
     int num_neurons = sim_info->totalNeurons;
-    vector<DistDestNeuron> distDestNeurons[num_neurons];
+    vector<DistDestNeuron> distDestNeurons;
+    vector<int> srcNeurons;
 
     int added = 0;
 
     DEBUG(cout << "Initializing connections" << endl;)
 
-    for (int dest_neuron = 0; dest_neuron < num_neurons; dest_neuron++) {
-        distDestNeurons[dest_neuron].clear(); 
-        // pick the connections shorter than threshConnsRadius
-        for (int src_neuron = 0; src_neuron < num_neurons; src_neuron++) {
-            if (src_neuron != dest_neuron) {
-                BGFLOAT dist = (*layout->dist)(src_neuron, dest_neuron);
-                if (dist <= m_threshConnsRadius) {
-                    DistDestNeuron distDestNeuron;
-                    distDestNeuron.dist = dist;
-                    distDestNeuron.src_neuron = src_neuron;
-                    distDestNeurons[dest_neuron].push_back(distDestNeuron);
-                }
-            }
-        }
+    // the neurons are connected in their original order, so that the network
+    // (and the weights drawn) do not depend on the partition of the neurons
+    for (int iOriginal = 0; iOriginal < num_neurons; iOriginal++) {
+        int dest_neuron = layout->getLayoutIndex(iOriginal);
+        findSourceNeurons(layout, dest_neuron, srcNeurons, distDestNeurons);
 
-        // sort ascendant
-        sort(distDestNeurons[dest_neuron].begin(), distDestNeurons[dest_neuron].end());
         // pick the shortest m_nConnsPerNeuron connections
-        for (BGSIZE i = 0; i < distDestNeurons[dest_neuron].size() && (int)i < m_nConnsPerNeuron; i++) {
-            int src_neuron = distDestNeurons[dest_neuron][i].src_neuron;
+        for (BGSIZE i = 0; i < distDestNeurons.size() && (int)i < m_nConnsPerNeuron; i++) {
+            int src_neuron = distDestNeurons[i].src_neuron;
             // get the cluster index where the destination neuron exits
             CLUSTER_INDEX_TYPE iCluster = SynapseIndexMap::getClusterIdxFromNeuronLayoutIdx(dest_neuron, vtClrInfo);
             int iNeuron = dest_neuron - vtClrInfo[iCluster]->clusterNeuronsBegin;
@@ -73,7 +64,7 @@ void ConnStatic::setupConnections(const SimulationInfo *sim_info, Layout *layout
 
             // create a synapse at the cluster of the destination neuron
 
-            DEBUG_MID (cout << "source: " << src_neuron << " dest: " << dest_neuron << " dist: " << distDestNeurons[src_neuron][i].dist << endl;)
+            DEBUG_MID (cout << "source: " << src_neuron << " dest: " << dest_neuron << " dist: " << distDestNeurons[i].dist << endl;)
 
             BGFLOAT* sum_point = &( pNeuronsProps->summation_map[iNeuron] );
             BGSIZE iSyn;
@@ -100,6 +91,60 @@ void ConnStatic::setupConnections(const SimulationInfo *sim_info, Layout *layout
     // Create synapse index maps
     SynapseIndexMap::createSynapseImap(sim_info, vtClr, vtClrInfo);
 }
+
+/*
+ *  Estimate the incoming connections of every neuron before they are set up:
+ *  the shortest m_nConnsPerNeuron connections within threshConnsRadius,
+ *  as setupConnections() picks them.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  layout      Layout information of the neunal network.
+ *  @param  sources     Layout indices of the source neurons of each neuron (output).
+ */
+void ConnStatic::estimateConnections(const SimulationInfo *sim_info, const Layout *layout, vector<vector<int> > &sources) const
+{
+    vector<DistDestNeuron> distDestNeurons;
+    vector<int> srcNeurons;
+
+    sources.resize(sim_info->totalNeurons);
+    for (int dest_neuron = 0; dest_neuron < sim_info->totalNeurons; dest_neuron++) {
+        findSourceNeurons(layout, dest_neuron, srcNeurons, distDestNeurons);
+
+        sources[dest_neuron].clear();
+        for (BGSIZE i = 0; i < distDestNeurons.size() && (int)i < m_nConnsPerNeuron; i++) {
+            sources[dest_neuron].push_back(distDestNeurons[i].src_neuron);
+        }
+    }
+}
+
+/*
+ *  Find the connections of a neuron shorter than threshConnsRadius, sorted by distance.
+ *  The sources are visited in their original order, so that the connections picked
+ *  among the ones of the same length do not depend on the partition of the neurons.
+ *
+ *  @param  layout           Layout information of the neunal network.
+ *  @param  dest_neuron      Layout index of the destination neuron.
+ *  @param  srcNeurons       Scratch vector for the neighbors of the neuron.
+ *  @param  distDestNeurons  Connections of the neuron, by ascending length (output).
+ */
+void ConnStatic::findSourceNeurons(const Layout *layout, int dest_neuron, vector<int> &srcNeurons, vector<DistDestNeuron> &distDestNeurons) const
+{
+    distDestNeurons.clear(); 
+    // pick the connections shorter than threshConnsRadius
+    layout->getNeighborsInRange(dest_neuron, m_threshConnsRadius, srcNeurons);
+    if (layout->getOriginalIndices() != NULL) {
+        layout->sortByOriginalIndex(srcNeurons);
+    }
+    for (BGSIZE i = 0; i < srcNeurons.size(); i++) {
+        DistDestNeuron distDestNeuron;
+        distDestNeuron.dist = layout->dist(srcNeurons[i], dest_neuron);
+        distDestNeuron.src_neuron = srcNeurons[i];
+        distDestNeurons.push_back(distDestNeuron);
+    }
+
+    // sort ascendant
+    sort(distDestNeurons.begin(), distDestNeurons.end());
+}
 #endif // !USE_GPU
 
 /*
@@ -248,6 +293,9 @@ IRecorder* ConnStatic::createRecorder(const SimulationInfo *simInfo)
     if (simInfo->stateOutputFileName.find(".xml") != string::npos) {
         simRecorder = new XmlRecorder(simInfo);
     }
+    else if (simInfo->stateOutputFileName.find(".bgspk") != string::npos) {
+        simRecorder = new BinaryRecorder(simInfo);
+    }
 #ifdef USE_HDF5
     else if (simInfo->stateOutputFileName.find(".h5") != string::npos) {
         simRecorder = new Hdf5Recorder(simInfo);
@@ -81,6 +81,18 @@ class ConnStatic : public Connections
         void setupConnectionsThread(const SimulationInfo *sim_info, Layout *layout, Cluster * clr, ClusterInfo * clr_info);
 #endif // USE_GPU
 
+#if !defined(USE_GPU)
+        /**
+         *  Estimate the incoming connections of every neuron before they are set up:
+         *  the shortest m_nConnsPerNeuron connections within threshConnsRadius.
+         *
+         *  @param  sim_info    SimulationInfo class to read information from.
+         *  @param  layout      Layout information of the neunal network.
+         *  @param  sources     Layout indices of the source neurons of each neuron (output).
+         */
+        virtual void estimateConnections(const SimulationInfo *sim_info, const Layout *layout, vector<vector<int> > &sources) const;
+#endif // !USE_GPU
+
         /**
          *  Cleanup the class.
          */
@@ -153,6 +165,19 @@ public:
                 return (dist < other.dist);
             }
         };
+
+#if !defined(USE_GPU)
+private:
+        /**
+         *  Find the connections of a neuron shorter than threshConnsRadius, sorted by distance.
+         *
+         *  @param  layout           Layout information of the neunal network.
+         *  @param  dest_neuron      Layout index of the destination neuron.
+         *  @param  srcNeurons       Scratch vector for the neighbors of the neuron.
+         *  @param  distDestNeurons  Connections of the neuron, by ascending length (output).
+         */
+        void findSourceNeurons(const Layout *layout, int dest_neuron, vector<int> &srcNeurons, vector<DistDestNeuron> &distDestNeurons) const;
+#endif // !USE_GPU
 };
 
 #if defined(USE_GPU) && defined(__CUDACC__)
@@ -47,6 +47,23 @@ Connections::~Connections()
 {
 }
 
+/*
+ *  Estimate the incoming connections of every neuron before they are set up,
+ *  to partition the neurons among the clusters: each neuron is connected
+ *  from its nearest neighbors.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  layout      Layout information of the neunal network.
+ *  @param  sources     Layout indices of the source neurons of each neuron (output).
+ */
+void Connections::estimateConnections(const SimulationInfo *sim_info, const Layout *layout, vector<vector<int> > &sources) const
+{
+    sources.resize(sim_info->totalNeurons);
+    for (int i = 0; i < sim_info->totalNeurons; i++) {
+        layout->getNearestNeighbors(i, ESTIMATED_CONNS_PER_NEURON, sources[i]);
+    }
+}
+
 /*
  *  Creates synapses from synapse weights saved in the serialization file.
  *
@@ -47,8 +47,13 @@
 
 using namespace std;
 
+//! Number of nearest neighbors that a neuron is estimated to be connected from by default.
+#define ESTIMATED_CONNS_PER_NEURON 8
+
 class IModel;
 class Cluster;
+class CheckpointWriter;
+class CheckpointReader;
 
 class Connections
 {
@@ -115,6 +120,39 @@ class Connections
          */
         virtual IRecorder* createRecorder(const SimulationInfo *sim_info) = 0;
 
+#if !defined(USE_GPU)
+        /**
+         *  Add the state of the connections that changes during the simulation
+         *  to a periodic checkpoint.
+         *  By default, this method does nothing (the connections are static).
+         *
+         *  @param  writer    The checkpoint writer.
+         */
+        virtual void checkpointState(CheckpointWriter &writer) const {}
+
+        /**
+         *  Restore the state of the connections that changes during the simulation
+         *  from a periodic checkpoint.
+         *  By default, this method does nothing (the connections are static).
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader) { return true; }
+#endif // !USE_GPU
+
+        /**
+         *  Estimate the incoming connections of every neuron before they are set up,
+         *  to partition the neurons among the clusters (see Partitioner).
+         *  By default, each neuron is connected from its ESTIMATED_CONNS_PER_NEURON
+         *  nearest neighbors. Override in a subclass that knows its connections.
+         *
+         *  @param  sim_info    SimulationInfo class to read information from.
+         *  @param  layout      Layout information of the neunal network.
+         *  @param  sources     Layout indices of the source neurons of each neuron (output).
+         */
+        virtual void estimateConnections(const SimulationInfo *sim_info, const Layout *layout, vector<vector<int> > &sources) const;
+
         /**
          *  Creates synapses from synapse weights saved in the serialization file.
          * 
@@ -0,0 +1,71 @@
+#include "AxonalSpikeRings.h"
+#include "Checkpoint.h"
+
+AxonalSpikeRings::AxonalSpikeRings() :
+    m_rings(NULL),
+    m_totalNeurons(0),
+    m_minSynapticTransDelay(0)
+{
+}
+
+AxonalSpikeRings::~AxonalSpikeRings()
+{
+    if (m_rings != NULL) {
+        delete[] m_rings;
+    }
+}
+
+/*
+ * Initializes the rings (they are allocated by enableSpikeRings()).
+ *
+ * @param totalNeurons           Total number of neurons in the network.
+ * @param minSynapticTransDelay  Length of the synaptic transmission delay window in steps.
+ */
+void AxonalSpikeRings::initSpikeRings(int totalNeurons, int minSynapticTransDelay)
+{
+    assert( minSynapticTransDelay < LENGTH_OF_SPIKE_RING );
+
+    m_totalNeurons = totalNeurons;
+    m_minSynapticTransDelay = minSynapticTransDelay;
+}
+
+/*
+ * Allocate the rings, when the synapses of a cluster use the ring spike delivery.
+ * The synapses of every cluster call it, so it only allocates them once.
+ */
+void AxonalSpikeRings::enableSpikeRings()
+{
+    if (m_rings != NULL) {
+        return;
+    }
+
+    m_rings = new uint64_t[m_totalNeurons];
+    fill_n(m_rings, m_totalNeurons, 0);
+}
+
+/*
+ * Add the rings of the neurons of a cluster to a checkpoint.
+ *
+ * @param writer        The checkpoint writer.
+ * @param cluster       Index of the cluster of the section.
+ * @param iNeuronBegin  Layout index of the first neuron of the cluster.
+ * @param nNeurons      Number of neurons of the cluster.
+ */
+void AxonalSpikeRings::checkpoint(CheckpointWriter &writer, uint32_t cluster, int iNeuronBegin, int nNeurons) const
+{
+    writer.addArray(CKPT_SPIKE_RINGS, cluster, m_rings + iNeuronBegin, nNeurons);
+}
+
+/*
+ * Restore the rings of the neurons of a cluster from a checkpoint.
+ *
+ * @param reader        The checkpoint reader.
+ * @param cluster       Index of the cluster of the section.
+ * @param iNeuronBegin  Layout index of the first neuron of the cluster.
+ * @param nNeurons      Number of neurons of the cluster.
+ * @return true if successful, false if the section is missing or does not match the rings.
+ */
+bool AxonalSpikeRings::restore(const CheckpointReader &reader, uint32_t cluster, int iNeuronBegin, int nNeurons)
+{
+    return reader.restoreArray(CKPT_SPIKE_RINGS, cluster, m_rings + iNeuronBegin, nNeurons);
+}
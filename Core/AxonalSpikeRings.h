@@ -0,0 +1,132 @@
+/**
+ *	@file AxonalSpikeRings.h
+ *
+ *	@brief The recent spikes of every neuron, for the ring spike delivery.
+ */
+
+/**
+ **
+ ** @class AxonalSpikeRings AxonalSpikeRings.h "AxonalSpikeRings.h"
+ **
+ ** \latexonly  \subsubsection*{Implementation} \endlatexonly
+ ** \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ **
+ ** With the queue spike delivery, a neuron that fires adds an event to the
+ ** spike queue of each of its outgoing synapses (EventQueue::addAnEvent(),
+ ** an atomic compare and swap per synapse). With the ring spike delivery
+ ** (spikeDelivery ring), the neuron records the spike once, in its own ring,
+ ** and a synapse checks the ring of its source neuron at the step of its
+ ** current step minus its delay (AllSpikingSynapses::isSpikeQueue()).
+ **
+ ** The ring of a neuron is a bitmask of LENGTH_OF_SPIKE_RING steps, with a
+ ** bit per step. It is shared by the clusters and indexed by the layout index
+ ** of the neuron. Only the cluster of the neuron writes it: every step,
+ ** the bit of the step is set if the neuron has fired and cleared otherwise
+ ** (which drops the spike of LENGTH_OF_SPIKE_RING steps before). The other
+ ** clusters read the steps before the current synaptic transmission delay
+ ** window, which were written before the last synchronization of the
+ ** clusters, so the delays are limited to LENGTH_OF_SPIKE_RING steps minus
+ ** the length of the window (getMaxDelay()).
+ **/
+
+#pragma once
+
+#include "Global.h"
+
+class CheckpointWriter;
+class CheckpointReader;
+
+//! The number of steps of the ring of a neuron.
+#define LENGTH_OF_SPIKE_RING 64
+
+class AxonalSpikeRings
+{
+    public:
+        //! The constructor for AxonalSpikeRings.
+        AxonalSpikeRings();
+
+        //! The destructor for AxonalSpikeRings.
+        virtual ~AxonalSpikeRings();
+
+        /**
+         * Initializes the rings (they are allocated by enableSpikeRings()).
+         *
+         * @param totalNeurons           Total number of neurons in the network.
+         * @param minSynapticTransDelay  Length of the synaptic transmission delay window in steps.
+         */
+        void initSpikeRings(int totalNeurons, int minSynapticTransDelay);
+
+        /**
+         * Allocate the rings, when the synapses of a cluster use the ring spike delivery.
+         */
+        void enableSpikeRings();
+
+        /**
+         * Get the longest synaptic transmission delay that the rings can deliver.
+         *
+         * @return the delay in steps.
+         */
+        int getMaxDelay() const { return LENGTH_OF_SPIKE_RING - m_minSynapticTransDelay; }
+
+        /**
+         * Record whether a neuron has fired at a step (by the cluster of the neuron).
+         *
+         * @param iNeuron         Layout index of the neuron.
+         * @param simulationStep  The simulation step.
+         * @param fired           True if the neuron has fired.
+         */
+        void recordStep(int iNeuron, uint64_t simulationStep, bool fired)
+        {
+            uint64_t bit = uint64_t(0x1) << (simulationStep & (LENGTH_OF_SPIKE_RING - 1));
+            uint64_t ring = __atomic_load_n(&m_rings[iNeuron], __ATOMIC_RELAXED);
+            ring = fired ? (ring | bit) : (ring & ~bit);
+
+            // the neuron has a single writer, so the ring needs no atomic update:
+            // the store only keeps the readers of the other clusters from seeing a torn value
+            __atomic_store_n(&m_rings[iNeuron], ring, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * Checks if a neuron has fired at a step.
+         *
+         * @param iNeuron         Layout index of the neuron.
+         * @param simulationStep  The simulation step (within getMaxDelay() steps before the current window).
+         * @return true if the neuron has fired.
+         */
+        bool hasFired(int iNeuron, uint64_t simulationStep) const
+        {
+            uint64_t bit = uint64_t(0x1) << (simulationStep & (LENGTH_OF_SPIKE_RING - 1));
+            return (__atomic_load_n(&m_rings[iNeuron], __ATOMIC_RELAXED) & bit) != 0;
+        }
+
+        /**
+         * Add the rings of the neurons of a cluster to a checkpoint.
+         *
+         * @param writer        The checkpoint writer.
+         * @param cluster       Index of the cluster of the section.
+         * @param iNeuronBegin  Layout index of the first neuron of the cluster.
+         * @param nNeurons      Number of neurons of the cluster.
+         */
+        void checkpoint(CheckpointWriter &writer, uint32_t cluster, int iNeuronBegin, int nNeurons) const;
+
+        /**
+         * Restore the rings of the neurons of a cluster from a checkpoint.
+         *
+         * @param reader        The checkpoint reader.
+         * @param cluster       Index of the cluster of the section.
+         * @param iNeuronBegin  Layout index of the first neuron of the cluster.
+         * @param nNeurons      Number of neurons of the cluster.
+         * @return true if successful, false if the section is missing or does not match the rings.
+         */
+        bool restore(const CheckpointReader &reader, uint32_t cluster, int iNeuronBegin, int nNeurons);
+
+    private:
+        //! The ring of each neuron (NULL until enableSpikeRings()).
+        uint64_t* m_rings;
+
+        //! Total number of neurons in the network.
+        int m_totalNeurons;
+
+        //! Length of the synaptic transmission delay window in steps.
+        int m_minSynapticTransDelay;
+};
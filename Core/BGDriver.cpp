@@ -9,6 +9,7 @@
  */
 
 #include <fstream>
+#include <cstring>
 #include "Global.h"
 #include "ParamContainer.h"
 
@@ -23,6 +24,7 @@
 #include <cereal/archives/xml.hpp>
 #include <cereal/archives/binary.hpp>
 #include "ConnGrowth.h"
+#include "Checkpoint.h"
 
 // Uncomment to use visual leak detector (Visual Studios Plugin)
 // #include <vld.h>
@@ -31,6 +33,7 @@
     #include "GPUSpikingCluster.h"
 #else 
     #include "SingleThreadedCluster.h"
+    #include "ThreadedCluster.h"
 #endif
 
 using namespace std;
@@ -41,7 +44,7 @@ void printParams(SimulationInfo *simInfo);
 bool parseCommandLine(int argc, char* argv[], SimulationInfo *simInfo);
 bool createAllModelClassInstances(TiXmlDocument* simDoc, SimulationInfo *simInfo, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
 void printKeyStateInfo(SimulationInfo *simInfo, vector<Cluster *> &vtClr);
-void serializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vector<Cluster *> &vtClr);
+bool serializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vector<Cluster *> &vtClr);
 bool deserializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
 
 /*
@@ -95,8 +98,24 @@ int main(int argc, char* argv[]) {
     DEBUG(cerr << "Setup simulation." << endl;)
     simulator->setup(simInfo);
 
+#if !defined(USE_GPU)
+    // Resumes a killed run from its last periodic checkpoint
+    bool resumed = false;
+    if (!simInfo->checkpointFileName.empty() && ifstream(simInfo->checkpointFileName.c_str()).good()) {
+        cout << "Resuming the simulation from the checkpoint " << simInfo->checkpointFileName << endl;
+        if (!simulator->restore(simInfo)) {
+            cerr << "! ERROR: failed while resuming from the checkpoint" << endl;
+            return -1;
+        }
+        cout << "Resumed after epoch " << simInfo->currentStep << endl;
+        resumed = true;
+    }
+#else
+    bool resumed = false;
+#endif // !USE_GPU
+
     // Deserializes internal state from a prior run of the simulation
-    if (!simInfo->memInputFileName.empty()) {
+    if (!simInfo->memInputFileName.empty() && !resumed) {
 
         DEBUG(cerr << "Deserializing state from file." << endl;)
       
@@ -137,7 +156,10 @@ int main(int argc, char* argv[]) {
     if (!simInfo->memOutputFileName.empty()) {
         
         // Serialization
-        serializeSynapseInfo(simInfo, simulator, vtClr);
+        if (!serializeSynapseInfo(simInfo, simulator, vtClr)) {
+            cerr << "! ERROR: failed while serializing objects" << endl;
+            return -1;
+        }
 
         DEBUG(
         // Prints out internal state information after serialization
@@ -269,7 +291,13 @@ bool createAllModelClassInstances(TiXmlDocument* simDoc, SimulationInfo *simInfo
 #if defined(USE_GPU)
             cluster = new GPUSpikingCluster(neurons, synapses);
 #else
-            cluster = new SingleThreadedCluster(neurons, synapses);
+            // with -x yes, a single threaded cluster is specialized for the neurons and synapses classes if it can be
+            if (simInfo->numClusterThreads > 1) {
+                cluster = new ThreadedCluster(neurons, synapses);
+            } else if (!simInfo->specializedClusters
+                    || (cluster = FClassOfCategory::get()->createCluster(neurons, synapses)) == NULL) {
+                cluster = new SingleThreadedCluster(neurons, synapses);
+            }
 #endif
         } else {
             // create a new neurons class object and copy properties from the reference neurons class object
@@ -282,7 +310,12 @@ bool createAllModelClassInstances(TiXmlDocument* simDoc, SimulationInfo *simInfo
 #if defined(USE_GPU)
             cluster = new GPUSpikingCluster(neurons_1, synapses_1);
 #else
-            cluster = new SingleThreadedCluster(neurons_1, synapses_1);
+            if (simInfo->numClusterThreads > 1) {
+                cluster = new ThreadedCluster(neurons_1, synapses_1);
+            } else if (!simInfo->specializedClusters
+                    || (cluster = FClassOfCategory::get()->createCluster(neurons_1, synapses_1)) == NULL) {
+                cluster = new SingleThreadedCluster(neurons_1, synapses_1);
+            }
 #endif
         }
 
@@ -333,6 +366,23 @@ bool LoadAllParameters(SimulationInfo *simInfo, vector<Cluster *> &vtClr, vector
         return -1;
     }
 
+#if !defined(USE_GPU)
+    // only the binary recorder (.bgspk) writes the histories on a background thread
+    if (simInfo->asyncRecorder && simInfo->stateOutputFileName.find(".bgspk") == string::npos) {
+        cerr << "! ERROR: the asynchronous recorder (-a yes) needs a .bgspk state output file, not "
+             << simInfo->stateOutputFileName << endl;
+        return false;
+    }
+
+    // only the XML and binary recorders restore their histories from a periodic checkpoint
+    if (!simInfo->checkpointFileName.empty() && simInfo->stateOutputFileName.find(".xml") == string::npos
+            && simInfo->stateOutputFileName.find(".bgspk") == string::npos) {
+        cerr << "! ERROR: periodic checkpoints (-k) need a .xml or .bgspk state output file, the recorder of "
+             << simInfo->stateOutputFileName << " cannot resume from them" << endl;
+        return false;
+    }
+#endif // !USE_GPU
+
     /*    verify that params were read correctly */
     DEBUG(printParams(simInfo);)
 
@@ -382,9 +432,16 @@ bool parseCommandLine(int argc, char* argv[], SimulationInfo *simInfo)
     if ((cl.addParam("stateoutfile", 'o', ParamContainer::filename, "simulation state output filename") != ParamContainer::errOk)
             || (cl.addParam("stateinfile", 't', ParamContainer::filename | ParamContainer::required, "simulation parameter filename") != ParamContainer::errOk)
             || (cl.addParam("numclusters", 'c', ParamContainer::regular, "number of clusters") != ParamContainer::errOk)
+            || (cl.addParam("barrier", 'b', ParamContainer::regular, "cluster threads barrier: mutex (default) or spin") != ParamContainer::errOk)
+            || (cl.addParam("pinthreads", 'p', ParamContainer::regular, "pin cluster threads: no (default), core (or yes) or node") != ParamContainer::errOk)
+            || (cl.addParam("numthreads", 'n', ParamContainer::regular, "number of threads per cluster") != ParamContainer::errOk)
             || (cl.addParam( "stiminfile", 's', ParamContainer::filename, "stimulus input file" ) != ParamContainer::errOk)
             || (cl.addParam("meminfile", 'r', ParamContainer::filename, "simulation memory image filename") != ParamContainer::errOk)
-            || (cl.addParam("memoutfile", 'w', ParamContainer::filename, "simulation memory image output filename") != ParamContainer::errOk)) {
+            || (cl.addParam("memoutfile", 'w', ParamContainer::filename, "simulation memory image output filename") != ParamContainer::errOk)
+            || (cl.addParam("checkpointfile", 'k', ParamContainer::filename, "periodic checkpoint filename (resumes from it if it exists)") != ParamContainer::errOk)
+            || (cl.addParam("checkpointinterval", 'e', ParamContainer::regular, "number of epochs between periodic checkpoints (default 1)") != ParamContainer::errOk)
+            || (cl.addParam("asyncrecorder", 'a', ParamContainer::regular, "write the spike stream (.bgspk) on a background thread: yes or no (default)") != ParamContainer::errOk)
+            || (cl.addParam("specialized", 'x', ParamContainer::regular, "specialize the single threaded clusters for the neurons and synapses classes: yes or no (default)") != ParamContainer::errOk)) {
         cerr << "Internal error creating command line parser" << endl;
         return false;
     }
@@ -410,6 +467,73 @@ bool parseCommandLine(int argc, char* argv[], SimulationInfo *simInfo)
 
     simInfo->numClusters = g_numClusters;
 
+#if !defined(USE_GPU)
+    // Barrier and affinity of the cluster threads
+    if (cl["barrier"].empty() || cl["barrier"] == "mutex") {
+        simInfo->spinBarrier = false;
+    } else if (cl["barrier"] == "spin") {
+        simInfo->spinBarrier = true;
+    } else {
+        cerr << "Invalid barrier type: " << cl["barrier"] << " (must be mutex or spin)" << endl;
+        return false;
+    }
+
+    if (cl["pinthreads"].empty() || cl["pinthreads"] == "no") {
+        simInfo->pinThreads = NO_PINNING;
+    } else if (cl["pinthreads"] == "core" || cl["pinthreads"] == "yes") {
+        simInfo->pinThreads = CORE_PINNING;
+    } else if (cl["pinthreads"] == "node") {
+        simInfo->pinThreads = NODE_PINNING;
+    } else {
+        cerr << "Invalid pinthreads value: " << cl["pinthreads"] << " (must be no, core, yes or node)" << endl;
+        return false;
+    }
+
+    // Number of threads per cluster
+    if (EOF == sscanf(cl["numthreads"].c_str(), "%d", &simInfo->numClusterThreads)) {
+        simInfo->numClusterThreads = 1;
+    }
+    if (simInfo->numClusterThreads < 1) {
+        cerr << "Invalid number of threads per cluster: " << cl["numthreads"] << endl;
+        return false;
+    }
+
+    // Periodic checkpoint
+    simInfo->checkpointFileName = cl["checkpointfile"];
+    if (!simInfo->checkpointFileName.empty()) {
+        if (EOF == sscanf(cl["checkpointinterval"].c_str(), "%d", &simInfo->checkpointInterval)) {
+            simInfo->checkpointInterval = 1;
+        }
+        if (simInfo->checkpointInterval < 1) {
+            cerr << "Invalid number of epochs between checkpoints: " << cl["checkpointinterval"] << endl;
+            return false;
+        }
+    } else if (!cl["checkpointinterval"].empty()) {
+        cerr << "The number of epochs between checkpoints needs a checkpoint file (-k)" << endl;
+        return false;
+    }
+
+    // Recorder thread
+    if (cl["asyncrecorder"].empty() || cl["asyncrecorder"] == "no") {
+        simInfo->asyncRecorder = false;
+    } else if (cl["asyncrecorder"] == "yes") {
+        simInfo->asyncRecorder = true;
+    } else {
+        cerr << "Invalid asyncrecorder value: " << cl["asyncrecorder"] << " (must be yes or no)" << endl;
+        return false;
+    }
+
+    // Specialized clusters
+    if (cl["specialized"].empty() || cl["specialized"] == "no") {
+        simInfo->specializedClusters = false;
+    } else if (cl["specialized"] == "yes") {
+        simInfo->specializedClusters = true;
+    } else {
+        cerr << "Invalid specialized value: " << cl["specialized"] << " (must be yes or no)" << endl;
+        return false;
+    }
+#endif  // !USE_GPU
+
 #if defined(USE_GPU)
     if (EOF == sscanf(cl["deviceid"].c_str(), "%d", &g_deviceId)) {
         g_deviceId = 0;
@@ -453,34 +577,80 @@ void printKeyStateInfo(SimulationInfo *simInfo, vector<Cluster *> &vtClr)
  *  Serializes synapse weights, source neurons, destination neurons, 
  *  maxSynapsesPerNeuron, totalClusterNeurons, and 
  *  if running a connGrowth model, serializes radii as well 
+ *  The state is indexed by layout index, so the original index of each
+ *  neuron is saved with it (see Layout::renumberNeurons()).
+ *
+ *  The state is written to a binary checkpoint file (see Checkpoint.h),
+ *  unless the file name ends with ".xml", in which case it is written
+ *  to a cereal XML archive.
  *
  *  @param  simInfo   SimulationInfo class to read information from.
  *  @param  simulator Simulator class to perform actions.
  *  @param  cluster   Cluster class object to be created.
+ *  @returns    true if successful, false otherwise.
  */
-void serializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vector<Cluster *> &vtClr)
+bool serializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vector<Cluster *> &vtClr)
 {
-    // We can serialize to a variety of archive file formats. Below, comment out
-    // all but the two lines that correspond to the desired format.
-    ofstream memory_out (simInfo->memOutputFileName.c_str());
-    cereal::XMLOutputArchive archive(memory_out);
-    //ofstream memory_out (simInfo->memOutputFileName.c_str(), std::ios::binary);
-    //cereal::BinaryOutputArchive archive(memory_out);
-
 #if defined(USE_GPU)        
     // Copies GPU Synapse props data to CPU for serialization
     simulator->copyGPUSynapseToCPU(simInfo);
 #endif // USE_GPU
 
-    // Serializes synapse weights along with each synapse's source neuron and destination neuron
-    for(int i = 0; i < vtClr.size(); i++) {
-        archive(*vtClr[i]);
+    ConnGrowth *connGrowth = dynamic_cast<ConnGrowth *>(dynamic_cast<Model *>(simInfo->model)->m_conns);
+    Layout *layout = dynamic_cast<Model *>(simInfo->model)->m_layout;
+    const string &fileName = simInfo->memOutputFileName;
+
+    if (fileName.size() >= 4 && fileName.compare(fileName.size() - 4, 4, ".xml") == 0) {
+        ofstream memory_out (fileName.c_str());
+        if (!memory_out) {
+            cerr << "Failed creating the serialization file " << fileName << endl;
+            return false;
+        }
+
+        // the archive is flushed when it is destroyed
+        {
+            cereal::XMLOutputArchive archive(memory_out);
+
+            // Serializes the original index of each neuron first, so that it is read before the synapses
+            vector<int> originalIndex(simInfo->totalNeurons);
+            for (int i = 0; i < simInfo->totalNeurons; i++) {
+                originalIndex[i] = layout->getOriginalIndex(i);
+            }
+            archive(cereal::make_nvp("neuronOriginalIndex", originalIndex));
+
+            // Serializes synapse weights along with each synapse's source neuron and destination neuron
+            for(int i = 0; i < vtClr.size(); i++) {
+                archive(*vtClr[i]);
+            }
+            // Serializes radii (only if it is a connGrowth model)
+            if(connGrowth != nullptr) {
+                archive(*connGrowth);
+            }
+        }
+
+        memory_out.close();
+        if (!memory_out) {
+            cerr << "Failed writing the serialization file " << fileName << endl;
+            return false;
+        }
+        return true;
     }
-    // Serializes radii (only if it is a connGrowth model)
-    if(dynamic_cast<ConnGrowth *>(dynamic_cast<Model *>(simInfo->model)->m_conns) != nullptr) {
-        archive(*(dynamic_cast<ConnGrowth *>(dynamic_cast<Model *>(simInfo->model)->m_conns)));
+
+    CheckpointWriter writer;
+
+    // Adds the original index of each neuron
+    layout->checkpoint(writer, simInfo->totalNeurons);
+
+    // Adds synapse weights along with each synapse's source neuron and destination neuron
+    for(CLUSTER_INDEX_TYPE i = 0; i < vtClr.size(); i++) {
+        dynamic_cast<AllSynapses *>(vtClr[i]->m_synapses)->m_pSynapsesProps->checkpoint(writer, i);
+    }
+    // Adds radii (only if it is a connGrowth model)
+    if(connGrowth != nullptr) {
+        connGrowth->checkpoint(writer);
     }
 
+    return writer.write(fileName);
 }
 
 /*
@@ -488,6 +658,10 @@ void serializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vector<
  *  maxSynapsesPerNeuron, totalClusterNeurons, and 
  *  if running a connGrowth model and radii is in serialization file, deserializes radii as well
  *
+ *  The file may be either a binary checkpoint file (recognized by its magic)
+ *  or a cereal XML archive. It is rejected if the neurons were renumbered
+ *  differently when it was written (e.g. with another number of clusters).
+ *
  *  @param  simInfo   SimulationInfo class to read information from.
  *  @param  simulator Simulator class to perform actions.
  *  @param  cluster   Cluster class object to be created.
@@ -496,32 +670,61 @@ void serializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vector<
  */
 bool deserializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
 {
-   // We can deserialize from a variety of archive file formats. Below, comment
-   // out all but the line that is compatible with the desired format.
-    ifstream memory_in(simInfo->memInputFileName.c_str());
-    //ifstream memory_in (simInfo->memInputFileName.c_str(), std::ios::binary);
-    
-    // Checks to see if serialization file exists
-    if(!memory_in) {
-        cerr << "The serialization file doesn't exist" << endl;
-        return false;
-    }
+    ConnGrowth *connGrowth = dynamic_cast<ConnGrowth *>(dynamic_cast<Model *>(simInfo->model)->m_conns);
+    Layout *layout = dynamic_cast<Model *>(simInfo->model)->m_layout;
+    const string &fileName = simInfo->memInputFileName;
+    CheckpointReader reader;
+    ifstream memory_in;
+    cereal::XMLInputArchive *archive = NULL;
+
+    if (CheckpointReader::isCheckpoint(fileName)) {
+        if (!reader.open(fileName) || !layout->restore(reader, simInfo->totalNeurons)) {
+            return false;
+        }
 
-   // We can deserialize from a variety of archive file formats. Below, comment
-   // out all but the line that corresponds to the desired format.
-    cereal::XMLInputArchive archive(memory_in);
-    //cereal::BinaryInputArchive archive(memory_in);
+        // Restores synapse weights along with each synapse's source neuron and destination neuron
+        for(CLUSTER_INDEX_TYPE i = 0; i < vtClr.size(); i++) {
+            if (!dynamic_cast<AllSynapses *>(vtClr[i]->m_synapses)->m_pSynapsesProps->restore(reader, i)) {
+                return false;
+            }
+        }
+    } else {
+        memory_in.open(fileName.c_str());
 
-    // Deserializes synapse weights along with each synapse's source neuron and destination neuron
-    for(int i = 0; i < vtClr.size(); i++) {
-        // Uses "try catch" to catch any cereal exception
-        try {
-            archive(*vtClr[i]);
+        // Checks to see if serialization file exists
+        if(!memory_in) {
+            cerr << "The serialization file doesn't exist" << endl;
+            return false;
         }
-        catch(cereal::Exception e) {
-            cerr << "Failed deserializing synapse weights, source neurons, and/or destination neurons." << endl;
+
+        archive = new cereal::XMLInputArchive(memory_in);
+
+        // Checks the original index of each neuron (the archives written before it was saved start with the synapses)
+        vector<int> originalIndex;
+        const char *nodeName = archive->getNodeName();
+        if (nodeName != NULL && strcmp(nodeName, "neuronOriginalIndex") == 0) {
+            (*archive)(cereal::make_nvp("neuronOriginalIndex", originalIndex));
+        }
+        if ((!originalIndex.empty() && originalIndex.size() != static_cast<size_t>(simInfo->totalNeurons))
+                || !layout->hasOriginalIndices(originalIndex.empty() ? NULL : &originalIndex[0], simInfo->totalNeurons)) {
+            cerr << "The serialization file was written with another renumbering of the neurons"
+                 << " (number of clusters or partitioner)" << endl;
+            delete archive;
             return false;
         }
+
+        // Deserializes synapse weights along with each synapse's source neuron and destination neuron
+        for(int i = 0; i < vtClr.size(); i++) {
+            // Uses "try catch" to catch any cereal exception
+            try {
+                (*archive)(*vtClr[i]);
+            }
+            catch(cereal::Exception e) {
+                cerr << "Failed deserializing synapse weights, source neurons, and/or destination neurons." << endl;
+                delete archive;
+                return false;
+            }
+        }
     }
 
     // Creates synapses from weights 
@@ -537,17 +740,24 @@ bool deserializeSynapseInfo(SimulationInfo *simInfo, Simulator *simulator, vecto
     SynapseIndexMap::createSynapseImap(simInfo, vtClr, vtClrInfo);
 
     // Deserializes radii (only when running a connGrowth model and radii is in serialization file)
-    if( dynamic_cast<ConnGrowth *>(dynamic_cast<Model *>(simInfo->model)->m_conns) != nullptr) {
-        // Uses "try catch" to catch any cereal exception
-        try {
-            archive(*(dynamic_cast<ConnGrowth *>(dynamic_cast<Model *>(simInfo->model)->m_conns)));
-        }
-        catch(cereal::Exception e) {
-            cerr << "Failed deserializing radii." << endl;
-            return false;
+    if(connGrowth != nullptr) {
+        if (archive == NULL) {
+            if (!connGrowth->restore(reader)) {
+                return false;
+            }
+        } else {
+            // Uses "try catch" to catch any cereal exception
+            try {
+                (*archive)(*connGrowth);
+            }
+            catch(cereal::Exception e) {
+                cerr << "Failed deserializing radii." << endl;
+                delete archive;
+                return false;
+            }
         }
     }
 
+    delete archive;
     return true;
-    
 }
@@ -3,10 +3,27 @@
  * @note The barrier automatically resets after all threads are synced
  */
 
+#pragma once
+
 #include <mutex>
 #include <condition_variable>
 
-class Barrier
+/**
+ * @brief Interface of the CPU thread barriers
+ */
+class IBarrier
+{
+public:
+    virtual ~IBarrier() { }
+
+    /// Blocks until all N threads reach here
+    virtual void Sync() = 0;
+};
+
+/**
+ * @brief A CPU thread barrier that blocks the threads on a condition variable
+ */
+class Barrier : public IBarrier
 {
 private:
     std::mutex m_mutex;
@@ -52,4 +69,4 @@ public:
             }
         }
     }
-};  
+};
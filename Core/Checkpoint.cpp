@@ -0,0 +1,433 @@
+#include "Checkpoint.h"
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//! The magic of the checkpoint files.
+static const char checkpointMagic[8] = { 'B', 'G', 'C', 'K', 'P', 'T', 0, 0 };
+
+/*
+ *  64 bits FNV-1a hash of a buffer.
+ *
+ *  @param  data    The buffer.
+ *  @param  size    Size of the buffer in bytes.
+ *  @param  hash    Hash of the preceding data.
+ *  @return the hash.
+ */
+uint64_t checkpointChecksum(const void *data, size_t size, uint64_t hash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+/*
+ *  Write a buffer to a file descriptor, retrying the partial writes.
+ *
+ *  @param  fd      The file descriptor.
+ *  @param  data    The buffer.
+ *  @param  size    Size of the buffer in bytes.
+ *  @return true if successful, false otherwise.
+ */
+static bool writeAll(int fd, const void *data, size_t size)
+{
+    const char *p = static_cast<const char *>(data);
+
+    while (size > 0) {
+        ssize_t n = ::write(fd, p, size);
+        if (n < 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+CheckpointWriter::CheckpointWriter()
+{
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    for (size_t i = 0; i < m_buffers.size(); i++) {
+        delete[] m_buffers[i];
+    }
+}
+
+/*
+ *  Add a section to write. The array must stay valid until write() is called.
+ *
+ *  @param  type          Type of the section.
+ *  @param  cluster       Index of the cluster of the section.
+ *  @param  data          The array.
+ *  @param  elementSize   Size of an element in bytes.
+ *  @param  rows          Number of rows of the array.
+ *  @param  columns       Number of columns of the array.
+ */
+void CheckpointWriter::addSection(checkpointSectionType type, uint32_t cluster, const void *data, uint32_t elementSize, uint64_t rows, uint64_t columns)
+{
+    CheckpointSection section;
+
+    memset(&section, 0, sizeof(section));
+    section.type = type;
+    section.cluster = cluster;
+    section.elementSize = elementSize;
+    section.rows = rows;
+    section.columns = columns;
+
+    m_sections.push_back(section);
+    m_data.push_back(data);
+    m_fileRows.push_back(pair<string, vector<uint64_t> >());
+}
+
+/*
+ *  Add a section whose array is allocated by the writer (for values that
+ *  are not stored in an array of the simulation). The array is freed
+ *  when the writer is destroyed.
+ *
+ *  @param  type          Type of the section.
+ *  @param  cluster       Index of the cluster of the section.
+ *  @param  elementSize   Size of an element in bytes.
+ *  @param  rows          Number of rows of the array.
+ *  @param  columns       Number of columns of the array.
+ *  @return pointer to the array to fill.
+ */
+void *CheckpointWriter::allocSection(checkpointSectionType type, uint32_t cluster, uint32_t elementSize, uint64_t rows, uint64_t columns)
+{
+    char *buffer = new char[elementSize * rows * columns];
+
+    memset(buffer, 0, elementSize * rows * columns);
+    m_buffers.push_back(buffer);
+    addSection(type, cluster, buffer, elementSize, rows, columns);
+
+    return buffer;
+}
+
+/*
+ *  Add a section whose rows are copied from a file when the checkpoint
+ *  is written (for arrays that are kept in a file rather than in memory).
+ *
+ *  @param  type          Type of the section.
+ *  @param  cluster       Index of the cluster of the section.
+ *  @param  fileName      Name of the file.
+ *  @param  rowOffsets    Offset of each row in the file (CHECKPOINT_NO_ROW for a row of zeros).
+ *  @param  elementSize   Size of an element in bytes.
+ *  @param  columns       Number of columns of the array.
+ */
+void CheckpointWriter::addFileSection(checkpointSectionType type, uint32_t cluster, const string &fileName, const vector<uint64_t> &rowOffsets, uint32_t elementSize, uint64_t columns)
+{
+    addSection(type, cluster, NULL, elementSize, rowOffsets.size(), columns);
+    m_fileRows.back().first = fileName;
+    m_fileRows.back().second = rowOffsets;
+}
+
+/*
+ *  Write the checkpoint file.
+ *  The file is written under a temporary name and renamed when complete, so
+ *  an interrupted write never leaves a truncated checkpoint behind.
+ *  The data of the sections is written first, and the header and the section
+ *  table with the checksums of the data last, so that the sections copied
+ *  from a file are read only once.
+ *
+ *  @param  fileName   Name of the file.
+ *  @return true if successful, false otherwise.
+ */
+bool CheckpointWriter::write(const string &fileName)
+{
+    // lay out the sections
+    uint64_t tableEnd = sizeof(CheckpointHeader) + m_sections.size() * sizeof(CheckpointSection);
+    uint64_t offset = tableEnd;
+    for (size_t i = 0; i < m_sections.size(); i++) {
+        CheckpointSection &section = m_sections[i];
+        uint64_t size = section.elementSize * section.rows * section.columns;
+
+        offset = (offset + CHECKPOINT_ALIGNMENT - 1) / CHECKPOINT_ALIGNMENT * CHECKPOINT_ALIGNMENT;
+        section.offset = offset;
+        offset += size;
+    }
+
+    string tmpFileName = fileName + ".tmp";
+    int fd = open(tmpFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        cerr << "Failed creating the checkpoint file " << tmpFileName << endl;
+        return false;
+    }
+
+    // the data of the sections, and their checksums
+    static const char padding[CHECKPOINT_ALIGNMENT] = { 0 };
+    bool success = lseek(fd, tableEnd, SEEK_SET) == static_cast<off_t>(tableEnd);
+    uint64_t position = tableEnd;
+    for (size_t i = 0; success && i < m_sections.size(); i++) {
+        CheckpointSection &section = m_sections[i];
+        uint64_t size = section.elementSize * section.rows * section.columns;
+
+        success = writeAll(fd, padding, section.offset - position);
+        if (m_fileRows[i].first.empty()) {
+            section.checksum = checkpointChecksum(m_data[i], size);
+            success = success && writeAll(fd, m_data[i], size);
+        } else {
+            success = success && writeFileSection(fd, i);
+        }
+        position = section.offset + size;
+    }
+
+    // the header and the section table
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, checkpointMagic, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.nSections = m_sections.size();
+    header.tableChecksum = checkpointChecksum(m_sections.data(), m_sections.size() * sizeof(CheckpointSection));
+
+    success = success && lseek(fd, 0, SEEK_SET) == 0
+        && writeAll(fd, &header, sizeof(header))
+        && writeAll(fd, m_sections.data(), m_sections.size() * sizeof(CheckpointSection));
+
+    success = (close(fd) == 0) && success;
+    if (!success || rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+        cerr << "Failed writing the checkpoint file " << fileName << endl;
+        unlink(tmpFileName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ *  Write the data of a section added by addFileSection(), and compute its checksum.
+ *
+ *  @param  fd        The file descriptor of the checkpoint.
+ *  @param  index     Index of the section.
+ *  @return true if successful, false otherwise.
+ */
+bool CheckpointWriter::writeFileSection(int fd, size_t index)
+{
+    CheckpointSection &section = m_sections[index];
+    const string &fileName = m_fileRows[index].first;
+    const vector<uint64_t> &rowOffsets = m_fileRows[index].second;
+
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (file == NULL) {
+        cerr << "Failed opening " << fileName << " for the checkpoint" << endl;
+        return false;
+    }
+
+    // copy the rows one by one
+    vector<char> row(section.elementSize * section.columns);
+    uint64_t checksum = checkpointChecksum(NULL, 0);
+    bool success = true;
+    for (size_t i = 0; success && i < rowOffsets.size(); i++) {
+        if (rowOffsets[i] == CHECKPOINT_NO_ROW) {
+            fill(row.begin(), row.end(), 0);
+        } else if (fseeko(file, rowOffsets[i], SEEK_SET) != 0 || fread(row.data(), row.size(), 1, file) != 1) {
+            cerr << "Failed reading " << fileName << " for the checkpoint" << endl;
+            success = false;
+            break;
+        }
+        checksum = checkpointChecksum(row.data(), row.size(), checksum);
+        success = writeAll(fd, row.data(), row.size());
+    }
+    fclose(file);
+
+    section.checksum = checksum;
+    return success;
+}
+
+CheckpointReader::CheckpointReader() : m_map(NULL), m_size(0)
+{
+}
+
+CheckpointReader::~CheckpointReader()
+{
+    if (m_map != NULL) {
+        munmap(const_cast<char *>(m_map), m_size);
+    }
+}
+
+/*
+ *  Check if a file is a checkpoint file (starts with the magic).
+ *
+ *  @param  fileName   Name of the file.
+ *  @return true if the file is a checkpoint file.
+ */
+bool CheckpointReader::isCheckpoint(const string &fileName)
+{
+    char magic[sizeof(checkpointMagic)];
+    FILE *file = fopen(fileName.c_str(), "rb");
+
+    if (file == NULL) {
+        return false;
+    }
+    bool found = fread(magic, sizeof(magic), 1, file) == 1
+        && memcmp(magic, checkpointMagic, sizeof(magic)) == 0;
+    fclose(file);
+
+    return found;
+}
+
+/*
+ *  Map a checkpoint file in memory, and check its header and section table.
+ *  (The checksums of the data are checked by getSection, so that only the
+ *  sections which are used are read.)
+ *
+ *  @param  fileName   Name of the file.
+ *  @return true if successful, false otherwise.
+ */
+bool CheckpointReader::open(const string &fileName)
+{
+    m_fileName = fileName;
+
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "The checkpoint file " << fileName << " doesn't exist" << endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CheckpointHeader)) {
+        cerr << "The checkpoint file " << fileName << " is truncated" << endl;
+        close(fd);
+        return false;
+    }
+
+    m_size = st.st_size;
+    void *map = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        cerr << "Failed mapping the checkpoint file " << fileName << endl;
+        m_size = 0;
+        return false;
+    }
+    m_map = static_cast<const char *>(map);
+    madvise(map, m_size, MADV_SEQUENTIAL);
+
+    const CheckpointHeader *header = reinterpret_cast<const CheckpointHeader *>(m_map);
+    if (memcmp(header->magic, checkpointMagic, sizeof(checkpointMagic)) != 0) {
+        cerr << fileName << " is not a checkpoint file" << endl;
+        return false;
+    }
+    if (header->version != CHECKPOINT_VERSION) {
+        cerr << "The checkpoint file " << fileName << " has version " << header->version
+             << ", expected " << CHECKPOINT_VERSION << endl;
+        return false;
+    }
+
+    uint64_t tableSize = static_cast<uint64_t>(header->nSections) * sizeof(CheckpointSection);
+    if (sizeof(CheckpointHeader) + tableSize > m_size) {
+        cerr << "The checkpoint file " << fileName << " is truncated" << endl;
+        return false;
+    }
+    if (checkpointChecksum(m_map + sizeof(CheckpointHeader), tableSize) != header->tableChecksum) {
+        cerr << "The section table of the checkpoint file " << fileName << " is corrupted" << endl;
+        return false;
+    }
+
+    const CheckpointSection *sections = reinterpret_cast<const CheckpointSection *>(m_map + sizeof(CheckpointHeader));
+    for (uint32_t i = 0; i < header->nSections; i++) {
+        uint64_t size = sections[i].elementSize * sections[i].rows * sections[i].columns;
+        if (sections[i].offset > m_size || size > m_size - sections[i].offset) {
+            cerr << "The checkpoint file " << fileName << " is truncated" << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ *  Find the entry of a section.
+ *
+ *  @param  type      Type of the section.
+ *  @param  cluster   Index of the cluster of the section.
+ *  @return pointer to the entry, or NULL if the section is missing.
+ */
+const CheckpointSection *CheckpointReader::findSection(checkpointSectionType type, uint32_t cluster) const
+{
+    if (m_map == NULL) {
+        return NULL;
+    }
+
+    const CheckpointHeader *header = reinterpret_cast<const CheckpointHeader *>(m_map);
+    const CheckpointSection *sections = reinterpret_cast<const CheckpointSection *>(m_map + sizeof(CheckpointHeader));
+    for (uint32_t i = 0; i < header->nSections; i++) {
+        if (sections[i].type == static_cast<uint32_t>(type) && sections[i].cluster == cluster) {
+            return &sections[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ *  Check if the checkpoint has a section.
+ *
+ *  @param  type      Type of the section.
+ *  @param  cluster   Index of the cluster of the section.
+ *  @return true if the section exists.
+ */
+bool CheckpointReader::hasSection(checkpointSectionType type, uint32_t cluster) const
+{
+    return findSection(type, cluster) != NULL;
+}
+
+/*
+ *  Get the number of rows of a section (for the arrays whose length
+ *  is part of the state).
+ *
+ *  @param  type      Type of the section.
+ *  @param  cluster   Index of the cluster of the section.
+ *  @return the number of rows, or 0 if the section is missing.
+ */
+uint64_t CheckpointReader::getRows(checkpointSectionType type, uint32_t cluster) const
+{
+    const CheckpointSection *section = findSection(type, cluster);
+
+    return section == NULL ? 0 : section->rows;
+}
+
+/*
+ *  Get the data of a section, after checking its element size, shape and checksum.
+ *
+ *  @param  type          Type of the section.
+ *  @param  cluster       Index of the cluster of the section.
+ *  @param  elementSize   Expected size of an element in bytes.
+ *  @param  rows          Expected number of rows of the array.
+ *  @param  columns       Expected number of columns of the array.
+ *  @return pointer to the data in the mapped file, or NULL if the section
+ *          is missing or does not match.
+ */
+const void *CheckpointReader::getSection(checkpointSectionType type, uint32_t cluster, uint32_t elementSize, uint64_t rows, uint64_t columns) const
+{
+    const CheckpointSection *section = findSection(type, cluster);
+
+    if (section == NULL) {
+        cerr << "The checkpoint file " << m_fileName << " has no section " << type
+             << " for cluster " << cluster << endl;
+        return NULL;
+    }
+    if (section->elementSize != elementSize || section->rows != rows || section->columns != columns) {
+        cerr << "Section " << type << " of cluster " << cluster << " of the checkpoint file " << m_fileName
+             << " has shape " << section->rows << " x " << section->columns << " of " << section->elementSize
+             << " bytes, expected " << rows << " x " << columns << " of " << elementSize << " bytes" << endl;
+        return NULL;
+    }
+
+    const char *data = m_map + section->offset;
+    if (checkpointChecksum(data, elementSize * rows * columns) != section->checksum) {
+        cerr << "Section " << type << " of cluster " << cluster << " of the checkpoint file "
+             << m_fileName << " is corrupted" << endl;
+        return NULL;
+    }
+
+    return data;
+}
@@ -0,0 +1,418 @@
+/**
+ *      @file Checkpoint.h
+ *
+ *      @brief Binary checkpoint files of the simulation state.
+ */
+
+/**
+ ** @class CheckpointWriter Checkpoint.h "Checkpoint.h"
+ ** @class CheckpointReader Checkpoint.h "Checkpoint.h"
+ **
+ ** \latexonly  \subsubsection*{Implementation} \endlatexonly
+ ** \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ **
+ ** A checkpoint file is made of a header, a section table and the sections:
+ **
+ ** - The header (CheckpointHeader) holds the magic "BGCKPT", the version of the
+ **   format, the number of sections and the checksum of the section table.
+ ** - Each entry of the section table (CheckpointSection) describes an array:
+ **   its type, the cluster it belongs to, the size of its elements, its shape
+ **   (rows x columns), its offset in the file and the checksum of its data.
+ ** - The data of each section is the raw array, in the byte order of the
+ **   machine, starting at an offset aligned to CHECKPOINT_ALIGNMENT.
+ **
+ ** The writer collects the arrays, and writes them with one large write per
+ ** section (the sections of the arrays kept in a file, such as the growth
+ ** history of XmlGrowthRecorder, are copied from the file row by row). The
+ ** reader maps the file in memory, checks the header, the table and the
+ ** checksums, and returns a pointer to the data of a section after checking
+ ** its element size and shape against the arrays of the simulation. The
+ ** objects of the simulation copy the data straight from the mapping into
+ ** their arrays.
+ **
+ ** The checksums are 64 bits FNV-1a hashes.
+ **
+ ** Two kinds of checkpoints share the format: the memory image of -w/-r
+ ** (synapse weights, endpoints and radii, by layout index, with the original
+ ** index of each neuron), and the periodic checkpoint of -k, which holds the
+ ** complete state of the simulation at an epoch boundary (see
+ ** Simulator::checkpoint()). The sections of the objects that are not tied to
+ ** a cluster use cluster 0; the sections of the stimulus input synapses of a
+ ** cluster use CHECKPOINT_SINPUT_CLUSTER(iCluster).
+ **/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "BGTypes.h"
+
+using namespace std;
+
+//! Version of the checkpoint file format.
+#define CHECKPOINT_VERSION 1
+
+//! Alignment of the sections in the checkpoint file.
+#define CHECKPOINT_ALIGNMENT 64
+
+//! Row offset of CheckpointWriter::addFileSection() for a row of zeros.
+#define CHECKPOINT_NO_ROW (~static_cast<uint64_t>(0))
+
+//! Cluster index of the sections of the stimulus input synapses of a cluster.
+#define CHECKPOINT_SINPUT_CLUSTER(iCluster) (0x10000 + (iCluster))
+
+//! Number of sections of an EventQueue (see CKPT_PRE_SPIKE_QUEUE).
+#define CHECKPOINT_QUEUE_SECTIONS 6
+
+//! Types of the sections of the checkpoint file.
+enum checkpointSectionType {
+    CKPT_SYNAPSE_W = 1,             //!< AllSynapsesProps::W
+    CKPT_SYNAPSE_SOURCE = 2,        //!< AllSynapsesProps::sourceNeuronLayoutIndex
+    CKPT_SYNAPSE_DEST = 3,          //!< AllSynapsesProps::destNeuronLayoutIndex
+    CKPT_RADII = 4,                 //!< ConnGrowth::radii
+
+    // simulation
+    CKPT_RUN = 5,                   //!< Epoch, simulation step and configuration (Simulator)
+    CKPT_GLOBAL_RNG = 6,            //!< The global MTRand rng
+    CKPT_RATES = 7,                 //!< ConnGrowth::rates
+    CKPT_NEURON_ORIGINAL_INDEX = 8, //!< Layout original index of each neuron (the renumbering of the neurons)
+
+    // neurons
+    CKPT_NEURON_SUMMATION = 16,     //!< AllNeuronsProps::summation_map
+    CKPT_NEURON_HAS_FIRED = 17,     //!< AllSpikingNeuronsProps::hasFired
+    CKPT_NEURON_SPIKE_COUNT = 18,   //!< AllSpikingNeuronsProps::spikeCount
+    CKPT_NEURON_SPIKE_COUNT_OFFSET = 19, //!< AllSpikingNeuronsProps::spikeCountOffset
+    CKPT_NEURON_SPIKE_HISTORY = 20, //!< AllSpikingNeuronsProps::spike_history (the used part)
+    CKPT_NEURON_SPIKE_HISTORY_BEGIN = 21, //!< AllSpikingNeuronsProps::spikeHistoryBegin
+    CKPT_NEURON_SPIKE_HISTORY_SIZE = 22,  //!< AllSpikingNeuronsProps::spikeHistorySize
+    CKPT_NEURON_SPIKE_HISTORY_STATE = 23, //!< spikeHistoryBaseStep, spikeHistoryUsed and spikeHistoryAllocated
+    CKPT_NEURON_VM = 24,            //!< AllIFNeuronsProps::Vm
+    CKPT_NEURON_STEPS_IN_REFR = 25, //!< AllIFNeuronsProps::nStepsInRefr
+    CKPT_NEURON_U = 26,             //!< AllIZHNeuronsProps::u
+
+    // synapses
+    CKPT_SYNAPSE_TYPE = 32,         //!< AllSynapsesProps::type
+    CKPT_SYNAPSE_PSR = 33,          //!< AllSynapsesProps::psr
+    CKPT_SYNAPSE_IN_USE = 34,       //!< AllSynapsesProps::in_use
+    CKPT_SYNAPSE_COUNTS = 35,       //!< AllSynapsesProps::synapse_counts
+    CKPT_SYNAPSE_TOTAL_COUNT = 36,  //!< AllSynapsesProps::total_synapse_counts
+    CKPT_SYNAPSE_DECAY = 37,        //!< AllSpikingSynapsesProps::decay
+    CKPT_SYNAPSE_TAU = 38,          //!< AllSpikingSynapsesProps::tau
+    CKPT_SYNAPSE_TOTAL_DELAY = 39,  //!< AllSpikingSynapsesProps::total_delay
+    CKPT_SYNAPSE_ACTIVE = 40,       //!< AllSpikingSynapses::m_activeSynapses
+    CKPT_SYNAPSE_IDLE_STEP = 41,    //!< AllSpikingSynapses::m_idleStep
+    CKPT_SYNAPSE_NEXT_ACTIVE_STEP = 42, //!< AllSpikingSynapses::m_nextActiveStep
+    CKPT_SYNAPSE_LAST_SPIKE = 43,   //!< lastSpike of the dynamic synapses
+    CKPT_SYNAPSE_R = 44,            //!< r of the dynamic synapses
+    CKPT_SYNAPSE_U = 45,            //!< u of the dynamic synapses
+    CKPT_SYNAPSE_D = 46,            //!< D of the dynamic synapses
+    CKPT_SYNAPSE_USE = 47,          //!< U of the dynamic synapses
+    CKPT_SYNAPSE_F = 48,            //!< F of the dynamic synapses
+    CKPT_STDP_TOTAL_DELAY_POST = 49, //!< AllSTDPSynapsesProps::total_delayPost
+    CKPT_STDP_TAUSPOST = 50,        //!< AllSTDPSynapsesProps::tauspost
+    CKPT_STDP_TAUSPRE = 51,         //!< AllSTDPSynapsesProps::tauspre
+    CKPT_STDP_TAUPOS = 52,          //!< AllSTDPSynapsesProps::taupos
+    CKPT_STDP_TAUNEG = 53,          //!< AllSTDPSynapsesProps::tauneg
+    CKPT_STDP_GAP = 54,             //!< AllSTDPSynapsesProps::STDPgap
+    CKPT_STDP_WEX = 55,             //!< AllSTDPSynapsesProps::Wex
+    CKPT_STDP_ANEG = 56,            //!< AllSTDPSynapsesProps::Aneg
+    CKPT_STDP_APOS = 57,            //!< AllSTDPSynapsesProps::Apos
+    CKPT_STDP_MUPOS = 58,           //!< AllSTDPSynapsesProps::mupos
+    CKPT_STDP_MUNEG = 59,           //!< AllSTDPSynapsesProps::muneg
+    CKPT_STDP_FROEMKE_DAN = 60,     //!< AllSTDPSynapsesProps::useFroemkeDanSTDP
+    CKPT_SPIKE_RINGS = 61,          //!< AxonalSpikeRings of the neurons of the cluster
+    CKPT_SYNAPSE_RING_NEW = 62,     //!< AllSpikingSynapsesProps::ringNewSynapse
+    CKPT_SYNAPSE_RING_CREATED_STEP = 63, //!< AllSpikingSynapsesProps::ringCreatedStep
+
+    // event queues: CHECKPOINT_QUEUE_SECTIONS consecutive types each (see EventQueue::checkpoint())
+    CKPT_PRE_SPIKE_QUEUE = 64,      //!< AllSpikingSynapsesProps::preSpikeQueue
+    CKPT_POST_SPIKE_QUEUE = 72,     //!< AllSTDPSynapsesProps::postSpikeQueue
+
+    // random number generators of the clusters
+    CKPT_NORM_RAND = 80,            //!< ClusterInfo::normRand
+    CKPT_BATCH_NORM_RAND = 81,      //!< ClusterInfo::batchNormRand
+    CKPT_SINPUT_RNG = 82,           //!< ClusterInfo::rng
+
+    // stimulus input
+    CKPT_SINPUT_ISI = 88,           //!< SInputPoisson::m_nISIs
+    CKPT_SINPUT_CYCLE = 89,         //!< ClusterInfo::nStepsInCycle
+    CKPT_SINPUT_ISI_SCHEDULE = 90,  //!< HostSInputPoisson intervals drawn ahead from ClusterInfo::rng
+    CKPT_SINPUT_ISI_NEXT = 91,      //!< HostSInputPoisson index of the next drawn interval
+
+    // recorders
+    CKPT_BURSTINESS_HIST = 96,      //!< XmlRecorder::burstinessHist (up to the current epoch)
+    CKPT_SPIKES_HISTORY = 97,       //!< XmlRecorder::spikesHistory (up to the current epoch)
+    CKPT_RATES_HISTORY = 98,        //!< XmlGrowthRecorder rates history (up to the current epoch)
+    CKPT_RADII_HISTORY = 99,        //!< XmlGrowthRecorder radii history (up to the current epoch)
+    CKPT_SPIKE_STREAM_OFFSET = 100  //!< BinaryRecorder size of the spike stream file (up to the current epoch)
+};
+
+//! Header of the checkpoint file.
+struct CheckpointHeader
+{
+    //! "BGCKPT" followed by two zero bytes.
+    char magic[8];
+
+    //! Version of the file format (CHECKPOINT_VERSION).
+    uint32_t version;
+
+    //! Number of entries of the section table.
+    uint32_t nSections;
+
+    //! Checksum of the section table.
+    uint64_t tableChecksum;
+};
+
+//! Entry of the section table of the checkpoint file.
+struct CheckpointSection
+{
+    //! Type of the section (checkpointSectionType).
+    uint32_t type;
+
+    //! Index of the cluster of the section (0 for the sections of the whole network).
+    uint32_t cluster;
+
+    //! Size of an element in bytes.
+    uint32_t elementSize;
+
+    //! Padding (0).
+    uint32_t reserved;
+
+    //! Number of rows of the array (e.g. neurons).
+    uint64_t rows;
+
+    //! Number of columns of the array (e.g. synapses per neuron).
+    uint64_t columns;
+
+    //! Offset of the data in the file.
+    uint64_t offset;
+
+    //! Checksum of the data.
+    uint64_t checksum;
+};
+
+class CheckpointWriter
+{
+    public:
+        CheckpointWriter();
+        ~CheckpointWriter();
+
+        /**
+         *  Add a section to write. The array must stay valid until write() is called.
+         *
+         *  @param  type          Type of the section.
+         *  @param  cluster       Index of the cluster of the section.
+         *  @param  data          The array.
+         *  @param  elementSize   Size of an element in bytes.
+         *  @param  rows          Number of rows of the array.
+         *  @param  columns       Number of columns of the array.
+         */
+        void addSection(checkpointSectionType type, uint32_t cluster, const void *data, uint32_t elementSize, uint64_t rows, uint64_t columns);
+
+        /**
+         *  Add a section whose array is allocated by the writer (for values that
+         *  are not stored in an array of the simulation). The array is freed
+         *  when the writer is destroyed.
+         *
+         *  @param  type          Type of the section.
+         *  @param  cluster       Index of the cluster of the section.
+         *  @param  elementSize   Size of an element in bytes.
+         *  @param  rows          Number of rows of the array.
+         *  @param  columns       Number of columns of the array.
+         *  @return pointer to the array to fill.
+         */
+        void *allocSection(checkpointSectionType type, uint32_t cluster, uint32_t elementSize, uint64_t rows, uint64_t columns);
+
+        /**
+         *  Add a section whose rows are copied from a file when the checkpoint
+         *  is written (for arrays that are kept in a file rather than in memory).
+         *
+         *  @param  type          Type of the section.
+         *  @param  cluster       Index of the cluster of the section.
+         *  @param  fileName      Name of the file.
+         *  @param  rowOffsets    Offset of each row in the file (CHECKPOINT_NO_ROW for a row of zeros).
+         *  @param  elementSize   Size of an element in bytes.
+         *  @param  columns       Number of columns of the array.
+         */
+        void addFileSection(checkpointSectionType type, uint32_t cluster, const string &fileName, const vector<uint64_t> &rowOffsets, uint32_t elementSize, uint64_t columns);
+
+        /**
+         *  Add a section of an array (rows x columns elements).
+         *
+         *  @param  type      Type of the section.
+         *  @param  cluster   Index of the cluster of the section.
+         *  @param  data      The array.
+         *  @param  rows      Number of rows of the array.
+         *  @param  columns   Number of columns of the array.
+         */
+        template<typename T>
+        void addArray(checkpointSectionType type, uint32_t cluster, const T *data, uint64_t rows, uint64_t columns = 1)
+        {
+            addSection(type, cluster, data, sizeof(T), rows, columns);
+        }
+
+        /**
+         *  Add a section of a single value (copied by the writer).
+         *
+         *  @param  type      Type of the section.
+         *  @param  cluster   Index of the cluster of the section.
+         *  @param  value     The value.
+         */
+        template<typename T>
+        void addValue(checkpointSectionType type, uint32_t cluster, const T &value)
+        {
+            *static_cast<T *>(allocSection(type, cluster, sizeof(T), 1, 1)) = value;
+        }
+
+        /**
+         *  Write the checkpoint file.
+         *
+         *  @param  fileName   Name of the file.
+         *  @return true if successful, false otherwise.
+         */
+        bool write(const string &fileName);
+
+    private:
+        //! The section table.
+        vector<CheckpointSection> m_sections;
+
+        //! The arrays of the sections.
+        vector<const void *> m_data;
+
+        //! The arrays allocated by allocSection().
+        vector<char *> m_buffers;
+
+        //! The file and the row offsets of the sections added by addFileSection() (no file for the others).
+        vector<pair<string, vector<uint64_t> > > m_fileRows;
+
+        /**
+         *  Write the data of a section added by addFileSection(), and compute its checksum.
+         *
+         *  @param  fd        The file descriptor of the checkpoint.
+         *  @param  index     Index of the section.
+         *  @return true if successful, false otherwise.
+         */
+        bool writeFileSection(int fd, size_t index);
+};
+
+class CheckpointReader
+{
+    public:
+        CheckpointReader();
+        ~CheckpointReader();
+
+        /**
+         *  Check if a file is a checkpoint file (starts with the magic).
+         *
+         *  @param  fileName   Name of the file.
+         *  @return true if the file is a checkpoint file.
+         */
+        static bool isCheckpoint(const string &fileName);
+
+        /**
+         *  Map a checkpoint file in memory, and check its header, section table
+         *  and checksums.
+         *
+         *  @param  fileName   Name of the file.
+         *  @return true if successful, false otherwise.
+         */
+        bool open(const string &fileName);
+
+        /**
+         *  Check if the checkpoint has a section.
+         *
+         *  @param  type      Type of the section.
+         *  @param  cluster   Index of the cluster of the section.
+         *  @return true if the section exists.
+         */
+        bool hasSection(checkpointSectionType type, uint32_t cluster) const;
+
+        /**
+         *  Get the data of a section, after checking its element size and shape.
+         *
+         *  @param  type          Type of the section.
+         *  @param  cluster       Index of the cluster of the section.
+         *  @param  elementSize   Expected size of an element in bytes.
+         *  @param  rows          Expected number of rows of the array.
+         *  @param  columns       Expected number of columns of the array.
+         *  @return pointer to the data in the mapped file, or NULL if the section
+         *          is missing or does not match.
+         */
+        const void *getSection(checkpointSectionType type, uint32_t cluster, uint32_t elementSize, uint64_t rows, uint64_t columns) const;
+
+        /**
+         *  Get the number of rows of a section (for the arrays whose length
+         *  is part of the state).
+         *
+         *  @param  type      Type of the section.
+         *  @param  cluster   Index of the cluster of the section.
+         *  @return the number of rows, or 0 if the section is missing.
+         */
+        uint64_t getRows(checkpointSectionType type, uint32_t cluster) const;
+
+        /**
+         *  Copy a section into an array, after checking its element size and shape.
+         *
+         *  @param  type      Type of the section.
+         *  @param  cluster   Index of the cluster of the section.
+         *  @param  data      The array.
+         *  @param  rows      Expected number of rows of the array.
+         *  @param  columns   Expected number of columns of the array.
+         *  @return true if successful, false if the section is missing or does not match.
+         */
+        template<typename T>
+        bool restoreArray(checkpointSectionType type, uint32_t cluster, T *data, uint64_t rows, uint64_t columns = 1) const
+        {
+            const void *section = getSection(type, cluster, sizeof(T), rows, columns);
+            if (section == NULL) {
+                return false;
+            }
+            copy(static_cast<const T *>(section), static_cast<const T *>(section) + rows * columns, data);
+            return true;
+        }
+
+        /**
+         *  Copy a section of a single value.
+         *
+         *  @param  type      Type of the section.
+         *  @param  cluster   Index of the cluster of the section.
+         *  @param  value     The value.
+         *  @return true if successful, false if the section is missing or does not match.
+         */
+        template<typename T>
+        bool restoreValue(checkpointSectionType type, uint32_t cluster, T &value) const
+        {
+            return restoreArray(type, cluster, &value, 1);
+        }
+
+    private:
+        /**
+         *  Find the entry of a section.
+         *
+         *  @param  type      Type of the section.
+         *  @param  cluster   Index of the cluster of the section.
+         *  @return pointer to the entry, or NULL if the section is missing.
+         */
+        const CheckpointSection *findSection(checkpointSectionType type, uint32_t cluster) const;
+
+        //! The mapped file.
+        const char *m_map;
+
+        //! Size of the mapped file.
+        size_t m_size;
+
+        //! Name of the file (for the error messages).
+        string m_fileName;
+};
+
+/**
+ *  64 bits FNV-1a hash of a buffer.
+ *
+ *  @param  data    The buffer.
+ *  @param  size    Size of the buffer in bytes.
+ *  @param  hash    Hash of the preceding data.
+ *  @return the hash.
+ */
+uint64_t checkpointChecksum(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL);
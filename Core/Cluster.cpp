@@ -1,8 +1,12 @@
 #include "Cluster.h"
 #include "ISInput.h"
+#include "NumaTopology.h"
+#if defined(__linux__)
+#include <pthread.h>
+#endif
 
 // Initialize the Barrier Synchnonize object for advanceThreads.
-Barrier *Cluster::m_barrierAdvance = NULL;
+IBarrier *Cluster::m_barrierAdvance = NULL;
 
 // Initialize the flag for advanceThreads. true if terminating advanceThreads.
 bool Cluster::m_isAdvanceExit = false;
@@ -90,16 +94,163 @@ void Cluster::createAdvanceThread(const SimulationInfo *sim_info, ClusterInfo *c
     // If barrier synchronize object has not been created, create it
     if (m_barrierAdvance == NULL) {
         // number of cluster thread + 1 (for main thread)
-        m_barrierAdvance = new Barrier(count + 1);
+        if (sim_info->spinBarrier) {
+            m_barrierAdvance = new SpinBarrier(count + 1);
+        } else {
+            m_barrierAdvance = new Barrier(count + 1);
+        }
     }
 
     // Create an advanceThread
     std::thread thAdvance(&Cluster::advanceThread, this, sim_info, clr_info);
 
+    // Pin it to its core or to the CPUs of the NUMA node of the cluster
+    if (sim_info->pinThreads != NO_PINNING) {
+        pinThread(thAdvance, sim_info, clr_info, 0);
+    }
+
     // Leave it running
     thAdvance.detach();
 }
 
+/*
+ *  Get the NUMA node of a cluster: the clusters are spread evenly over the nodes,
+ *  in order, so that neighbouring clusters (which exchange the most spikes) share a node.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  clr_info    ClusterInfo class to read information from.
+ *  @return the index of the node.
+ */
+int Cluster::getClusterNode(const SimulationInfo *sim_info, const ClusterInfo *clr_info)
+{
+    int nNodes = NumaTopology::getNumNodes();
+    int nClusters = sim_info->numClusters > 0 ? sim_info->numClusters : 1;
+
+    return static_cast<int>(static_cast<long>(clr_info->clusterID) * nNodes / nClusters);
+}
+
+/*
+ *  Get the CPUs a thread of a cluster is pinned to.
+ *  With the core pinning, each thread of the cluster has its own core (core 0 is left
+ *  to the main thread when there are enough cores, and the cores after the one of the
+ *  advance thread to the other threads of the cluster). With the node pinning, all the
+ *  threads of the cluster share the CPUs of the NUMA node of the cluster.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  clr_info    ClusterInfo class to read information from.
+ *  @param  iThread     Index of the thread in the cluster (0 for the advance thread).
+ *  @return the indexes of the CPUs (empty if the threads are not pinned).
+ */
+vector<int> Cluster::getThreadCpus(const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iThread)
+{
+    vector<int> cpus;
+    if (sim_info->pinThreads == CORE_PINNING) {
+        int nCores = std::thread::hardware_concurrency();
+        if (nCores > 0) {
+            cpus.push_back((clr_info->clusterID * sim_info->numClusterThreads + 1 + iThread) % nCores);
+        }
+    } else if (sim_info->pinThreads == NODE_PINNING) {
+        cpus = NumaTopology::getNodeCpus(getClusterNode(sim_info, clr_info));
+    }
+
+    return cpus;
+}
+
+/*
+ *  Pin a thread of a cluster to its CPUs (see getThreadCpus()).
+ *
+ *  @param  thread      The thread to pin.
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  clr_info    ClusterInfo class to read information from.
+ *  @param  iThread     Index of the thread in the cluster (0 for the advance thread).
+ */
+void Cluster::pinThread(std::thread &thread, const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iThread)
+{
+    setThreadAffinity(thread.native_handle(), getThreadCpus(sim_info, clr_info, iThread));
+}
+
+/*
+ *  Pin the calling thread to the CPUs of a thread of a cluster (see getThreadCpus()),
+ *  e.g. before it allocates and initializes memory of the cluster.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  clr_info    ClusterInfo class to read information from.
+ *  @param  iThread     Index of the thread in the cluster (0 for the advance thread).
+ */
+void Cluster::pinCurrentThread(const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iThread)
+{
+#if defined(__linux__)
+    setThreadAffinity(pthread_self(), getThreadCpus(sim_info, clr_info, iThread));
+#endif
+}
+
+/*
+ *  Set the CPUs a thread may run on.
+ *
+ *  @param  handle   Native handle of the thread.
+ *  @param  cpus     Indexes of the CPUs (the affinity is left unchanged if empty).
+ */
+void Cluster::setThreadAffinity(std::thread::native_handle_type handle, const vector<int> &cpus)
+{
+    if (cpus.empty()) {
+        return;
+    }
+
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (size_t i = 0; i < cpus.size(); i++) {
+        CPU_SET(cpus[i], &cpuset);
+    }
+    if (pthread_setaffinity_np(handle, sizeof(cpu_set_t), &cpuset) != 0) {
+        cerr << "Failed to pin a cluster thread to CPU " << cpus[0];
+        if (cpus.size() > 1) {
+            cerr << "-" << cpus.back();
+        }
+        cerr << endl;
+    }
+#else
+    cerr << "Thread pinning is not supported on this platform" << endl;
+#endif
+}
+
+/*
+ *  Advances the neurons and synapses of the cluster through the steps of
+ *  the synaptic transmission delay window, one step at a time.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  clr_info    ClusterInfo class to read information from.
+ *  @param  nSteps      Number of steps of the window.
+ */
+void Cluster::advanceWindow(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps)
+{
+    for (int iStepOffset = 0; iStepOffset < nSteps; iStepOffset++) {
+        if (sim_info->pInput != NULL) {
+            // input stimulus
+            sim_info->pInput->inputStimulus(sim_info, clr_info, iStepOffset);
+        }
+
+        // Advances neurons network state one simulation step
+        advanceNeurons(sim_info, clr_info, iStepOffset);
+
+        // When advanceNeurons and advanceSynapses in different clusters 
+        // are running concurrently, there might be race condition at
+        // event queues. For example, EventQueue::addAnEvent() is called
+        // from advanceNeurons in cluster 0 and EventQueue::checkAnEvent()
+        // is called from advanceSynapses in cluster 1. These functions
+        // contain memory read/write operation at event queue and 
+        // consequntltly data race happens. (host version)
+
+        // Now we could eliminate all barrier synchronization within
+        // synaptic transmission delay period, because
+        // EventQueue::addAnEvent() and EventQueue::checkAnEvent() handle
+        // atomic read/write operations.
+
+        // Advances synapses network state one simulation step
+        advanceSynapses(sim_info, clr_info, iStepOffset);
+    } // end synaptic transmission delay loop
+}
+
 /*
  *  Thread for advance a cluster.
  *
@@ -127,51 +278,28 @@ void Cluster::advanceThread(const SimulationInfo *sim_info, ClusterInfo *clr_inf
 #endif // VALIDATION
 
         // Advance neurons and synapses indepedently (without barrier synchronization)
-        // within synaptic transmission delay period. 
-        for (int iStepOffset = 0; iStepOffset < m_nSynapticTransDelay; iStepOffset++) {
-            if (sim_info->pInput != NULL) {
-                // input stimulus
-                sim_info->pInput->inputStimulus(sim_info, clr_info, iStepOffset);
-            }
-
-            // Advances neurons network state one simulation step
-            advanceNeurons(sim_info, clr_info, iStepOffset);
-
-            // When advanceNeurons and advanceSynapses in different clusters 
-            // are running concurrently, there might be race condition at
-            // event queues. For example, EventQueue::addAnEvent() is called
-            // from advanceNeurons in cluster 0 and EventQueue::checkAnEvent()
-            // is called from advanceSynapses in cluster 1. These functions
-            // contain memory read/write operation at event queue and 
-            // consequntltly data race happens. (host version)
-
-            // Now we could eliminate all barrier synchronization within
-            // synaptic transmission delay period, because
-            // EventQueue::addAnEvent() and EventQueue::checkAnEvent() handle
-            // atomic read/write operations.
-
-            // Advances synapses network state one simulation step
-            advanceSynapses(sim_info, clr_info, iStepOffset);
-        } // end synaptic transmission delay loop
-
-        // wait until all threads are complete the synaptic transmission delay loop
-        m_barrierAdvance->Sync();
+        // within synaptic transmission delay period.
+        advanceWindow(sim_info, clr_info, m_nSynapticTransDelay);
 
-        // Process outgoing spiking data between clusters
+        // With a single cluster, no other thread adds events to the queue and
+        // there is no inter clusters spiking data, so the cluster can advance its
+        // event queue right away.
         if (sim_info->numClusters >= 2) {
+            // wait until all threads are complete the synaptic transmission delay loop
+            m_barrierAdvance->Sync();
+
+            // Process outgoing spiking data between clusters
             processInterClustesOutgoingSpikes(clr_info);
-        }
 
-        // wait until all threads are complete
-        m_barrierAdvance->Sync();
+            // wait until all threads are complete
+            m_barrierAdvance->Sync();
 
-        // Process incoming spiking data between clusters
-        if (sim_info->numClusters >= 2) {
+            // Process incoming spiking data between clusters
             processInterClustesIncomingSpikes(clr_info);
-        }
 
-        // wait until all threads are complete
-        m_barrierAdvance->Sync();
+            // wait until all threads are complete
+            m_barrierAdvance->Sync();
+        }
 
         // Advance event queue state m_nSynapticTransDelay simulation steps
         advanceSpikeQueue(sim_info, clr_info, m_nSynapticTransDelay);
@@ -200,14 +328,16 @@ void Cluster::runAdvance(const SimulationInfo *sim_info, int iStep)
     // start advanceThread
     m_barrierAdvance->Sync();
 
-    // wait until the advance of all advanceThread complete the synaptic transmission delay loop
-    m_barrierAdvance->Sync();
+    if (sim_info->numClusters >= 2) {
+        // wait until the advance of all advanceThread complete the synaptic transmission delay loop
+        m_barrierAdvance->Sync();
 
-    // wait until the process outgoing spiking data between clusters complete
-    m_barrierAdvance->Sync();
+        // wait until the process outgoing spiking data between clusters complete
+        m_barrierAdvance->Sync();
 
-    // wait until the process incoming spiking data between clusters complete
-    m_barrierAdvance->Sync();
+        // wait until the process incoming spiking data between clusters complete
+        m_barrierAdvance->Sync();
+    }
 
     // wait until the advance of event queue state
     m_barrierAdvance->Sync();
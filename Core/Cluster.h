@@ -53,6 +53,10 @@
 #include "Layout.h"
 #include <thread>
 #include "Barrier.hpp"
+#include "SpinBarrier.hpp"
+
+class CheckpointWriter;
+class CheckpointReader;
 
 class Cluster
 {
@@ -144,6 +148,17 @@ class Cluster
          */
         virtual void advanceSynapses(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset) = 0;
 
+        /**
+         * Advances the neurons and synapses of the cluster through the steps of
+         * the synaptic transmission delay window (one step at a time: the input
+         * stimulus, the neurons, then the synapses of each step).
+         *
+         * @param sim_info    SimulationInfo class to read information from.
+         * @param clr_info    ClusterInfo class to read information from.
+         * @param nSteps      Number of steps of the window.
+         */
+        virtual void advanceWindow(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps);
+
         /**
          * Advances synapses spike event queue state of the cluster.
          *
@@ -153,6 +168,27 @@ class Cluster
          */
         virtual void advanceSpikeQueue(const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iStep) = 0;
 
+#if !defined(USE_GPU)
+        /**
+         *  Add the state of the cluster (neurons, synapses, spike queues and
+         *  random number generators) to a periodic checkpoint.
+         *
+         *  @param  writer      The checkpoint writer.
+         *  @param  clr_info    ClusterInfo to refer.
+         */
+        virtual void checkpoint(CheckpointWriter &writer, const ClusterInfo *clr_info) const = 0;
+
+        /**
+         *  Restore the state of the cluster from a periodic checkpoint.
+         *  The synapse index map must be recreated afterwards.
+         *
+         *  @param  reader      The checkpoint reader.
+         *  @param  clr_info    ClusterInfo to refer.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restore(const CheckpointReader &reader, ClusterInfo *clr_info) = 0;
+#endif // !USE_GPU
+
         /**
          *  Create an advanceThread.
          *  If barrier synchronize object has not been created, create it.
@@ -200,11 +236,57 @@ class Cluster
          */
         SynapseIndexMap *m_synapseIndexMap;
 
+        /**
+         *  Get the NUMA node of a cluster.
+         *
+         *  @param  sim_info    SimulationInfo class to read information from.
+         *  @param  clr_info    ClusterInfo class to read information from.
+         *  @return the index of the node.
+         */
+        static int getClusterNode(const SimulationInfo *sim_info, const ClusterInfo *clr_info);
+
+        /**
+         *  Get the CPUs a thread of a cluster is pinned to (see SimulationInfo::pinThreads).
+         *
+         *  @param  sim_info    SimulationInfo class to read information from.
+         *  @param  clr_info    ClusterInfo class to read information from.
+         *  @param  iThread     Index of the thread in the cluster (0 for the advance thread).
+         *  @return the indexes of the CPUs (empty if the threads are not pinned).
+         */
+        static vector<int> getThreadCpus(const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iThread);
+
+        /**
+         *  Pin a thread of a cluster to its CPUs.
+         *
+         *  @param  thread      The thread to pin.
+         *  @param  sim_info    SimulationInfo class to read information from.
+         *  @param  clr_info    ClusterInfo class to read information from.
+         *  @param  iThread     Index of the thread in the cluster (0 for the advance thread).
+         */
+        static void pinThread(std::thread &thread, const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iThread);
+
+        /**
+         *  Pin the calling thread to the CPUs of a thread of a cluster.
+         *
+         *  @param  sim_info    SimulationInfo class to read information from.
+         *  @param  clr_info    ClusterInfo class to read information from.
+         *  @param  iThread     Index of the thread in the cluster (0 for the advance thread).
+         */
+        static void pinCurrentThread(const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iThread);
+
     private:
+        /**
+         *  Set the CPUs a thread may run on.
+         *
+         *  @param  handle   Native handle of the thread.
+         *  @param  cpus     Indexes of the CPUs (the affinity is left unchanged if empty).
+         */
+        static void setThreadAffinity(std::thread::native_handle_type handle, const vector<int> &cpus);
+
         /**
          *  Pointer to the Barrier Synchnonize object for advanceThreads.
          */
-        static Barrier *m_barrierAdvance;
+        static IBarrier *m_barrierAdvance;
 
         /**
          *  Flag for advanceThreads. true if terminating advanceThreads.
@@ -40,6 +40,11 @@ class SimulationInfo;
 #endif // USE_GPU
 
 class IAllSynapses;
+#if !defined(USE_GPU)
+class BatchNorm;
+class Philox;
+class AxonalSpikeRings;
+#endif // !USE_GPU
 
 class ClusterInfo
 {
@@ -50,7 +55,16 @@ class ClusterInfo
             totalClusterNeurons(0),
             pClusterSummationMap(NULL),
             seed(0),
+#if !defined(USE_GPU)
+            batchNormRand(NULL),
+            counterRand(NULL),
+            randNoise(NULL),
+            originalNeuronIndex(NULL),
+#endif // !USE_GPU
             eventHandler(NULL),
+#if !defined(USE_GPU)
+            spikeRings(NULL),
+#endif // !USE_GPU
 #if defined(USE_GPU)
             initValues_d(NULL),
             nShiftValues_d(NULL),
@@ -93,6 +107,32 @@ class ClusterInfo
 #if !defined(USE_GPU)
         //! A normalized random number generator
         Norm* normRand;
+
+        //! A generator of normalized random numbers in batches (batch noise only)
+        BatchNorm* batchNormRand;
+
+        //! A counter-based random number generator, keyed by the simulation seed (counter noise only)
+        Philox* counterRand;
+
+        //! The noise of the neurons in the current step, by neuron index (batch and counter noise only)
+        BGFLOAT* randNoise;
+
+        //! Original index of every neuron of the network by layout index,
+        //! or NULL if the neurons are not renumbered (see Layout::renumberNeurons())
+        const int* originalNeuronIndex;
+
+        /**
+         * Get the original index of a neuron of the cluster, which keys the counter noise
+         * and the counter Poisson input, so that they do not depend on the partition.
+         *
+         * @param iNeuron  Index of the neuron in the cluster.
+         * @return the original index of the neuron.
+         */
+        int getOriginalNeuronIndex(int iNeuron) const
+        {
+            int neuronLayoutIndex = clusterNeuronsBegin + iNeuron;
+            return originalNeuronIndex != NULL ? originalNeuronIndex[neuronLayoutIndex] : neuronLayoutIndex;
+        }
 #endif // !USE_GPU
 
 #if defined(USE_GPU) && defined(PERFORMANCE_METRICS) 
@@ -113,6 +153,11 @@ class ClusterInfo
         //! Pointer to the multi clusters event handler
         InterClustersEventHandler* eventHandler;
 
+#if !defined(USE_GPU)
+        //! Pointer to the spike rings of the neurons (ring spike delivery)
+        AxonalSpikeRings* spikeRings;
+#endif // !USE_GPU
+
 #if defined(USE_GPU)
         //! Pointer to device input values for stimulus inputs (Regular).
         BGFLOAT* initValues_d;
@@ -1,4 +1,6 @@
 #include "EventQueue.h"
+#include "Checkpoint.h"
+#include <algorithm>
 #if defined(USE_GPU)
 #include <helper_cuda.h>
 #endif // USE_GPU
@@ -11,6 +13,19 @@ CUDA_CALLABLE EventQueue::EventQueue()
     m_idxQueue = 0;
     m_eventHandler = NULL;
 
+#if !defined(USE_GPU)
+    m_eventRecorded = NULL;
+    m_recordedEvents = NULL;
+    m_nRecordedEvents = 0;
+
+    m_timingWheel = false;
+    m_delays = NULL;
+    m_step = 0;
+    m_nWheelEvents = 0;
+    m_clearedStep = NULL;
+    m_wheelLock = 0;
+#endif // !USE_GPU
+
 #if defined(USE_GPU)
     m_nMaxInterClustersOutgoingEvents = 0;
     m_nInterClustersOutgoingEvents = 0;
@@ -30,6 +45,22 @@ CUDA_CALLABLE EventQueue::~EventQueue()
         m_queueEvent = NULL;
     }
 
+#if !defined(USE_GPU)
+    // de-allocate memory for the event recording
+    if (m_eventRecorded != NULL) {
+        delete[] m_eventRecorded;
+        delete[] m_recordedEvents;
+        m_eventRecorded = NULL;
+        m_recordedEvents = NULL;
+    }
+
+    // de-allocate memory for the timing wheel
+    if (m_clearedStep != NULL) {
+        delete[] m_clearedStep;
+        m_clearedStep = NULL;
+    }
+#endif // !USE_GPU
+
 #if defined(USE_GPU)
     // In the device side memories, it should use cudaFree() and set NULL 
     // before destroying the object
@@ -61,7 +92,242 @@ void EventQueue::initEventQueue(CLUSTER_INDEX_TYPE clusterID, BGSIZE nMaxEvent)
 
     // allocate & initialize a memory for the event queue
     m_nMaxEvent = nMaxEvent;
-    m_queueEvent = new BGQUEUE_ELEMENT[nMaxEvent];
+    m_queueEvent = new BGQUEUE_ELEMENT[nMaxEvent]();
+}
+
+/*
+ * Start recording the queue indexes that receive events, so that
+ * the owner of the queue can find them without scanning all queues.
+ * Each index is recorded once until the recorded indexes are taken.
+ */
+void EventQueue::enableEventRecording()
+{
+    if (m_eventRecorded != NULL) {
+        return;
+    }
+
+    m_eventRecorded = new uint8_t[m_nMaxEvent];
+    m_recordedEvents = new BGSIZE[m_nMaxEvent];
+    m_nRecordedEvents = 0;
+    fill_n(m_eventRecorded, m_nMaxEvent, 0);
+}
+
+/*
+ * Take the queue indexes that received events since the last call,
+ * and reset the record. Must not run concurrently with addAnEvent().
+ *
+ * @param indexes  Vector to append the recorded queue indexes to.
+ */
+void EventQueue::takeRecordedEvents(vector<BGSIZE> &indexes)
+{
+    if (m_eventRecorded == NULL) {
+        return;
+    }
+
+    for (BGSIZE i = 0; i < m_nRecordedEvents; i++) {
+        BGSIZE idx = m_recordedEvents[i];
+        m_eventRecorded[idx] = 0;
+        indexes.push_back(idx);
+    }
+    m_nRecordedEvents = 0;
+}
+
+/*
+ * Keep the events that are triggered beyond LENGTH_OF_DELAYQUEUE steps
+ * in a timing wheel, so that delays are not limited by the bitmask.
+ *
+ * When delays is given, the events are keyed by the step they arrive at:
+ * addAnEvent(idx, clusterID, iStepOffset) adds the delay of the queue index,
+ * and checkAnEvent(idx, delay, iStepOffset) checks the current step.
+ *
+ * @param delays  The delay of each queue index descretized into time steps,
+ *                or NULL if the events are added with their delay.
+ */
+void EventQueue::enableTimingWheel(const int *delays)
+{
+    if (m_timingWheel) {
+        return;
+    }
+
+    m_timingWheel = true;
+    m_delays = delays;
+    m_clearedStep = new uint64_t[m_nMaxEvent];
+    fill_n(m_clearedStep, m_nMaxEvent, 0);
+}
+
+/*
+ * Add an event in the timing wheel.
+ *
+ * @param idx          The queue index of the collection.
+ * @param iStepOffset  offset from the current time slot when the event will be triggered.
+ */
+void EventQueue::addAWheelEvent(const BGSIZE idx, uint32_t iStepOffset)
+{
+    // events are added concurrently by the clusters and the threads of a cluster
+    while (__sync_lock_test_and_set(&m_wheelLock, 1)) {
+    }
+
+    // the buckets cover the longest delay, so that a bucket holds events of one step only
+    if (iStepOffset >= m_wheelBuckets.size()) {
+        BGSIZE nBuckets = LENGTH_OF_DELAYQUEUE;
+        while (nBuckets <= iStepOffset) {
+            nBuckets <<= 1;
+        }
+
+        vector< vector<wheelEvent_t> > buckets(nBuckets);
+        for (BGSIZE i = 0; i < m_wheelBuckets.size(); i++) {
+            for (BGSIZE j = 0; j < m_wheelBuckets[i].size(); j++) {
+                const wheelEvent_t &event = m_wheelBuckets[i][j];
+                buckets[event.step & (nBuckets - 1)].push_back(event);
+            }
+        }
+        m_wheelBuckets.swap(buckets);
+    }
+
+    wheelEvent_t event = { idx, m_step + iStepOffset, m_step };
+    m_wheelBuckets[event.step & (m_wheelBuckets.size() - 1)].push_back(event);
+    m_nWheelEvents++;
+
+    __sync_lock_release(&m_wheelLock);
+}
+
+/*
+ * Move the events of the timing wheel that come within the bitmask into it.
+ *
+ * @param iStep        simulation steps advanced.
+ */
+void EventQueue::moveWheelEvents(int iStep)
+{
+    // the steps that have come within the bitmask
+    for (uint64_t step = m_step + LENGTH_OF_DELAYQUEUE - iStep; step < m_step + LENGTH_OF_DELAYQUEUE; step++) {
+        vector<wheelEvent_t> &bucket = m_wheelBuckets[step & (m_wheelBuckets.size() - 1)];
+        if (bucket.empty()) {
+            continue;
+        }
+
+        uint32_t idxQueue = m_idxQueue + static_cast<uint32_t>(step - m_step);
+        idxQueue = (idxQueue < LENGTH_OF_DELAYQUEUE) ? idxQueue : idxQueue - LENGTH_OF_DELAYQUEUE;
+
+        for (BGSIZE i = 0; i < bucket.size(); i++) {
+            BGSIZE idx = bucket[i].idx;
+            assert( bucket[i].step == step );
+
+            // drop the events added before the queue was cleared
+            if (bucket[i].stepAdded < m_clearedStep[idx]) {
+                continue;
+            }
+
+            assert( !(m_queueEvent[idx] & (BGQUEUE_ELEMENT(0x1) << idxQueue)) );
+            m_queueEvent[idx] |= (BGQUEUE_ELEMENT(0x1) << idxQueue);
+
+            if (m_eventRecorded != NULL && m_eventRecorded[idx] == 0) {
+                m_eventRecorded[idx] = 1;
+                m_recordedEvents[m_nRecordedEvents++] = idx;
+            }
+        }
+
+        m_nWheelEvents -= bucket.size();
+        bucket.clear();
+    }
+}
+
+/*
+ * Add the state of the queue to a checkpoint: the bitmasks, the current
+ * time slot, the timing wheel and the recorded queue indexes.
+ * The sections are (type + 0) the bitmasks, (type + 1) the scalars,
+ * (type + 2) the steps when the queues were cleared, (type + 3) the sizes of
+ * the buckets of the timing wheel, (type + 4) the events of the buckets in
+ * bucket order, and (type + 5) the recorded queue indexes.
+ *
+ * @param writer   The checkpoint writer.
+ * @param type     Type of the first of the CHECKPOINT_QUEUE_SECTIONS sections of the queue.
+ * @param cluster  Index of the cluster of the sections.
+ */
+void EventQueue::checkpoint(CheckpointWriter &writer, uint32_t type, uint32_t cluster) const
+{
+    BGSIZE nBuckets = m_wheelBuckets.size();
+
+    writer.addArray(static_cast<checkpointSectionType>(type), cluster, m_queueEvent, m_nMaxEvent);
+
+    uint64_t *state = static_cast<uint64_t *>(writer.allocSection(static_cast<checkpointSectionType>(type + 1), cluster, sizeof(uint64_t), 5, 1));
+    state[0] = m_idxQueue;
+    state[1] = m_step;
+    state[2] = nBuckets;
+    state[3] = m_nWheelEvents;
+    state[4] = m_nRecordedEvents;
+
+    writer.addArray(static_cast<checkpointSectionType>(type + 2), cluster, m_clearedStep, m_clearedStep != NULL ? m_nMaxEvent : 0);
+
+    BGSIZE *bucketSizes = static_cast<BGSIZE *>(writer.allocSection(static_cast<checkpointSectionType>(type + 3), cluster, sizeof(BGSIZE), nBuckets, 1));
+    wheelEvent_t *events = static_cast<wheelEvent_t *>(writer.allocSection(static_cast<checkpointSectionType>(type + 4), cluster, sizeof(wheelEvent_t), m_nWheelEvents, 1));
+    for (BGSIZE i = 0; i < nBuckets; i++) {
+        bucketSizes[i] = m_wheelBuckets[i].size();
+        events = copy(m_wheelBuckets[i].begin(), m_wheelBuckets[i].end(), events);
+    }
+
+    writer.addArray(static_cast<checkpointSectionType>(type + 5), cluster, m_recordedEvents, m_nRecordedEvents);
+}
+
+/*
+ * Restore the state of the queue from a checkpoint.
+ *
+ * @param reader   The checkpoint reader.
+ * @param type     Type of the first of the CHECKPOINT_QUEUE_SECTIONS sections of the queue.
+ * @param cluster  Index of the cluster of the sections.
+ * @return true if successful, false if the sections are missing or do not match the queue.
+ */
+bool EventQueue::restore(const CheckpointReader &reader, uint32_t type, uint32_t cluster)
+{
+    uint64_t state[5];
+
+    if (!reader.restoreArray(static_cast<checkpointSectionType>(type), cluster, m_queueEvent, m_nMaxEvent)
+            || !reader.restoreArray(static_cast<checkpointSectionType>(type + 1), cluster, state, 5)) {
+        return false;
+    }
+
+    BGSIZE nBuckets = state[2];
+    BGSIZE nWheelEvents = state[3];
+    BGSIZE nRecordedEvents = state[4];
+    vector<BGSIZE> bucketSizes(nBuckets);
+    vector<wheelEvent_t> events(nWheelEvents);
+    vector<BGSIZE> recordedEvents(nRecordedEvents);
+
+    if (!reader.restoreArray(static_cast<checkpointSectionType>(type + 2), cluster, m_clearedStep, m_clearedStep != NULL ? m_nMaxEvent : 0)
+            || !reader.restoreArray(static_cast<checkpointSectionType>(type + 3), cluster, bucketSizes.data(), nBuckets)
+            || !reader.restoreArray(static_cast<checkpointSectionType>(type + 4), cluster, events.data(), nWheelEvents)
+            || !reader.restoreArray(static_cast<checkpointSectionType>(type + 5), cluster, recordedEvents.data(), nRecordedEvents)) {
+        return false;
+    }
+    if ((nWheelEvents != 0 && !m_timingWheel) || (nRecordedEvents != 0 && m_eventRecorded == NULL)) {
+        cerr << "The event queue of the checkpoint uses the timing wheel or the event recording, but the queue does not" << endl;
+        return false;
+    }
+
+    m_idxQueue = state[0];
+    m_step = state[1];
+
+    m_wheelBuckets.assign(nBuckets, vector<wheelEvent_t>());
+    vector<wheelEvent_t>::const_iterator event = events.begin();
+    for (BGSIZE i = 0; i < nBuckets; i++) {
+        if (bucketSizes[i] > static_cast<BGSIZE>(events.end() - event)) {
+            cerr << "The timing wheel of the checkpoint is corrupted" << endl;
+            return false;
+        }
+        m_wheelBuckets[i].assign(event, event + bucketSizes[i]);
+        event += bucketSizes[i];
+    }
+    m_nWheelEvents = nWheelEvents;
+
+    if (m_eventRecorded != NULL) {
+        fill_n(m_eventRecorded, m_nMaxEvent, 0);
+        for (BGSIZE i = 0; i < nRecordedEvents; i++) {
+            m_recordedEvents[i] = recordedEvents[i];
+            m_eventRecorded[recordedEvents[i]] = 1;
+        }
+        m_nRecordedEvents = nRecordedEvents;
+    }
+
+    return true;
 }
 
 #else // USE_GPU
@@ -111,7 +377,7 @@ __host__ void EventQueue::initEventQueue(CLUSTER_INDEX_TYPE clusterID, BGSIZE nM
 
     // allocate & initialize a memory for the event queue
     m_nMaxEvent = nMaxEvent;
-    m_queueEvent = new BGQUEUE_ELEMENT[nMaxEvent];
+    m_queueEvent = new BGQUEUE_ELEMENT[nMaxEvent]();
 
     // initialize a memory for the inter clusters outgoing event queue
     m_nMaxInterClustersOutgoingEvents = nMaxInterClustersOutgoingEvents;
@@ -163,6 +429,19 @@ CUDA_CALLABLE void EventQueue::addAnEvent(const BGSIZE idx, const CLUSTER_INDEX_
     } else {
         // Add to event queue
 
+#if !defined(USE_GPU)
+        if (m_timingWheel) {
+            // key the event by the step it arrives at
+            if (m_delays != NULL) {
+                iStepOffset += m_delays[idx];
+            }
+            if (static_cast<uint32_t>(iStepOffset) >= LENGTH_OF_DELAYQUEUE) {
+                addAWheelEvent(idx, iStepOffset);
+                return;
+            }
+        }
+#endif // !USE_GPU
+
         // adjust offset
         uint32_t idxQueue = m_idxQueue + iStepOffset;
         idxQueue = (idxQueue < LENGTH_OF_DELAYQUEUE) ? idxQueue : idxQueue - LENGTH_OF_DELAYQUEUE;
@@ -184,6 +463,13 @@ CUDA_CALLABLE void EventQueue::addAnEvent(const BGSIZE idx, const CLUSTER_INDEX_
             newQueueEvent = currQueueEvent | (BGQUEUE_ELEMENT(0x1) << idxQueue);
             currQueueEvent = __sync_val_compare_and_swap(&m_queueEvent[idx], oldQueueEvent, newQueueEvent);
         } while (currQueueEvent != oldQueueEvent);
+
+#if !defined(USE_GPU)
+        // record the queue index (the first thread that sets the flag stores it)
+        if (m_eventRecorded != NULL && __sync_bool_compare_and_swap(&m_eventRecorded[idx], 0, 1)) {
+            m_recordedEvents[__sync_fetch_and_add(&m_nRecordedEvents, 1)] = idx;
+        }
+#endif // !USE_GPU
 #else // __CUDA_ARCH__
         // set a spike
         BGQUEUE_ELEMENT &queue = m_queueEvent[idx];
@@ -321,6 +607,12 @@ CUDA_CALLABLE void EventQueue::addAnEvent(const BGSIZE idx, const int delay, int
 {
 
     // Add to event queue
+#if !defined(USE_GPU)
+    if (m_timingWheel && static_cast<uint32_t>(delay + iStepOffset) >= LENGTH_OF_DELAYQUEUE) {
+        addAWheelEvent(idx, delay + iStepOffset);
+        return;
+    }
+#endif // !USE_GPU
     assert( static_cast<uint32_t>(delay + iStepOffset) < LENGTH_OF_DELAYQUEUE );
 
     // calculate index where to insert the event into queueEvent
@@ -372,6 +664,13 @@ CUDA_CALLABLE bool EventQueue::checkAnEvent(const BGSIZE idx, const int delay, i
     // calculate index where to check if there is an event
     assert( delay > iStepOffset );
     int idxQueue = m_idxQueue - delay + iStepOffset;
+#if !defined(USE_GPU)
+    if (m_delays != NULL) {
+        // the event is keyed by the step it arrives at
+        idxQueue = m_idxQueue + iStepOffset;
+        idxQueue = ( idxQueue < static_cast<int>(LENGTH_OF_DELAYQUEUE) ) ? idxQueue : idxQueue - LENGTH_OF_DELAYQUEUE;
+    }
+#endif // !USE_GPU
     idxQueue = ( idxQueue < 0 ) ? idxQueue + LENGTH_OF_DELAYQUEUE : idxQueue;
 
 #if !defined(USE_GPU)
@@ -411,6 +710,12 @@ CUDA_CALLABLE void EventQueue::clearAnEvent(const BGSIZE idx)
     BGQUEUE_ELEMENT &queue = m_queueEvent[idx];
 
     queue = 0;
+
+#if !defined(USE_GPU)
+    if (m_clearedStep != NULL) {
+        m_clearedStep[idx] = m_step;
+    }
+#endif // !USE_GPU
 }
 
 /*
@@ -422,6 +727,15 @@ CUDA_CALLABLE void EventQueue::advanceEventQueue(int iStep)
 {
     m_idxQueue += iStep;
     m_idxQueue = (m_idxQueue < LENGTH_OF_DELAYQUEUE) ? m_idxQueue : m_idxQueue - LENGTH_OF_DELAYQUEUE;
+
+#if !defined(USE_GPU)
+    if (m_timingWheel) {
+        m_step += iStep;
+        if (m_nWheelEvents != 0) {
+            moveWheelEvents(iStep);
+        }
+    }
+#endif // !USE_GPU
 }
 
 /*
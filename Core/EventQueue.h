@@ -17,6 +17,12 @@
  ** where idx is the queue index of the collection and delay is the delay
  ** in simulation step when the event will be triggered. 
  **
+ ** Each event queue is a bitmask of LENGTH_OF_DELAYQUEUE time slots, so by
+ ** default an event must be triggered within LENGTH_OF_DELAYQUEUE steps.
+ ** On the host, enableTimingWheel() lifts this limit: events that are triggered
+ ** beyond the bitmask are kept in a timing wheel (one bucket per step) and are
+ ** moved into the bitmask by advanceEventQueue() when they come within it.
+ **
  ** \latexonly  \subsubsection*{Credits} \endlatexonly
  ** \htmlonly   <h3>Credits</h3> \endhtmlonly
  **
@@ -42,6 +48,17 @@ typedef struct {
     BGSIZE idxSyn;
     int iStepOffset;
 } interClustersIncomingEvents_t;
+
+#if !defined(USE_GPU)
+class CheckpointWriter;
+class CheckpointReader;
+
+typedef struct {
+    BGSIZE idx;
+    uint64_t step;      // step when the event is triggered
+    uint64_t stepAdded; // step when the event was added
+} wheelEvent_t;
+#endif // !USE_GPU
             
 class EventQueue
 {
@@ -66,6 +83,79 @@ class EventQueue
          */
         void initEventQueue(CLUSTER_INDEX_TYPE clusterID, BGSIZE nMaxEvent);
 
+        /**
+         * Start recording the queue indexes that receive events, so that
+         * the owner of the queue can find them without scanning all queues.
+         * Each index is recorded once until the recorded indexes are taken.
+         */
+        void enableEventRecording();
+
+        /**
+         * Take the queue indexes that received events since the last call,
+         * and reset the record. Must not run concurrently with addAnEvent().
+         *
+         * @param indexes  Vector to append the recorded queue indexes to.
+         */
+        void takeRecordedEvents(vector<BGSIZE> &indexes);
+
+        /**
+         * Keep the events that are triggered beyond LENGTH_OF_DELAYQUEUE steps
+         * in a timing wheel, so that delays are not limited by the bitmask.
+         *
+         * When delays is given, the events are keyed by the step they arrive at:
+         * addAnEvent(idx, clusterID, iStepOffset) adds the delay of the queue index,
+         * and checkAnEvent(idx, delay, iStepOffset) checks the current step.
+         *
+         * @param delays  The delay of each queue index descretized into time steps,
+         *                or NULL if the events are added with their delay.
+         */
+        void enableTimingWheel(const int *delays);
+
+        /**
+         * Checks if there are events in the queue (in the bitmask; the events in the
+         * timing wheel are recorded again when they are moved into the bitmask).
+         *
+         * @param idx The queue index of the collection.
+         * @return true if there are events.
+         */
+        bool hasEvents(const BGSIZE idx) const { return m_queueEvent[idx] != 0; }
+
+        /**
+         * Add the state of the queue to a checkpoint: the bitmasks, the current
+         * time slot, the timing wheel and the recorded queue indexes.
+         * @param writer   The checkpoint writer.
+         * @param type     Type of the first of the CHECKPOINT_QUEUE_SECTIONS sections of the queue.
+         * @param cluster  Index of the cluster of the sections.
+         */
+        void checkpoint(CheckpointWriter &writer, uint32_t type, uint32_t cluster) const;
+
+        /**
+         * Restore the state of the queue from a checkpoint.
+         * @param reader   The checkpoint reader.
+         * @param type     Type of the first of the CHECKPOINT_QUEUE_SECTIONS sections of the queue.
+         * @param cluster  Index of the cluster of the sections.
+         * @return true if successful, false if the sections are missing or do not match the queue.
+         */
+        bool restore(const CheckpointReader &reader, uint32_t type, uint32_t cluster);
+
+        /**
+         * Send the spike of a source neuron of the cluster to the synapses of another
+         * cluster: add it to the outbox of the event handler to the cluster
+         * (InterClustersEventHandler::addASpike()), instead of adding an event
+         * in the queue of the cluster for each of the synapses.
+         *
+         * @param iNeuron      Index of the source neuron in the cluster.
+         * @param clusterID    The cluster ID of the synapses.
+         * @param iStepOffset  offset from the current simulation step.
+         * @return false if the spike is not sent (the cluster is the one of the queue,
+         *         or the outbox has no room), and the events have to be added one by one.
+         */
+        bool addAnInterClustersSpike(int iNeuron, const CLUSTER_INDEX_TYPE clusterID, int iStepOffset)
+        {
+            return clusterID != m_clusterID && m_eventHandler != NULL
+                && m_eventHandler->addASpike(m_clusterID, clusterID, iNeuron, iStepOffset);
+        }
+
 #else // USE_GPU
         /**
          * Initializes the collection of queue in device memory.
@@ -202,6 +292,53 @@ class EventQueue
         //! Pointer to the InterClustersEventHandler.
         InterClustersEventHandler* m_eventHandler;
 
+#if !defined(USE_GPU)
+        //! Flags of the queue indexes that are recorded (NULL if the recording is disabled).
+        uint8_t* m_eventRecorded;
+
+        //! The recorded queue indexes.
+        BGSIZE* m_recordedEvents;
+
+        //! The number of recorded queue indexes.
+        BGSIZE m_nRecordedEvents;
+
+        /**
+         * Add an event in the timing wheel.
+         *
+         * @param idx          The queue index of the collection.
+         * @param iStepOffset  offset from the current time slot when the event will be triggered.
+         */
+        void addAWheelEvent(const BGSIZE idx, uint32_t iStepOffset);
+
+        /**
+         * Move the events of the timing wheel that come within the bitmask into it.
+         *
+         * @param iStep        simulation steps advanced.
+         */
+        void moveWheelEvents(int iStep);
+
+        //! True if the events beyond the bitmask are kept in the timing wheel.
+        bool m_timingWheel;
+
+        //! The delay of each queue index when the events are keyed by arrival (NULL otherwise).
+        const int* m_delays;
+
+        //! The simulation step of the current time slot (counted from the initialization).
+        uint64_t m_step;
+
+        //! Buckets of the timing wheel (the bucket of an event is its step modulo the number of buckets).
+        vector< vector<wheelEvent_t> > m_wheelBuckets;
+
+        //! The number of events in the timing wheel.
+        BGSIZE m_nWheelEvents;
+
+        //! The step when each queue was cleared, to drop the events of the timing wheel added before.
+        uint64_t* m_clearedStep;
+
+        //! Lock of the timing wheel.
+        volatile int m_wheelLock;
+#endif // !USE_GPU
+
 #if defined(USE_GPU)
 
     public:
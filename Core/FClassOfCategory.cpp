@@ -17,6 +17,9 @@
 #include "FixedLayout.h"
 #include "DynamicLayout.h"
 #include "ParseParamError.h"
+#if !defined(USE_GPU)
+#include "SpecializedCluster.h"
+#endif // !USE_GPU
 #include <typeinfo>
 
 // Part of the stopgap approach for selecting model types, until parameter file selection
@@ -51,6 +54,18 @@ FClassOfCategory::FClassOfCategory() :
     // register layout classes    
     registerLayout("FixedLayout", &FixedLayout::Create);
     registerLayout("DynamicLayout", &DynamicLayout::Create);
+
+#if !defined(USE_GPU)
+    // register the clusters specialized for the pairs of neurons and synapses classes
+    registerCluster("AllLIFNeurons", "AllSpikingSynapses", &SpecializedCluster<AllLIFNeurons, AllSpikingSynapses>::Create);
+    registerCluster("AllLIFNeurons", "AllDSSynapses", &SpecializedCluster<AllLIFNeurons, AllDSSynapses>::Create);
+    registerCluster("AllLIFNeurons", "AllSTDPSynapses", &SpecializedCluster<AllLIFNeurons, AllSTDPSynapses>::Create);
+    registerCluster("AllLIFNeurons", "AllDynamicSTDPSynapses", &SpecializedCluster<AllLIFNeurons, AllDynamicSTDPSynapses>::Create);
+    registerCluster("AllIZHNeurons", "AllSpikingSynapses", &SpecializedCluster<AllIZHNeurons, AllSpikingSynapses>::Create);
+    registerCluster("AllIZHNeurons", "AllDSSynapses", &SpecializedCluster<AllIZHNeurons, AllDSSynapses>::Create);
+    registerCluster("AllIZHNeurons", "AllSTDPSynapses", &SpecializedCluster<AllIZHNeurons, AllSTDPSynapses>::Create);
+    registerCluster("AllIZHNeurons", "AllDynamicSTDPSynapses", &SpecializedCluster<AllIZHNeurons, AllDynamicSTDPSynapses>::Create);
+#endif // !USE_GPU
 }
 
 /*
@@ -62,6 +77,7 @@ FClassOfCategory::~FClassOfCategory()
     m_FactoryMapSynapses.clear();
     m_FactoryMapConns.clear();
     m_FactoryMapLayout.clear();
+    m_FactoryMapCluster.clear();
 }
 
 /*
@@ -108,6 +124,19 @@ void FClassOfCategory::registerLayout(const string &layoutClassName, CreateLayou
     m_FactoryMapLayout[layoutClassName] = pfnCreateLayout;
 }
 
+/*
+ *  Register a cluster specialized for a pair of neurons and synapses classes
+ *  and its creation function to the factory.
+ *
+ *  @param  neuronsClassName   neurons class name.
+ *  @param  synapsesClassName  synapses class name.
+ *  @param  pfnCreateCluster   Pointer to the cluster creation function.
+ */
+void FClassOfCategory::registerCluster(const string &neuronsClassName, const string &synapsesClassName, CreateClusterFn pfnCreateCluster)
+{
+    m_FactoryMapCluster[neuronsClassName + "/" + synapsesClassName] = pfnCreateCluster;
+}
+
 /*
  * Create an instance of the neurons class, which is specified in the parameter file.
  *
@@ -186,6 +215,23 @@ IAllSynapses* FClassOfCategory::createSynapses()
     return synapses;
 }
 
+/*
+ * Create a cluster specialized for the neurons and synapses classes of the
+ * parameter file (see SpecializedCluster.h), if one is registered for them.
+ *
+ * @param  neurons   The neurons of the cluster.
+ * @param  synapses  The synapses of the cluster.
+ * @return Poiner to the cluster object, or NULL if the pair of classes is
+ *         not registered (the generic cluster is used then).
+ */
+Cluster* FClassOfCategory::createCluster(IAllNeurons *neurons, IAllSynapses *synapses)
+{
+    FactoryMapCluster::iterator it = m_FactoryMapCluster.find(m_neuronsClassName + "/" + m_synapsesClassName);
+    if (it != m_FactoryMapCluster.end())
+        return it->second(neurons, synapses);
+    return NULL;
+}
+
 /*
  * Create an instance of the connections class, which is specified in the parameter file.
  *
@@ -40,6 +40,8 @@
 #include "Connections.h"
 #include "Layout.h"
 
+class Cluster;
+
 class FClassOfCategory : public TiXmlVisitor
 {
 public:
@@ -85,6 +87,17 @@ public:
      */
     IAllSynapses* createSynapses();
 
+    /**
+     * Create a cluster specialized for the neurons and synapses classes of the
+     * parameter file (see SpecializedCluster.h), if one is registered for them.
+     *
+     * @param  neurons   The neurons of the cluster.
+     * @param  synapses  The synapses of the cluster.
+     * @return Poiner to the cluster object, or NULL if the pair of classes is
+     *         not registered (the generic cluster is used then).
+     */
+    Cluster* createCluster(IAllNeurons *neurons, IAllSynapses *synapses);
+
     /**
      * Create an instance of the connections class, which is specified in the parameter file.
      *
@@ -151,11 +164,13 @@ private:
     typedef IAllSynapses* (*CreateSynapsesFn)(void);
     typedef Connections* (*CreateConnsFn)(void);
     typedef Layout* (*CreateLayoutFn)(void);
+    typedef Cluster* (*CreateClusterFn)(IAllNeurons *, IAllSynapses *);
 
     typedef map<string, CreateNeuronsFn> FactoryMapNeurons;
     typedef map<string, CreateSynapsesFn> FactoryMapSynapses;
     typedef map<string, CreateConnsFn> FactoryMapConns;
     typedef map<string, CreateLayoutFn> FactoryMapLayout;
+    typedef map<string, CreateClusterFn> FactoryMapCluster;
 
     //! neurons class name, class creation function map
     FactoryMapNeurons m_FactoryMapNeurons;
@@ -169,6 +184,9 @@ private:
     //! layout class name, class creation function map
     FactoryMapLayout m_FactoryMapLayout;
 
+    //! "neurons/synapses" class names, specialized cluster creation function map
+    FactoryMapCluster m_FactoryMapCluster;
+
     /**
      *  Register neurons class and its creation function to the factory.
      *
@@ -201,6 +219,16 @@ private:
      */
     void registerLayout(const string &layoutClassName, CreateLayoutFn pfnCreateLayout);
 
+    /**
+     *  Register a cluster specialized for a pair of neurons and synapses classes
+     *  and its creation function to the factory.
+     *
+     *  @param  neuronsClassName   neurons class name.
+     *  @param  synapsesClassName  synapses class name.
+     *  @param  pfnCreateCluster   Pointer to the cluster creation function.
+     */
+    void registerCluster(const string &neuronsClassName, const string &synapsesClassName, CreateClusterFn pfnCreateCluster);
+
     /**
      * Create an instance of the neurons class, which name is specified by neuronsClassName.
      *
@@ -139,6 +139,27 @@ class IModel {
          */
         virtual void updateHistory(const SimulationInfo *sim_info) = 0;
 
+#if !defined(USE_GPU)
+        /**
+         *  Add the state of the network, the connections, the recorder and
+         *  the stimulus input to a periodic checkpoint.
+         *
+         *  @param  writer      The checkpoint writer.
+         *  @param  sim_info    SimulationInfo to refer from.
+         */
+        virtual void checkpoint(CheckpointWriter &writer, const SimulationInfo *sim_info) const = 0;
+
+        /**
+         *  Restore the state of the network, the connections, the recorder and
+         *  the stimulus input from a periodic checkpoint.
+         *
+         *  @param  reader      The checkpoint reader.
+         *  @param  sim_info    SimulationInfo to refer from.
+         *  @return true if successful, false otherwise.
+         */
+        virtual bool restore(const CheckpointReader &reader, SimulationInfo *sim_info) = 0;
+#endif // !USE_GPU
+
 #if defined(PERFORMANCE_METRICS)
         /**
          *  Print performance metrics statistics
@@ -3,6 +3,9 @@
 
 InterClustersEventHandler::InterClustersEventHandler() : m_vtEventQueue(NULL)
 {
+#if !defined(USE_GPU)
+    m_nClusters = 0;
+#endif // !USE_GPU
 }
 
 InterClustersEventHandler::~InterClustersEventHandler()
@@ -20,6 +23,14 @@ InterClustersEventHandler::~InterClustersEventHandler()
 void InterClustersEventHandler::initEventHandler(const int size)
 {
     m_vtEventQueue = new vector<EventQueue *>(size);
+
+#if !defined(USE_GPU)
+    m_nClusters = size;
+    m_outboxes.resize(size * size);
+    for (size_t i = 0; i < m_outboxes.size(); i++) {
+        m_outboxes[i].nSpikes = 0;
+    }
+#endif // !USE_GPU
 }
 
 /*
@@ -51,3 +62,41 @@ void InterClustersEventHandler::addAnEvent(const BGSIZE idx, const CLUSTER_INDEX
 #endif // USE_GPU
 }
 
+#if !defined(USE_GPU)
+/*
+ * Make room in the outbox of a cluster to another cluster for a number of spikes.
+ * Must not run concurrently with addASpike().
+ *
+ * @param srcClusterID  Cluster ID of the source neurons.
+ * @param dstClusterID  Cluster ID of the synapses.
+ * @param nMaxSpikes    The maximum number of spikes in a synaptic transmission delay window.
+ */
+void InterClustersEventHandler::reserveSpikes(const CLUSTER_INDEX_TYPE srcClusterID, const CLUSTER_INDEX_TYPE dstClusterID, BGSIZE nMaxSpikes)
+{
+    spikeOutbox_t &outbox = m_outboxes.at(srcClusterID * m_nClusters + dstClusterID);
+    assert( outbox.nSpikes == 0 );
+
+    // the outbox only grows, since the network is grown and rarely pruned
+    if (nMaxSpikes > outbox.spikes.size()) {
+        outbox.spikes.resize(nMaxSpikes);
+    }
+}
+
+/*
+ * Take the spikes of the outbox of a cluster to another cluster, and empty it.
+ * The spikes are valid until the next call to addASpike() or reserveSpikes().
+ *
+ * @param srcClusterID  Cluster ID of the source neurons.
+ * @param dstClusterID  Cluster ID of the synapses.
+ * @param nSpikes       The number of spikes (output).
+ * @return pointer to the spikes.
+ */
+const interClustersSpike_t* InterClustersEventHandler::takeSpikes(const CLUSTER_INDEX_TYPE srcClusterID, const CLUSTER_INDEX_TYPE dstClusterID, BGSIZE &nSpikes)
+{
+    spikeOutbox_t &outbox = m_outboxes[srcClusterID * m_nClusters + dstClusterID];
+    nSpikes = outbox.nSpikes;
+    outbox.nSpikes = 0;
+
+    return outbox.spikes.data();
+}
+#endif // !USE_GPU
@@ -16,6 +16,18 @@
  ** cluser, the function calls InterClustersEventHandler::addAnEvent() and the event will be added to
  ** the event queue of clusterID specified by the parameter.
  **
+ ** On the host, the spikes of the neurons are exchanged between the clusters instead of
+ ** the events of the synapses. A neuron that fires adds a spike to the outbox of its
+ ** cluster for each other cluster where it has outgoing synapses (addASpike()), once,
+ ** instead of an event in the remote queue of each of these synapses, so that the clusters
+ ** don't write the queues of each other during the synaptic transmission delay window.
+ ** After the window, each cluster takes the spikes of the outboxes addressed to it
+ ** (takeSpikes()) and adds the events to the queues of its synapses from the source neurons
+ ** (SynapseIndexMap::remoteSynapseIndexMap). The spikes can wait until then because
+ ** the window is not longer than the minimum synaptic transmission delay.
+ ** The outboxes are sized for every source neuron to fire at every step of the window
+ ** (reserveSpikes()); the events of a cluster whose outbox has no room are added one by one.
+ **
  ** \latexonly  \subsubsection*{Credits} \endlatexonly
  ** \htmlonly   <h3>Credits</h3> \endhtmlonly
  **
@@ -33,6 +45,13 @@
 
 class EventQueue;
 
+#if !defined(USE_GPU)
+typedef struct {
+    int iNeuron;        // index of the source neuron in its cluster
+    int iStepOffset;    // offset from the current simulation step when the neuron fired
+} interClustersSpike_t;
+#endif // !USE_GPU
+
 class InterClustersEventHandler
 {
     public:
@@ -66,7 +85,70 @@ class InterClustersEventHandler
          */
         void addAnEvent(const BGSIZE idx, const CLUSTER_INDEX_TYPE clusterID, int iStepOffset);
 
+#if !defined(USE_GPU)
+        /**
+         * Make room in the outbox of a cluster to another cluster for a number of spikes.
+         * Must not run concurrently with addASpike().
+         *
+         * @param srcClusterID  Cluster ID of the source neurons.
+         * @param dstClusterID  Cluster ID of the synapses.
+         * @param nMaxSpikes    The maximum number of spikes in a synaptic transmission delay window.
+         */
+        void reserveSpikes(const CLUSTER_INDEX_TYPE srcClusterID, const CLUSTER_INDEX_TYPE dstClusterID, BGSIZE nMaxSpikes);
+
+        /**
+         * Add a spike in the outbox of a cluster to another cluster.
+         *
+         * @param srcClusterID  Cluster ID of the source neuron.
+         * @param dstClusterID  Cluster ID of the synapses.
+         * @param iNeuron       Index of the source neuron in its cluster.
+         * @param iStepOffset   offset from the current simulation step.
+         * @return false if the outbox has no room for the spike.
+         */
+        bool addASpike(const CLUSTER_INDEX_TYPE srcClusterID, const CLUSTER_INDEX_TYPE dstClusterID, int iNeuron, int iStepOffset)
+        {
+            spikeOutbox_t &outbox = m_outboxes[srcClusterID * m_nClusters + dstClusterID];
+            if (outbox.spikes.empty()) {
+                return false;
+            }
+
+            // the threads of a cluster add the spikes concurrently
+            BGSIZE i = __sync_fetch_and_add(&outbox.nSpikes, 1);
+            assert( i < outbox.spikes.size() );
+            outbox.spikes[i].iNeuron = iNeuron;
+            outbox.spikes[i].iStepOffset = iStepOffset;
+
+            return true;
+        }
+
+        /**
+         * Take the spikes of the outbox of a cluster to another cluster, and empty it.
+         * The spikes are valid until the next call to addASpike() or reserveSpikes().
+         *
+         * @param srcClusterID  Cluster ID of the source neurons.
+         * @param dstClusterID  Cluster ID of the synapses.
+         * @param nSpikes       The number of spikes (output).
+         * @return pointer to the spikes.
+         */
+        const interClustersSpike_t* takeSpikes(const CLUSTER_INDEX_TYPE srcClusterID, const CLUSTER_INDEX_TYPE dstClusterID, BGSIZE &nSpikes);
+#endif // !USE_GPU
+
     private:
         //! Vector to store pointers to each cluster's EventQueue.
         std::vector<EventQueue *> *m_vtEventQueue; 
+
+#if !defined(USE_GPU)
+        //! The outbox of a cluster to another cluster (padded so that the outboxes of the clusters don't share a cache line).
+        typedef struct {
+            std::vector<interClustersSpike_t> spikes;
+            BGSIZE nSpikes;
+            char padding[64 - sizeof(std::vector<interClustersSpike_t>) - sizeof(BGSIZE)];
+        } spikeOutbox_t;
+
+        //! The number of clusters.
+        CLUSTER_INDEX_TYPE m_nClusters;
+
+        //! The outboxes, indexed by the source cluster ID * m_nClusters + the destination cluster ID.
+        std::vector<spikeOutbox_t> m_outboxes;
+#endif // !USE_GPU
 };
@@ -6,8 +6,13 @@
 #include "Util.h"
 #include "ConnGrowth.h"
 #include "ISInput.h"
+#include "Checkpoint.h"
+#include "Partitioner.h"
 #if defined(USE_GPU)
 #include "GPUSpikingCluster.h"
+#else // USE_GPU
+#include "AxonalSpikeRings.h"
+#include "NumaTopology.h"
 #endif
 
 /*
@@ -45,11 +50,182 @@ Model::~Model()
  */
 void Model::saveData(SimulationInfo *sim_info)
 {
+#if !defined(USE_GPU)
+    // the synapses of ConnGrowth are created by the growth updates, after the report of setupClusters()
+    if (m_vtClr.size() > 1 && dynamic_cast<ConnGrowth*>(m_conns) != NULL) {
+        printPartitionReport();
+    }
+#endif // !USE_GPU
+
     if (sim_info->simRecorder != NULL) {
         sim_info->simRecorder->saveSimData(m_vtClr, m_vtClrInfo);
     }
 }
 
+#if !defined(USE_GPU)
+/*
+ *  Partition the neurons among the clusters with the partitioner of the simulation
+ *  (SimConfig partitioner), and renumber them so that each cluster gets a contiguous
+ *  range of layout indices. The partition is computed on the connections estimated
+ *  before they are set up, and reported with the contiguous ranges for comparison.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ */
+void Model::partitionNeurons(SimulationInfo *sim_info)
+{
+    int num_neurons = sim_info->totalNeurons;
+    int nClusters = m_vtClrInfo.size();
+
+    vector<vector<int> > sources;
+    m_conns->estimateConnections(sim_info, m_layout, sources);
+
+    // the contiguous ranges (as createAllModelClassInstances() makes them)
+    vector<int> order(num_neurons);
+    vector<int> partSizes(nClusters, num_neurons / nClusters);
+    for (int i = 0; i < num_neurons; i++) {
+        order[i] = i;
+    }
+    partSizes[nClusters - 1] = num_neurons - (num_neurons / nClusters) * (nClusters - 1);
+    Partitioner::printReport(cout, "contiguous (estimated)", sources, order, partSizes);
+
+    Partitioner *partitioner = Partitioner::create(sim_info->partitioner);
+    partitioner->partition(m_layout, sources, nClusters, order, partSizes);
+    string name = string(partitioner->getName()) + " (estimated)";
+    Partitioner::printReport(cout, name.c_str(), sources, order, partSizes);
+    delete partitioner;
+
+    m_layout->renumberNeurons(order);
+
+    int clusterNeuronsBegin = 0;
+    for (int i = 0; i < nClusters; i++) {
+        m_vtClrInfo[i]->clusterNeuronsBegin = clusterNeuronsBegin;
+        m_vtClrInfo[i]->totalClusterNeurons = partSizes[i];
+        clusterNeuronsBegin += partSizes[i];
+    }
+}
+
+/*
+ *  Prints out the number of synapses between the neurons of different clusters,
+ *  and the work imbalance of the clusters (neurons and synapses).
+ *  Nothing is printed while there are no synapses.
+ */
+void Model::printPartitionReport() const
+{
+    uint64_t totalSynapses = 0, cutSynapses = 0, maxWork = 0, totalWork = 0;
+
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < m_vtClr.size(); iCluster++) {
+        AllSynapses *synapses = dynamic_cast<AllSynapses*>(m_vtClr[iCluster]->m_synapses);
+        AllSynapsesProps *pSynapsesProps = synapses->m_pSynapsesProps;
+        int clusterNeuronsBegin = m_vtClrInfo[iCluster]->clusterNeuronsBegin;
+        int totalClusterNeurons = m_vtClrInfo[iCluster]->totalClusterNeurons;
+
+        uint64_t clusterSynapses = 0;
+        BGSIZE maxTotalSynapses = pSynapsesProps->maxSynapsesPerNeuron * totalClusterNeurons;
+        for (BGSIZE iSyn = 0; iSyn < maxTotalSynapses; iSyn++) {
+            if (!pSynapsesProps->in_use[iSyn]) {
+                continue;
+            }
+            int src_neuron = pSynapsesProps->sourceNeuronLayoutIndex[iSyn];
+            if (src_neuron < clusterNeuronsBegin || src_neuron >= clusterNeuronsBegin + totalClusterNeurons) {
+                cutSynapses++;
+            }
+            clusterSynapses++;
+        }
+
+        totalSynapses += clusterSynapses;
+        totalWork += totalClusterNeurons + clusterSynapses;
+        maxWork = max(maxWork, totalClusterNeurons + clusterSynapses);
+    }
+
+    if (totalSynapses == 0) {
+        return;
+    }
+    cout << "Clusters: " << cutSynapses << " of " << totalSynapses << " synapses cut ("
+        << 100.0 * cutSynapses / totalSynapses << "%), work imbalance "
+        << static_cast<double>(maxWork) * m_vtClr.size() / totalWork << endl;
+}
+
+/*
+ *  Count the NUMA nodes of sampled pages of an array.
+ *
+ *  @param  array       The array.
+ *  @param  size        Size of the array in bytes.
+ *  @param  nodePages   Number of sampled pages per node, the last entry counts the
+ *                      pages whose node is unknown.
+ */
+static void countPageNodes(const void *array, size_t size, vector<int> &nodePages)
+{
+    const size_t nSamples = 64;
+    if (array == NULL || size == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < nSamples; i++) {
+        int node = NumaTopology::getPageNode(static_cast<const char*>(array) + size / nSamples * i);
+        if (node < 0 || node >= static_cast<int>(nodePages.size()) - 1) {
+            node = nodePages.size() - 1;
+        }
+        nodePages[node]++;
+    }
+}
+
+/*
+ *  Prints out the CPUs the threads of each cluster are pinned to, and the NUMA nodes
+ *  of sampled pages of the neuron and synapse state of the cluster (including the
+ *  spike history, which is reallocated at the end of each epoch).
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ */
+void Model::printPlacementReport(const SimulationInfo *sim_info) const
+{
+    int nNodes = NumaTopology::getNumNodes();
+
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < m_vtClr.size(); iCluster++) {
+        AllNeuronsProps *pNeuronsProps = dynamic_cast<AllNeurons*>(m_vtClr[iCluster]->m_neurons)->m_pNeuronsProps;
+        AllSynapsesProps *pSynapsesProps = dynamic_cast<AllSynapses*>(m_vtClr[iCluster]->m_synapses)->m_pSynapsesProps;
+        int totalClusterNeurons = m_vtClrInfo[iCluster]->totalClusterNeurons;
+        BGSIZE maxTotalSynapses = pSynapsesProps->maxSynapsesPerNeuron * totalClusterNeurons;
+
+        vector<int> nodePages(nNodes + 1, 0);
+        countPageNodes(pNeuronsProps->summation_map, totalClusterNeurons * sizeof(BGFLOAT), nodePages);
+        countPageNodes(pSynapsesProps->W, maxTotalSynapses * sizeof(BGFLOAT), nodePages);
+        countPageNodes(pSynapsesProps->in_use, maxTotalSynapses * sizeof(bool), nodePages);
+        AllSpikingNeuronsProps *pSpikingProps = dynamic_cast<AllSpikingNeuronsProps*>(pNeuronsProps);
+        if (pSpikingProps != NULL) {
+            countPageNodes(pSpikingProps->spike_history, pSpikingProps->spikeHistoryAllocated * sizeof(uint32_t), nodePages);
+        }
+
+        vector<int> cpus = Cluster::getThreadCpus(sim_info, m_vtClrInfo[iCluster], 0);
+        cout << "Cluster " << static_cast<int>(iCluster) << ": " << (cpus.size() == 1 ? "CPU " : "CPUs ");
+        for (size_t i = 0; i < cpus.size(); i++) {
+            // print the runs of consecutive CPUs as ranges
+            size_t last = i;
+            while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1) {
+                last++;
+            }
+            cout << (i == 0 ? "" : ",") << cpus[i];
+            if (last > i) {
+                cout << "-" << cpus[last];
+            }
+            i = last;
+        }
+        if (sim_info->pinThreads == NODE_PINNING) {
+            cout << " (node " << Cluster::getClusterNode(sim_info, m_vtClrInfo[iCluster]) << ")";
+        }
+        cout << ", sampled state pages on";
+        for (int iNode = 0; iNode < nNodes; iNode++) {
+            if (nodePages[iNode] != 0) {
+                cout << " node " << iNode << ": " << nodePages[iNode];
+            }
+        }
+        if (nodePages[nNodes] != 0) {
+            cout << " unknown: " << nodePages[nNodes];
+        }
+        cout << endl;
+    }
+}
+#endif // !USE_GPU
+
 /*
  *  Creates all the Neurons and generates data for them.
  *
@@ -67,6 +243,16 @@ void Model::setupClusters(SimulationInfo *sim_info)
     m_layout->generateNeuronTypeMap(sim_info->totalNeurons);
     m_layout->initStarterMap(sim_info->totalNeurons);
 
+#if !defined(USE_GPU)
+    // renumber the neurons for a locality-aware partition among the clusters
+    if (sim_info->partitioner != CONTIGUOUS_PARTITION && m_vtClr.size() > 1) {
+        partitionNeurons(sim_info);
+    }
+    for (unsigned int i = 0; i < m_vtClrInfo.size(); i++) {
+        m_vtClrInfo[i]->originalNeuronIndex = m_layout->getOriginalIndices();
+    }
+#endif // !USE_GPU
+
 #ifdef PERFORMANCE_METRICS
     // Time to initialization (layout)
     t_host_initialization_layout += sim_info->short_timer.lap() / 1000000.0;
@@ -79,12 +265,36 @@ void Model::setupClusters(SimulationInfo *sim_info)
     m_eventHandler = new InterClustersEventHandler();
     m_eventHandler->initEventHandler(m_vtClr.size());
 
+#if !defined(USE_GPU)
+    // create the spike rings (allocated if the synapses use the ring spike delivery)
+    m_spikeRings = new AxonalSpikeRings();
+    m_spikeRings->initSpikeRings(sim_info->totalNeurons, sim_info->minSynapticTransDelay);
+#endif // !USE_GPU
+
     // setup each cluster
     for (unsigned int i = 0; i < m_vtClr.size(); i++) {
         m_vtClrInfo[i]->eventHandler = m_eventHandler;
+#if !defined(USE_GPU)
+        m_vtClrInfo[i]->spikeRings = m_spikeRings;
+#endif // !USE_GPU
 
         // creates all the Neurons and generates data for them in the cluster
+#if !defined(USE_GPU)
+        if (sim_info->pinThreads != NO_PINNING) {
+            // on a thread pinned like the advance thread of the cluster, so that the state of
+            // the cluster is first touched on its NUMA node (the thread is joined before the
+            // next cluster is set up, so that the random numbers are drawn in the same order)
+            std::thread thSetup([=]() {
+                Cluster::pinCurrentThread(sim_info, m_vtClrInfo[i], 0);
+                m_vtClr[i]->setupCluster(sim_info, m_layout, m_vtClrInfo[i]);
+            });
+            thSetup.join();
+        } else {
+            m_vtClr[i]->setupCluster(sim_info, m_layout, m_vtClrInfo[i]);
+        }
+#else // !USE_GPU
         m_vtClr[i]->setupCluster(sim_info, m_layout, m_vtClrInfo[i]);
+#endif // !USE_GPU
 
         // create advance threads
         m_vtClr[i]->createAdvanceThread(sim_info, m_vtClrInfo[i], m_vtClrInfo.size());
@@ -101,6 +311,15 @@ void Model::setupClusters(SimulationInfo *sim_info)
     // set up the connection of all the Neurons and Synapses of the simulation
     m_conns->setupConnections(sim_info, m_layout, m_vtClr, m_vtClrInfo);
 
+#if !defined(USE_GPU)
+    if (m_vtClr.size() > 1) {
+        printPartitionReport();
+    }
+    if (sim_info->pinThreads != NO_PINNING) {
+        printPlacementReport(sim_info);
+    }
+#endif // !USE_GPU
+
 #ifdef PERFORMANCE_METRICS
     // Time to initialization (connections)
     t_host_initialization_connections += sim_info->short_timer.lap() / 1000000.0;
@@ -145,6 +364,9 @@ void Model::cleanupSim(SimulationInfo *sim_info)
     m_conns->cleanupConnections();
 
     delete m_eventHandler;
+#if !defined(USE_GPU)
+    delete m_spikeRings;
+#endif // !USE_GPU
 }
 
 /*
@@ -240,6 +462,73 @@ void Model::updateHistory(const SimulationInfo *sim_info)
     }
 }
 
+#if !defined(USE_GPU)
+/*
+ *  Add the state of the network, the connections, the recorder and
+ *  the stimulus input to a periodic checkpoint.
+ *
+ *  @param  writer      The checkpoint writer.
+ *  @param  sim_info    SimulationInfo to refer from.
+ */
+void Model::checkpoint(CheckpointWriter &writer, const SimulationInfo *sim_info) const
+{
+    for (unsigned int i = 0; i < m_vtClr.size(); i++) {
+        m_vtClr[i]->checkpoint(writer, m_vtClrInfo[i]);
+    }
+
+    m_conns->checkpointState(writer);
+    m_layout->checkpoint(writer, sim_info->totalNeurons);
+
+    if (sim_info->simRecorder != NULL) {
+        sim_info->simRecorder->checkpoint(writer);
+    }
+
+    if (sim_info->pInput != NULL) {
+        sim_info->pInput->checkpoint(writer, m_vtClrInfo);
+    }
+}
+
+/*
+ *  Restore the state of the network, the connections, the recorder and
+ *  the stimulus input from a periodic checkpoint.
+ *  The epoch of the checkpoint must be in sim_info->currentStep.
+ *
+ *  @param  reader      The checkpoint reader.
+ *  @param  sim_info    SimulationInfo to refer from.
+ *  @return true if successful, false otherwise.
+ */
+bool Model::restore(const CheckpointReader &reader, SimulationInfo *sim_info)
+{
+    // the state of the neurons and synapses is indexed by layout index
+    if (!m_layout->restore(reader, sim_info->totalNeurons)) {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < m_vtClr.size(); i++) {
+        if (!m_vtClr[i]->restore(reader, m_vtClrInfo[i])) {
+            return false;
+        }
+    }
+
+    if (!m_conns->restoreState(reader)) {
+        return false;
+    }
+
+    if (sim_info->simRecorder != NULL && !sim_info->simRecorder->restore(reader)) {
+        return false;
+    }
+
+    if (sim_info->pInput != NULL && !sim_info->pInput->restore(reader, m_vtClrInfo)) {
+        return false;
+    }
+
+    // the synapse index maps are derived from the restored synapses
+    SynapseIndexMap::createSynapseImap(sim_info, m_vtClr, m_vtClrInfo);
+
+    return true;
+}
+#endif // !USE_GPU
+
 /*
  *  Get the Connections class object.
  *
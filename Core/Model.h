@@ -117,6 +117,27 @@ class Model : public IModel
          */
         virtual void updateHistory(const SimulationInfo *sim_info);
 
+#if !defined(USE_GPU)
+        /**
+         *  Add the state of the network, the connections, the recorder and
+         *  the stimulus input to a periodic checkpoint.
+         *
+         *  @param  writer      The checkpoint writer.
+         *  @param  sim_info    SimulationInfo to refer from.
+         */
+        virtual void checkpoint(CheckpointWriter &writer, const SimulationInfo *sim_info) const;
+
+        /**
+         *  Restore the state of the network, the connections, the recorder and
+         *  the stimulus input from a periodic checkpoint.
+         *
+         *  @param  reader      The checkpoint reader.
+         *  @param  sim_info    SimulationInfo to refer from.
+         *  @return true if successful, false otherwise.
+         */
+        virtual bool restore(const CheckpointReader &reader, SimulationInfo *sim_info);
+#endif // !USE_GPU
+
         /**
          * Advances network state one simulation step.
          *
@@ -194,6 +215,13 @@ class Model : public IModel
          */
         InterClustersEventHandler *m_eventHandler;
 
+#if !defined(USE_GPU)
+        /**
+         *  Pointer to the spike rings of the neurons.
+         */
+        AxonalSpikeRings *m_spikeRings;
+#endif // !USE_GPU
+
     protected:
         /**
          * Populate an instance of IAllNeurons with an initial state for each neuron.
@@ -202,4 +230,29 @@ class Model : public IModel
          */
         virtual void setupClusters(SimulationInfo *sim_info);
 
+#if !defined(USE_GPU)
+        /**
+         * Partition the neurons among the clusters with the partitioner of the simulation
+         * (SimConfig partitioner), and renumber them so that each cluster gets a contiguous
+         * range of layout indices.
+         *
+         * @param sim_info - parameters defining the simulation to be run with the given collection of neurons.
+         */
+        void partitionNeurons(SimulationInfo *sim_info);
+
+        /**
+         * Prints out the number of synapses between the neurons of different clusters,
+         * and the work imbalance of the clusters (neurons and synapses).
+         */
+        void printPartitionReport() const;
+
+        /**
+         * Prints out the CPUs the threads of each cluster are pinned to, and the NUMA nodes
+         * of sampled pages of the neuron and synapse state of the cluster (including the
+         * spike history, which is reallocated at the end of each epoch).
+         *
+         * @param sim_info - parameters defining the simulation to be run with the given collection of neurons.
+         */
+        void printPlacementReport(const SimulationInfo *sim_info) const;
+#endif // !USE_GPU
 };
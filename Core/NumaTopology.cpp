@@ -0,0 +1,139 @@
+#include "NumaTopology.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+// flags of get_mempolicy(2) (numaif.h is part of libnuma)
+#define MPOL_F_NODE_FLAG    (1 << 0)
+#define MPOL_F_ADDR_FLAG    (1 << 1)
+
+/*
+ *  Read the first line of a file of the sysfs.
+ *
+ *  @param  fileName   Name of the file.
+ *  @param  line       Buffer that receives the line.
+ *  @param  size       Size of the buffer.
+ *  @return true if the line has been read.
+ */
+static bool readSysfsLine(const char *fileName, char *line, int size)
+{
+    FILE *fp = fopen(fileName, "r");
+    if (fp == NULL) {
+        return false;
+    }
+    bool read = fgets(line, size, fp) != NULL;
+    fclose(fp);
+
+    return read;
+}
+
+/*
+ *  Get the number of NUMA nodes of the machine.
+ *
+ *  @return the number of nodes (at least 1).
+ */
+int NumaTopology::getNumNodes()
+{
+    char line[1024];
+    if (!readSysfsLine("/sys/devices/system/node/online", line, sizeof(line))) {
+        return 1;
+    }
+
+    // the nodes are numbered from 0, a hole in the list is an offline node
+    vector<int> nodes = parseCpuList(line);
+    int nNodes = 1;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i] + 1 > nNodes) {
+            nNodes = nodes[i] + 1;
+        }
+    }
+
+    return nNodes;
+}
+
+/*
+ *  Get the CPUs of a NUMA node.
+ *
+ *  @param  iNode    Index of the node.
+ *  @return the indexes of the CPUs of the node (all the CPUs if the node is unknown).
+ */
+vector<int> NumaTopology::getNodeCpus(int iNode)
+{
+    char fileName[128];
+    char line[4096];
+    snprintf(fileName, sizeof(fileName), "/sys/devices/system/node/node%d/cpulist", iNode);
+
+    vector<int> cpus;
+    if (readSysfsLine(fileName, line, sizeof(line))) {
+        cpus = parseCpuList(line);
+    }
+
+    if (cpus.empty()) {
+        int nCores = std::thread::hardware_concurrency();
+        for (int i = 0; i < (nCores > 0 ? nCores : 1); i++) {
+            cpus.push_back(i);
+        }
+    }
+
+    return cpus;
+}
+
+/*
+ *  Get the NUMA node of the page at an address.
+ *  The page must have been touched, otherwise it has no node yet.
+ *
+ *  @param  addr     Address in the page.
+ *  @return the index of the node, or -1 if it cannot be queried.
+ */
+int NumaTopology::getPageNode(const void *addr)
+{
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    int node = -1;
+    if (addr == NULL
+            || syscall(SYS_get_mempolicy, &node, NULL, 0, addr, MPOL_F_NODE_FLAG | MPOL_F_ADDR_FLAG) != 0) {
+        return -1;
+    }
+
+    return node;
+#else
+    return -1;
+#endif
+}
+
+/*
+ *  Parse a list of CPUs of the kernel (e.g. "0-3,8-11").
+ *
+ *  @param  list     The list of CPUs.
+ *  @return the indexes of the CPUs.
+ */
+vector<int> NumaTopology::parseCpuList(const char *list)
+{
+    vector<int> cpus;
+    const char *p = list;
+    while (*p != '\0') {
+        char *end;
+        long first = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long i = first; i <= last; i++) {
+            cpus.push_back(static_cast<int>(i));
+        }
+        if (*p != ',') {
+            break;
+        }
+        p++;
+    }
+
+    return cpus;
+}
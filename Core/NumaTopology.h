@@ -0,0 +1,73 @@
+/**
+ *      @file NumaTopology.h
+ *
+ *      @brief The NUMA nodes of the machine, their CPUs and the node of a page.
+ */
+
+/**
+ **
+ ** @class NumaTopology NumaTopology.h "NumaTopology.h"
+ **
+ ** \latexonly  \subsubsection*{Implementation} \endlatexonly
+ ** \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ **
+ ** The NumaTopology class reads the NUMA nodes of the machine and their CPUs
+ ** from /sys/devices/system/node, so that the cluster threads can be bound
+ ** to the CPUs of a node without linking libnuma. The memory of a cluster is
+ ** not bound explicitly: the kernel places a page on the node of the thread
+ ** that first touches it, so the state of a cluster lands on its node when it
+ ** is allocated and initialized by a thread bound to that node (see
+ ** Model::setupClusters()).
+ **
+ ** A machine without the sysfs node directory (or another platform) is seen
+ ** as a single node with all the CPUs.
+ **
+ ** \latexonly  \subsubsection*{Credits} \endlatexonly
+ ** \htmlonly   <h3>Credits</h3> \endhtmlonly
+ **
+ ** Some models in this simulator is a rewrite of CSIM (2006) and other
+ ** work (Stiber and Kawasaki (2007?))
+ **/
+
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+class NumaTopology
+{
+    public:
+        /**
+         *  Get the number of NUMA nodes of the machine.
+         *
+         *  @return the number of nodes (at least 1).
+         */
+        static int getNumNodes();
+
+        /**
+         *  Get the CPUs of a NUMA node.
+         *
+         *  @param  iNode    Index of the node.
+         *  @return the indexes of the CPUs of the node (all the CPUs if the node is unknown).
+         */
+        static vector<int> getNodeCpus(int iNode);
+
+        /**
+         *  Get the NUMA node of the page at an address.
+         *  The page must have been touched, otherwise it has no node yet.
+         *
+         *  @param  addr     Address in the page.
+         *  @return the index of the node, or -1 if it cannot be queried.
+         */
+        static int getPageNode(const void *addr);
+
+    private:
+        /**
+         *  Parse a list of CPUs of the kernel (e.g. "0-3,8-11").
+         *
+         *  @param  list     The list of CPUs.
+         *  @return the indexes of the CPUs.
+         */
+        static vector<int> parseCpuList(const char *list);
+};
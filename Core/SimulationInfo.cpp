@@ -136,10 +136,56 @@ bool SimulationInfo::VisitEnter(const TiXmlElement& element, const TiXmlAttribut
 	else if(element.ValueStr().compare("maxSynapsesPerNeuron") == 0){
 	    maxSynapsesPerNeuron = atoi(element.GetText());
 	}
+	else if(element.ValueStr().compare("spikeHistoryWindow") == 0){
+	    spikeHistoryWindow = atof(element.GetText());
+	}
+	else if(element.ValueStr().compare("minSynapticTransDelay") == 0){
+	    minSynapticTransDelay = atoi(element.GetText());
+	}
+	else if(element.ValueStr().compare("noiseGenerator") == 0){
+	    string noiseGenerator = element.GetText();
+	    if (noiseGenerator == "norm") {
+	        this->noiseGenerator = NORM_NOISE;
+	    } else if (noiseGenerator == "batch") {
+	        this->noiseGenerator = BATCH_NOISE;
+	    } else if (noiseGenerator == "counter") {
+	        this->noiseGenerator = COUNTER_NOISE;
+	    } else {
+	        throw ParseParamError("SimConfig noiseGenerator", "noiseGenerator must be norm, batch or counter.");
+	    }
+	}
+	else if(element.ValueStr().compare("advanceOrder") == 0){
+	    string advanceOrder = element.GetText();
+	    if (advanceOrder == "step") {
+	        blockedAdvance = false;
+	    } else if (advanceOrder == "blocked") {
+	        blockedAdvance = true;
+	    } else {
+	        throw ParseParamError("SimConfig advanceOrder", "advanceOrder must be step or blocked.");
+	    }
+	}
+	else if(element.ValueStr().compare("partitioner") == 0){
+	    string partitioner = element.GetText();
+	    if (partitioner == "contiguous") {
+	        this->partitioner = CONTIGUOUS_PARTITION;
+	    } else if (partitioner == "sfc") {
+	        this->partitioner = SFC_PARTITION;
+	    } else if (partitioner == "rcb") {
+	        this->partitioner = RCB_PARTITION;
+	    } else if (partitioner == "graph") {
+	        this->partitioner = GRAPH_PARTITION;
+	    } else {
+	        throw ParseParamError("SimConfig partitioner", "partitioner must be contiguous, sfc, rcb or graph.");
+	    }
+	}
 
-        if (maxFiringRate < 0 || maxSynapsesPerNeuron < 0) {
+        if (maxFiringRate < 0 || maxSynapsesPerNeuron < 0 || spikeHistoryWindow < 0) {
             throw ParseParamError("SimConfig", "Invalid negative SimConfig value.");
         }
+        // the event queues keep one bitmask of 64 steps
+        if (minSynapticTransDelay < 1 || minSynapticTransDelay > 64) {
+            throw ParseParamError("SimConfig minSynapticTransDelay", "minSynapticTransDelay must be between 1 and 64 steps.");
+        }
 
         return true;
     }
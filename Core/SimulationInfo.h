@@ -38,6 +38,15 @@ class ISInput;
 #include "Timer.h"
 #endif
 
+//! Generators of the noise of the neurons (see SimConfig noiseGenerator).
+enum noiseGeneratorType { NORM_NOISE = 0, BATCH_NOISE = 1, COUNTER_NOISE = 2 };
+
+//! Partitioners of the neurons among the clusters (see SimConfig partitioner).
+enum partitionerType { CONTIGUOUS_PARTITION = 0, SFC_PARTITION = 1, RCB_PARTITION = 2, GRAPH_PARTITION = 3 };
+
+//! Affinity of the cluster threads (see the -p command line option).
+enum threadPinningType { NO_PINNING = 0, CORE_PINNING = 1, NODE_PINNING = 2 };
+
 //! Class design to hold all of the parameters of the simulation.
 class SimulationInfo : public TiXmlVisitor
 {
@@ -51,11 +60,21 @@ public:
             epochDuration(0),
             maxFiringRate(0),
             maxSynapsesPerNeuron(0),
+            spikeHistoryWindow(DEFAULT_SPIKE_HISTORY_WINDOW),
             minSynapticTransDelay(MIN_SYNAPTIC_TRANS_DELAY), 
+            noiseGenerator(NORM_NOISE),
+            blockedAdvance(false),
+            partitioner(CONTIGUOUS_PARTITION),
             deltaT(DEFAULT_dt),
             maxRate(0),
 	    seed(0),
             numClusters(0),
+            numClusterThreads(1),
+            spinBarrier(false),
+            pinThreads(NO_PINNING),
+            checkpointInterval(0),
+            asyncRecorder(false),
+            specializedClusters(false),
             model(NULL),
             simRecorder(NULL),
             pInput(NULL)
@@ -117,9 +136,26 @@ public:
 	//! Maximum number of synapses per neuron. **Only used by GPU simulation.**
 	int maxSynapsesPerNeuron;
 
-        //! The synaptic transmission delay (minimum), descretized into time steps
+        //! Length (in seconds) of the spike history kept for every neuron beyond the current epoch.
+        BGFLOAT spikeHistoryWindow;
+
+        //! The synaptic transmission delay (minimum), descretized into time steps.
+        //! The clusters exchange spikes once per this number of steps.
         int minSynapticTransDelay;
 
+        //! Generator of the noise of the neurons (host only): a Norm per cluster, a BatchNorm
+        //! per cluster that draws the noise of all its neurons at once, or a counter-based
+        //! Philox that also draws the Poisson stimulus input.
+        noiseGeneratorType noiseGenerator;
+
+        //! True if the clusters advance each block of neurons and their incoming synapses
+        //! through all the steps of the synaptic transmission delay window at once (host only).
+        bool blockedAdvance;
+
+        //! Partitioner of the neurons among the clusters: contiguous ranges of the layout,
+        //! or a locality-aware partition, for which the neurons are renumbered (see Partitioner).
+        partitionerType partitioner;
+
 	//! Time elapsed between the beginning and end of the simulation step
 	BGFLOAT deltaT; // Inner Simulation Step Duration !!!!!!!!
 
@@ -132,6 +168,16 @@ public:
         //! Number of clusters.
         int numClusters;
 
+        //! Number of threads per cluster (a ThreadedCluster is used when greater than 1).
+        int numClusterThreads;
+
+        //! True if the cluster advance threads synchronize with a SpinBarrier instead of a Barrier.
+        bool spinBarrier;
+
+        //! Affinity of the cluster threads: none, a core per thread, or the CPUs
+        //! of the NUMA node of the cluster (where the cluster state is then placed).
+        threadPinningType pinThreads;
+
         //! File name of the simulation results.
         string stateOutputFileName;
 
@@ -147,6 +193,18 @@ public:
         //! File name of the stimulus input file.
         string stimulusInputFileName;
 
+        //! File name of the periodic checkpoint (the simulation resumes from it if it exists).
+        string checkpointFileName;
+
+        //! Number of epochs between two periodic checkpoints.
+        int checkpointInterval;
+
+        //! True if the recorder writes the histories of an epoch on a background thread during the next epoch.
+        bool asyncRecorder;
+
+        //! True if the single threaded clusters are specialized for the neurons and synapses classes (see SpecializedCluster.h).
+        bool specializedClusters;
+
         //! Neural Network Model interface.
         IModel *model;
 
@@ -8,6 +8,9 @@
  */
 
 #include "Simulator.h"
+#include "Checkpoint.h"
+#include <fstream>
+#include <sstream>
 
 /*
  *  Constructor
@@ -119,7 +122,8 @@ void Simulator::freeResources()
 void Simulator::simulate(SimulationInfo *sim_info)
 {
   // Main simulation loop - execute maxGrowthSteps
-  for (int currentStep = 1; currentStep <= sim_info->maxSteps; currentStep++) {
+  // (from the epoch after the checkpoint when the simulation is resumed)
+  for (int currentStep = sim_info->currentStep + 1; currentStep <= sim_info->maxSteps; currentStep++) {
 
     DEBUG(cout << endl << endl;)
       DEBUG(cout << "Performing simulation number " << currentStep << endl;)
@@ -154,6 +158,20 @@ void Simulator::simulate(SimulationInfo *sim_info)
 
     sim_info->model->updateHistory(sim_info);
 
+#if !defined(USE_GPU)
+    // Periodic checkpoint (not after the last epoch, the results are saved then);
+    // the run stops if it fails rather than going on without a valid checkpoint
+    // (the file is replaced only once written, so the previous checkpoint is kept)
+    if (sim_info->checkpointInterval > 0 && currentStep % sim_info->checkpointInterval == 0
+            && currentStep < sim_info->maxSteps) {
+      if (!checkpoint(sim_info)) {
+        cerr << "! ERROR: stopping the simulation, it can be resumed from the previous checkpoint of "
+             << sim_info->checkpointFileName << " if any" << endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+#endif // !USE_GPU
+
 #ifdef PERFORMANCE_METRICS
     // Times converted from microseconds to seconds
     // Time to update synapses
@@ -218,3 +236,111 @@ void Simulator::saveData(SimulationInfo *sim_info) const
 {
   sim_info->model->saveData(sim_info);
 }
+
+#if !defined(USE_GPU)
+/*
+ * Hash of the configuration that a periodic checkpoint depends on:
+ * the parameter file, the stimulus input file and the number of clusters.
+ *
+ *  @param  sim_info    parameters for the simulation.
+ *  @return the hash.
+ */
+uint64_t Simulator::getConfigHash(const SimulationInfo *sim_info) const
+{
+  uint64_t hash = checkpointChecksum(&sim_info->numClusters, sizeof(sim_info->numClusters));
+
+  const string *fileNames[] = { &sim_info->stateInputFileName, &sim_info->stimulusInputFileName };
+  for (int i = 0; i < 2; i++) {
+    if (fileNames[i]->empty()) {
+      continue;
+    }
+    ifstream file(fileNames[i]->c_str(), ios::binary);
+    stringstream contents;
+    contents << file.rdbuf();
+    string data = contents.str();
+    hash = checkpointChecksum(data.data(), data.size(), hash);
+  }
+
+  return hash;
+}
+
+/*
+ * Write a periodic checkpoint of the complete state of the simulation
+ * at the end of the current epoch to sim_info->checkpointFileName.
+ *
+ *  @param  sim_info    parameters for the simulation.
+ *  @return true if successful, false otherwise.
+ */
+bool Simulator::checkpoint(SimulationInfo *sim_info) const
+{
+  CheckpointWriter writer;
+
+  // simulation step, configuration, epoch and number of clusters
+  uint64_t run[4];
+  run[0] = g_simulationStep;
+  run[1] = getConfigHash(sim_info);
+  run[2] = sim_info->currentStep;
+  run[3] = sim_info->numClusters;
+  writer.addArray(CKPT_RUN, 0, run, 4);
+
+  rng.save(static_cast<uint32_t *>(writer.allocSection(CKPT_GLOBAL_RNG, 0, sizeof(uint32_t), MTRand::SAVE, 1)));
+
+  sim_info->model->checkpoint(writer, sim_info);
+
+  if (!writer.write(sim_info->checkpointFileName)) {
+    cerr << "Failed writing the checkpoint of epoch " << sim_info->currentStep << endl;
+    return false;
+  }
+
+  DEBUG(cout << "Checkpoint of epoch " << sim_info->currentStep << " written to "
+        << sim_info->checkpointFileName << endl;)
+  return true;
+}
+
+/*
+ * Resume the simulation from the periodic checkpoint in
+ * sim_info->checkpointFileName.
+ *
+ *  @param  sim_info    parameters for the simulation.
+ *  @return true if successful, false otherwise.
+ */
+bool Simulator::restore(SimulationInfo *sim_info)
+{
+  CheckpointReader reader;
+  if (!reader.open(sim_info->checkpointFileName)) {
+    return false;
+  }
+
+  uint64_t run[4];
+  if (!reader.restoreArray(CKPT_RUN, 0, run, 4)) {
+    return false;
+  }
+  if (run[1] != getConfigHash(sim_info) || run[3] != static_cast<uint64_t>(sim_info->numClusters)) {
+    cerr << "The checkpoint " << sim_info->checkpointFileName
+         << " was written with other parameters, stimulus input or number of clusters" << endl;
+    return false;
+  }
+  if (run[2] >= static_cast<uint64_t>(sim_info->maxSteps)) {
+    cerr << "The checkpoint " << sim_info->checkpointFileName << " is at epoch " << run[2]
+         << ", not before the last epoch " << sim_info->maxSteps << endl;
+    return false;
+  }
+
+  uint32_t rngState[MTRand::SAVE];
+  if (!reader.restoreArray(CKPT_GLOBAL_RNG, 0, rngState, MTRand::SAVE)) {
+    return false;
+  }
+  rng.load(rngState);
+
+  // the recorder restores the histories of the epochs up to the current one
+  g_simulationStep = run[0];
+  sim_info->currentStep = static_cast<int>(run[2]);
+
+  if (!sim_info->model->restore(reader, sim_info)) {
+    cerr << "Failed restoring the simulation state from " << sim_info->checkpointFileName << endl;
+    return false;
+  }
+
+  return true;
+}
+#endif // !USE_GPU
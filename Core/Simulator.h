@@ -95,7 +95,40 @@ class Simulator
          */
         void saveData(SimulationInfo *sim_info) const;
 
+#if !defined(USE_GPU)
+        /**
+         * Write a periodic checkpoint of the complete state of the simulation
+         * at the end of the current epoch to sim_info->checkpointFileName.
+         *
+         *  @param  sim_info    parameters for the simulation.
+         *  @return true if successful, false otherwise.
+         */
+        bool checkpoint(SimulationInfo *sim_info) const;
+
+        /**
+         * Resume the simulation from the periodic checkpoint in
+         * sim_info->checkpointFileName: restores the state of the simulation
+         * and sets the current epoch, so that #simulate() continues with the
+         * next epoch.
+         *
+         *  @param  sim_info    parameters for the simulation.
+         *  @return true if successful, false otherwise.
+         */
+        bool restore(SimulationInfo *sim_info);
+#endif // !USE_GPU
+
     private:
+#if !defined(USE_GPU)
+        /**
+         * Hash of the configuration that a periodic checkpoint depends on:
+         * the parameter file, the stimulus input file and the number of clusters.
+         *
+         *  @param  sim_info    parameters for the simulation.
+         *  @return the hash.
+         */
+        uint64_t getConfigHash(const SimulationInfo *sim_info) const;
+#endif // !USE_GPU
+
         /**
          * Frees dynamically allocated memory associated with the maps.
          */
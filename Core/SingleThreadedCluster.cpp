@@ -1,11 +1,19 @@
 #include "SingleThreadedCluster.h"
 #include "ISInput.h"
+#include "BatchNorm.h"
+#include "Philox.h"
+#include "Checkpoint.h"
+#include "AllNeurons.h"
+#include "AllSynapses.h"
+#include "AllSpikingNeurons.h"
+#include "AllSpikingSynapses.h"
 
 /*
  *  Constructor
  */
 SingleThreadedCluster::SingleThreadedCluster(IAllNeurons *neurons, IAllSynapses *synapses) :
-    Cluster(neurons, synapses)
+    Cluster(neurons, synapses),
+    m_blockedAdvance(false)
 {
 }
 
@@ -25,6 +33,18 @@ SingleThreadedCluster::~SingleThreadedCluster()
  */
 void SingleThreadedCluster::setupCluster(SimulationInfo *sim_info, Layout *layout, ClusterInfo *clr_info)
 {
+    // The noise buffer is allocated first, because the neurons keep a pointer to it.
+    if (sim_info->noiseGenerator == BATCH_NOISE) {
+        clr_info->batchNormRand = new BatchNorm(clr_info->seed + clr_info->clusterID);
+    }
+    // the counter-based generator does not depend on the cluster
+    if (sim_info->noiseGenerator == COUNTER_NOISE) {
+        clr_info->counterRand = new Philox(sim_info->seed);
+    }
+    if (sim_info->noiseGenerator != NORM_NOISE) {
+        clr_info->randNoise = new BGFLOAT[clr_info->totalClusterNeurons];
+    }
+
     Cluster::setupCluster(sim_info, layout, clr_info);
 
     // Create a normalized random number generator
@@ -33,6 +53,53 @@ void SingleThreadedCluster::setupCluster(SimulationInfo *sim_info, Layout *layou
 
     // Create a random number generator used in stimulus input (Poisson)
     clr_info->rng = new MTRand(clr_info->seed + clr_info->clusterID);
+
+    setupAdvanceOrder(sim_info, clr_info);
+}
+
+/*
+ *  Selects the order of the advance of the window (SimConfig advanceOrder):
+ *  the blocked advance when it is requested and gives the same results as
+ *  the step by step advance.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  clr_info    ClusterInfo class to read information from.
+ */
+void SingleThreadedCluster::setupAdvanceOrder(const SimulationInfo *sim_info, const ClusterInfo *clr_info)
+{
+    m_blockedAdvance = sim_info->blockedAdvance && canAdvanceBlocked(sim_info);
+
+    // the other configurations are advanced step by step
+    if (sim_info->blockedAdvance && !m_blockedAdvance && clr_info->clusterID == 0) {
+        cerr << "The blocked advanceOrder needs the batch or counter noiseGenerator, no stimulus input and synapses "
+             << "without back propagation or event driven advance; the clusters advance step by step." << endl;
+    }
+}
+
+/*
+ *  Checks if the cluster can advance its neurons in blocks through the window
+ *  with the same results as step by step.
+ *  Within the window, the spikes of a neuron only reach synapses after the window
+ *  (the delays are at least the length of the window), so a neuron only depends
+ *  on its incoming synapses, and these only on their own state, unless the noise
+ *  is drawn in the order of the neurons (norm), the stimulus input is applied
+ *  to all the neurons of the cluster at each step, the synapses read the spikes
+ *  of their source neurons (back propagation), or only the active synapses are
+ *  advanced (event driven).
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @return true if the blocked advance gives the same results.
+ */
+bool SingleThreadedCluster::canAdvanceBlocked(const SimulationInfo *sim_info) const
+{
+    AllSpikingSynapses *synapses = dynamic_cast<AllSpikingSynapses*>(m_synapses);
+    if (synapses == NULL || dynamic_cast<AllSpikingNeurons*>(m_neurons) == NULL) {
+        return false;
+    }
+
+    return sim_info->noiseGenerator != NORM_NOISE && sim_info->pInput == NULL
+            && !dynamic_cast<AllSpikingSynapsesProps*>(synapses->m_pSynapsesProps)->eventDrivenAdvance
+            && !synapses->allowBackPropagation();
 }
 
 /*
@@ -46,6 +113,14 @@ void SingleThreadedCluster::cleanupCluster(SimulationInfo *sim_info, ClusterInfo
     // delete a normalized random number generator
     delete clr_info->normRand;
 
+    // delete the batch and counter noise generators and their buffer
+    delete clr_info->batchNormRand;
+    delete clr_info->counterRand;
+    delete[] clr_info->randNoise;
+    clr_info->batchNormRand = NULL;
+    clr_info->counterRand = NULL;
+    clr_info->randNoise = NULL;
+
     // delete a random number generator used in stimulus input (Poisson)
     delete clr_info->rng;
 
@@ -75,9 +150,44 @@ void SingleThreadedCluster::genRandNumbers(const SimulationInfo *sim_info, Clust
  */
 void SingleThreadedCluster::advanceNeurons(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset)
 {
+    genRandNoise(clr_info, iStepOffset);
     m_neurons->advanceNeurons(*m_synapses, sim_info, m_synapseIndexMap, clr_info, iStepOffset);
 }
 
+/*
+ * Draws the noise of all the neurons of the cluster for the current step
+ * into clr_info->randNoise, with the batch or counter noise generator.
+ * Does nothing if the cluster draws the noise from normRand.
+ *
+ * @param clr_info - ClusterInfo to refer.
+ * @param iStepOffset - offset from the current simulation step.
+ */
+void SingleThreadedCluster::genRandNoise(ClusterInfo *clr_info, int iStepOffset)
+{
+    if (clr_info->batchNormRand != NULL) {
+        clr_info->batchNormRand->fill(clr_info->randNoise, clr_info->totalClusterNeurons);
+    } else if (clr_info->counterRand != NULL) {
+        genCounterNoise(clr_info, g_simulationStep + iStepOffset, 0, clr_info->totalClusterNeurons);
+    }
+}
+
+/*
+ * Draws the noise of the neurons in a range for a simulation step into
+ * clr_info->randNoise, with the counter noise generator. The noise of
+ * a neuron only depends on the seed, its original index and the step.
+ *
+ * @param clr_info - ClusterInfo to refer.
+ * @param simulationStep - the simulation step.
+ * @param iNeuronBegin - index of the first neuron of the range.
+ * @param iNeuronEnd - index after the last neuron of the range.
+ */
+void SingleThreadedCluster::genCounterNoise(ClusterInfo *clr_info, uint64_t simulationStep, int iNeuronBegin, int iNeuronEnd)
+{
+    for (int iNeuron = iNeuronBegin; iNeuron < iNeuronEnd; iNeuron++) {
+        clr_info->randNoise[iNeuron] = clr_info->counterRand->normal(PHILOX_STREAM_NOISE, clr_info->getOriginalNeuronIndex(iNeuron), simulationStep);
+    }
+}
+
 /*
  * Process outgoing spiking data between clusters.
  *
@@ -85,15 +195,41 @@ void SingleThreadedCluster::advanceNeurons(const SimulationInfo *sim_info, Clust
  */
 void SingleThreadedCluster::processInterClustesOutgoingSpikes(ClusterInfo *clr_info)
 {
+    // the spikes to the other clusters are already in the outboxes of the event handler
 }
 
 /*
- * Process incoming spiking data between clusters.
+ * Process incoming spiking data between clusters: add the events of the spikes
+ * that the other clusters have sent to the cluster to the queues of its synapses
+ * from the source neurons.
  *
  * @param  clr_info  ClusterInfo to refer.
  */
 void SingleThreadedCluster::processInterClustesIncomingSpikes(ClusterInfo *clr_info)
 {
+    InterClustersEventHandler *eventHandler = clr_info->eventHandler;
+    if (eventHandler == NULL || m_synapseIndexMap == NULL || m_synapseIndexMap->remoteSourceBegin.empty()) {
+        return;
+    }
+
+    AllSpikingSynapses *synapses = dynamic_cast<AllSpikingSynapses*>(m_synapses);
+    CLUSTER_INDEX_TYPE nClusters = m_synapseIndexMap->remoteSourceBegin.size() - 1;
+    for (CLUSTER_INDEX_TYPE iSrcCluster = 0; iSrcCluster < nClusters; iSrcCluster++) {
+        if (iSrcCluster == clr_info->clusterID) {
+            continue;
+        }
+
+        BGSIZE nSpikes;
+        const interClustersSpike_t *spikes = eventHandler->takeSpikes(iSrcCluster, clr_info->clusterID, nSpikes);
+        for (BGSIZE i = 0; i < nSpikes; i++) {
+            BGSIZE synapse_counts;
+            const BGSIZE *remoteMap_begin = m_synapseIndexMap->findRemoteSynapses(iSrcCluster, spikes[i].iNeuron, synapse_counts);
+            assert( remoteMap_begin != NULL );
+            for (BGSIZE j = 0; j < synapse_counts; j++) {
+                synapses->preSpikeHit(remoteMap_begin[j], clr_info->clusterID, spikes[i].iStepOffset);
+            }
+        }
+    }
 }
 
 /*
@@ -110,6 +246,96 @@ void SingleThreadedCluster::advanceSynapses(const SimulationInfo *sim_info, Clus
     m_synapses->advanceSynapses(sim_info, m_neurons, m_synapseIndexMap, iStepOffset);
 }
 
+/*
+ * Advances the neurons and synapses of the cluster through the steps of
+ * the synaptic transmission delay window. In the blocked advance, each block
+ * of neurons and their incoming synapses goes through all the steps of the
+ * window before the next block, while their state is in the cache.
+ *
+ * @param sim_info - SimulationInfo class to read information from.
+ * @param clr_info - ClusterInfo class to read information from.
+ * @param nSteps   - number of steps of the window.
+ */
+void SingleThreadedCluster::advanceWindow(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps)
+{
+    if (!m_blockedAdvance) {
+        Cluster::advanceWindow(sim_info, clr_info, nSteps);
+        return;
+    }
+
+    genWindowNoise(clr_info, nSteps);
+
+    int totalNeurons = clr_info->totalClusterNeurons;
+    for (int iNeuronBegin = 0; iNeuronBegin < totalNeurons; iNeuronBegin += NEURONS_PER_BLOCK) {
+        advanceBlock(sim_info, clr_info, nSteps, iNeuronBegin, min(iNeuronBegin + NEURONS_PER_BLOCK, totalNeurons));
+    }
+}
+
+/*
+ * Draws the batch noise of all the neurons of the cluster for all the
+ * steps of the window, in the order of the step by step advance.
+ * The counter noise is drawn by block, since it does not depend on the order.
+ *
+ * @param clr_info - ClusterInfo to refer.
+ * @param nSteps   - number of steps of the window.
+ */
+void SingleThreadedCluster::genWindowNoise(ClusterInfo *clr_info, int nSteps)
+{
+    if (clr_info->batchNormRand == NULL) {
+        return;
+    }
+
+    int totalNeurons = clr_info->totalClusterNeurons;
+    m_windowNoise.resize(static_cast<size_t>(nSteps) * totalNeurons);
+    for (int iStepOffset = 0; iStepOffset < nSteps; iStepOffset++) {
+        clr_info->batchNormRand->fill(m_windowNoise.data() + static_cast<size_t>(iStepOffset) * totalNeurons, totalNeurons);
+    }
+}
+
+/*
+ * Puts the noise of the neurons of a block for a step of the window into
+ * clr_info->randNoise (from the window noise or the counter noise generator).
+ *
+ * @param clr_info     - ClusterInfo to refer.
+ * @param iStepOffset  - offset from the current simulation step.
+ * @param iNeuronBegin - index of the first neuron of the block.
+ * @param iNeuronEnd   - index after the last neuron of the block.
+ */
+void SingleThreadedCluster::genBlockNoise(ClusterInfo *clr_info, int iStepOffset, int iNeuronBegin, int iNeuronEnd)
+{
+    if (clr_info->batchNormRand != NULL) {
+        const BGFLOAT *noise = m_windowNoise.data() + static_cast<size_t>(iStepOffset) * clr_info->totalClusterNeurons;
+        copy(noise + iNeuronBegin, noise + iNeuronEnd, clr_info->randNoise + iNeuronBegin);
+    } else if (clr_info->counterRand != NULL) {
+        genCounterNoise(clr_info, g_simulationStep + iStepOffset, iNeuronBegin, iNeuronEnd);
+    }
+}
+
+/*
+ * Advances a block of neurons and their incoming synapses through all the
+ * steps of the window.
+ *
+ * @param sim_info     - SimulationInfo class to read information from.
+ * @param clr_info     - ClusterInfo class to read information from.
+ * @param nSteps       - number of steps of the window.
+ * @param iNeuronBegin - index of the first neuron of the block.
+ * @param iNeuronEnd   - index after the last neuron of the block.
+ */
+void SingleThreadedCluster::advanceBlock(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps, int iNeuronBegin, int iNeuronEnd)
+{
+    AllSpikingNeurons *neurons = static_cast<AllSpikingNeurons*>(m_neurons);
+    AllSynapses *synapses = static_cast<AllSynapses*>(m_synapses);
+
+    for (int iStepOffset = 0; iStepOffset < nSteps; iStepOffset++) {
+        genBlockNoise(clr_info, iStepOffset, iNeuronBegin, iNeuronEnd);
+        neurons->advanceNeurons(*m_synapses, sim_info, m_synapseIndexMap, iStepOffset, iNeuronBegin, iNeuronEnd, clr_info->normRand);
+
+        if (m_synapseIndexMap != NULL) {
+            synapses->advanceSynapses(sim_info, m_neurons, m_synapseIndexMap, iStepOffset, iNeuronBegin, iNeuronEnd);
+        }
+    }
+}
+
 /*
  * Advances synapses spike event queue state of the cluster.
  *
@@ -154,3 +380,65 @@ void SingleThreadedCluster::copyCPUSynapseToGPUCluster(SimulationInfo *sim_info,
    cerr << "ERROR: SingleThreadedCluster::copyCPUSynapseToGPUCluster() was called." << endl;
    exit(EXIT_FAILURE);
 }
+
+#if !defined(USE_GPU)
+/*
+ *  Add the state of the cluster (neurons, synapses, spike queues and
+ *  random number generators) to a periodic checkpoint.
+ *  The counter noise generator has no state, and the noise buffer is
+ *  drawn again at every step.
+ *
+ *  @param  writer      The checkpoint writer.
+ *  @param  clr_info    ClusterInfo to refer.
+ */
+void SingleThreadedCluster::checkpoint(CheckpointWriter &writer, const ClusterInfo *clr_info) const
+{
+    int iCluster = clr_info->clusterID;
+
+    dynamic_cast<AllNeurons *>(m_neurons)->m_pNeuronsProps->checkpointState(writer, iCluster);
+    dynamic_cast<AllSynapses *>(m_synapses)->checkpointState(writer, iCluster);
+
+    clr_info->normRand->save(static_cast<uint32_t *>(writer.allocSection(CKPT_NORM_RAND, iCluster, sizeof(uint32_t), Norm::SAVE, 1)));
+    if (clr_info->batchNormRand != NULL) {
+        clr_info->batchNormRand->save(static_cast<uint32_t *>(writer.allocSection(CKPT_BATCH_NORM_RAND, iCluster, sizeof(uint32_t), BatchNorm::SAVE, 1)));
+    }
+    clr_info->rng->save(static_cast<uint32_t *>(writer.allocSection(CKPT_SINPUT_RNG, iCluster, sizeof(uint32_t), MTRand::SAVE, 1)));
+}
+
+/*
+ *  Restore the state of the cluster from a periodic checkpoint.
+ *  The synapse index map must be recreated afterwards.
+ *
+ *  @param  reader      The checkpoint reader.
+ *  @param  clr_info    ClusterInfo to refer.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool SingleThreadedCluster::restore(const CheckpointReader &reader, ClusterInfo *clr_info)
+{
+    int iCluster = clr_info->clusterID;
+
+    if (!dynamic_cast<AllNeurons *>(m_neurons)->m_pNeuronsProps->restoreState(reader, iCluster)
+            || !dynamic_cast<AllSynapses *>(m_synapses)->restoreState(reader, iCluster, clr_info)) {
+        return false;
+    }
+
+    uint32_t normState[Norm::SAVE];
+    uint32_t rngState[MTRand::SAVE];
+    if (!reader.restoreArray(CKPT_NORM_RAND, iCluster, normState, Norm::SAVE)
+            || !reader.restoreArray(CKPT_SINPUT_RNG, iCluster, rngState, MTRand::SAVE)) {
+        return false;
+    }
+    clr_info->normRand->load(normState);
+    clr_info->rng->load(rngState);
+
+    if (clr_info->batchNormRand != NULL) {
+        uint32_t batchState[BatchNorm::SAVE];
+        if (!reader.restoreArray(CKPT_BATCH_NORM_RAND, iCluster, batchState, BatchNorm::SAVE)) {
+            return false;
+        }
+        clr_info->batchNormRand->load(batchState);
+    }
+
+    return true;
+}
+#endif // !USE_GPU
@@ -43,6 +43,8 @@
  * work (Stiber and Kawasaki (2007?))
  */
 
+#pragma once
+
 #include "Cluster.h"
 
 class SingleThreadedCluster : public Cluster {
@@ -128,6 +130,18 @@ class SingleThreadedCluster : public Cluster {
          */
         virtual void advanceSynapses(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset);
 
+        /**
+         * Advances the neurons and synapses of the cluster through the steps of
+         * the synaptic transmission delay window. In the blocked advance, each block
+         * of neurons and their incoming synapses goes through all the steps of the
+         * window before the next block.
+         *
+         * @param sim_info    SimulationInfo class to read information from.
+         * @param clr_info    ClusterInfo class to read information from.
+         * @param nSteps      Number of steps of the window.
+         */
+        virtual void advanceWindow(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps);
+
         /**
          * Advances synapses spike event queue state of the cluster one simulation step.
          *
@@ -137,4 +151,111 @@ class SingleThreadedCluster : public Cluster {
          * @param iStep       simulation step to advance.
          */
         virtual void advanceSpikeQueue(const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iStep);
+
+        /**
+         * Selects the order of the advance of the window (SimConfig advanceOrder):
+         * the blocked advance when it is requested and gives the same results as
+         * the step by step advance.
+         *
+         * @param sim_info    SimulationInfo class to read information from.
+         * @param clr_info    ClusterInfo class to read information from.
+         */
+        void setupAdvanceOrder(const SimulationInfo *sim_info, const ClusterInfo *clr_info);
+
+#if !defined(USE_GPU)
+        /**
+         *  Add the state of the cluster (neurons, synapses, spike queues and
+         *  random number generators) to a periodic checkpoint.
+         *
+         *  @param  writer      The checkpoint writer.
+         *  @param  clr_info    ClusterInfo to refer.
+         */
+        virtual void checkpoint(CheckpointWriter &writer, const ClusterInfo *clr_info) const;
+
+        /**
+         *  Restore the state of the cluster from a periodic checkpoint.
+         *  The synapse index map must be recreated afterwards.
+         *
+         *  @param  reader      The checkpoint reader.
+         *  @param  clr_info    ClusterInfo to refer.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restore(const CheckpointReader &reader, ClusterInfo *clr_info);
+#endif // !USE_GPU
+
+    protected:
+        /**
+         * Draws the noise of all the neurons of the cluster for the current step
+         * into clr_info->randNoise, with the batch or counter noise generator.
+         * Does nothing if the cluster draws the noise from normRand.
+         *
+         * @param clr_info    ClusterInfo to refer.
+         * @param iStepOffset  offset from the current simulation step.
+         */
+        virtual void genRandNoise(ClusterInfo *clr_info, int iStepOffset);
+
+        /**
+         * Draws the noise of the neurons in a range for a simulation step into
+         * clr_info->randNoise, with the counter noise generator. The noise of
+         * a neuron only depends on the seed, its original index and the step.
+         *
+         * @param clr_info        ClusterInfo to refer.
+         * @param simulationStep  the simulation step.
+         * @param iNeuronBegin    index of the first neuron of the range.
+         * @param iNeuronEnd      index after the last neuron of the range.
+         */
+        static void genCounterNoise(ClusterInfo *clr_info, uint64_t simulationStep, int iNeuronBegin, int iNeuronEnd);
+
+        /**
+         * Checks if the cluster can advance its neurons in blocks through the window
+         * with the same results as step by step: the noise must not depend on the
+         * order of the neurons (batch or counter noise), and a neuron and its incoming
+         * synapses must not read the state of other neurons of the window
+         * (no stimulus input, no back propagation, no event driven advance).
+         *
+         * @param sim_info    SimulationInfo class to read information from.
+         * @return true if the blocked advance gives the same results.
+         */
+        bool canAdvanceBlocked(const SimulationInfo *sim_info) const;
+
+        /**
+         * Draws the batch noise of all the neurons of the cluster for all the
+         * steps of the window, in the order of the step by step advance.
+         *
+         * @param clr_info    ClusterInfo to refer.
+         * @param nSteps      Number of steps of the window.
+         */
+        void genWindowNoise(ClusterInfo *clr_info, int nSteps);
+
+        /**
+         * Puts the noise of the neurons of a block for a step of the window into
+         * clr_info->randNoise (from the window noise or the counter noise generator).
+         *
+         * @param clr_info      ClusterInfo to refer.
+         * @param iStepOffset   offset from the current simulation step.
+         * @param iNeuronBegin  index of the first neuron of the block.
+         * @param iNeuronEnd    index after the last neuron of the block.
+         */
+        void genBlockNoise(ClusterInfo *clr_info, int iStepOffset, int iNeuronBegin, int iNeuronEnd);
+
+        /**
+         * Advances a block of neurons and their incoming synapses through all the
+         * steps of the window.
+         *
+         * @param sim_info      SimulationInfo class to read information from.
+         * @param clr_info      ClusterInfo class to read information from.
+         * @param nSteps        Number of steps of the window.
+         * @param iNeuronBegin  index of the first neuron of the block.
+         * @param iNeuronEnd    index after the last neuron of the block.
+         */
+        virtual void advanceBlock(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps, int iNeuronBegin, int iNeuronEnd);
+
+        //! Number of neurons per block of the blocked advance.
+        static const int NEURONS_PER_BLOCK = 16;
+
+        //! True if the cluster advances its neurons in blocks through the window.
+        bool m_blockedAdvance;
+
+        //! The batch noise of the steps of the window (steps x neurons) in the blocked advance.
+        vector<BGFLOAT> m_windowNoise;
 };
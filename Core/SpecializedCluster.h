@@ -0,0 +1,311 @@
+/**
+ *      @file SpecializedCluster.h
+ *
+ *      @brief Cluster compiled for a fixed pair of neuron and synapse classes.
+ */
+
+/**
+ *
+ * @class SpecializedCluster SpecializedCluster.h "SpecializedCluster.h"
+ *
+ * \latexonly  \subsubsection*{Implementation} \endlatexonly
+ * \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ *
+ * The SingleThreadedCluster advances the neurons and synapses through the
+ * IAllNeurons and IAllSynapses interfaces: every step casts the neurons,
+ * synapses and their properties to their classes, and every neuron and
+ * synapse update is a virtual call.
+ *
+ * A SpecializedCluster is a SingleThreadedCluster instantiated for a
+ * neuron class and a synapse class known at compile time. The classes are
+ * resolved once, when the cluster is created, and the step calls the
+ * advanceNeuronsBatch(), preSpikeHit(), postSpikeHit(), advanceSynapse()
+ * and advanceSpikeQueue() of these classes directly instead of through the
+ * virtual tables (the calls that these functions make, e.g. changePSR(),
+ * are still virtual). The loops themselves are the ones of the
+ * generic advance (AllSpikingNeurons::notifyFiredNeurons(),
+ * AllSynapses::advanceIncomingSynapses() and
+ * AllSpikingSynapses::advanceEventDriven()), so the results are the same.
+ * The blocked advance (SimConfig advanceOrder) runs the same range functions
+ * for each block of neurons.
+ *
+ * The pairs are registered in FClassOfCategory, which creates a specialized
+ * cluster for the neuron and synapse classes of the parameter file when one
+ * is registered for them. The specialized clusters are only used with -x yes:
+ * since the inner calls stay virtual, they are not measurably faster than
+ * the generic advance (see Benchmarks/ClusterBench.cpp), which the other
+ * runs, the other pairs and the threaded clusters use.
+ */
+
+#pragma once
+
+#include "SingleThreadedCluster.h"
+#include "AllSpikingNeurons.h"
+#include "AllSpikingSynapses.h"
+#include "ISInput.h"
+
+template <class NeuronsT, class SynapsesT>
+class SpecializedCluster : public SingleThreadedCluster {
+    public:
+        // Constructor & Destructor
+        SpecializedCluster(IAllNeurons *neurons, IAllSynapses *synapses);
+        ~SpecializedCluster();
+
+        /**
+         *  Creates a specialized cluster for the neurons and synapses.
+         *
+         *  @param  neurons     The neurons of the cluster (of class NeuronsT).
+         *  @param  synapses    The synapses of the cluster (of class SynapsesT).
+         *  @return Pointer to the cluster.
+         */
+        static Cluster *Create(IAllNeurons *neurons, IAllSynapses *synapses) { return new SpecializedCluster(neurons, synapses); }
+
+        /**
+         * Advances neurons network state of the cluster one simulation step.
+         *
+         * @param sim_info   parameters defining the simulation to be run with
+         *                   the given collection of neurons.
+         * @param clr_info   ClusterInfo to refer.
+         * @param iStepOffset  offset from the current simulation step.
+         */
+        virtual void advanceNeurons(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset);
+
+        /**
+         * Advances synapses network state of the cluster one simulation step.
+         *
+         * @param sim_info   parameters defining the simulation to be run with
+         *                   the given collection of neurons.
+         * @param clr_info  ClusterInfo to refer.
+         * @param iStepOffset  offset from the current simulation step.
+         */
+        virtual void advanceSynapses(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset);
+
+        /**
+         * Advances synapses spike event queue state of the cluster one simulation step.
+         *
+         * @param sim_info    parameters defining the simulation to be run with
+         *                    the given collection of neurons.
+         * @param clr_info    ClusterInfo to refer.
+         * @param iStep       simulation step to advance.
+         */
+        virtual void advanceSpikeQueue(const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iStep);
+
+    protected:
+        /**
+         * Advances a block of neurons and their incoming synapses through all the
+         * steps of the window.
+         *
+         * @param sim_info      SimulationInfo class to read information from.
+         * @param clr_info      ClusterInfo class to read information from.
+         * @param nSteps        Number of steps of the window.
+         * @param iNeuronBegin  index of the first neuron of the block.
+         * @param iNeuronEnd    index after the last neuron of the block.
+         */
+        virtual void advanceBlock(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps, int iNeuronBegin, int iNeuronEnd);
+
+    private:
+        /**
+         * Advances the neurons in a range one simulation step, and notifies
+         * the synapses of the neurons that have fired.
+         *
+         * @param sim_info      SimulationInfo class to read information from.
+         * @param clr_info      ClusterInfo to refer.
+         * @param iStepOffset   offset from the current simulation step.
+         * @param iNeuronBegin  index of the first neuron of the range.
+         * @param iNeuronEnd    index after the last neuron of the range.
+         */
+        void advanceNeurons(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset, int iNeuronBegin, int iNeuronEnd);
+
+        /**
+         * Advances the incoming synapses of the neurons in a range one simulation step.
+         *
+         * @param sim_info      SimulationInfo class to read information from.
+         * @param iStepOffset   offset from the current simulation step.
+         * @param iNeuronBegin  index of the first destination neuron of the range.
+         * @param iNeuronEnd    index after the last destination neuron of the range.
+         */
+        void advanceSynapses(const SimulationInfo *sim_info, int iStepOffset, BGSIZE iNeuronBegin, BGSIZE iNeuronEnd);
+
+
+        //! The neurons of the cluster.
+        NeuronsT *m_typedNeurons;
+
+        //! The synapses of the cluster.
+        SynapsesT *m_typedSynapses;
+};
+
+/*
+ *  Constructor
+ *  The neurons and synapses must be of the classes of the cluster.
+ *
+ *  @param  neurons     The neurons of the cluster.
+ *  @param  synapses    The synapses of the cluster.
+ */
+template <class NeuronsT, class SynapsesT>
+SpecializedCluster<NeuronsT, SynapsesT>::SpecializedCluster(IAllNeurons *neurons, IAllSynapses *synapses) :
+    SingleThreadedCluster(neurons, synapses),
+    m_typedNeurons(dynamic_cast<NeuronsT*>(neurons)),
+    m_typedSynapses(dynamic_cast<SynapsesT*>(synapses))
+{
+    assert( m_typedNeurons != NULL && m_typedSynapses != NULL );
+}
+
+/*
+ *  Destructor
+ */
+template <class NeuronsT, class SynapsesT>
+SpecializedCluster<NeuronsT, SynapsesT>::~SpecializedCluster()
+{
+}
+
+/*
+ * Advances neurons network state of the cluster one simulation step.
+ *
+ * @param sim_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param clr_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param iStepOffset - offset from the current simulation step.
+ */
+template <class NeuronsT, class SynapsesT>
+void SpecializedCluster<NeuronsT, SynapsesT>::advanceNeurons(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset)
+{
+    genRandNoise(clr_info, iStepOffset);
+    advanceNeurons(sim_info, clr_info, iStepOffset, 0, clr_info->totalClusterNeurons);
+}
+
+/*
+ * Advances the neurons in a range one simulation step, and notifies
+ * the synapses of the neurons that have fired.
+ *
+ * @param sim_info     - SimulationInfo class to read information from.
+ * @param clr_info     - ClusterInfo to refer.
+ * @param iStepOffset  - offset from the current simulation step.
+ * @param iNeuronBegin - index of the first neuron of the range.
+ * @param iNeuronEnd   - index after the last neuron of the range.
+ */
+template <class NeuronsT, class SynapsesT>
+void SpecializedCluster<NeuronsT, SynapsesT>::advanceNeurons(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset, int iNeuronBegin, int iNeuronEnd)
+{
+    NeuronsT *neurons = m_typedNeurons;
+    SynapsesT *synapses = m_typedSynapses;
+    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
+    const BGFLOAT deltaT = sim_info->deltaT;
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
+    AllSpikingNeuronsProps *pNeuronsProps = static_cast<AllSpikingNeuronsProps*>(neurons->m_pNeuronsProps);
+    AllSpikingSynapsesProps *pSynapsesProps = static_cast<AllSpikingSynapsesProps*>(synapses->m_pSynapsesProps);
+
+    // advance neurons
+    neurons->NeuronsT::advanceNeuronsBatch(iNeuronBegin, iNeuronEnd, maxSpikes, deltaT, simulationStep, clr_info->normRand);
+
+    // notify the synapses of the neurons that have fired
+    neurons->notifyFiredNeurons(iNeuronBegin, iNeuronEnd, pNeuronsProps->hasFired, pNeuronsProps->spikeCount, maxSpikes, deltaT, simulationStep, m_synapseIndexMap,
+                                synapses->m_pSynapsesProps->total_synapse_counts != 0, synapses->SynapsesT::allowBackPropagation(),
+                                pSynapsesProps->spikeRings, pSynapsesProps->spikeRingsBegin,
+                                [=](BGSIZE iSyn, CLUSTER_INDEX_TYPE iCluster) { synapses->SynapsesT::preSpikeHit(iSyn, iCluster, iStepOffset); },
+                                [=](int iNeuron, CLUSTER_INDEX_TYPE iCluster) { return synapses->preSpikeHitCluster(iNeuron, iCluster, iStepOffset); },
+                                [=](BGSIZE iSyn) { synapses->SynapsesT::postSpikeHit(iSyn, iStepOffset); });
+}
+
+/*
+ * Advances synapses network state of the cluster one simulation step.
+ *
+ * @param sim_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param clr_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param iStepOffset - offset from the current simulation step.
+ */
+template <class NeuronsT, class SynapsesT>
+void SpecializedCluster<NeuronsT, SynapsesT>::advanceSynapses(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset)
+{
+    if (m_synapseIndexMap == NULL) {
+        return;
+    }
+
+    SynapsesT *synapses = m_typedSynapses;
+
+    // the back propagation (STDP) needs every synapse to see the post spikes
+    if (!static_cast<AllSpikingSynapsesProps*>(synapses->m_pSynapsesProps)->eventDrivenAdvance || synapses->SynapsesT::allowBackPropagation()) {
+        advanceSynapses(sim_info, iStepOffset, 0, m_synapseIndexMap->num_neurons);
+        return;
+    }
+
+    IAllNeurons *neurons = m_neurons;
+    IAllNeuronsProps *pINeuronsProps = m_typedNeurons->m_pNeuronsProps;
+    BGFLOAT *summation_map = m_typedNeurons->m_pNeuronsProps->summation_map;
+    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
+    const BGFLOAT deltaT = sim_info->deltaT;
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
+
+    synapses->advanceEventDriven(summation_map, simulationStep, [=](BGSIZE iSyn) {
+        synapses->SynapsesT::advanceSynapse(iSyn, deltaT, neurons, simulationStep, iStepOffset, maxSpikes, pINeuronsProps);
+    });
+}
+
+/*
+ * Advances the incoming synapses of the neurons in a range one simulation step.
+ *
+ * @param sim_info     - SimulationInfo class to read information from.
+ * @param iStepOffset  - offset from the current simulation step.
+ * @param iNeuronBegin - index of the first destination neuron of the range.
+ * @param iNeuronEnd   - index after the last destination neuron of the range.
+ */
+template <class NeuronsT, class SynapsesT>
+void SpecializedCluster<NeuronsT, SynapsesT>::advanceSynapses(const SimulationInfo *sim_info, int iStepOffset, BGSIZE iNeuronBegin, BGSIZE iNeuronEnd)
+{
+    SynapsesT *synapses = m_typedSynapses;
+    IAllNeurons *neurons = m_neurons;
+    IAllNeuronsProps *pINeuronsProps = m_typedNeurons->m_pNeuronsProps;
+    BGFLOAT *summation_map = m_typedNeurons->m_pNeuronsProps->summation_map;
+    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
+    const BGFLOAT deltaT = sim_info->deltaT;
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
+
+    synapses->advanceIncomingSynapses(m_synapseIndexMap, summation_map, iNeuronBegin, iNeuronEnd, [=](BGSIZE iSyn) {
+        synapses->SynapsesT::advanceSynapse(iSyn, deltaT, neurons, simulationStep, iStepOffset, maxSpikes, pINeuronsProps);
+    });
+}
+
+/*
+ * Advances a block of neurons and their incoming synapses through all the
+ * steps of the window.
+ *
+ * @param sim_info     - SimulationInfo class to read information from.
+ * @param clr_info     - ClusterInfo class to read information from.
+ * @param nSteps       - number of steps of the window.
+ * @param iNeuronBegin - index of the first neuron of the block.
+ * @param iNeuronEnd   - index after the last neuron of the block.
+ */
+template <class NeuronsT, class SynapsesT>
+void SpecializedCluster<NeuronsT, SynapsesT>::advanceBlock(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps, int iNeuronBegin, int iNeuronEnd)
+{
+    for (int iStepOffset = 0; iStepOffset < nSteps; iStepOffset++) {
+        genBlockNoise(clr_info, iStepOffset, iNeuronBegin, iNeuronEnd);
+        advanceNeurons(sim_info, clr_info, iStepOffset, iNeuronBegin, iNeuronEnd);
+
+        if (m_synapseIndexMap != NULL) {
+            advanceSynapses(sim_info, iStepOffset, iNeuronBegin, iNeuronEnd);
+        }
+    }
+}
+
+/*
+ * Advances synapses spike event queue state of the cluster.
+ *
+ * @param sim_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param clr_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param iStep    - simulation steps to advance.
+ */
+template <class NeuronsT, class SynapsesT>
+void SpecializedCluster<NeuronsT, SynapsesT>::advanceSpikeQueue(const SimulationInfo *sim_info, const ClusterInfo *clr_info, int iStep)
+{
+    m_typedSynapses->SynapsesT::advanceSpikeQueue(iStep);
+
+    if (sim_info->pInput != NULL) {
+        // advance input stimulus state
+        sim_info->pInput->advanceSInputState(clr_info, iStep);
+    }
+}
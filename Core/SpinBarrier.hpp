@@ -0,0 +1,84 @@
+/**
+ * @brief Represents a sense-reversing CPU thread barrier that spins before parking
+ * @note The barrier automatically resets after all threads are synced
+ *
+ * The last thread to arrive resets the counter and flips the global sense.
+ * The other threads spin on the sense for a bounded number of iterations,
+ * which avoids the futex wake-ups of the Barrier when the threads arrive
+ * close together, and then park on a condition variable, so that waiting
+ * threads do not keep a core busy when the cores are oversubscribed.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include "Barrier.hpp"
+
+class SpinBarrier : public IBarrier
+{
+public:
+    /// Default number of spin iterations before parking
+    static constexpr int DEFAULT_SPIN_COUNT = 4000;
+
+private:
+    std::atomic<size_t> m_count;
+    const size_t m_initial;
+
+    std::atomic<bool> m_sense;
+    const int m_spinCount;
+
+    std::atomic<size_t> m_nParked;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+    /// Hint the CPU that the thread is spinning
+    static void relax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+public:
+    /// Spinning only delays the last thread when the threads outnumber the cores,
+    /// so the waiting threads park right away in that case
+    explicit SpinBarrier(std::size_t count, int spinCount = DEFAULT_SPIN_COUNT) :
+        m_count{ count }, m_initial{ count }, m_sense{ false },
+        m_spinCount{ count > std::thread::hardware_concurrency() ? 0 : spinCount }, m_nParked{ 0 } { }
+
+    /// Blocks until all N threads reach here
+    void Sync()
+    {
+        // The global sense cannot flip before this thread arrives
+        const bool sense = !m_sense.load(std::memory_order_relaxed);
+
+        if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // The last thread resets the counter (for auto reset) and releases the others
+            m_count.store(m_initial, std::memory_order_relaxed);
+            m_sense.store(sense, std::memory_order_seq_cst);
+
+            if (m_nParked.load(std::memory_order_seq_cst) != 0) {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                m_cv.notify_all();
+            }
+            return;
+        }
+
+        // Spin for a while
+        for (int i = 0; i < m_spinCount; i++) {
+            if (m_sense.load(std::memory_order_acquire) == sense) {
+                return;
+            }
+            relax();
+        }
+
+        // Then park until the last thread arrives
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        m_nParked.fetch_add(1, std::memory_order_seq_cst);
+        m_cv.wait(lock, [this, sense] { return m_sense.load(std::memory_order_seq_cst) == sense; });
+        m_nParked.fetch_sub(1, std::memory_order_relaxed);
+    }
+};
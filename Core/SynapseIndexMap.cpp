@@ -15,6 +15,8 @@
 #ifdef PERFORMANCE_METRICS
 #include "Timer.h"
 #endif
+#include <algorithm>
+#include <thread>
 
 /**
  *  Get cluster index from neuron layout index.
@@ -47,6 +49,10 @@ int SynapseIndexMap::getNeuronIdxFromNeuronLayoutIdx(int iNeuron, vector<Cluster
 
 /*
  *  Create a synapse index map.
+ *  The incoming and then the outgoing maps of the clusters are created 
+ *  in parallel (one thread per cluster) by counting sort. The threads are
+ *  pinned like the advance threads of their clusters, so that the maps are
+ *  placed on the NUMA nodes of the clusters.
  *
  *  @param  sim_info          Pointer to the simulation information.
  *  @param  vtClr             Vector of pointer to the Cluster object.
@@ -59,124 +65,59 @@ void SynapseIndexMap::createSynapseImap(const SimulationInfo* sim_info, vector<C
     imap_timer.start();
 #endif
 
-    // allocate memories for forward map
-    int totalNeurons = sim_info->totalNeurons;
-    vector<OUTGOING_SYNAPSE_INDEX_TYPE>* rgSynapseSynapseIndexMap = new vector<OUTGOING_SYNAPSE_INDEX_TYPE>[totalNeurons];
-
-    // create incoming synapse index map
-    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
-        int neuron_count = vtClrInfo[iCluster]->totalClusterNeurons;
-        AllSynapses *synapses = dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses);
-        AllSynapsesProps *pSynapsesProps = dynamic_cast<AllSynapsesProps*>(synapses->m_pSynapsesProps);
-        SynapseIndexMap *synapseIndexMap = vtClr[iCluster]->m_synapseIndexMap;
-        BGSIZE total_incoming_synapse_count = 0;
-
-        // count the total synapses
-        for ( int iNeuron = 0; iNeuron < neuron_count; iNeuron++ )
-        {
-            assert( static_cast<int>(pSynapsesProps->synapse_counts[iNeuron]) < sim_info->maxSynapsesPerNeuron );
-            total_incoming_synapse_count += pSynapsesProps->synapse_counts[iNeuron];
-        }
-
-        DEBUG ( cout << "\nCluster: " << iCluster << " total_incoming_synapse_count: " << total_incoming_synapse_count << endl; )
-
-        if ( total_incoming_synapse_count == 0 )
-        {
-            continue;
-        }
-
-        if (synapseIndexMap != NULL)
-        {
-            delete synapseIndexMap;
-            synapseIndexMap = NULL;
+    // create incoming synapse index maps
+    if (vtClr.size() == 1) {
+        createIncomingSynapseImap(sim_info, vtClr[0], vtClrInfo[0]);
+    } else {
+        vector<thread> vtThread;
+        for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+            vtThread.push_back(thread([=, &vtClr, &vtClrInfo]() {
+                Cluster::pinCurrentThread(sim_info, vtClrInfo[iCluster], 0);
+                createIncomingSynapseImap(sim_info, vtClr[iCluster], vtClrInfo[iCluster]);
+            }));
         }
-
-        BGSIZE syn_i = 0;
-        BGSIZE n_inUse = 0;
-        BGSIZE inter_cluster_synapse_count = 0; 
-
-        // create incomming synapse index map
-        vtClr[iCluster]->m_synapseIndexMap = new SynapseIndexMap(neuron_count, total_incoming_synapse_count);
-
-        // for each destination neuron in the cluster
-        for (int iNeuron = 0; iNeuron < neuron_count; iNeuron++)
-        {
-            BGSIZE synapse_count = 0;
-            vtClr[iCluster]->m_synapseIndexMap->incomingSynapseBegin[iNeuron] = n_inUse;
-            for ( int j = 0; j < sim_info->maxSynapsesPerNeuron; j++, syn_i++ )
-            {
-                if ( pSynapsesProps->in_use[syn_i] == true )
-                {
-                    int srcNeuronLayoutIndex = pSynapsesProps->sourceNeuronLayoutIndex[syn_i];
-                    OUTGOING_SYNAPSE_INDEX_TYPE idxSynapse = SynapseIndexMap::getOutgoingSynapseIndex(iCluster, syn_i);
-
-                    // save for outgoing synapse index map
-                    rgSynapseSynapseIndexMap[srcNeuronLayoutIndex].push_back(idxSynapse);
-
-                    vtClr[iCluster]->m_synapseIndexMap->incomingSynapseIndexMap[n_inUse] = syn_i;
-                    n_inUse++;
-                    synapse_count++;
-
-                    DEBUG(
-                    CLUSTER_INDEX_TYPE idxCluster = SynapseIndexMap::getClusterIdxFromNeuronLayoutIdx(srcNeuronLayoutIndex, vtClrInfo);
-                    if (iCluster != idxCluster) {
-                        inter_cluster_synapse_count++;
-                    }
-                    )
-                }
-            }
-            assert( synapse_count == pSynapsesProps->synapse_counts[iNeuron] );
-            vtClr[iCluster]->m_synapseIndexMap->incomingSynapseCount[iNeuron] = synapse_count;
+        for (size_t i = 0; i < vtThread.size(); i++) {
+            vtThread[i].join();
         }
-
-        assert( total_incoming_synapse_count == n_inUse );
-        pSynapsesProps->total_synapse_counts = total_incoming_synapse_count;
-
-        DEBUG ( cout << "Cluster: " << iCluster << " inter_cluster_synapse_count: " << inter_cluster_synapse_count << endl; )
     }
 
     // create outgoing synapse index maps
-    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) 
-    {
-        int neuronLayoutIndex = vtClrInfo[iCluster]->clusterNeuronsBegin;
-        int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
-
-        // for each neuron in the cluster
-        BGSIZE total_outgoing_synapse_count = 0; 
-        for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++, neuronLayoutIndex++)
-        {
-            total_outgoing_synapse_count += rgSynapseSynapseIndexMap[neuronLayoutIndex].size();
+    if (vtClr.size() == 1) {
+        createOutgoingSynapseImap(vtClr, vtClrInfo, 0);
+    } else {
+        vector<thread> vtThread;
+        for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+            vtThread.push_back(thread([=, &vtClr, &vtClrInfo]() {
+                Cluster::pinCurrentThread(sim_info, vtClrInfo[iCluster], 0);
+                createOutgoingSynapseImap(vtClr, vtClrInfo, iCluster);
+            }));
         }
-
-        if (total_outgoing_synapse_count == 0) {
-            continue;
+        for (size_t i = 0; i < vtThread.size(); i++) {
+            vtThread[i].join();
         }
+    }
 
-        // Number of incoming synapes and number of outgoing synapses are not always equal.
-        // However for the growth connection model, each couple of neurons are connected 
-        // bi-directionally. So the number of inter cluster synapses between two clusters 
-        // should be equal, and therefore number of incoming synapes and number of outgoing 
-        // synapses are equal.
-        vtClr[iCluster]->m_synapseIndexMap->allocOutgoingSynapseIndexMap(total_outgoing_synapse_count);
-
-        DEBUG( cout << "\nCluster: " << iCluster << " total_outgoing_synapse_count: " << total_outgoing_synapse_count << endl; )
-
-        neuronLayoutIndex = vtClrInfo[iCluster]->clusterNeuronsBegin;
-        BGSIZE syn_i = 0;
-        for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++, neuronLayoutIndex++)
-        {
-            vtClr[iCluster]->m_synapseIndexMap->outgoingSynapseBegin[iNeuron] = syn_i;
-            vtClr[iCluster]->m_synapseIndexMap->outgoingSynapseCount[iNeuron] = rgSynapseSynapseIndexMap[neuronLayoutIndex].size();
-
-            for ( BGSIZE j = 0; j < rgSynapseSynapseIndexMap[neuronLayoutIndex].size(); j++, syn_i++)
-            {
-                vtClr[iCluster]->m_synapseIndexMap->outgoingSynapseIndexMap[syn_i] = rgSynapseSynapseIndexMap[neuronLayoutIndex][j];
-            }
+#if !defined(USE_GPU)
+    // create remote synapse index maps
+    if (vtClr.size() > 1) {
+        vector<thread> vtThread;
+        for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+            vtThread.push_back(thread([=, &vtClr, &vtClrInfo]() {
+                Cluster::pinCurrentThread(sim_info, vtClrInfo[iCluster], 0);
+                createRemoteSynapseImap(vtClr, vtClrInfo, iCluster);
+            }));
+        }
+        for (size_t i = 0; i < vtThread.size(); i++) {
+            vtThread[i].join();
         }
+        reserveInterClustersSpikes(sim_info, vtClr, vtClrInfo);
     }
 
-    // delete memories
-    delete[] rgSynapseSynapseIndexMap;
+    // the maps have all the synapses
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+        dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses)->m_synapseDeltas.clear();
+    }
+#endif // !USE_GPU
 
 #if defined(USE_GPU)
     // Copy synapse index maps to the device memory
@@ -268,3 +209,399 @@ void SynapseIndexMap::createSynapseImap(const SimulationInfo* sim_info, vector<C
 
 }
 
+/*
+ *  Create the incoming synapse index map of a cluster.
+ *
+ *  @param  sim_info          Pointer to the simulation information.
+ *  @param  clr               Pointer to the Cluster object.
+ *  @param  clr_info          Pointer to the ClusterInfo object.
+ */
+void SynapseIndexMap::createIncomingSynapseImap(const SimulationInfo* sim_info, Cluster *clr, ClusterInfo *clr_info)
+{
+    int neuron_count = clr_info->totalClusterNeurons;
+    AllSynapses *synapses = dynamic_cast<AllSynapses*>(clr->m_synapses);
+    AllSynapsesProps *pSynapsesProps = dynamic_cast<AllSynapsesProps*>(synapses->m_pSynapsesProps);
+    BGSIZE total_incoming_synapse_count = 0;
+    BGSIZE total_capacity = 0;
+
+    // count the total synapses
+    for ( int iNeuron = 0; iNeuron < neuron_count; iNeuron++ )
+    {
+        assert( static_cast<int>(pSynapsesProps->synapse_counts[iNeuron]) < sim_info->maxSynapsesPerNeuron );
+        total_incoming_synapse_count += pSynapsesProps->synapse_counts[iNeuron];
+        total_capacity += getSegmentCapacity(pSynapsesProps->synapse_counts[iNeuron]);
+    }
+
+    DEBUG ( cout << "\nCluster: " << clr_info->clusterID << " total_incoming_synapse_count: " << total_incoming_synapse_count << endl; )
+
+    if (clr->m_synapseIndexMap != NULL)
+    {
+        delete clr->m_synapseIndexMap;
+        clr->m_synapseIndexMap = NULL;
+    }
+
+    // create incomming synapse index map
+    SynapseIndexMap *synapseIndexMap = new SynapseIndexMap(neuron_count, total_capacity);
+
+    BGSIZE syn_i = 0;
+    BGSIZE n_inUse = 0;
+    BGSIZE map_i = 0;
+
+    // for each destination neuron in the cluster
+    for (int iNeuron = 0; iNeuron < neuron_count; iNeuron++)
+    {
+        BGSIZE synapse_count = 0;
+        synapseIndexMap->incomingSynapseBegin[iNeuron] = map_i;
+        synapseIndexMap->incomingSynapseCapacity[iNeuron] = getSegmentCapacity(pSynapsesProps->synapse_counts[iNeuron]);
+        for ( int j = 0; j < sim_info->maxSynapsesPerNeuron; j++, syn_i++ )
+        {
+            if ( pSynapsesProps->in_use[syn_i] == true )
+            {
+                synapseIndexMap->incomingSynapseIndexMap[map_i + synapse_count] = syn_i;
+                synapse_count++;
+            }
+        }
+        assert( synapse_count == pSynapsesProps->synapse_counts[iNeuron] );
+        synapseIndexMap->incomingSynapseCount[iNeuron] = synapse_count;
+        n_inUse += synapse_count;
+        map_i += synapseIndexMap->incomingSynapseCapacity[iNeuron];
+    }
+
+    assert( total_incoming_synapse_count == n_inUse );
+    pSynapsesProps->total_synapse_counts = total_incoming_synapse_count;
+    clr->m_synapseIndexMap = synapseIndexMap;
+}
+
+/*
+ *  Create the outgoing synapse index map of a cluster
+ *  from the incoming synapse index maps of all clusters.
+ *
+ *  @param  vtClr             Vector of pointer to the Cluster object.
+ *  @param  vtClrInfo         Vecttor of pointer to the ClusterInfo object.
+ *  @param  iCluster          Index of the cluster of the source neurons.
+ */
+void SynapseIndexMap::createOutgoingSynapseImap(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo, CLUSTER_INDEX_TYPE iCluster)
+{
+    SynapseIndexMap *synapseIndexMap = vtClr[iCluster]->m_synapseIndexMap;
+    int clusterNeuronsBegin = vtClrInfo[iCluster]->clusterNeuronsBegin;
+    int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
+    BGSIZE inter_cluster_synapse_count = 0;
+
+    // count the outgoing synapses of each source neuron in the cluster
+    fill(synapseIndexMap->outgoingSynapseCount, synapseIndexMap->outgoingSynapseCount + totalClusterNeurons, 0);
+    for (CLUSTER_INDEX_TYPE iDstCluster = 0; iDstCluster < vtClr.size(); iDstCluster++)
+    {
+        SynapseIndexMap *dstSynapseIndexMap = vtClr[iDstCluster]->m_synapseIndexMap;
+        AllSynapsesProps *pSynapsesProps = dynamic_cast<AllSynapses*>(vtClr[iDstCluster]->m_synapses)->m_pSynapsesProps;
+        for (BGSIZE iNeuron = 0; iNeuron < dstSynapseIndexMap->num_neurons; iNeuron++)
+        {
+            BGSIZE* incomingMap_begin = &( dstSynapseIndexMap->incomingSynapseIndexMap[dstSynapseIndexMap->incomingSynapseBegin[iNeuron]] );
+            for (BGSIZE i = 0; i < dstSynapseIndexMap->incomingSynapseCount[iNeuron]; i++)
+            {
+                int srcNeuron = pSynapsesProps->sourceNeuronLayoutIndex[incomingMap_begin[i]] - clusterNeuronsBegin;
+                if (srcNeuron >= 0 && srcNeuron < totalClusterNeurons)
+                {
+                    synapseIndexMap->outgoingSynapseCount[srcNeuron]++;
+                    if (iDstCluster != iCluster) {
+                        inter_cluster_synapse_count++;
+                    }
+                }
+            }
+        }
+    }
+
+    // set the segment of each source neuron
+    BGSIZE total_capacity = 0;
+    for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++)
+    {
+        synapseIndexMap->outgoingSynapseBegin[iNeuron] = total_capacity;
+        synapseIndexMap->outgoingSynapseCapacity[iNeuron] = getSegmentCapacity(synapseIndexMap->outgoingSynapseCount[iNeuron]);
+        total_capacity += synapseIndexMap->outgoingSynapseCapacity[iNeuron];
+    }
+
+    DEBUG( cout << "\nCluster: " << iCluster << " inter_cluster_synapse_count: " << inter_cluster_synapse_count << endl; )
+
+    if (total_capacity == 0) {
+        return;
+    }
+
+    // Number of incoming synapes and number of outgoing synapses are not always equal.
+    // However for the growth connection model, each couple of neurons are connected 
+    // bi-directionally. So the number of inter cluster synapses between two clusters 
+    // should be equal, and therefore number of incoming synapes and number of outgoing 
+    // synapses are equal.
+    synapseIndexMap->allocOutgoingSynapseIndexMap(total_capacity);
+
+    // fill the segments in ascending order of cluster and synapse index
+    fill(synapseIndexMap->outgoingSynapseCount, synapseIndexMap->outgoingSynapseCount + totalClusterNeurons, 0);
+    for (CLUSTER_INDEX_TYPE iDstCluster = 0; iDstCluster < vtClr.size(); iDstCluster++)
+    {
+        SynapseIndexMap *dstSynapseIndexMap = vtClr[iDstCluster]->m_synapseIndexMap;
+        AllSynapsesProps *pSynapsesProps = dynamic_cast<AllSynapses*>(vtClr[iDstCluster]->m_synapses)->m_pSynapsesProps;
+        for (BGSIZE iNeuron = 0; iNeuron < dstSynapseIndexMap->num_neurons; iNeuron++)
+        {
+            BGSIZE* incomingMap_begin = &( dstSynapseIndexMap->incomingSynapseIndexMap[dstSynapseIndexMap->incomingSynapseBegin[iNeuron]] );
+            for (BGSIZE i = 0; i < dstSynapseIndexMap->incomingSynapseCount[iNeuron]; i++)
+            {
+                BGSIZE syn_i = incomingMap_begin[i];
+                int srcNeuron = pSynapsesProps->sourceNeuronLayoutIndex[syn_i] - clusterNeuronsBegin;
+                if (srcNeuron >= 0 && srcNeuron < totalClusterNeurons)
+                {
+                    BGSIZE map_i = synapseIndexMap->outgoingSynapseBegin[srcNeuron] + synapseIndexMap->outgoingSynapseCount[srcNeuron]++;
+                    synapseIndexMap->outgoingSynapseIndexMap[map_i] = SynapseIndexMap::getOutgoingSynapseIndex(iDstCluster, syn_i);
+                }
+            }
+        }
+    }
+}
+
+#if !defined(USE_GPU)
+/*
+ *  Create the remote synapse index map of a cluster
+ *  from its incoming synapse index map.
+ *
+ *  @param  vtClr             Vector of pointer to the Cluster object.
+ *  @param  vtClrInfo         Vecttor of pointer to the ClusterInfo object.
+ *  @param  iCluster          Index of the cluster of the synapses.
+ */
+void SynapseIndexMap::createRemoteSynapseImap(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo, CLUSTER_INDEX_TYPE iCluster)
+{
+    SynapseIndexMap *synapseIndexMap = vtClr[iCluster]->m_synapseIndexMap;
+    AllSynapsesProps *pSynapsesProps = dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses)->m_pSynapsesProps;
+    int clusterNeuronsBegin = vtClrInfo[iCluster]->clusterNeuronsBegin;
+    int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
+
+    // collect the incoming synapses from the other clusters (source neuron layout index, synapse index)
+    vector< pair<int, BGSIZE> > remoteSynapses;
+    for (BGSIZE iNeuron = 0; iNeuron < synapseIndexMap->num_neurons; iNeuron++)
+    {
+        BGSIZE* incomingMap_begin = &( synapseIndexMap->incomingSynapseIndexMap[synapseIndexMap->incomingSynapseBegin[iNeuron]] );
+        for (BGSIZE i = 0; i < synapseIndexMap->incomingSynapseCount[iNeuron]; i++)
+        {
+            BGSIZE syn_i = incomingMap_begin[i];
+            int srcNeuron = pSynapsesProps->sourceNeuronLayoutIndex[syn_i];
+            if (srcNeuron < clusterNeuronsBegin || srcNeuron >= clusterNeuronsBegin + totalClusterNeurons)
+            {
+                remoteSynapses.push_back(make_pair(srcNeuron, syn_i));
+            }
+        }
+    }
+
+    // the clusters have ascending ranges of layout indexes, so the source neurons
+    // sorted by layout index are sorted by cluster and index in the cluster
+    sort(remoteSynapses.begin(), remoteSynapses.end());
+
+    synapseIndexMap->remoteSourceNeurons.clear();
+    synapseIndexMap->remoteSourceBegin.assign(vtClr.size() + 1, 0);
+    synapseIndexMap->remoteSynapseBegin.clear();
+    synapseIndexMap->remoteSynapseIndexMap.resize(remoteSynapses.size());
+    for (BGSIZE i = 0; i < remoteSynapses.size(); i++)
+    {
+        int srcNeuron = remoteSynapses[i].first;
+        if (i == 0 || srcNeuron != remoteSynapses[i - 1].first)
+        {
+            CLUSTER_INDEX_TYPE iSrcCluster = SynapseIndexMap::getClusterIdxFromNeuronLayoutIdx(srcNeuron, vtClrInfo);
+            synapseIndexMap->remoteSourceNeurons.push_back(srcNeuron - vtClrInfo[iSrcCluster]->clusterNeuronsBegin);
+            synapseIndexMap->remoteSourceBegin[iSrcCluster + 1]++;
+            synapseIndexMap->remoteSynapseBegin.push_back(i);
+        }
+        synapseIndexMap->remoteSynapseIndexMap[i] = remoteSynapses[i].second;
+    }
+    synapseIndexMap->remoteSynapseBegin.push_back(remoteSynapses.size());
+
+    for (CLUSTER_INDEX_TYPE iSrcCluster = 0; iSrcCluster < vtClr.size(); iSrcCluster++)
+    {
+        synapseIndexMap->remoteSourceBegin[iSrcCluster + 1] += synapseIndexMap->remoteSourceBegin[iSrcCluster];
+    }
+}
+
+/*
+ *  Make room in the outboxes of the inter clusters event handler for the spikes
+ *  of the source neurons of the remote synapse index maps in a synaptic
+ *  transmission delay window (a neuron fires at most once a step).
+ *
+ *  @param  sim_info          Pointer to the simulation information.
+ *  @param  vtClr             Vector of pointer to the Cluster object.
+ *  @param  vtClrInfo         Vecttor of pointer to the ClusterInfo object.
+ */
+void SynapseIndexMap::reserveInterClustersSpikes(const SimulationInfo* sim_info, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
+{
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++)
+    {
+        InterClustersEventHandler *eventHandler = vtClrInfo[iCluster]->eventHandler;
+        SynapseIndexMap *synapseIndexMap = vtClr[iCluster]->m_synapseIndexMap;
+        if (eventHandler == NULL || synapseIndexMap == NULL || synapseIndexMap->remoteSourceBegin.empty()) {
+            continue;
+        }
+
+        for (CLUSTER_INDEX_TYPE iSrcCluster = 0; iSrcCluster < vtClr.size(); iSrcCluster++)
+        {
+            if (iSrcCluster != iCluster) {
+                BGSIZE nSources = synapseIndexMap->remoteSourceBegin[iSrcCluster + 1] - synapseIndexMap->remoteSourceBegin[iSrcCluster];
+                eventHandler->reserveSpikes(iSrcCluster, iCluster, nSources * sim_info->minSynapticTransDelay);
+            }
+        }
+    }
+}
+
+/*
+ *  Find the incoming synapses of the cluster from a source neuron of another cluster.
+ *
+ *  @param  iSrcCluster   Cluster index of the source neuron.
+ *  @param  iSrcNeuron    Index of the source neuron in its cluster.
+ *  @param  count         Number of the synapses (output).
+ *  @return pointer to the synapse indexes, or NULL if the neuron has no synapses in the cluster.
+ */
+const BGSIZE* SynapseIndexMap::findRemoteSynapses(CLUSTER_INDEX_TYPE iSrcCluster, int iSrcNeuron, BGSIZE &count) const
+{
+    count = 0;
+    if (remoteSourceBegin.empty()) {
+        return NULL;
+    }
+
+    const int *first = remoteSourceNeurons.data() + remoteSourceBegin[iSrcCluster];
+    const int *last = remoteSourceNeurons.data() + remoteSourceBegin[iSrcCluster + 1];
+    const int *pos = lower_bound(first, last, iSrcNeuron);
+    if (pos == last || *pos != iSrcNeuron) {
+        return NULL;
+    }
+
+    BGSIZE iSource = pos - remoteSourceNeurons.data();
+    count = remoteSynapseBegin[iSource + 1] - remoteSynapseBegin[iSource];
+    return remoteSynapseIndexMap.data() + remoteSynapseBegin[iSource];
+}
+
+/*
+ *  Insert a synapse index into a segment of a synapse index map
+ *  (keeps the segment in ascending order).
+ *
+ *  @param  map       Synapse index map.
+ *  @param  begin     Beginning index of the segment.
+ *  @param  count     Number of synapse indexes in the segment.
+ *  @param  capacity  Number of entries of the segment.
+ *  @param  index     Synapse index to insert.
+ *  @return false if the segment is full.
+ */
+template<class T>
+static bool insertSynapseIndex(T *map, BGSIZE begin, BGSIZE &count, BGSIZE capacity, T index)
+{
+    if (count >= capacity) {
+        return false;
+    }
+
+    T *first = map + begin;
+    T *last = first + count;
+    T *pos = upper_bound(first, last, index);
+    copy_backward(pos, last, last + 1);
+    *pos = index;
+    count++;
+
+    return true;
+}
+
+/*
+ *  Remove a synapse index from a segment of a synapse index map.
+ *
+ *  @param  map       Synapse index map.
+ *  @param  begin     Beginning index of the segment.
+ *  @param  count     Number of synapse indexes in the segment.
+ *  @param  index     Synapse index to remove.
+ *  @return false if the segment doesn't have the synapse index.
+ */
+template<class T>
+static bool removeSynapseIndex(T *map, BGSIZE begin, BGSIZE &count, T index)
+{
+    T *first = map + begin;
+    T *last = first + count;
+    T *pos = lower_bound(first, last, index);
+    if (pos == last || *pos != index) {
+        return false;
+    }
+    copy(pos + 1, last, pos);
+    count--;
+
+    return true;
+}
+
+/*
+ *  Update the synapse index maps with the synapses added or removed 
+ *  since the maps were created (AllSynapses::m_synapseDeltas).
+ *  The maps are created again when they can't be patched in place.
+ *
+ *  @param  sim_info          Pointer to the simulation information.
+ *  @param  vtClr             Vector of pointer to the Cluster object.
+ *  @param  vtClrInfo         Vecttor of pointer to the ClusterInfo object.
+ */
+void SynapseIndexMap::updateSynapseImap(const SimulationInfo* sim_info, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
+{
+#ifdef PERFORMANCE_METRICS
+    Timer imap_timer;
+    imap_timer.start();
+#endif
+
+    // patching is slower than creating when most of the synapses have changed
+    bool patched = true;
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size() && patched; iCluster++) {
+        AllSynapses *synapses = dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses);
+        if (vtClr[iCluster]->m_synapseIndexMap == NULL ||
+            synapses->m_synapseDeltas.size() > synapses->m_pSynapsesProps->total_synapse_counts) {
+            patched = false;
+        }
+    }
+
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size() && patched; iCluster++) {
+        AllSynapses *synapses = dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses);
+        AllSynapsesProps *pSynapsesProps = synapses->m_pSynapsesProps;
+        SynapseIndexMap *inMap = vtClr[iCluster]->m_synapseIndexMap;
+        vector<AllSynapses::SynapseDelta> &vtDelta = synapses->m_synapseDeltas;
+
+        for (size_t i = 0; i < vtDelta.size() && patched; i++) {
+            // incoming synapse index map of the destination neuron
+            BGSIZE iNeuron = vtDelta[i].iSyn / sim_info->maxSynapsesPerNeuron;
+            BGSIZE inBegin = inMap->incomingSynapseBegin[iNeuron];
+
+            // outgoing synapse index map of the source neuron
+            CLUSTER_INDEX_TYPE iSrcCluster = SynapseIndexMap::getClusterIdxFromNeuronLayoutIdx(vtDelta[i].src_neuron, vtClrInfo);
+            SynapseIndexMap *outMap = vtClr[iSrcCluster]->m_synapseIndexMap;
+            int iSrcNeuron = vtDelta[i].src_neuron - vtClrInfo[iSrcCluster]->clusterNeuronsBegin;
+            BGSIZE outBegin = outMap->outgoingSynapseBegin[iSrcNeuron];
+            OUTGOING_SYNAPSE_INDEX_TYPE idxSynapse = SynapseIndexMap::getOutgoingSynapseIndex(iCluster, vtDelta[i].iSyn);
+
+            if (vtDelta[i].added) {
+                patched = insertSynapseIndex(inMap->incomingSynapseIndexMap, inBegin, inMap->incomingSynapseCount[iNeuron], inMap->incomingSynapseCapacity[iNeuron], vtDelta[i].iSyn)
+                    && insertSynapseIndex(outMap->outgoingSynapseIndexMap, outBegin, outMap->outgoingSynapseCount[iSrcNeuron], outMap->outgoingSynapseCapacity[iSrcNeuron], idxSynapse);
+                pSynapsesProps->total_synapse_counts++;
+            } else {
+                patched = removeSynapseIndex(inMap->incomingSynapseIndexMap, inBegin, inMap->incomingSynapseCount[iNeuron], vtDelta[i].iSyn)
+                    && removeSynapseIndex(outMap->outgoingSynapseIndexMap, outBegin, outMap->outgoingSynapseCount[iSrcNeuron], idxSynapse);
+                pSynapsesProps->total_synapse_counts--;
+            }
+        }
+    }
+
+    if (!patched) {
+        DEBUG ( cout << "\nSynapse index maps can't be patched, creating them." << endl; )
+        createSynapseImap(sim_info, vtClr, vtClrInfo);
+        return;
+    }
+
+    // the remote synapse index maps of the clusters whose synapses have changed are created again
+    if (vtClr.size() > 1) {
+        for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+            if (!dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses)->m_synapseDeltas.empty()) {
+                createRemoteSynapseImap(vtClr, vtClrInfo, iCluster);
+            }
+        }
+        reserveInterClustersSpikes(sim_info, vtClr, vtClrInfo);
+    }
+
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+        dynamic_cast<AllSynapses*>(vtClr[iCluster]->m_synapses)->m_synapseDeltas.clear();
+    }
+
+#ifdef PERFORMANCE_METRICS
+    t_host_createSynapseImap += imap_timer.lap() / 1000000.0;
+#endif
+}
+#endif // !USE_GPU
+
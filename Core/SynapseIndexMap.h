@@ -25,6 +25,20 @@
  ** The list contribute to reduce the number of the device function thread to skip the inactive
  ** synapses.
  **
+ ** In the host only simulation, the segment of each neuron in the lists has some free space
+ ** (incomingSynapseCapacity[i] and outgoingSynapseCapacity[i] entries), and the synapse
+ ** indexes of a segment are kept in ascending order. So the synapses added or removed 
+ ** during the growth update (AllSynapses::m_synapseDeltas) are patched into the lists 
+ ** in place by updateSynapseImap(). The lists are created again only when the free space
+ ** of a segment is exhausted. The GPU implementation walks the lists contiguously,
+ ** so there the lists have no free space and are created every time.
+ **
+ ** In the host only simulation with several clusters, the remote synapses list stores the
+ ** incoming synapses of the cluster from the source neurons of the other clusters, by
+ ** source neuron, so that the cluster finds the synapses of the spikes that the other
+ ** clusters send to it (InterClustersEventHandler). The source neurons of a cluster
+ ** (remoteSourceNeurons) are in ascending order of their index in the cluster.
+ **
  ** \latexonly  \subsubsection*{Credits} \endlatexonly
  ** \htmlonly   <h3>Credits</h3> \endhtmlonly
  **
@@ -57,16 +71,22 @@ class SynapseIndexMap
             incomingSynapseIndexMap = NULL;
             incomingSynapseBegin = NULL;
             incomingSynapseCount = NULL;
+
+            outgoingSynapseCapacity = NULL;
+            incomingSynapseCapacity = NULL;
         };
 
-        SynapseIndexMap(int neuron_count, BGSIZE synapse_count) : num_neurons(neuron_count), num_incoming_synapses(synapse_count)
+        SynapseIndexMap(int neuron_count, BGSIZE synapse_count) : num_neurons(neuron_count), num_incoming_synapses(synapse_count), num_outgoing_synapses(0)
         {
+            outgoingSynapseIndexMap = NULL;
             outgoingSynapseBegin = new BGSIZE[neuron_count];
             outgoingSynapseCount = new BGSIZE[neuron_count];
+            outgoingSynapseCapacity = new BGSIZE[neuron_count];
 
-            incomingSynapseIndexMap = new BGSIZE[synapse_count];
+            incomingSynapseIndexMap = synapse_count != 0 ? new BGSIZE[synapse_count] : NULL;
             incomingSynapseBegin = new BGSIZE[neuron_count];
             incomingSynapseCount = new BGSIZE[neuron_count];
+            incomingSynapseCapacity = new BGSIZE[neuron_count];
         };
 
         ~SynapseIndexMap()
@@ -74,8 +94,10 @@ class SynapseIndexMap
             if (num_neurons != 0) {
                     delete[] outgoingSynapseBegin;
                     delete[] outgoingSynapseCount;
+                    delete[] outgoingSynapseCapacity;
                     delete[] incomingSynapseBegin;
                     delete[] incomingSynapseCount;
+                    delete[] incomingSynapseCapacity;
             }
             if (num_incoming_synapses != 0) {
                     delete[] incomingSynapseIndexMap;
@@ -131,6 +153,8 @@ class SynapseIndexMap
 
         /**
          *  Create a synapse index map.
+         *  The incoming and then the outgoing maps of the clusters are created 
+         *  in parallel (one thread per cluster) by counting sort.
          *
          *  @param  sim_info          Pointer to the simulation information.
          *  @param  vtClr             Vector of pointer to the Cluster object.
@@ -138,6 +162,29 @@ class SynapseIndexMap
          */
         static void createSynapseImap(const SimulationInfo* sim_info, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
 
+#if !defined(USE_GPU)
+        /**
+         *  Update the synapse index maps with the synapses added or removed 
+         *  since the maps were created (AllSynapses::m_synapseDeltas).
+         *  The maps are created again when they can't be patched in place.
+         *
+         *  @param  sim_info          Pointer to the simulation information.
+         *  @param  vtClr             Vector of pointer to the Cluster object.
+         *  @param  vtClrInfo         Vecttor of pointer to the ClusterInfo object.
+         */
+        static void updateSynapseImap(const SimulationInfo* sim_info, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
+
+        /**
+         *  Find the incoming synapses of the cluster from a source neuron of another cluster.
+         *
+         *  @param  iSrcCluster   Cluster index of the source neuron.
+         *  @param  iSrcNeuron    Index of the source neuron in its cluster.
+         *  @param  count         Number of the synapses (output).
+         *  @return pointer to the synapse indexes, or NULL if the neuron has no synapses in the cluster.
+         */
+        const BGSIZE* findRemoteSynapses(CLUSTER_INDEX_TYPE iSrcCluster, int iSrcNeuron, BGSIZE &count) const;
+#endif // !USE_GPU
+
         /**
          *  Allocate memory for outgoing synapses index.
          *
@@ -149,6 +196,64 @@ class SynapseIndexMap
             outgoingSynapseIndexMap = new OUTGOING_SYNAPSE_INDEX_TYPE[synapse_count];
         };
 
+    private:
+        /**
+         *  Create the incoming synapse index map of a cluster.
+         *
+         *  @param  sim_info          Pointer to the simulation information.
+         *  @param  clr               Pointer to the Cluster object.
+         *  @param  clr_info          Pointer to the ClusterInfo object.
+         */
+        static void createIncomingSynapseImap(const SimulationInfo* sim_info, Cluster *clr, ClusterInfo *clr_info);
+
+        /**
+         *  Create the outgoing synapse index map of a cluster
+         *  from the incoming synapse index maps of all clusters.
+         *
+         *  @param  vtClr             Vector of pointer to the Cluster object.
+         *  @param  vtClrInfo         Vecttor of pointer to the ClusterInfo object.
+         *  @param  iCluster          Index of the cluster of the source neurons.
+         */
+        static void createOutgoingSynapseImap(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo, CLUSTER_INDEX_TYPE iCluster);
+
+#if !defined(USE_GPU)
+        /**
+         *  Create the remote synapse index map of a cluster
+         *  from its incoming synapse index map.
+         *
+         *  @param  vtClr             Vector of pointer to the Cluster object.
+         *  @param  vtClrInfo         Vecttor of pointer to the ClusterInfo object.
+         *  @param  iCluster          Index of the cluster of the synapses.
+         */
+        static void createRemoteSynapseImap(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo, CLUSTER_INDEX_TYPE iCluster);
+
+        /**
+         *  Make room in the outboxes of the inter clusters event handler for the spikes
+         *  of the source neurons of the remote synapse index maps in a synaptic
+         *  transmission delay window.
+         *
+         *  @param  sim_info          Pointer to the simulation information.
+         *  @param  vtClr             Vector of pointer to the Cluster object.
+         *  @param  vtClrInfo         Vecttor of pointer to the ClusterInfo object.
+         */
+        static void reserveInterClustersSpikes(const SimulationInfo* sim_info, vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
+#endif // !USE_GPU
+
+        /**
+         *  Get the size of the segment of a neuron in the synapse index lists.
+         *
+         *  @param  synapse_count     Number of synapses of the neuron.
+         *  @return the number of entries of the segment.
+         */
+        static BGSIZE getSegmentCapacity(BGSIZE synapse_count)
+        {
+#if defined(USE_GPU)
+            return synapse_count;
+#else
+            return synapse_count + synapse_count / 4 + 4;
+#endif
+        };
+
     public:
         //! Pointer to the outgoing synapse index map.
         OUTGOING_SYNAPSE_INDEX_TYPE* outgoingSynapseIndexMap;
@@ -161,6 +266,10 @@ class SynapseIndexMap
         //! Indexed by a source neuron index.
         BGSIZE* outgoingSynapseCount;
 
+        //! The number of entries of the outgoing synapse index map segment of each neuron.
+        //! Indexed by a source neuron index.
+        BGSIZE* outgoingSynapseCapacity;
+
         //! Pointer to the incoming synapse index map.
         BGSIZE* incomingSynapseIndexMap;
 
@@ -172,6 +281,10 @@ class SynapseIndexMap
         //! Indexed by a destination neuron index.
         BGSIZE* incomingSynapseCount;
 
+        //! The number of entries of the incoming synapse index map segment of each neuron.
+        //! Indexed by a destination neuron index.
+        BGSIZE* incomingSynapseCapacity;
+
         // Number of total neurons.
         BGSIZE num_neurons;
 
@@ -180,5 +293,22 @@ class SynapseIndexMap
 
         // Number of total outging synapses.
         BGSIZE num_outgoing_synapses;
+
+#if !defined(USE_GPU)
+        //! The source neurons of the remote synapses (index in their cluster),
+        //! by cluster and in ascending order.
+        vector<int> remoteSourceNeurons;
+
+        //! The beginning of the source neurons of each cluster in remoteSourceNeurons
+        //! (the number of clusters + 1 entries).
+        vector<BGSIZE> remoteSourceBegin;
+
+        //! The beginning of the synapses of each source neuron in remoteSynapseIndexMap
+        //! (the number of source neurons + 1 entries).
+        vector<BGSIZE> remoteSynapseBegin;
+
+        //! The remote synapse index map.
+        vector<BGSIZE> remoteSynapseIndexMap;
+#endif // !USE_GPU
 };
 
@@ -0,0 +1,221 @@
+#include "ThreadPool.h"
+#include "SpinBarrier.hpp"
+
+/*
+ *  Constructor
+ *
+ *  @param  nThreads      Number of threads, including the thread that calls parallelFor().
+ *  @param  spinBarrier   True to synchronize the threads with a SpinBarrier instead of a Barrier.
+ */
+ThreadPool::ThreadPool(int nThreads, bool spinBarrier) :
+    m_nThreads(nThreads),
+    m_task(NULL),
+    m_stop(false)
+{
+    assert( nThreads >= 1 );
+
+    if (spinBarrier) {
+        m_barrier = new SpinBarrier(nThreads);
+    } else {
+        m_barrier = new Barrier(nThreads);
+    }
+
+    m_ranges = new ChunkRange[nThreads];
+    for (int i = 0; i < nThreads; i++) {
+        m_ranges[i].range.store(packRange(0, 0));
+    }
+
+    for (int i = 1; i < nThreads; i++) {
+        m_workers.push_back(std::thread(&ThreadPool::workerThread, this, i));
+    }
+}
+
+/*
+ *  Destructor
+ */
+ThreadPool::~ThreadPool()
+{
+    // release the worker threads waiting for a loop
+    m_stop = true;
+    if (m_nThreads > 1) {
+        m_barrier->Sync();
+    }
+
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        m_workers[i].join();
+    }
+
+    delete[] m_ranges;
+    delete m_barrier;
+}
+
+/*
+ *  Get the number of threads, including the thread that calls parallelFor().
+ *
+ *  @return the number of threads.
+ */
+int ThreadPool::getNumThreads() const
+{
+    return m_nThreads;
+}
+
+/*
+ *  Get a worker thread of the pool.
+ *
+ *  @param  iThread   Index of the thread (1 to getNumThreads() - 1).
+ *  @return the worker thread.
+ */
+std::thread &ThreadPool::getWorkerThread(int iThread)
+{
+    return m_workers.at(iThread - 1);
+}
+
+/*
+ *  Run task(iChunk, iThread) for each chunk of a loop and wait for the loop to complete.
+ *
+ *  @param  nChunks   Number of chunks of the loop.
+ *  @param  task      Function to run a chunk, which receives the index of the chunk
+ *                    and the index of the thread (0 for the calling thread).
+ */
+void ThreadPool::parallelFor(BGSIZE nChunks, const std::function<void(BGSIZE, int)> &task)
+{
+    if (nChunks == 0) {
+        return;
+    }
+
+    // no need to wake up the worker threads for one chunk
+    if (m_nThreads == 1 || nChunks == 1) {
+        for (BGSIZE iChunk = 0; iChunk < nChunks; iChunk++) {
+            task(iChunk, 0);
+        }
+        return;
+    }
+
+    // split the chunks into contiguous ranges of the threads
+    m_task = &task;
+    for (int i = 0; i < m_nThreads; i++) {
+        uint32_t front = static_cast<uint64_t>(nChunks) * i / m_nThreads;
+        uint32_t back = static_cast<uint64_t>(nChunks) * (i + 1) / m_nThreads;
+        m_ranges[i].range.store(packRange(front, back), std::memory_order_relaxed);
+    }
+
+    // start the loop
+    m_barrier->Sync();
+
+    runChunks(0);
+
+    // wait until all threads complete the loop
+    m_barrier->Sync();
+
+    m_task = NULL;
+}
+
+/*
+ *  Main loop of a worker thread.
+ *
+ *  @param  iThread   Index of the thread.
+ */
+void ThreadPool::workerThread(int iThread)
+{
+    while (true) {
+        // wait for a loop
+        m_barrier->Sync();
+
+        if (m_stop) {
+            return;
+        }
+
+        runChunks(iThread);
+
+        // the loop is complete
+        m_barrier->Sync();
+    }
+}
+
+/*
+ *  Run the chunks of the thread and steal chunks of the other threads until no chunk is left.
+ *
+ *  @param  iThread   Index of the thread.
+ */
+void ThreadPool::runChunks(int iThread)
+{
+    BGSIZE iChunk;
+
+    while (true) {
+        if (popChunk(iThread, iChunk)) {
+            (*m_task)(iChunk, iThread);
+        } else if (!stealChunks(iThread)) {
+            return;
+        }
+    }
+}
+
+/*
+ *  Take the chunk at the front of the range of the thread.
+ *
+ *  @param  iThread   Index of the thread.
+ *  @param  iChunk    Index of the chunk taken.
+ *  @return true if a chunk is taken, false if the range is empty.
+ */
+bool ThreadPool::popChunk(int iThread, BGSIZE &iChunk)
+{
+    std::atomic<uint64_t> &range = m_ranges[iThread].range;
+    uint64_t oldRange = range.load(std::memory_order_acquire);
+
+    while (true) {
+        uint32_t front = static_cast<uint32_t>(oldRange);
+        uint32_t back = static_cast<uint32_t>(oldRange >> 32);
+        if (front >= back) {
+            return false;
+        }
+
+        if (range.compare_exchange_weak(oldRange, packRange(front + 1, back), std::memory_order_acq_rel)) {
+            iChunk = front;
+            return true;
+        }
+    }
+}
+
+/*
+ *  Steal half of the chunks at the back of the range of another thread,
+ *  and make them the range of the thread.
+ *
+ *  @param  iThread   Index of the thread.
+ *  @return true if chunks are stolen, false if every range is empty.
+ */
+bool ThreadPool::stealChunks(int iThread)
+{
+    for (int i = 1; i < m_nThreads; i++) {
+        std::atomic<uint64_t> &victimRange = m_ranges[(iThread + i) % m_nThreads].range;
+        uint64_t oldRange = victimRange.load(std::memory_order_acquire);
+
+        while (true) {
+            uint32_t front = static_cast<uint32_t>(oldRange);
+            uint32_t back = static_cast<uint32_t>(oldRange >> 32);
+            if (front >= back) {
+                break;
+            }
+
+            uint32_t nSteal = (back - front + 1) / 2;
+            if (victimRange.compare_exchange_weak(oldRange, packRange(front, back - nSteal), std::memory_order_acq_rel)) {
+                // the range of the thread is empty, so no other thread takes from it meanwhile
+                m_ranges[iThread].range.store(packRange(back - nSteal, back), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/*
+ *  Pack the front and back chunk indexes of a range.
+ *
+ *  @param  front   Index of the first chunk of the range.
+ *  @param  back    Index after the last chunk of the range.
+ *  @return the packed range.
+ */
+uint64_t ThreadPool::packRange(uint32_t front, uint32_t back)
+{
+    return (static_cast<uint64_t>(back) << 32) | front;
+}
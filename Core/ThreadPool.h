@@ -0,0 +1,139 @@
+/**
+ *      @file ThreadPool.h
+ *
+ *      @brief A pool of threads that run chunked loops with work stealing.
+ */
+
+/**
+ **
+ ** @class ThreadPool ThreadPool.h "ThreadPool.h"
+ **
+ ** \latexonly  \subsubsection*{Implementation} \endlatexonly
+ ** \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ **
+ ** The ThreadPool class runs the chunks of a loop on a set of threads: the
+ ** thread that calls parallelFor() and the worker threads of the pool.
+ ** Each thread first takes the chunks of its own contiguous range, from the
+ ** front, and then steals half of the remaining chunks of the other threads,
+ ** from the back. A range is packed in one 64 bits atomic word (front and back
+ ** chunk indexes), so that the owner and the thieves update it with a
+ ** compare and swap.
+ **
+ ** The threads meet at a barrier before and after each loop, so that a loop
+ ** is complete when parallelFor() returns. Which thread runs a chunk is not
+ ** deterministic, so the chunks must not depend on each other.
+ **
+ ** \latexonly  \subsubsection*{Credits} \endlatexonly
+ ** \htmlonly   <h3>Credits</h3> \endhtmlonly
+ **
+ ** Some models in this simulator is a rewrite of CSIM (2006) and other
+ ** work (Stiber and Kawasaki (2007?))
+ **/
+
+#pragma once
+
+#include "Global.h"
+#include "Barrier.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+
+class ThreadPool
+{
+    public:
+        /**
+         *  The constructor for ThreadPool.
+         *
+         *  @param  nThreads      Number of threads, including the thread that calls parallelFor().
+         *  @param  spinBarrier   True to synchronize the threads with a SpinBarrier instead of a Barrier.
+         */
+        ThreadPool(int nThreads, bool spinBarrier);
+
+        //! The destructor for ThreadPool.
+        ~ThreadPool();
+
+        /**
+         *  Get the number of threads, including the thread that calls parallelFor().
+         *
+         *  @return the number of threads.
+         */
+        int getNumThreads() const;
+
+        /**
+         *  Get a worker thread of the pool.
+         *
+         *  @param  iThread   Index of the thread (1 to getNumThreads() - 1).
+         *  @return the worker thread.
+         */
+        std::thread &getWorkerThread(int iThread);
+
+        /**
+         *  Run task(iChunk, iThread) for each chunk of a loop and wait for the loop to complete.
+         *
+         *  @param  nChunks   Number of chunks of the loop.
+         *  @param  task      Function to run a chunk, which receives the index of the chunk
+         *                    and the index of the thread (0 for the calling thread).
+         */
+        void parallelFor(BGSIZE nChunks, const std::function<void(BGSIZE, int)> &task);
+
+    private:
+        /**
+         *  Main loop of a worker thread.
+         *
+         *  @param  iThread   Index of the thread.
+         */
+        void workerThread(int iThread);
+
+        /**
+         *  Run the chunks of the thread and steal chunks of the other threads until no chunk is left.
+         *
+         *  @param  iThread   Index of the thread.
+         */
+        void runChunks(int iThread);
+
+        /**
+         *  Take the chunk at the front of the range of the thread.
+         *
+         *  @param  iThread   Index of the thread.
+         *  @param  iChunk    Index of the chunk taken.
+         *  @return true if a chunk is taken, false if the range is empty.
+         */
+        bool popChunk(int iThread, BGSIZE &iChunk);
+
+        /**
+         *  Steal half of the chunks at the back of the range of another thread,
+         *  and make them the range of the thread.
+         *
+         *  @param  iThread   Index of the thread.
+         *  @return true if chunks are stolen, false if every range is empty.
+         */
+        bool stealChunks(int iThread);
+
+        //! Pack the front and back chunk indexes of a range.
+        static uint64_t packRange(uint32_t front, uint32_t back);
+
+        //! Number of threads, including the thread that calls parallelFor().
+        int m_nThreads;
+
+        //! The worker threads (threads 1 to m_nThreads - 1).
+        std::vector<std::thread> m_workers;
+
+        //! Barrier to start and complete a loop.
+        IBarrier *m_barrier;
+
+        //! The task of the current loop.
+        const std::function<void(BGSIZE, int)> *m_task;
+
+        //! True when the worker threads must exit.
+        bool m_stop;
+
+        //! Range of the chunks of a thread, in its own cache line.
+        struct ChunkRange {
+            std::atomic<uint64_t> range;
+            char padding[64 - sizeof(std::atomic<uint64_t>)];
+        };
+
+        //! Ranges of the chunks of the threads.
+        ChunkRange *m_ranges;
+};
@@ -0,0 +1,148 @@
+#include "ThreadedCluster.h"
+#include "AllSpikingNeurons.h"
+
+/*
+ *  Constructor
+ */
+ThreadedCluster::ThreadedCluster(IAllNeurons *neurons, IAllSynapses *synapses) :
+    SingleThreadedCluster(neurons, synapses),
+    m_pool(NULL)
+{
+}
+
+/*
+ *  Destructor
+ */
+ThreadedCluster::~ThreadedCluster()
+{
+}
+
+/*
+ *  Creates all the Neurons and generates data for them,
+ *  and creates the pool of threads of the cluster.
+ *
+ *  @param  sim_info    SimulationInfo class to read information from.
+ *  @param  layout      A class to define neurons' layout information in the network.
+ *  @param  clr_info    ClusterInfo class to read information from.
+ */
+void ThreadedCluster::setupCluster(SimulationInfo *sim_info, Layout *layout, ClusterInfo *clr_info)
+{
+    SingleThreadedCluster::setupCluster(sim_info, layout, clr_info);
+
+    // the advance thread of the cluster is the thread 0 of the pool
+    m_pool = new ThreadPool(sim_info->numClusterThreads, sim_info->spinBarrier);
+
+    // pin the worker threads to the cores after the one of the advance thread,
+    // or to the NUMA node of the cluster
+    if (sim_info->pinThreads != NO_PINNING) {
+        for (int i = 1; i < m_pool->getNumThreads(); i++) {
+            pinThread(m_pool->getWorkerThread(i), sim_info, clr_info, i);
+        }
+    }
+}
+
+/*
+ *  Clean up the cluster.
+ *
+ *  @param  sim_info    SimulationInfo to refer.
+ *  @param  clr_info    ClusterInfo to refer.
+ */
+void ThreadedCluster::cleanupCluster(SimulationInfo *sim_info, ClusterInfo *clr_info)
+{
+    delete m_pool;
+    m_pool = NULL;
+
+    SingleThreadedCluster::cleanupCluster(sim_info, clr_info);
+}
+
+/*
+ * Advances neurons network state of the cluster one simulation step.
+ *
+ * @param sim_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param clr_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param iStepOffset - offset from the current simulation step.
+ */
+void ThreadedCluster::advanceNeurons(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset)
+{
+    genRandNoise(clr_info, iStepOffset);
+    dynamic_cast<AllSpikingNeurons*>(m_neurons)->advanceNeurons(*m_synapses, sim_info, m_synapseIndexMap, clr_info, iStepOffset, *m_pool, NEURONS_PER_CHUNK);
+}
+
+/*
+ * Draws the noise of all the neurons of the cluster for the current step
+ * into clr_info->randNoise. The counter noise is drawn by the threads of
+ * the pool, since the noise of a neuron does not depend on the others.
+ *
+ * @param clr_info - ClusterInfo to refer.
+ * @param iStepOffset - offset from the current simulation step.
+ */
+void ThreadedCluster::genRandNoise(ClusterInfo *clr_info, int iStepOffset)
+{
+    if (clr_info->counterRand == NULL) {
+        SingleThreadedCluster::genRandNoise(clr_info, iStepOffset);
+        return;
+    }
+
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
+    int totalNeurons = clr_info->totalClusterNeurons;
+    int nNeuronsPerChunk = NEURONS_PER_CHUNK;
+    BGSIZE nChunks = (totalNeurons + nNeuronsPerChunk - 1) / nNeuronsPerChunk;
+
+    m_pool->parallelFor(nChunks, [&](BGSIZE iChunk, int iThread) {
+        int iNeuronBegin = iChunk * nNeuronsPerChunk;
+        int iNeuronEnd = min(iNeuronBegin + nNeuronsPerChunk, totalNeurons);
+        genCounterNoise(clr_info, simulationStep, iNeuronBegin, iNeuronEnd);
+    });
+}
+
+/*
+ * Advances synapses network state of the cluster one simulation step.
+ *
+ * @param sim_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param clr_info - parameters defining the simulation to be run with
+ *                   the given collection of neurons.
+ * @param iStepOffset - offset from the current simulation step.
+ */
+void ThreadedCluster::advanceSynapses(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset)
+{
+    dynamic_cast<AllSynapses*>(m_synapses)->advanceSynapses(sim_info, m_neurons, m_synapseIndexMap, iStepOffset, *m_pool, SYNAPSE_NEURONS_PER_CHUNK);
+}
+
+/*
+ * Advances the neurons and synapses of the cluster through the steps of
+ * the synaptic transmission delay window. In the blocked advance, the
+ * blocks of neurons run on the threads of the pool.
+ *
+ * @param sim_info - SimulationInfo class to read information from.
+ * @param clr_info - ClusterInfo class to read information from.
+ * @param nSteps   - number of steps of the window.
+ */
+void ThreadedCluster::advanceWindow(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps)
+{
+    if (!m_blockedAdvance) {
+        Cluster::advanceWindow(sim_info, clr_info, nSteps);
+        return;
+    }
+
+    genWindowNoise(clr_info, nSteps);
+
+    // a neuron that fires with a full spike history grows it, which reallocates
+    // the buffer of all neurons, so the histories are grown for the window first
+    int totalNeurons = clr_info->totalClusterNeurons;
+    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
+    AllSpikingNeuronsProps *pNeuronsProps = dynamic_cast<AllSpikingNeuronsProps*>(dynamic_cast<AllSpikingNeurons*>(m_neurons)->m_pNeuronsProps);
+    for (int iNeuron = 0; iNeuron < totalNeurons; iNeuron++) {
+        pNeuronsProps->reserveSpikeHistory(iNeuron, nSteps, maxSpikes);
+    }
+
+    BGSIZE nBlocks = (totalNeurons + NEURONS_PER_BLOCK - 1) / NEURONS_PER_BLOCK;
+
+    m_pool->parallelFor(nBlocks, [&](BGSIZE iBlock, int iThread) {
+        int iNeuronBegin = iBlock * NEURONS_PER_BLOCK;
+        int iNeuronEnd = min(iNeuronBegin + NEURONS_PER_BLOCK, totalNeurons);
+        advanceBlock(sim_info, clr_info, nSteps, iNeuronBegin, iNeuronEnd);
+    });
+}
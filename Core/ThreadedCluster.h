@@ -0,0 +1,120 @@
+/**
+ *      @file ThreadedCluster.h
+ *
+ *      @brief Implementation of Cluster that advances its neurons and synapses on several threads.
+ */
+
+/**
+ *
+ * @class ThreadedCluster ThreadedCluster.h "ThreadedCluster.h"
+ *
+ * \latexonly  \subsubsection*{Implementation} \endlatexonly
+ * \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ *
+ * A ThreadedCluster is a SingleThreadedCluster that splits the advance of its
+ * neurons and synapses over a ThreadPool, so that more cores can be used without
+ * splitting the network into more clusters (which adds inter-cluster events and
+ * barriers). The number of threads per cluster is SimulationInfo::numClusterThreads.
+ *
+ * The neurons are split into chunks of contiguous neurons. The synapses are split
+ * into chunks of contiguous destination neurons: a chunk advances the incoming
+ * synapses of its neurons (SynapseIndexMap::incomingSynapseBegin/Count), so each
+ * summation point is updated by one thread, without atomic operations.
+ *
+ * The random noise of the neurons is drawn by the advance thread of the cluster
+ * before the neurons are advanced, in the order of the SingleThreadedCluster,
+ * and the synapses are summed in the same order. So the results are the same as
+ * the ones of the SingleThreadedCluster, for any number of threads.
+ *
+ * In the blocked advance (SimConfig advanceOrder), the blocks of neurons, which
+ * go through the window with their incoming synapses, are independent, so they
+ * are split over the pool as well.
+ *
+ * \latexonly  \subsubsection*{Credits} \endlatexonly
+ * \htmlonly   <h3>Credits</h3> \endhtmlonly
+ *
+ * Some models in this simulator is a rewrite of CSIM (2006) and other
+ * work (Stiber and Kawasaki (2007?))
+ */
+
+#pragma once
+
+#include "SingleThreadedCluster.h"
+#include "ThreadPool.h"
+
+class ThreadedCluster : public SingleThreadedCluster {
+    public:
+        // Constructor & Destructor
+        ThreadedCluster(IAllNeurons *neurons, IAllSynapses *synapses);
+        ~ThreadedCluster();
+
+        /**
+         *  Creates all the Neurons and generates data for them,
+         *  and creates the pool of threads of the cluster.
+         *
+         *  @param  sim_info    SimulationInfo class to read information from.
+         *  @param  layout      A class to define neurons' layout information in the network.
+         *  @param  clr_info    ClusterInfo class to read information from.
+         */
+        virtual void setupCluster(SimulationInfo *sim_info, Layout *layout, ClusterInfo *clr_info);
+
+        /**
+         *  Clean up the cluster.
+         *
+         *  @param  sim_info    SimulationInfo to refer.
+         *  @param  clr_info    ClusterInfo to refer.
+         */
+        virtual void cleanupCluster(SimulationInfo *sim_info, ClusterInfo *clr_info);
+
+        /**
+         * Advances neurons network state of the cluster one simulation step.
+         *
+         * @param sim_info   parameters defining the simulation to be run with
+         *                   the given collection of neurons.
+         * @param clr_info   ClusterInfo to refer.
+         * @param iStepOffset  offset from the current simulation step.
+         */
+        virtual void advanceNeurons(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset);
+
+        /**
+         * Advances synapses network state of the cluster one simulation step.
+         *
+         * @param sim_info   parameters defining the simulation to be run with
+         *                   the given collection of neurons.
+         * @param clr_info  ClusterInfo to refer.
+         * @param iStepOffset  offset from the current simulation step.
+         */
+        virtual void advanceSynapses(const SimulationInfo *sim_info, ClusterInfo *clr_info, int iStepOffset);
+
+        /**
+         * Advances the neurons and synapses of the cluster through the steps of
+         * the synaptic transmission delay window. In the blocked advance, the
+         * blocks of neurons run on the threads of the pool.
+         *
+         * @param sim_info    SimulationInfo class to read information from.
+         * @param clr_info    ClusterInfo class to read information from.
+         * @param nSteps      Number of steps of the window.
+         */
+        virtual void advanceWindow(const SimulationInfo *sim_info, ClusterInfo *clr_info, int nSteps);
+
+    protected:
+        /**
+         * Draws the noise of all the neurons of the cluster for the current step
+         * into clr_info->randNoise. The counter noise is drawn by the threads of
+         * the pool, since the noise of a neuron does not depend on the others.
+         *
+         * @param clr_info    ClusterInfo to refer.
+         * @param iStepOffset  offset from the current simulation step.
+         */
+        virtual void genRandNoise(ClusterInfo *clr_info, int iStepOffset);
+
+    private:
+        //! Number of neurons per chunk of the neurons advance.
+        static const int NEURONS_PER_CHUNK = 256;
+
+        //! Number of destination neurons per chunk of the synapses advance.
+        static const int SYNAPSE_NEURONS_PER_CHUNK = 16;
+
+        //! The pool of threads of the cluster.
+        ThreadPool *m_pool;
+};
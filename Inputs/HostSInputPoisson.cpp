@@ -8,6 +8,8 @@
 
 #include "HostSInputPoisson.h"
 #include "tinyxml.h"
+#include "Philox.h"
+#include "Checkpoint.h"
 
 /*
  * The constructor for HostSInputPoisson.
@@ -39,6 +41,31 @@ void HostSInputPoisson::init(SimulationInfo* psi, vector<ClusterInfo *> &vtClrIn
 
     if (m_fSInput == false)
         return;
+
+    m_maxSpikes = (int) ((psi->epochDuration * psi->maxFiringRate));
+
+    // resolve the stimulus input state of each cluster
+    m_clusters.resize(vtClrInfo.size());
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClrInfo.size(); iCluster++)
+    {
+        ClusterInfo *clr_info = vtClrInfo[iCluster];
+        ClusterSInput &clrSInput = m_clusters[clr_info->clusterID];
+
+        clrSInput.synapses = dynamic_cast<AllDSSynapses*>(clr_info->synapsesSInput);
+        clrSInput.nISIs = m_nISIs + clr_info->clusterNeuronsBegin;
+
+        clrSInput.stimulatedNeurons.clear();
+        for (int iNeuron = 0; iNeuron < clr_info->totalClusterNeurons; iNeuron++)
+        {
+            // the masks are read by original index
+            if (m_masks[clr_info->getOriginalNeuronIndex(iNeuron)])
+                clrSInput.stimulatedNeurons.push_back(iNeuron);
+        }
+
+        // the schedule is empty until the first spike
+        clrSInput.isiSchedule.assign(ISI_BATCH_SIZE, 0);
+        clrSInput.iNextISI = ISI_BATCH_SIZE;
+    }
 }
 
 /*
@@ -65,36 +92,87 @@ void HostSInputPoisson::inputStimulus(const SimulationInfo* psi, ClusterInfo *pc
     if (m_fSInput == false)
         return;
 
-    int neuronLayoutIndex = pci->clusterNeuronsBegin;
-    int totalClusterNeurons = pci->totalClusterNeurons;
+    ClusterSInput &clrSInput = m_clusters[pci->clusterID];
+    AllDSSynapses *synapses = clrSInput.synapses;
+    int *nISIs = clrSInput.nISIs;
+    const int *stimulatedNeurons = clrSInput.stimulatedNeurons.data();
+    int nStimulatedNeurons = clrSInput.stimulatedNeurons.size();
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
+    BGFLOAT deltaT = psi->deltaT;
 
-    for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++, neuronLayoutIndex++)
+    for (int i = 0; i < nStimulatedNeurons; i++)
     {
-        if (m_masks[neuronLayoutIndex] == false)
-            continue;
-
+        int iNeuron = stimulatedNeurons[i];
         BGSIZE iSyn = m_maxSynapsesPerNeuron * iNeuron;
-        if (--m_nISIs[neuronLayoutIndex] <= 0)
+
+        if (--nISIs[iNeuron] <= 0)
         {
             // add a spike
-            dynamic_cast<AllSpikingSynapses*>(pci->synapsesSInput)->preSpikeHit(iSyn, pci->clusterID, iStepOffset);
+            synapses->AllSpikingSynapses::preSpikeHit(iSyn, pci->clusterID, iStepOffset);
 
             // update interval counter (exponectially distribution ISIs, Poisson)
-            BGFLOAT isi = -m_lambda * log(pci->rng->inRange(0, 1));
-            // delete isi within refractoriness
-            while (pci->rng->inRange(0, 1) <= exp(-(isi*isi)/32))
-                isi = -m_lambda * log(pci->rng->inRange(0, 1));
-            // convert isi from msec to steps
-            m_nISIs[neuronLayoutIndex] = static_cast<int>( (isi / 1000) / psi->deltaT + 0.5 );
+            if (pci->counterRand != NULL) {
+                nISIs[iNeuron] = drawCounterISI(psi, *pci->counterRand, pci->getOriginalNeuronIndex(iNeuron), simulationStep);
+            } else {
+                if (clrSInput.iNextISI == ISI_BATCH_SIZE)
+                    fillISISchedule(psi, pci);
+                nISIs[iNeuron] = clrSInput.isiSchedule[clrSInput.iNextISI++];
+            }
         }
 
         // process synapse & apply psr to the summation point
-        AllSynapses *pSynapses = dynamic_cast<AllSynapses*>(pci->synapsesSInput);
-        int maxSpikes = (int) ((psi->epochDuration * psi->maxFiringRate));
-        uint64_t simulationStep = g_simulationStep + iStepOffset;
+        // (the input synapses are AllDSSynapses, which don't override advanceSynapse)
+        synapses->AllSpikingSynapses::advanceSynapse(iSyn, deltaT, NULL, simulationStep, iStepOffset, m_maxSpikes, NULL);
+    }
+}
+
+/*
+ * Draw the next interval of a neuron from the counter based generator.
+ * The draws only depend on the seed, the neuron and the step.
+ *
+ * @param[in] psi                 Pointer to the simulation information.
+ * @param[in] counterRand         The counter based generator of the cluster.
+ * @param[in] neuronOriginalIndex Original index of the neuron.
+ * @param[in] simulationStep      The current simulation step.
+ * @return the interval in steps.
+ */
+int HostSInputPoisson::drawCounterISI(const SimulationInfo* psi, const Philox &counterRand, int neuronOriginalIndex, uint64_t simulationStep) const
+{
+    uint32_t iSample = 0;
+    BGFLOAT isi = -m_lambda * log(counterRand.uniform(PHILOX_STREAM_POISSON, neuronOriginalIndex, simulationStep, iSample++));
+    // delete isi within refractoriness
+    while (counterRand.uniform(PHILOX_STREAM_POISSON, neuronOriginalIndex, simulationStep, iSample++) <= exp(-(isi*isi)/32))
+        isi = -m_lambda * log(counterRand.uniform(PHILOX_STREAM_POISSON, neuronOriginalIndex, simulationStep, iSample++));
+
+    // convert isi from msec to steps
+    return static_cast<int>( (isi / 1000) / psi->deltaT + 0.5 );
+}
+
+/*
+ * Draw a batch of intervals from the random number generator of a cluster.
+ * The spikes of the neurons of the cluster consume the intervals in the order
+ * they are drawn, so the neurons get the same intervals as when each one is
+ * drawn at its spike.
+ *
+ * @param[in] psi             Pointer to the simulation information.
+ * @param[in] pci             ClusterInfo class to read information from.
+ */
+void HostSInputPoisson::fillISISchedule(const SimulationInfo* psi, const ClusterInfo *pci)
+{
+    ClusterSInput &clrSInput = m_clusters[pci->clusterID];
+    MTRand &rng = *pci->rng;
+
+    for (int i = 0; i < ISI_BATCH_SIZE; i++)
+    {
+        BGFLOAT isi = -m_lambda * log(rng.inRange(0, 1));
+        // delete isi within refractoriness
+        while (rng.inRange(0, 1) <= exp(-(isi*isi)/32))
+            isi = -m_lambda * log(rng.inRange(0, 1));
 
-        pSynapses->advanceSynapse(iSyn, psi->deltaT, NULL, simulationStep, iStepOffset, maxSpikes, NULL);
+        // convert isi from msec to steps
+        clrSInput.isiSchedule[i] = static_cast<int>( (isi / 1000) / psi->deltaT + 0.5 );
     }
+    clrSInput.iNextISI = 0;
 }
 
 /*
@@ -106,5 +184,72 @@ void HostSInputPoisson::inputStimulus(const SimulationInfo* psi, ClusterInfo *pc
 void HostSInputPoisson::advanceSInputState(const ClusterInfo *pci, int iStep)
 {
     // Advances synapses pre spike event queue state of the cluster iStep simulation step
-    dynamic_cast<AllSpikingSynapses*>(pci->synapsesSInput)->advanceSpikeQueue(iStep);
+    m_clusters[pci->clusterID].synapses->AllSpikingSynapses::advanceSpikeQueue(iStep);
+}
+
+/*
+ * Add the input stimulus state to a periodic checkpoint:
+ * the interval counters, the intervals drawn ahead and the input synapses
+ * of each cluster.
+ *
+ * @param[in] writer          The checkpoint writer.
+ * @param[in] vtClrInfo       Vector of ClusterInfo.
+ */
+void HostSInputPoisson::checkpoint(CheckpointWriter &writer, const vector<ClusterInfo *> &vtClrInfo) const
+{
+    if (m_fSInput == false)
+        return;
+
+    int totalNeurons = 0;
+    for (unsigned int iCluster = 0; iCluster < vtClrInfo.size(); iCluster++) {
+        totalNeurons += vtClrInfo[iCluster]->totalClusterNeurons;
+    }
+    writer.addArray(CKPT_SINPUT_ISI, 0, m_nISIs, totalNeurons);
+
+    for (unsigned int iCluster = 0; iCluster < vtClrInfo.size(); iCluster++) {
+        const ClusterSInput &clrSInput = m_clusters[vtClrInfo[iCluster]->clusterID];
+        writer.addArray(CKPT_SINPUT_ISI_SCHEDULE, iCluster, clrSInput.isiSchedule.data(), ISI_BATCH_SIZE);
+        writer.addValue(CKPT_SINPUT_ISI_NEXT, iCluster, clrSInput.iNextISI);
+
+        const AllSynapses *pSynapses = dynamic_cast<const AllSynapses*>(vtClrInfo[iCluster]->synapsesSInput);
+        pSynapses->checkpointState(writer, CHECKPOINT_SINPUT_CLUSTER(iCluster));
+    }
+}
+
+/*
+ * Restore the input stimulus state from a periodic checkpoint.
+ *
+ * @param[in] reader          The checkpoint reader.
+ * @param[in] vtClrInfo       Vector of ClusterInfo.
+ * @return true if successful, false otherwise.
+ */
+bool HostSInputPoisson::restore(const CheckpointReader &reader, vector<ClusterInfo *> &vtClrInfo)
+{
+    if (m_fSInput == false)
+        return true;
+
+    int totalNeurons = 0;
+    for (unsigned int iCluster = 0; iCluster < vtClrInfo.size(); iCluster++) {
+        totalNeurons += vtClrInfo[iCluster]->totalClusterNeurons;
+    }
+    if (!reader.restoreArray(CKPT_SINPUT_ISI, 0, m_nISIs, totalNeurons))
+        return false;
+
+    for (unsigned int iCluster = 0; iCluster < vtClrInfo.size(); iCluster++) {
+        // the generator of the cluster has drawn these intervals ahead
+        // (a checkpoint without them was written with an empty schedule)
+        ClusterSInput &clrSInput = m_clusters[vtClrInfo[iCluster]->clusterID];
+        clrSInput.iNextISI = ISI_BATCH_SIZE;
+        if (reader.hasSection(CKPT_SINPUT_ISI_SCHEDULE, iCluster)) {
+            if (!reader.restoreArray(CKPT_SINPUT_ISI_SCHEDULE, iCluster, clrSInput.isiSchedule.data(), ISI_BATCH_SIZE)
+                    || !reader.restoreValue(CKPT_SINPUT_ISI_NEXT, iCluster, clrSInput.iNextISI))
+                return false;
+        }
+
+        AllSynapses *pSynapses = dynamic_cast<AllSynapses*>(vtClrInfo[iCluster]->synapsesSInput);
+        if (!pSynapses->restoreState(reader, CHECKPOINT_SINPUT_CLUSTER(iCluster), vtClrInfo[iCluster]))
+            return false;
+    }
+
+    return true;
 }
@@ -52,7 +52,46 @@ public:
     // Process input stimulus for each time step.
     virtual void advanceSInputState(const ClusterInfo *pci, int iStep);
 
+    // Add the input stimulus state to a periodic checkpoint.
+    virtual void checkpoint(CheckpointWriter &writer, const vector<ClusterInfo *> &vtClrInfo) const;
+
+    // Restore the input stimulus state from a periodic checkpoint.
+    virtual bool restore(const CheckpointReader &reader, vector<ClusterInfo *> &vtClrInfo);
+
 private:
+    // Draw the next interval (in steps) of a neuron from the counter based generator.
+    int drawCounterISI(const SimulationInfo* psi, const Philox &counterRand, int neuronOriginalIndex, uint64_t simulationStep) const;
+
+    // Draw a batch of intervals (in steps) from the random number generator of a cluster.
+    void fillISISchedule(const SimulationInfo* psi, const ClusterInfo *pci);
+
+    //! Number of intervals drawn at a time from the random number generator of a cluster.
+    static const int ISI_BATCH_SIZE = 256;
+
+    //! Stimulus input state of a cluster.
+    struct ClusterSInput
+    {
+        //! Cluster local indexes of the stimulated neurons (ascending).
+        vector<int> stimulatedNeurons;
+
+        //! The input synapses of the cluster.
+        AllDSSynapses *synapses;
+
+        //! Interval counters of the neurons of the cluster (points into m_nISIs).
+        int *nISIs;
+
+        //! Intervals (in steps) drawn ahead from the random number generator.
+        vector<int> isiSchedule;
+
+        //! Index of the next interval of isiSchedule.
+        int iNextISI;
+    };
+
+    //! Stimulus input state of the clusters, indexed by cluster ID.
+    vector<ClusterSInput> m_clusters;
+
+    //! Maximum number of spikes of a synapse in an epoch.
+    int m_maxSpikes;
 };
 
 #endif // _HOSTSINPUTPOISSON_H_
@@ -7,6 +7,7 @@
  */
 
 #include "HostSInputRegular.h"
+#include "Checkpoint.h"
 
 /*
  * constructor
@@ -65,16 +66,46 @@ void HostSInputRegular::inputStimulus(const SimulationInfo* psi, ClusterInfo *pc
     if (m_fSInput == false)
         return;
 
-    int neuronLayoutIndex = pci->clusterNeuronsBegin;
     int totalClusterNeurons = pci->totalClusterNeurons;
 
-    // add input to each summation point
-    for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++, neuronLayoutIndex++) {
-        if ( (pci->nStepsInCycle >= m_nShiftValues[neuronLayoutIndex]) && (pci->nStepsInCycle < (m_nShiftValues[neuronLayoutIndex] + m_nStepsDuration ) % m_nStepsCycle) )
-            pci->pClusterSummationMap[iNeuron] += m_values[neuronLayoutIndex];
+    // add input to each summation point (the values are set by original index)
+    for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++) {
+        int neuronOriginalIndex = pci->getOriginalNeuronIndex(iNeuron);
+        if ( (pci->nStepsInCycle >= m_nShiftValues[neuronOriginalIndex]) && (pci->nStepsInCycle < (m_nShiftValues[neuronOriginalIndex] + m_nStepsDuration ) % m_nStepsCycle) )
+            pci->pClusterSummationMap[iNeuron] += m_values[neuronOriginalIndex];
     }
 
     // update cycle count 
     pci->nStepsInCycle = (pci->nStepsInCycle + 1) % m_nStepsCycle;
 }
 
+/*
+ * Add the input stimulus state to a periodic checkpoint:
+ * the cycle count of each cluster.
+ *
+ * @param[in] writer          The checkpoint writer.
+ * @param[in] vtClrInfo       Vector of ClusterInfo.
+ */
+void HostSInputRegular::checkpoint(CheckpointWriter &writer, const vector<ClusterInfo *> &vtClrInfo) const
+{
+    for (unsigned int iCluster = 0; iCluster < vtClrInfo.size(); iCluster++) {
+        writer.addValue(CKPT_SINPUT_CYCLE, iCluster, vtClrInfo[iCluster]->nStepsInCycle);
+    }
+}
+
+/*
+ * Restore the input stimulus state from a periodic checkpoint.
+ *
+ * @param[in] reader          The checkpoint reader.
+ * @param[in] vtClrInfo       Vector of ClusterInfo.
+ * @return true if successful, false otherwise.
+ */
+bool HostSInputRegular::restore(const CheckpointReader &reader, vector<ClusterInfo *> &vtClrInfo)
+{
+    for (unsigned int iCluster = 0; iCluster < vtClrInfo.size(); iCluster++) {
+        if (!reader.restoreValue(CKPT_SINPUT_CYCLE, iCluster, vtClrInfo[iCluster]->nStepsInCycle))
+            return false;
+    }
+
+    return true;
+}
@@ -47,6 +47,12 @@ public:
     //! Process input stimulus for each time step.
     virtual void inputStimulus(const SimulationInfo* psi, ClusterInfo *pci, int iStepOffset);
 
+    //! Add the input stimulus state to a periodic checkpoint.
+    virtual void checkpoint(CheckpointWriter &writer, const vector<ClusterInfo *> &vtClrInfo) const;
+
+    //! Restore the input stimulus state from a periodic checkpoint.
+    virtual bool restore(const CheckpointReader &reader, vector<ClusterInfo *> &vtClrInfo);
+
 private:
 };
 
@@ -32,6 +32,9 @@
 #include "IModel.h"
 #include "tinyxml.h"
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class ISInput
 {
 public:
@@ -66,6 +69,29 @@ public:
      * @param[in] iStep           Simulation steps to advance.
      */
     virtual void advanceSInputState(const ClusterInfo *pci, int iStep) = 0;
+
+    /**
+     * Add the input stimulus state to a periodic checkpoint.
+     * By default, this method does nothing.
+     *
+     * @param[in] writer          The checkpoint writer.
+     * @param[in] vtClrInfo       Vector of ClusterInfo.
+     */
+    virtual void checkpoint(CheckpointWriter &writer, const vector<ClusterInfo *> &vtClrInfo) const {}
+
+    /**
+     * Restore the input stimulus state from a periodic checkpoint.
+     * By default, the input stimulus can't resume a simulation.
+     *
+     * @param[in] reader          The checkpoint reader.
+     * @param[in] vtClrInfo       Vector of ClusterInfo.
+     * @return true if successful, false otherwise.
+     */
+    virtual bool restore(const CheckpointReader &reader, vector<ClusterInfo *> &vtClrInfo)
+    {
+        cerr << "The stimulus input doesn't support resuming a simulation from a checkpoint" << endl;
+        return false;
+    }
 };
 
 #endif // _ISINPUT_H_
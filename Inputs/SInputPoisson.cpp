@@ -139,6 +139,7 @@ void SInputPoisson::init(SimulationInfo* psi, vector<ClusterInfo *> &vtClrInfo)
         // create an input synapse layer
         // TODO: do we need to support other types of synapses?
         clr_info->synapsesSInput = new AllDSSynapses();
+        clr_info->synapsesSInput->createSynapsesProps();
 
         // HACK!!! avoid to overwrite eventHandler in setupSynapses
         InterClustersEventHandler* t_eventHandler = clr_info->eventHandler;
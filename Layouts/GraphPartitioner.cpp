@@ -0,0 +1,125 @@
+#include "GraphPartitioner.h"
+#include "SFCPartitioner.h"
+#include <algorithm>
+
+//! Largest work of a part over the average work, that the moves may reach.
+#define GRAPH_IMBALANCE 1.03
+
+//! Maximum number of refinement passes over the neurons.
+#define GRAPH_REFINEMENT_PASSES 8
+
+GraphPartitioner::GraphPartitioner()
+{
+}
+
+GraphPartitioner::~GraphPartitioner()
+{
+}
+
+/*
+ *  Partition the neurons.
+ *
+ *  @param  layout     Layout of the neurons.
+ *  @param  sources    Estimated source neurons of the incoming synapses of each neuron.
+ *  @param  nParts     Number of parts (clusters).
+ *  @param  order      Layout indices of the neurons, part by part (output).
+ *  @param  partSizes  Number of neurons of each part (output).
+ */
+void GraphPartitioner::partition(const Layout *layout, const vector<vector<int> > &sources, int nParts, vector<int> &order, vector<int> &partSizes)
+{
+    int num_neurons = sources.size();
+    vector<BGSIZE> work;
+    getWork(sources, work);
+
+    // start from the space-filling curve partition
+    vector<int> curve;
+    SFCPartitioner::getCurveOrder(layout, num_neurons, curve);
+    splitByWork(curve, work, nParts, partSizes);
+
+    vector<int> partOf(num_neurons);
+    vector<int64_t> partWork(nParts, 0);
+    vector<int> partCount(nParts, 0);
+    int64_t totalWork = 0;
+    for (int iPart = 0, i = 0; iPart < nParts; iPart++) {
+        for (int j = 0; j < partSizes[iPart]; j++, i++) {
+            partOf[curve[i]] = iPart;
+            partWork[iPart] += work[curve[i]];
+            partCount[iPart]++;
+        }
+        totalWork += partWork[iPart];
+    }
+    int64_t maxWork = max(static_cast<int64_t>(GRAPH_IMBALANCE * totalWork / nParts), *max_element(partWork.begin(), partWork.end()));
+
+    // the outgoing connections of each neuron
+    vector<vector<int> > targets(num_neurons);
+    for (int i = 0; i < num_neurons; i++) {
+        for (BGSIZE j = 0; j < sources[i].size(); j++) {
+            targets[sources[i][j]].push_back(i);
+        }
+    }
+
+    vector<int> connections(nParts, 0);
+    vector<int> touched;
+    for (int pass = 0; pass < GRAPH_REFINEMENT_PASSES; pass++) {
+        int moved = 0;
+        for (int k = 0; k < num_neurons; k++) {
+            int i = curve[k];
+            int own = partOf[i];
+
+            // count the connections of the neuron with each part
+            touched.clear();
+            for (int dir = 0; dir < 2; dir++) {
+                const vector<int> &neighbors = dir == 0 ? sources[i] : targets[i];
+                for (BGSIZE j = 0; j < neighbors.size(); j++) {
+                    int iPart = partOf[neighbors[j]];
+                    if (connections[iPart]++ == 0) {
+                        touched.push_back(iPart);
+                    }
+                }
+            }
+
+            // the neighboring part with the most connections
+            int best = own;
+            for (BGSIZE j = 0; j < touched.size(); j++) {
+                int iPart = touched[j];
+                if (iPart != own && (best == own || connections[iPart] > connections[best] ||
+                        (connections[iPart] == connections[best] && partWork[iPart] < partWork[best]))) {
+                    best = iPart;
+                }
+            }
+
+            if (best != own && partCount[own] > 1) {
+                int gain = connections[best] - connections[own];
+                bool balanced = partWork[best] + work[i] <= maxWork;
+                bool rebalances = partWork[best] + work[i] < partWork[own];
+                if ((gain > 0 && balanced) || (gain == 0 && rebalances)) {
+                    partOf[i] = best;
+                    partWork[own] -= work[i];
+                    partWork[best] += work[i];
+                    partCount[own]--;
+                    partCount[best]++;
+                    moved++;
+                }
+            }
+
+            for (BGSIZE j = 0; j < touched.size(); j++) {
+                connections[touched[j]] = 0;
+            }
+        }
+
+        if (moved == 0) {
+            break;
+        }
+    }
+
+    // the neurons of each part in the curve order
+    vector<int> partBegin(nParts + 1, 0);
+    for (int iPart = 0; iPart < nParts; iPart++) {
+        partSizes[iPart] = partCount[iPart];
+        partBegin[iPart + 1] = partBegin[iPart] + partCount[iPart];
+    }
+    order.resize(num_neurons);
+    for (int k = 0; k < num_neurons; k++) {
+        order[partBegin[partOf[curve[k]]]++] = curve[k];
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ *      @file GraphPartitioner.h
+ *
+ *      @brief A partitioner that refines a partition on the graph of the connections
+ */
+
+/**
+ *
+ * @class GraphPartitioner GraphPartitioner.h "GraphPartitioner.h"
+ *
+ * \latexonly  \subsubsection*{Implementation} \endlatexonly
+ * \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ *
+ * The GraphPartitioner starts from the space-filling curve partition (SFCPartitioner),
+ * and moves the neurons at the boundaries of the parts to the neighboring part that
+ * most of their incoming and outgoing connections come from or go to, as long as the
+ * move cuts fewer connections and keeps the work of the parts within GRAPH_IMBALANCE
+ * of the average (or does not cut more connections and improves the balance).
+ * It stops when a pass over the neurons moves none of them, or after
+ * GRAPH_REFINEMENT_PASSES passes. Unlike the geometric partitioners, it follows the
+ * connections themselves, so it also fits the layouts where the connections do not
+ * only depend on the distance.
+ *
+ */
+
+#pragma once
+
+#include "Partitioner.h"
+
+class GraphPartitioner : public Partitioner
+{
+    public:
+        GraphPartitioner();
+        virtual ~GraphPartitioner();
+
+        /**
+         *  Get the name of the partitioner (as in the SimConfig partitioner parameter).
+         *
+         *  @return the name of the partitioner.
+         */
+        virtual const char* getName() const { return "graph"; }
+
+        /**
+         *  Partition the neurons.
+         *
+         *  @param  layout     Layout of the neurons.
+         *  @param  sources    Estimated source neurons of the incoming synapses of each neuron.
+         *  @param  nParts     Number of parts (clusters).
+         *  @param  order      Layout indices of the neurons, part by part (output).
+         *  @param  partSizes  Number of neurons of each part (output).
+         */
+        virtual void partition(const Layout *layout, const vector<vector<int> > &sources, int nParts, vector<int> &order, vector<int> &partSizes);
+};
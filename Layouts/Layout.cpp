@@ -1,18 +1,17 @@
 #include "Layout.h"
 #include "ParseParamError.h"
 #include "Util.h"
+#include "Checkpoint.h"
+#include <algorithm>
 
 Layout::Layout() :
     num_endogenously_active_neurons(0),
     nParams(0),
-    m_grid_layout(true)
+    m_grid_layout(true),
+    m_grid_cell_size(1)
 {
     xloc = NULL;
     yloc = NULL;
-#if !defined(USE_GPU)
-    dist2 = NULL;
-    dist = NULL;
-#endif // !USE_GPU
     neuron_type_map = NULL;
     starter_map = NULL;
 }
@@ -21,19 +20,11 @@ Layout::~Layout()
 {
     if (xloc != NULL) delete[] xloc;
     if (yloc != NULL) delete[] yloc;
-#if !defined(USE_GPU)
-    if (dist2 != NULL) delete dist2;
-    if (dist != NULL) delete dist;
-#endif // !USE_GPU
     if (neuron_type_map != NULL) delete[] neuron_type_map;
     if (starter_map != NULL) delete[] starter_map;
 
     xloc = NULL;
     yloc = NULL;
-#if !defined(USE_GPU)
-    dist2 = NULL;
-    dist = NULL;
-#endif // !USE_GPU
     neuron_type_map = NULL;
     starter_map = NULL;
 }
@@ -50,33 +41,17 @@ void Layout::setupLayout(const SimulationInfo *sim_info)
 
     xloc = new BGFLOAT[num_neurons];
     yloc = new BGFLOAT[num_neurons];
-#if !defined(USE_GPU)
-    dist2 = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, num_neurons, num_neurons);
-    dist = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, num_neurons, num_neurons);
-#endif // !USE_GPU
 
     // Initialize neuron locations
     initNeuronsLocs(sim_info);
+    m_original_index.clear();
+    m_layout_index.clear();
 
-#if !defined(USE_GPU)
-    // calculate the distance between neurons
-    for (int n = 0; n < num_neurons - 1; n++)
-    {
-        for (int n2 = n + 1; n2 < num_neurons; n2++)
-        {
-            // distance^2 between two points in point-slope form
-            (*dist2)(n, n2) = (xloc[n] - xloc[n2]) * (xloc[n] - xloc[n2]) +
-                (yloc[n] - yloc[n2]) * (yloc[n] - yloc[n2]);
-
-            // both points are equidistant from each other
-            (*dist2)(n2, n) = (*dist2)(n, n2);
-        }
-    }
-
-    // take the square root to get actual distance (Pythagoras was right!)
-    // (The CompleteMatrix class makes this assignment look so easy...)
-    (*dist) = sqrt((*dist2));
-#endif // USE_GPU
+    // Build the spatial index, whose cells hold about one neuron on average
+    // (the distances are computed on demand instead of being stored).
+    BGFLOAT cellSize = sqrt(static_cast<BGFLOAT>(sim_info->width) * sim_info->height / num_neurons);
+    m_grid_cell_size = cellSize > 0 ? cellSize : 1;
+    m_grid.build(xloc, yloc, num_neurons, m_grid_cell_size);
 
     neuron_type_map = new neuronType[num_neurons];
     starter_map = new bool[num_neurons];
@@ -153,3 +128,121 @@ void Layout::initNeuronsLocs(const SimulationInfo *sim_info)
         }
     }
 }
+
+/*
+ *  Renumber the neurons: the neuron at position i of the order gets the layout index i.
+ *  The locations, types and starter maps are reordered, and the spatial index is rebuilt.
+ *  The lists read from the layout files keep the original indices.
+ *
+ *  @param  order  Layout indices of the neurons in their new order.
+ */
+void Layout::renumberNeurons(const vector<int> &order)
+{
+    int num_neurons = order.size();
+
+    vector<BGFLOAT> x(xloc, xloc + num_neurons);
+    vector<BGFLOAT> y(yloc, yloc + num_neurons);
+    vector<neuronType> types(neuron_type_map, neuron_type_map + num_neurons);
+    vector<bool> starters(starter_map, starter_map + num_neurons);
+    vector<int> original(num_neurons);
+
+    for (int i = 0; i < num_neurons; i++) {
+        int from = order[i];
+        xloc[i] = x[from];
+        yloc[i] = y[from];
+        neuron_type_map[i] = types[from];
+        starter_map[i] = starters[from];
+        original[i] = getOriginalIndex(from);
+    }
+
+    m_original_index.swap(original);
+    m_layout_index.resize(num_neurons);
+    for (int i = 0; i < num_neurons; i++) {
+        m_layout_index[m_original_index[i]] = i;
+    }
+
+    m_grid.build(xloc, yloc, num_neurons, m_grid_cell_size);
+}
+
+/*
+ *  Check that the neurons have the original indices they had when a state
+ *  indexed by layout index (synapses, radii) was saved.
+ *
+ *  @param  original     Original index of each neuron when the state was saved,
+ *                       or NULL if unknown (a state saved before the renumbering was recorded).
+ *  @param  num_neurons  Number of neurons.
+ *  @return true if the original indices match (if unknown, if the neurons are not renumbered).
+ */
+bool Layout::hasOriginalIndices(const int *original, int num_neurons) const
+{
+    for (int i = 0; i < num_neurons; i++) {
+        if (getOriginalIndex(i) != (original != NULL ? original[i] : i)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ *  Add the original index of each neuron to a checkpoint.
+ *
+ *  @param  writer       The checkpoint writer.
+ *  @param  num_neurons  Number of neurons.
+ */
+void Layout::checkpoint(CheckpointWriter &writer, int num_neurons) const
+{
+    int *original = static_cast<int *>(writer.allocSection(CKPT_NEURON_ORIGINAL_INDEX, 0, sizeof(int), num_neurons, 1));
+
+    for (int i = 0; i < num_neurons; i++) {
+        original[i] = getOriginalIndex(i);
+    }
+}
+
+/*
+ *  Check that a checkpoint was written with the same renumbering of the neurons.
+ *
+ *  @param  reader       The checkpoint reader.
+ *  @param  num_neurons  Number of neurons.
+ *  @return true if the renumbering matches, false otherwise.
+ */
+bool Layout::restore(const CheckpointReader &reader, int num_neurons) const
+{
+    const int *original = NULL;
+
+    if (reader.hasSection(CKPT_NEURON_ORIGINAL_INDEX, 0)) {
+        original = static_cast<const int *>(reader.getSection(CKPT_NEURON_ORIGINAL_INDEX, 0, sizeof(int), num_neurons, 1));
+        if (original == NULL) {
+            return false;
+        }
+    }
+
+    if (!hasOriginalIndices(original, num_neurons)) {
+        cerr << "The checkpoint was written with another renumbering of the neurons"
+             << " (number of clusters or partitioner)" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ *  Sort a list of neurons by their original indices.
+ *
+ *  @param  neurons  Layout indices of the neurons to sort.
+ */
+void Layout::sortByOriginalIndex(vector<int> &neurons) const
+{
+    if (m_original_index.empty()) {
+        sort(neurons.begin(), neurons.end());
+        return;
+    }
+
+    for (BGSIZE i = 0; i < neurons.size(); i++) {
+        neurons[i] = m_original_index[neurons[i]];
+    }
+    sort(neurons.begin(), neurons.end());
+    for (BGSIZE i = 0; i < neurons.size(); i++) {
+        neurons[i] = m_layout_index[neurons[i]];
+    }
+}
@@ -11,9 +11,16 @@
  * \latexonly  \subsubsection*{Implementation} \endlatexonly
  * \htmlonly   <h3>Implementation</h3> \endhtmlonly
  *
- * The Layout class maintains neurons locations (x, y coordinates), distance of every couple neurons,
- * neurons type map (distribution of excitatory and inhibitory neurons), and starter neurons map
- * (distribution of endogenously active neurons).  
+ * The Layout class maintains neurons locations (x, y coordinates), a spatial index over them
+ * for neighbor queries, neurons type map (distribution of excitatory and inhibitory neurons),
+ * and starter neurons map (distribution of endogenously active neurons).  
+ * The distance of every couple neurons is computed on demand.
+ *
+ * The neurons may be renumbered after the layout is generated, so that the neurons
+ * of every cluster get a contiguous range of layout indices (see Partitioner).
+ * The layout index of a neuron is then its index in the simulation, and its original
+ * index is its index in the layout files and in the simulation results.
+ * The recorders and the stimulus inputs convert between the two.
  *
  */
 
@@ -21,11 +28,15 @@
 
 #include "Global.h"
 #include "SimulationInfo.h"
+#include "SpatialGrid.h"
 #include <vector>
 #include <iostream>
 
 using namespace std;
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class Layout
 {
     public:
@@ -78,19 +89,138 @@ class Layout
          */
         virtual void initStarterMap(const int num_neurons);
 
+        /**
+         *  Inter-neuron distance squared.
+         *
+         *  @param  i   Layout index of the first neuron.
+         *  @param  j   Layout index of the second neuron.
+         *  @return the distance squared between the two neurons.
+         */
+        BGFLOAT dist2(int i, int j) const
+        {
+            return (xloc[i] - xloc[j]) * (xloc[i] - xloc[j]) +
+                (yloc[i] - yloc[j]) * (yloc[i] - yloc[j]);
+        }
+
+        /**
+         *  The true inter-neuron distance.
+         *
+         *  @param  i   Layout index of the first neuron.
+         *  @param  j   Layout index of the second neuron.
+         *  @return the distance between the two neurons.
+         */
+        BGFLOAT dist(int i, int j) const
+        {
+            return sqrt(dist2(i, j));
+        }
+
+        /**
+         *  Get all neurons within the radius of the neuron (excluding itself).
+         *
+         *  @param  neuron     Layout index of the neuron.
+         *  @param  radius     Radius of the query.
+         *  @param  neighbors  Vector to store the neighbors, sorted by ascending layout index.
+         */
+        void getNeighborsInRange(int neuron, BGFLOAT radius, vector<int> &neighbors) const
+        {
+            m_grid.getNeighborsInRange(neuron, radius, neighbors);
+        }
+
+        /**
+         *  Get the k nearest neurons of the neuron (excluding itself).
+         *  Neurons at the same distance are ordered by ascending layout index.
+         *
+         *  @param  neuron     Layout index of the neuron.
+         *  @param  k          Number of neighbors to get.
+         *  @param  neighbors  Vector to store the neighbors, sorted by ascending distance.
+         */
+        void getNearestNeighbors(int neuron, int k, vector<int> &neighbors) const
+        {
+            m_grid.getNearestNeighbors(neuron, k, neighbors);
+        }
+
+        /**
+         *  Renumber the neurons: the neuron at position i of the order gets the layout index i.
+         *  The locations, types and starter maps are reordered, and the spatial index is rebuilt.
+         *
+         *  @param  order  Layout indices of the neurons in their new order.
+         */
+        void renumberNeurons(const vector<int> &order);
+
+        /**
+         *  Get the original index of a neuron (its index in the layout files and in the results).
+         *
+         *  @param  neuron  Layout index of the neuron.
+         *  @return the original index of the neuron.
+         */
+        int getOriginalIndex(int neuron) const
+        {
+            return m_original_index.empty() ? neuron : m_original_index[neuron];
+        }
+
+        /**
+         *  Get the layout index of a neuron from its original index.
+         *
+         *  @param  original  Original index of the neuron.
+         *  @return the layout index of the neuron.
+         */
+        int getLayoutIndex(int original) const
+        {
+            return m_layout_index.empty() ? original : m_layout_index[original];
+        }
+
+        /**
+         *  Get the original indices of the neurons, indexed by layout index.
+         *
+         *  @return the original indices, or NULL if the neurons are not renumbered.
+         */
+        const int* getOriginalIndices() const
+        {
+            return m_original_index.empty() ? NULL : &m_original_index[0];
+        }
+
+        /**
+         *  Check that the neurons have the original indices they had when a state
+         *  indexed by layout index (synapses, radii) was saved.
+         *
+         *  @param  original     Original index of each neuron when the state was saved,
+         *                       or NULL if unknown (a state saved before the renumbering was recorded).
+         *  @param  num_neurons  Number of neurons.
+         *  @return true if the original indices match (if unknown, if the neurons are not renumbered).
+         */
+        bool hasOriginalIndices(const int *original, int num_neurons) const;
+
+        /**
+         *  Add the original index of each neuron to a checkpoint.
+         *
+         *  @param  writer       The checkpoint writer.
+         *  @param  num_neurons  Number of neurons.
+         */
+        void checkpoint(CheckpointWriter &writer, int num_neurons) const;
+
+        /**
+         *  Check that a checkpoint was written with the same renumbering of the neurons.
+         *
+         *  @param  reader       The checkpoint reader.
+         *  @param  num_neurons  Number of neurons.
+         *  @return true if the renumbering matches, false otherwise.
+         */
+        bool restore(const CheckpointReader &reader, int num_neurons) const;
+
+        /**
+         *  Sort a list of neurons by their original indices.
+         *
+         *  @param  neurons  Layout indices of the neurons to sort.
+         */
+        void sortByOriginalIndex(vector<int> &neurons) const;
+
         //! Store neuron i's x location.
         BGFLOAT *xloc;
 
         //! Store neuron i's y location.
         BGFLOAT *yloc;
 
-        // Inter-neuron distance squared. (not used on GPU)
-        CompleteMatrix *dist2;
-
-        //! The true inter-neuron distance. (not used on GPU)
-        CompleteMatrix *dist;
-
-        //! Probed neurons list.
+        //! Probed neurons list (original indices).
         vector<int> m_probed_neuron_list;
 
         //! The neuron type map (INH, EXC).
@@ -122,5 +252,17 @@ class Layout
 
         // True if grid layout.
         bool m_grid_layout;
+
+        //! Spatial index over the neurons locations.
+        SpatialGrid m_grid;
+
+        //! Length of a side of a cell of the spatial index.
+        BGFLOAT m_grid_cell_size;
+
+        //! Original index of each neuron (empty if the neurons are not renumbered).
+        vector<int> m_original_index;
+
+        //! Layout index of each original index (empty if the neurons are not renumbered).
+        vector<int> m_layout_index;
 };
 
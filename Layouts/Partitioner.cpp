@@ -0,0 +1,127 @@
+#include "Partitioner.h"
+#include "SFCPartitioner.h"
+#include "RCBPartitioner.h"
+#include "GraphPartitioner.h"
+#include <algorithm>
+
+Partitioner::Partitioner()
+{
+}
+
+Partitioner::~Partitioner()
+{
+}
+
+/*
+ *  Creates a partitioner.
+ *
+ *  @param  type  Type of the partitioner.
+ *  @return Pointer to the partitioner, or NULL for the contiguous ranges.
+ */
+Partitioner* Partitioner::create(partitionerType type)
+{
+    switch (type) {
+    case SFC_PARTITION:
+        return new SFCPartitioner();
+    case RCB_PARTITION:
+        return new RCBPartitioner();
+    case GRAPH_PARTITION:
+        return new GraphPartitioner();
+    default:
+        return NULL;
+    }
+}
+
+/*
+ *  Get the estimated work of each neuron: the neuron and its incoming synapses.
+ *
+ *  @param  sources  Estimated source neurons of the incoming synapses of each neuron.
+ *  @param  work     Work of each neuron (output).
+ */
+void Partitioner::getWork(const vector<vector<int> > &sources, vector<BGSIZE> &work)
+{
+    work.resize(sources.size());
+    for (BGSIZE i = 0; i < sources.size(); i++) {
+        work[i] = 1 + sources[i].size();
+    }
+}
+
+/*
+ *  Cut an order of the neurons into parts of about the same work.
+ *  Each boundary is put where the cumulative work is the closest to its share,
+ *  and every part gets at least one neuron.
+ *
+ *  @param  order      Layout indices of the neurons.
+ *  @param  work       Work of each neuron.
+ *  @param  nParts     Number of parts.
+ *  @param  partSizes  Number of neurons of each part (output).
+ */
+void Partitioner::splitByWork(const vector<int> &order, const vector<BGSIZE> &work, int nParts, vector<int> &partSizes)
+{
+    int num_neurons = order.size();
+    int64_t totalWork = 0;
+    for (int i = 0; i < num_neurons; i++) {
+        totalWork += work[order[i]];
+    }
+
+    partSizes.assign(nParts, 0);
+    int64_t cumWork = 0;
+    int begin = 0;
+    for (int iPart = 0; iPart < nParts - 1; iPart++) {
+        int64_t target = totalWork * (iPart + 1) / nParts;
+        int last = num_neurons - (nParts - 1 - iPart);   // leave a neuron to each next part
+        int end = begin;
+        while (end < last && cumWork + work[order[end]] <= target) {
+            cumWork += work[order[end++]];
+        }
+        if (end < last && (end == begin || target - cumWork > cumWork + work[order[end]] - target)) {
+            cumWork += work[order[end++]];
+        }
+        partSizes[iPart] = end - begin;
+        begin = end;
+    }
+    partSizes[nParts - 1] = num_neurons - begin;
+}
+
+/*
+ *  Prints out the number of synapses cut between the parts and the work imbalance
+ *  of the parts (the work of the largest part over the average work).
+ *
+ *  @param  output     ostream to send output to.
+ *  @param  name       Name of the partition.
+ *  @param  sources    Source neurons of the incoming synapses of each neuron.
+ *  @param  order      Layout indices of the neurons, part by part.
+ *  @param  partSizes  Number of neurons of each part.
+ */
+void Partitioner::printReport(ostream &output, const char *name, const vector<vector<int> > &sources, const vector<int> &order, const vector<int> &partSizes)
+{
+    int nParts = partSizes.size();
+    vector<int> partOf(order.size());
+    for (int iPart = 0, i = 0; iPart < nParts; iPart++) {
+        for (int j = 0; j < partSizes[iPart]; j++, i++) {
+            partOf[order[i]] = iPart;
+        }
+    }
+
+    uint64_t totalSynapses = 0, cutSynapses = 0;
+    vector<uint64_t> partWork(nParts, 0);
+    for (BGSIZE i = 0; i < sources.size(); i++) {
+        partWork[partOf[i]] += 1 + sources[i].size();
+        totalSynapses += sources[i].size();
+        for (BGSIZE j = 0; j < sources[i].size(); j++) {
+            if (partOf[sources[i][j]] != partOf[i]) {
+                cutSynapses++;
+            }
+        }
+    }
+
+    uint64_t maxWork = 0, totalWork = 0;
+    for (int iPart = 0; iPart < nParts; iPart++) {
+        maxWork = max(maxWork, partWork[iPart]);
+        totalWork += partWork[iPart];
+    }
+
+    output << "Partition " << name << ": " << cutSynapses << " of " << totalSynapses << " synapses cut ("
+        << (totalSynapses > 0 ? 100.0 * cutSynapses / totalSynapses : 0.0) << "%), work imbalance "
+        << (totalWork > 0 ? static_cast<double>(maxWork) * nParts / totalWork : 1.0) << endl;
+}
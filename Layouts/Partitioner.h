@@ -0,0 +1,99 @@
+/**
+ *      @file Partitioner.h
+ *
+ *      @brief The base class of the partitioners of the neurons among the clusters
+ */
+
+/**
+ *
+ * @class Partitioner Partitioner.h "Partitioner.h"
+ *
+ * \latexonly  \subsubsection*{Implementation} \endlatexonly
+ * \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ *
+ * A cluster simulates a contiguous range of layout indices. By default (SimConfig
+ * partitioner contiguous), the ranges are cut from the layout in index order, so a
+ * cluster of a grid layout gets a band of rows. A partitioner groups the neurons that
+ * are close to each other, balancing the estimated work of the clusters (a neuron and
+ * its incoming synapses) and minimizing the synapses cut between the clusters, whose
+ * spikes have to be exchanged. The neurons are then renumbered part by part
+ * (Layout::renumberNeurons()), so that every cluster still gets a contiguous range.
+ *
+ * The synapses do not exist until the clusters are set up, so the partitioners work
+ * on the incoming connections estimated by the connections class
+ * (Connections::estimateConnections()).
+ *
+ */
+
+#pragma once
+
+#include "Global.h"
+#include "SimulationInfo.h"
+#include "Layout.h"
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+class Partitioner
+{
+    public:
+        Partitioner();
+        virtual ~Partitioner();
+
+        /**
+         *  Creates a partitioner.
+         *
+         *  @param  type  Type of the partitioner.
+         *  @return Pointer to the partitioner, or NULL for the contiguous ranges.
+         */
+        static Partitioner* create(partitionerType type);
+
+        /**
+         *  Get the name of the partitioner (as in the SimConfig partitioner parameter).
+         *
+         *  @return the name of the partitioner.
+         */
+        virtual const char* getName() const = 0;
+
+        /**
+         *  Partition the neurons.
+         *
+         *  @param  layout     Layout of the neurons.
+         *  @param  sources    Estimated source neurons of the incoming synapses of each neuron.
+         *  @param  nParts     Number of parts (clusters).
+         *  @param  order      Layout indices of the neurons, part by part (output).
+         *  @param  partSizes  Number of neurons of each part (output).
+         */
+        virtual void partition(const Layout *layout, const vector<vector<int> > &sources, int nParts, vector<int> &order, vector<int> &partSizes) = 0;
+
+        /**
+         *  Get the estimated work of each neuron: the neuron and its incoming synapses.
+         *
+         *  @param  sources  Estimated source neurons of the incoming synapses of each neuron.
+         *  @param  work     Work of each neuron (output).
+         */
+        static void getWork(const vector<vector<int> > &sources, vector<BGSIZE> &work);
+
+        /**
+         *  Cut an order of the neurons into parts of about the same work.
+         *
+         *  @param  order      Layout indices of the neurons.
+         *  @param  work       Work of each neuron.
+         *  @param  nParts     Number of parts.
+         *  @param  partSizes  Number of neurons of each part (output).
+         */
+        static void splitByWork(const vector<int> &order, const vector<BGSIZE> &work, int nParts, vector<int> &partSizes);
+
+        /**
+         *  Prints out the number of synapses cut between the parts and the work imbalance
+         *  of the parts (the work of the largest part over the average work).
+         *
+         *  @param  output     ostream to send output to.
+         *  @param  name       Name of the partition.
+         *  @param  sources    Source neurons of the incoming synapses of each neuron.
+         *  @param  order      Layout indices of the neurons, part by part.
+         *  @param  partSizes  Number of neurons of each part.
+         */
+        static void printReport(ostream &output, const char *name, const vector<vector<int> > &sources, const vector<int> &order, const vector<int> &partSizes);
+};
@@ -0,0 +1,113 @@
+#include "RCBPartitioner.h"
+#include <algorithm>
+
+/*
+ *  Orders the neurons by a coordinate, then by the other one and by layout index.
+ */
+class CoordinateLess
+{
+    public:
+        CoordinateLess(const BGFLOAT *first, const BGFLOAT *second) : m_first(first), m_second(second) {}
+
+        bool operator()(int i, int j) const
+        {
+            if (m_first[i] != m_first[j]) {
+                return m_first[i] < m_first[j];
+            }
+            if (m_second[i] != m_second[j]) {
+                return m_second[i] < m_second[j];
+            }
+            return i < j;
+        }
+
+    private:
+        const BGFLOAT *m_first;
+        const BGFLOAT *m_second;
+};
+
+RCBPartitioner::RCBPartitioner()
+{
+}
+
+RCBPartitioner::~RCBPartitioner()
+{
+}
+
+/*
+ *  Partition the neurons.
+ *
+ *  @param  layout     Layout of the neurons.
+ *  @param  sources    Estimated source neurons of the incoming synapses of each neuron.
+ *  @param  nParts     Number of parts (clusters).
+ *  @param  order      Layout indices of the neurons, part by part (output).
+ *  @param  partSizes  Number of neurons of each part (output).
+ */
+void RCBPartitioner::partition(const Layout *layout, const vector<vector<int> > &sources, int nParts, vector<int> &order, vector<int> &partSizes)
+{
+    vector<BGSIZE> work;
+    getWork(sources, work);
+
+    int num_neurons = sources.size();
+    order.resize(num_neurons);
+    for (int i = 0; i < num_neurons; i++) {
+        order[i] = i;
+    }
+
+    partSizes.clear();
+    bisect(layout, work, 0, num_neurons, nParts, order, partSizes);
+}
+
+/*
+ *  Bisect a range of the order recursively.
+ *
+ *  @param  layout     Layout of the neurons.
+ *  @param  work       Work of each neuron.
+ *  @param  begin      Begin of the range in the order.
+ *  @param  end        End of the range in the order.
+ *  @param  nParts     Number of parts of the range.
+ *  @param  order      Layout indices of the neurons, part by part (updated).
+ *  @param  partSizes  Number of neurons of each part (appended).
+ */
+void RCBPartitioner::bisect(const Layout *layout, const vector<BGSIZE> &work, int begin, int end, int nParts, vector<int> &order, vector<int> &partSizes)
+{
+    if (nParts == 1) {
+        partSizes.push_back(end - begin);
+        return;
+    }
+
+    // cut along the longer side of the bounding box
+    BGFLOAT minX = layout->xloc[order[begin]], maxX = minX;
+    BGFLOAT minY = layout->yloc[order[begin]], maxY = minY;
+    for (int i = begin + 1; i < end; i++) {
+        minX = min(minX, layout->xloc[order[i]]);
+        maxX = max(maxX, layout->xloc[order[i]]);
+        minY = min(minY, layout->yloc[order[i]]);
+        maxY = max(maxY, layout->yloc[order[i]]);
+    }
+    if (maxX - minX >= maxY - minY) {
+        sort(order.begin() + begin, order.begin() + end, CoordinateLess(layout->xloc, layout->yloc));
+    } else {
+        sort(order.begin() + begin, order.begin() + end, CoordinateLess(layout->yloc, layout->xloc));
+    }
+
+    // divide the work in the proportion of the parts of each side
+    int nLeftParts = nParts / 2;
+    int64_t totalWork = 0;
+    for (int i = begin; i < end; i++) {
+        totalWork += work[order[i]];
+    }
+    int64_t target = totalWork * nLeftParts / nParts;
+    int64_t cumWork = 0;
+    int mid = begin;
+    // leave at least a neuron to each part
+    int first = begin + nLeftParts, last = end - (nParts - nLeftParts);
+    while (mid < last && (mid < first || cumWork + work[order[mid]] <= target)) {
+        cumWork += work[order[mid++]];
+    }
+    if (mid < last && target - cumWork > cumWork + work[order[mid]] - target) {
+        mid++;
+    }
+
+    bisect(layout, work, begin, mid, nLeftParts, order, partSizes);
+    bisect(layout, work, mid, end, nParts - nLeftParts, order, partSizes);
+}
@@ -0,0 +1,64 @@
+/**
+ *      @file RCBPartitioner.h
+ *
+ *      @brief A partitioner that bisects the neurons recursively along their coordinates
+ */
+
+/**
+ *
+ * @class RCBPartitioner RCBPartitioner.h "RCBPartitioner.h"
+ *
+ * \latexonly  \subsubsection*{Implementation} \endlatexonly
+ * \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ *
+ * The RCBPartitioner (recursive coordinate bisection) cuts the neurons along the
+ * longer side of their bounding box, at the location that divides the estimated
+ * work in the proportion of the number of parts of each side, and cuts each side
+ * again until there is one part per cluster. The parts are rectangles, whose
+ * boundaries are about as short as possible for a number of clusters that is
+ * a power of two.
+ *
+ */
+
+#pragma once
+
+#include "Partitioner.h"
+
+class RCBPartitioner : public Partitioner
+{
+    public:
+        RCBPartitioner();
+        virtual ~RCBPartitioner();
+
+        /**
+         *  Get the name of the partitioner (as in the SimConfig partitioner parameter).
+         *
+         *  @return the name of the partitioner.
+         */
+        virtual const char* getName() const { return "rcb"; }
+
+        /**
+         *  Partition the neurons.
+         *
+         *  @param  layout     Layout of the neurons.
+         *  @param  sources    Estimated source neurons of the incoming synapses of each neuron.
+         *  @param  nParts     Number of parts (clusters).
+         *  @param  order      Layout indices of the neurons, part by part (output).
+         *  @param  partSizes  Number of neurons of each part (output).
+         */
+        virtual void partition(const Layout *layout, const vector<vector<int> > &sources, int nParts, vector<int> &order, vector<int> &partSizes);
+
+    private:
+        /**
+         *  Bisect a range of the order recursively.
+         *
+         *  @param  layout     Layout of the neurons.
+         *  @param  work       Work of each neuron.
+         *  @param  begin      Begin of the range in the order.
+         *  @param  end        End of the range in the order.
+         *  @param  nParts     Number of parts of the range.
+         *  @param  order      Layout indices of the neurons, part by part (updated).
+         *  @param  partSizes  Number of neurons of each part (appended).
+         */
+        void bisect(const Layout *layout, const vector<BGSIZE> &work, int begin, int end, int nParts, vector<int> &order, vector<int> &partSizes);
+};
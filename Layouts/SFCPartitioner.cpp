@@ -0,0 +1,102 @@
+#include "SFCPartitioner.h"
+#include <algorithm>
+
+//! Number of bits of the coordinates of the Hilbert curve grid.
+#define SFC_GRID_BITS 16
+
+SFCPartitioner::SFCPartitioner()
+{
+}
+
+SFCPartitioner::~SFCPartitioner()
+{
+}
+
+/*
+ *  Partition the neurons.
+ *
+ *  @param  layout     Layout of the neurons.
+ *  @param  sources    Estimated source neurons of the incoming synapses of each neuron.
+ *  @param  nParts     Number of parts (clusters).
+ *  @param  order      Layout indices of the neurons, part by part (output).
+ *  @param  partSizes  Number of neurons of each part (output).
+ */
+void SFCPartitioner::partition(const Layout *layout, const vector<vector<int> > &sources, int nParts, vector<int> &order, vector<int> &partSizes)
+{
+    vector<BGSIZE> work;
+    getWork(sources, work);
+
+    getCurveOrder(layout, sources.size(), order);
+    splitByWork(order, work, nParts, partSizes);
+}
+
+/*
+ *  Order the neurons along a Hilbert curve over their locations.
+ *  The locations are scaled to a grid of 2^SFC_GRID_BITS cells on the longer side
+ *  of their bounding box; the neurons of a cell keep the layout index order.
+ *
+ *  @param  layout       Layout of the neurons.
+ *  @param  num_neurons  Number of neurons.
+ *  @param  order        Layout indices of the neurons in the curve order (output).
+ */
+void SFCPartitioner::getCurveOrder(const Layout *layout, int num_neurons, vector<int> &order)
+{
+    order.resize(num_neurons);
+    if (num_neurons == 0) {
+        return;
+    }
+
+    // bounding box of the neurons
+    BGFLOAT minX = layout->xloc[0], maxX = layout->xloc[0];
+    BGFLOAT minY = layout->yloc[0], maxY = layout->yloc[0];
+    for (int i = 1; i < num_neurons; i++) {
+        minX = min(minX, layout->xloc[i]);
+        maxX = max(maxX, layout->xloc[i]);
+        minY = min(minY, layout->yloc[i]);
+        maxY = max(maxY, layout->yloc[i]);
+    }
+    BGFLOAT extent = max(maxX - minX, maxY - minY);
+    double scale = extent > 0 ? ((1 << SFC_GRID_BITS) - 1) / static_cast<double>(extent) : 0;
+
+    vector<pair<uint64_t, int> > keys(num_neurons);
+    for (int i = 0; i < num_neurons; i++) {
+        uint32_t x = static_cast<uint32_t>((layout->xloc[i] - minX) * scale);
+        uint32_t y = static_cast<uint32_t>((layout->yloc[i] - minY) * scale);
+        keys[i] = make_pair(getCurveIndex(x, y), i);
+    }
+    sort(keys.begin(), keys.end());
+
+    for (int i = 0; i < num_neurons; i++) {
+        order[i] = keys[i].second;
+    }
+}
+
+/*
+ *  Get the distance along the Hilbert curve of a cell of the curve grid.
+ *
+ *  @param  x  Column of the cell.
+ *  @param  y  Row of the cell.
+ *  @return the distance of the cell along the curve.
+ */
+uint64_t SFCPartitioner::getCurveIndex(uint32_t x, uint32_t y)
+{
+    const uint32_t n = 1 << SFC_GRID_BITS;
+    uint64_t d = 0;
+
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) ? 1 : 0;
+        uint32_t ry = (y & s) ? 1 : 0;
+        d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant, so that the curve of the sub-grid starts at its origin
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+
+    return d;
+}
@@ -0,0 +1,67 @@
+/**
+ *      @file SFCPartitioner.h
+ *
+ *      @brief A partitioner that cuts a space-filling curve through the neurons
+ */
+
+/**
+ *
+ * @class SFCPartitioner SFCPartitioner.h "SFCPartitioner.h"
+ *
+ * \latexonly  \subsubsection*{Implementation} \endlatexonly
+ * \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ *
+ * The SFCPartitioner orders the neurons along a Hilbert curve over their locations,
+ * and cuts the curve into parts of about the same estimated work. The neurons that are
+ * close on the curve are close in space, so the parts are compact, and the neurons of
+ * a part keep the curve order, which also keeps the neighbors close in memory.
+ *
+ */
+
+#pragma once
+
+#include "Partitioner.h"
+
+class SFCPartitioner : public Partitioner
+{
+    public:
+        SFCPartitioner();
+        virtual ~SFCPartitioner();
+
+        /**
+         *  Get the name of the partitioner (as in the SimConfig partitioner parameter).
+         *
+         *  @return the name of the partitioner.
+         */
+        virtual const char* getName() const { return "sfc"; }
+
+        /**
+         *  Partition the neurons.
+         *
+         *  @param  layout     Layout of the neurons.
+         *  @param  sources    Estimated source neurons of the incoming synapses of each neuron.
+         *  @param  nParts     Number of parts (clusters).
+         *  @param  order      Layout indices of the neurons, part by part (output).
+         *  @param  partSizes  Number of neurons of each part (output).
+         */
+        virtual void partition(const Layout *layout, const vector<vector<int> > &sources, int nParts, vector<int> &order, vector<int> &partSizes);
+
+        /**
+         *  Order the neurons along a Hilbert curve over their locations.
+         *
+         *  @param  layout       Layout of the neurons.
+         *  @param  num_neurons  Number of neurons.
+         *  @param  order        Layout indices of the neurons in the curve order (output).
+         */
+        static void getCurveOrder(const Layout *layout, int num_neurons, vector<int> &order);
+
+    private:
+        /**
+         *  Get the distance along the Hilbert curve of a cell of the curve grid.
+         *
+         *  @param  x  Column of the cell.
+         *  @param  y  Row of the cell.
+         *  @return the distance of the cell along the curve.
+         */
+        static uint64_t getCurveIndex(uint32_t x, uint32_t y);
+};
@@ -0,0 +1,184 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+SpatialGrid::SpatialGrid() :
+    m_xloc(NULL),
+    m_yloc(NULL),
+    m_cellSize(1),
+    m_minX(0),
+    m_minY(0),
+    m_nCellsX(0),
+    m_nCellsY(0)
+{
+}
+
+SpatialGrid::~SpatialGrid()
+{
+    clear();
+}
+
+/*
+ *  Bin the neurons into the cells of the grid.
+ *
+ *  @param  xloc         Neurons x location.
+ *  @param  yloc         Neurons y location.
+ *  @param  num_neurons  Number of neurons.
+ *  @param  cellSize     Length of a side of a cell.
+ */
+void SpatialGrid::build(const BGFLOAT *xloc, const BGFLOAT *yloc, int num_neurons, BGFLOAT cellSize)
+{
+    assert(cellSize > 0);
+
+    m_xloc = xloc;
+    m_yloc = yloc;
+    m_cellSize = cellSize;
+
+    // bounding box of the neurons
+    m_minX = 0;
+    m_minY = 0;
+    BGFLOAT maxX = 0, maxY = 0;
+    if (num_neurons > 0) {
+        m_minX = maxX = xloc[0];
+        m_minY = maxY = yloc[0];
+    }
+    for (int i = 1; i < num_neurons; i++) {
+        m_minX = min(m_minX, xloc[i]);
+        maxX = max(maxX, xloc[i]);
+        m_minY = min(m_minY, yloc[i]);
+        maxY = max(maxY, yloc[i]);
+    }
+    m_nCellsX = static_cast<int>((maxX - m_minX) / m_cellSize) + 1;
+    m_nCellsY = static_cast<int>((maxY - m_minY) / m_cellSize) + 1;
+
+    // count the neurons of each cell
+    vector<int> cellOf(num_neurons);
+    m_cellBegin.assign(m_nCellsX * m_nCellsY + 1, 0);
+    for (int i = 0; i < num_neurons; i++) {
+        int cx, cy;
+        getCell(xloc[i], yloc[i], cx, cy);
+        cellOf[i] = cy * m_nCellsX + cx;
+        m_cellBegin[cellOf[i] + 1]++;
+    }
+    for (int c = 0; c < m_nCellsX * m_nCellsY; c++) {
+        m_cellBegin[c + 1] += m_cellBegin[c];
+    }
+
+    // fill the cells (keeps ascending layout index order in each cell)
+    vector<int> cellFill(m_cellBegin.begin(), m_cellBegin.end() - 1);
+    m_cellNeurons.resize(num_neurons);
+    for (int i = 0; i < num_neurons; i++) {
+        m_cellNeurons[cellFill[cellOf[i]]++] = i;
+    }
+}
+
+/*
+ *  Release the cells of the grid.
+ */
+void SpatialGrid::clear()
+{
+    m_cellBegin.clear();
+    m_cellNeurons.clear();
+    m_nCellsX = m_nCellsY = 0;
+    m_xloc = m_yloc = NULL;
+}
+
+/*
+ *  Get the cell coordinates of a location (clamped to the grid).
+ */
+void SpatialGrid::getCell(BGFLOAT x, BGFLOAT y, int &cx, int &cy) const
+{
+    BGFLOAT fx = (x - m_minX) / m_cellSize;
+    BGFLOAT fy = (y - m_minY) / m_cellSize;
+    cx = fx < 0 ? 0 : min(static_cast<int>(fx), m_nCellsX - 1);
+    cy = fy < 0 ? 0 : min(static_cast<int>(fy), m_nCellsY - 1);
+}
+
+/*
+ *  Get all neurons within the radius of the neuron (excluding itself).
+ *
+ *  @param  neuron     Layout index of the neuron.
+ *  @param  radius     Radius of the query.
+ *  @param  neighbors  Vector to store the neighbors, sorted by ascending layout index.
+ */
+void SpatialGrid::getNeighborsInRange(int neuron, BGFLOAT radius, vector<int> &neighbors) const
+{
+    neighbors.clear();
+
+    BGFLOAT x = m_xloc[neuron];
+    BGFLOAT y = m_yloc[neuron];
+    int cxBegin, cyBegin, cxEnd, cyEnd;
+    getCell(x - radius, y - radius, cxBegin, cyBegin);
+    getCell(x + radius, y + radius, cxEnd, cyEnd);
+
+    for (int cy = cyBegin; cy <= cyEnd; cy++) {
+        for (int cx = cxBegin; cx <= cxEnd; cx++) {
+            int c = cy * m_nCellsX + cx;
+            for (int k = m_cellBegin[c]; k < m_cellBegin[c + 1]; k++) {
+                int j = m_cellNeurons[k];
+                if (j != neuron && sqrt(dist2(neuron, j)) <= radius) {
+                    neighbors.push_back(j);
+                }
+            }
+        }
+    }
+
+    sort(neighbors.begin(), neighbors.end());
+}
+
+/*
+ *  Get the k nearest neurons of the neuron (excluding itself).
+ *  Neurons at the same distance are ordered by ascending layout index.
+ *
+ *  @param  neuron     Layout index of the neuron.
+ *  @param  k          Number of neighbors to get.
+ *  @param  neighbors  Vector to store the neighbors, sorted by ascending distance.
+ */
+void SpatialGrid::getNearestNeighbors(int neuron, int k, vector<int> &neighbors) const
+{
+    neighbors.clear();
+    if (k <= 0) {
+        return;
+    }
+
+    int cx, cy;
+    getCell(m_xloc[neuron], m_yloc[neuron], cx, cy);
+
+    // visit rings of cells around the cell of the neuron
+    vector< pair<BGFLOAT, int> > candidates;
+    int maxRing = max(m_nCellsX, m_nCellsY);
+    for (int ring = 0; ring < maxRing; ring++) {
+        for (int y = cy - ring; y <= cy + ring; y++) {
+            if (y < 0 || y >= m_nCellsY) {
+                continue;
+            }
+            // inner rows of the ring only have the first and last cells
+            int step = (y == cy - ring || y == cy + ring) ? 1 : 2 * ring;
+            for (int x = cx - ring; x <= cx + ring; x += step) {
+                if (x < 0 || x >= m_nCellsX) {
+                    continue;
+                }
+                int c = y * m_nCellsX + x;
+                for (int i = m_cellBegin[c]; i < m_cellBegin[c + 1]; i++) {
+                    int j = m_cellNeurons[i];
+                    if (j != neuron) {
+                        candidates.push_back(make_pair(dist2(neuron, j), j));
+                    }
+                }
+            }
+        }
+
+        // neurons out of the visited rings are at least ring * m_cellSize away
+        if (static_cast<int>(candidates.size()) >= k) {
+            nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+            BGFLOAT bound = ring * m_cellSize;
+            if (candidates[k - 1].first < bound * bound) {
+                break;
+            }
+        }
+    }
+
+    sort(candidates.begin(), candidates.end());
+    for (int i = 0; i < k && i < static_cast<int>(candidates.size()); i++) {
+        neighbors.push_back(candidates[i].second);
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ *      @file SpatialGrid.h
+ *
+ *      @brief A uniform grid (cell list) spatial index over neurons locations
+ */
+
+/**
+ *
+ * @class SpatialGrid SpatialGrid.h "SpatialGrid.h"
+ *
+ * \latexonly  \subsubsection*{Implementation} \endlatexonly
+ * \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ *
+ * The SpatialGrid class bins the neurons into square cells of a fixed size
+ * (a counting sort over the cells, so that the neurons of every cell are kept
+ * in ascending layout index order), and answers range and k-nearest neighbor
+ * queries by visiting only the cells around the query neuron.
+ * Distances are computed on demand from the neurons locations,
+ * so that the memory used is O(number of neurons).
+ *
+ */
+
+#pragma once
+
+#include "Global.h"
+#include <vector>
+
+using namespace std;
+
+class SpatialGrid
+{
+    public:
+        SpatialGrid();
+        virtual ~SpatialGrid();
+
+        /**
+         *  Bin the neurons into the cells of the grid.
+         *
+         *  @param  xloc         Neurons x location.
+         *  @param  yloc         Neurons y location.
+         *  @param  num_neurons  Number of neurons.
+         *  @param  cellSize     Length of a side of a cell.
+         */
+        void build(const BGFLOAT *xloc, const BGFLOAT *yloc, int num_neurons, BGFLOAT cellSize);
+
+        /**
+         *  Release the cells of the grid.
+         */
+        void clear();
+
+        /**
+         *  Get all neurons within the radius of the neuron (excluding itself).
+         *
+         *  @param  neuron     Layout index of the neuron.
+         *  @param  radius     Radius of the query.
+         *  @param  neighbors  Vector to store the neighbors, sorted by ascending layout index.
+         */
+        void getNeighborsInRange(int neuron, BGFLOAT radius, vector<int> &neighbors) const;
+
+        /**
+         *  Get the k nearest neurons of the neuron (excluding itself).
+         *  Neurons at the same distance are ordered by ascending layout index.
+         *
+         *  @param  neuron     Layout index of the neuron.
+         *  @param  k          Number of neighbors to get.
+         *  @param  neighbors  Vector to store the neighbors, sorted by ascending distance.
+         */
+        void getNearestNeighbors(int neuron, int k, vector<int> &neighbors) const;
+
+        /**
+         *  Get the length of a side of a cell.
+         *
+         *  @return the length of a side of a cell.
+         */
+        BGFLOAT getCellSize() const { return m_cellSize; }
+
+    private:
+        /**
+         *  Distance squared between two neurons.
+         */
+        BGFLOAT dist2(int i, int j) const
+        {
+            return (m_xloc[i] - m_xloc[j]) * (m_xloc[i] - m_xloc[j]) +
+                (m_yloc[i] - m_yloc[j]) * (m_yloc[i] - m_yloc[j]);
+        }
+
+        /**
+         *  Get the cell coordinates of a location (clamped to the grid).
+         */
+        void getCell(BGFLOAT x, BGFLOAT y, int &cx, int &cy) const;
+
+        //! Neurons x location.
+        const BGFLOAT *m_xloc;
+
+        //! Neurons y location.
+        const BGFLOAT *m_yloc;
+
+        //! Length of a side of a cell.
+        BGFLOAT m_cellSize;
+
+        //! Lower left corner of the grid.
+        BGFLOAT m_minX, m_minY;
+
+        //! Number of cells in x and y dimension.
+        int m_nCellsX, m_nCellsY;
+
+        //! Begin index of each cell in m_cellNeurons (number of cells + 1 entries).
+        vector<int> m_cellBegin;
+
+        //! Layout indexes of the neurons, grouped by cell.
+        vector<int> m_cellNeurons;
+};
@@ -17,3 +17,97 @@ void AllIFNeurons::createNeuronsProps()
     m_pNeuronsProps = new AllIFNeuronsProps();
 }
 
+
+#if !defined(USE_GPU)
+/*
+ *  Prepare the concurrent advance of a neuron in the current time step:
+ *  draw the noise that the neuron uses (unless the cluster draws the noise
+ *  of all its neurons at once), and grow the spike history of the
+ *  neuron if it fires with a full spike history.
+ *  The conditions are the ones of advanceNeuron() of the IF neurons.
+ *
+ *  @param  index                 Index of the Neuron.
+ *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+ *  @param  normRand              Pointer to the normalized random number generator.
+ *  @param  noise                 The noise drawn.
+ *  @return true if the noise is drawn.
+ */
+bool AllIFNeurons::prepareAdvanceNeuron(const int index, int maxSpikes, Norm* normRand, BGFLOAT &noise)
+{
+    AllIFNeuronsProps *pNeuronsProps = static_cast<AllIFNeuronsProps*>(m_pNeuronsProps);
+
+    if (pNeuronsProps->nStepsInRefr[index] > 0) { // is neuron refractory?
+        return false;
+    }
+
+    if (pNeuronsProps->Vm[index] >= pNeuronsProps->Vthresh[index]) { // should it fire?
+        // fire() grows the spike history, which reallocates the buffer of all neurons
+        if (pNeuronsProps->spikeCount[index] >= pNeuronsProps->spikeHistorySize[index]) {
+            pNeuronsProps->growSpikeHistory(index, maxSpikes);
+        }
+        return false;
+    }
+
+    // the noise of the step is already drawn by the cluster
+    if (m_randNoise != NULL) {
+        return false;
+    }
+
+    noise = (*normRand)();
+    return true;
+}
+#endif // !USE_GPU
+
+#if defined(IF_NEURONS_SIMD_WIDTH)
+/*
+ *  Setup the internal structure of the class (allocate memories).
+ *
+ *  @param  sim_info  SimulationInfo class to read information from.
+ *  @param  clr_info  ClusterInfo class to read information from.
+ */
+void AllIFNeurons::setupNeurons(SimulationInfo *sim_info, ClusterInfo *clr_info)
+{
+    AllSpikingNeurons::setupNeurons(sim_info, clr_info);
+
+    m_blockNoise.assign(clr_info->totalClusterNeurons, 0);
+}
+
+/*
+ *  Update the state of the neurons in a range for a time step, without
+ *  notifying the synapses. The noise is drawn in descending index order.
+ *  The neurons are advanced by blocks of IF_NEURONS_SIMD_WIDTH neurons,
+ *  which give the same results as the scalar reference.
+ *
+ *  @param  iNeuronBegin          Index of the first neuron of the range.
+ *  @param  iNeuronEnd            Index after the last neuron of the range.
+ *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+ *  @param  deltaT                Inner simulation step duration.
+ *  @param  simulationStep        The current simulation step.
+ *  @param  normRand              Pointer to the normalized random number generator.
+ */
+void AllIFNeurons::advanceNeuronsBatch(int iNeuronBegin, int iNeuronEnd, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, Norm* normRand)
+{
+    AllIFNeuronsProps *pNeuronsProps = static_cast<AllIFNeuronsProps*>(m_pNeuronsProps);
+    int iBlocksEnd = iNeuronBegin + (iNeuronEnd - iNeuronBegin) / IF_NEURONS_SIMD_WIDTH * IF_NEURONS_SIMD_WIDTH;
+
+    // The neurons after the last block come first in descending index order,
+    // so the scalar reference advances them and draws their noise first.
+    AllSpikingNeurons::advanceNeuronsBatch(iBlocksEnd, iNeuronEnd, maxSpikes, deltaT, simulationStep, normRand);
+
+    // the noise of the step may already be drawn by the cluster
+    const BGFLOAT *noise = m_randNoise;
+    if (noise == NULL) {
+        // draw the noise of the integrating neurons of the blocks, in the same order
+        for (int idx = iBlocksEnd - 1; idx >= iNeuronBegin; --idx) {
+            if (!(pNeuronsProps->nStepsInRefr[idx] > 0) && !(pNeuronsProps->Vm[idx] >= pNeuronsProps->Vthresh[idx])) {
+                m_blockNoise[idx] = (*normRand)();
+            }
+        }
+        noise = &m_blockNoise[0];
+    }
+
+    for (int idx = iNeuronBegin; idx < iBlocksEnd; idx += IF_NEURONS_SIMD_WIDTH) {
+        advanceNeuronsBlock(idx, maxSpikes, deltaT, simulationStep, noise);
+    }
+}
+#endif // IF_NEURONS_SIMD_WIDTH
@@ -41,6 +41,14 @@
 #include "AllSpikingNeurons.h"
 #include "AllIFNeuronsProps.h"
 
+// IF_NEURONS_SIMD_WIDTH: number of neurons advanced per iteration by the vectorized
+// kernels of the IF neurons. It is defined for all the objects by the Makefile (see
+// CSIMD), while only the objects of the kernels are compiled with the vector
+// instructions, and undefined when the host build has scalar kernels only.
+#if defined(USE_GPU)
+#undef IF_NEURONS_SIMD_WIDTH
+#endif // USE_GPU
+
 class AllIFNeurons : public AllSpikingNeurons
 {
     public:
@@ -51,5 +59,66 @@ class AllIFNeurons : public AllSpikingNeurons
          *  Create and setup neurons properties.
          */
         virtual void createNeuronsProps();
+
+#if defined(IF_NEURONS_SIMD_WIDTH)
+        /**
+         *  Setup the internal structure of the class (allocate memories).
+         *
+         *  @param  sim_info  SimulationInfo class to read information from.
+         *  @param  clr_info  ClusterInfo class to read information from.
+         */
+        virtual void setupNeurons(SimulationInfo *sim_info, ClusterInfo *clr_info);
+
+        /**
+         *  Update the state of the neurons in a range for a time step, without
+         *  notifying the synapses. The noise is drawn in descending index order.
+         *  The neurons are advanced by blocks of IF_NEURONS_SIMD_WIDTH neurons,
+         *  which give the same results as the scalar reference.
+         *
+         *  @param  iNeuronBegin          Index of the first neuron of the range.
+         *  @param  iNeuronEnd            Index after the last neuron of the range.
+         *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+         *  @param  deltaT                Inner simulation step duration.
+         *  @param  simulationStep        The current simulation step.
+         *  @param  normRand              Pointer to the normalized random number generator.
+         */
+        virtual void advanceNeuronsBatch(int iNeuronBegin, int iNeuronEnd, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, Norm* normRand);
+
+    protected:
+        /**
+         *  Advance the IF_NEURONS_SIMD_WIDTH neurons of a block with vector instructions:
+         *  the refractory, firing and integrating neurons are selected by masks,
+         *  and the firing neurons then call fire().
+         *
+         *  @param  iNeuron               Index of the first neuron of the block.
+         *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+         *  @param  deltaT                Inner simulation step duration.
+         *  @param  simulationStep        The current simulation step.
+         *  @param  noise                 The noise of the neurons, by neuron index
+         *                                (only read for the integrating neurons).
+         */
+        virtual void advanceNeuronsBlock(int iNeuron, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, const BGFLOAT *noise) = 0;
+
+    private:
+        //! The noise drawn for the vectorized kernels, by neuron index.
+        vector<BGFLOAT> m_blockNoise;
+#endif // IF_NEURONS_SIMD_WIDTH
+
+#if !defined(USE_GPU)
+    protected:
+        /**
+         *  Prepare the concurrent advance of a neuron in the current time step:
+         *  draw the noise that the neuron uses (unless the cluster draws the noise
+         *  of all its neurons at once), and grow the spike history of the
+         *  neuron if it fires with a full spike history.
+         *
+         *  @param  index                 Index of the Neuron.
+         *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+         *  @param  normRand              Pointer to the normalized random number generator.
+         *  @param  noise                 The noise drawn.
+         *  @return true if the noise is drawn.
+         */
+        virtual bool prepareAdvanceNeuron(const int index, int maxSpikes, Norm* normRand, BGFLOAT &noise);
+#endif // !USE_GPU
 };
 
@@ -1,4 +1,5 @@
 #include "AllIFNeuronsProps.h"
+#include "Checkpoint.h"
 #include "ParseParamError.h"
 #if defined(USE_GPU)
 #include <helper_cuda.h>
@@ -552,7 +553,6 @@ void AllIFNeuronsProps::setNeuronPropValues(SimulationInfo *sim_info, int neuron
     BGFLOAT &Vreset = this->Vreset[neuron_index];
     BGFLOAT &Vinit = this->Vinit[neuron_index];
     BGFLOAT &Vm = this->Vm[neuron_index];
-    uint64_t *&spike_history = this->spike_history[neuron_index];
     BGFLOAT &Trefract = this->Trefract[neuron_index];
     BGFLOAT &I0 = this->I0[neuron_index];
     BGFLOAT &C1 = this->C1[neuron_index];
@@ -569,12 +569,6 @@ void AllIFNeuronsProps::setNeuronPropValues(SimulationInfo *sim_info, int neuron
 
     initNeuronPropConstsFromParamValues(neuron_index, sim_info->deltaT);
 
-    int max_spikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
-    spike_history = new uint64_t[max_spikes];
-    for (int j = 0; j < max_spikes; ++j) {
-        spike_history[j] = ULONG_MAX;
-    }
-
     int neuron_layout_index = clr_info->clusterNeuronsBegin + neuron_index;
     switch (layout->neuron_type_map[neuron_layout_index]) {
         case INH:
@@ -675,3 +669,35 @@ void AllIFNeuronsProps::initNeuronPropConstsFromParamValues(int neuron_index, co
                 assert(false);
         }
 }
+
+#if !defined(USE_GPU)
+/*
+ *  Add the state of the neurons that changes during the simulation
+ *  to a periodic checkpoint.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the neurons.
+ */
+void AllIFNeuronsProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    AllSpikingNeuronsProps::checkpointState(writer, iCluster);
+
+    writer.addArray(CKPT_NEURON_VM, iCluster, Vm, size);
+    writer.addArray(CKPT_NEURON_STEPS_IN_REFR, iCluster, nStepsInRefr, size);
+}
+
+/*
+ *  Restore the state of the neurons that changes during the simulation
+ *  from a periodic checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the neurons.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllIFNeuronsProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    return AllSpikingNeuronsProps::restoreState(reader, iCluster)
+        && reader.restoreArray(CKPT_NEURON_VM, iCluster, Vm, size)
+        && reader.restoreArray(CKPT_NEURON_STEPS_IN_REFR, iCluster, nStepsInRefr, size);
+}
+#endif // !USE_GPU
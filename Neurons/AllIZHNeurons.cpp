@@ -7,6 +7,16 @@
 #if defined(USE_GPU)
 #include <helper_cuda.h>
 #endif
+#if defined(IF_NEURONS_SIMD_WIDTH)
+#include <immintrin.h>
+#if (IF_NEURONS_SIMD_WIDTH == 16 && !defined(__AVX512F__)) || (IF_NEURONS_SIMD_WIDTH == 8 && !defined(__AVX2__))
+#error "The vector kernels of the neurons must be compiled with the SIMDFLAGS of the Makefile"
+#endif
+#include <type_traits>
+// the _ps intrinsics of the vector kernels work on floats
+static_assert(std::is_same<BGFLOAT, float>::value,
+              "The vector kernels of the neurons need BGFLOAT to be float (SINGLEPRECISION in BGTypes.h)");
+#endif
 
 // Default constructor
 CUDA_CALLABLE AllIZHNeurons::AllIZHNeurons()
@@ -73,7 +83,7 @@ Norm* normRand)
 #if defined(USE_GPU)
         BGFLOAT noise = randNoise[index];
 #else // defined(USE_GPU)
-        BGFLOAT noise = (*normRand)();
+        BGFLOAT noise = (m_randNoise != NULL) ? m_randNoise[index] : (*normRand)();
 #endif // defined(USE_GPU)
         DEBUG_MID(printf("ADVANCE NEURON[%d] :: noise = %f\n", index, noise);)
         summationPoint += noise * Inoise; // add noise
@@ -136,6 +146,182 @@ CUDA_CALLABLE void AllIZHNeurons::fire(const int index, int maxSpikes, const BGF
     u = u + d;
 }
 
+#if defined(IF_NEURONS_SIMD_WIDTH)
+#if IF_NEURONS_SIMD_WIDTH == 16
+/*
+ *  Compute Vb = Vint + C3 * (0.04 * Vint * Vint + 5 * Vint + 140 - u) for 8 neurons,
+ *  in double precision as advanceNeuron() does.
+ */
+static inline __m256 izhikevichVb(__m256 Vint, __m256 u, __m256 C3)
+{
+    __m512d dVint = _mm512_cvtps_pd(Vint);
+    __m512d t = _mm512_mul_pd(_mm512_mul_pd(_mm512_set1_pd(0.04), dVint), dVint);
+    t = _mm512_add_pd(t, _mm512_cvtps_pd(_mm256_mul_ps(_mm256_set1_ps(5), Vint)));
+    t = _mm512_sub_pd(_mm512_add_pd(t, _mm512_set1_pd(140)), _mm512_cvtps_pd(u));
+    return _mm512_cvtpd_ps(_mm512_add_pd(dVint, _mm512_mul_pd(_mm512_cvtps_pd(C3), t)));
+}
+
+/*
+ *  Compute Vm = Vb * 0.001 + input for 8 neurons, in double precision as advanceNeuron() does.
+ */
+static inline __m256 izhikevichVm(__m256 Vb, __m256 input)
+{
+    return _mm512_cvtpd_ps(_mm512_add_pd(_mm512_mul_pd(_mm512_cvtps_pd(Vb), _mm512_set1_pd(0.001)), _mm512_cvtps_pd(input)));
+}
+
+//! The low 8 floats of a vector.
+static inline __m256 lowHalf(__m512 v)
+{
+    return _mm512_castps512_ps256(v);
+}
+
+//! The high 8 floats of a vector.
+static inline __m256 highHalf(__m512 v)
+{
+    return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1));
+}
+
+//! A vector made of two halves of 8 floats.
+static inline __m512 joinHalves(__m256 low, __m256 high)
+{
+    return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(low)), _mm256_castps_pd(high), 1));
+}
+#else // IF_NEURONS_SIMD_WIDTH == 8
+/*
+ *  Compute Vb = Vint + C3 * (0.04 * Vint * Vint + 5 * Vint + 140 - u) for 4 neurons,
+ *  in double precision as advanceNeuron() does.
+ */
+static inline __m128 izhikevichVb(__m128 Vint, __m128 u, __m128 C3)
+{
+    __m256d dVint = _mm256_cvtps_pd(Vint);
+    __m256d t = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.04), dVint), dVint);
+    t = _mm256_add_pd(t, _mm256_cvtps_pd(_mm_mul_ps(_mm_set1_ps(5), Vint)));
+    t = _mm256_sub_pd(_mm256_add_pd(t, _mm256_set1_pd(140)), _mm256_cvtps_pd(u));
+    return _mm256_cvtpd_ps(_mm256_add_pd(dVint, _mm256_mul_pd(_mm256_cvtps_pd(C3), t)));
+}
+
+/*
+ *  Compute Vm = Vb * 0.001 + input for 4 neurons, in double precision as advanceNeuron() does.
+ */
+static inline __m128 izhikevichVm(__m128 Vb, __m128 input)
+{
+    return _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(Vb), _mm256_set1_pd(0.001)), _mm256_cvtps_pd(input)));
+}
+
+//! The low 4 floats of a vector.
+static inline __m128 lowHalf(__m256 v)
+{
+    return _mm256_castps256_ps128(v);
+}
+
+//! The high 4 floats of a vector.
+static inline __m128 highHalf(__m256 v)
+{
+    return _mm256_extractf128_ps(v, 1);
+}
+
+//! A vector made of two halves of 4 floats.
+static inline __m256 joinHalves(__m128 low, __m128 high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+#endif
+
+/*
+ *  Advance the IF_NEURONS_SIMD_WIDTH neurons of a block with vector instructions:
+ *  the refractory, firing and integrating neurons are selected by masks,
+ *  and the firing neurons then call fire().
+ *  The arithmetic is the one of advanceNeuron(), operation by operation.
+ *
+ *  @param  iNeuron               Index of the first neuron of the block.
+ *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+ *  @param  deltaT                Inner simulation step duration.
+ *  @param  simulationStep        The current simulation step.
+ *  @param  noise                 The noise of the neurons, by neuron index
+ *                                (only read for the integrating neurons).
+ */
+void AllIZHNeurons::advanceNeuronsBlock(int iNeuron, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, const BGFLOAT *noise)
+{
+    AllIZHNeuronsProps *pNeuronsProps = static_cast<AllIZHNeuronsProps*>(m_pNeuronsProps);
+    BGFLOAT *Vm = &pNeuronsProps->Vm[iNeuron];
+    BGFLOAT *u = &pNeuronsProps->u[iNeuron];
+    BGFLOAT *summationPoint = &pNeuronsProps->summation_map[iNeuron];
+    int *nStepsInRefr = &pNeuronsProps->nStepsInRefr[iNeuron];
+
+#if IF_NEURONS_SIMD_WIDTH == 16
+    __m512i vSteps = _mm512_loadu_si512(nStepsInRefr);
+    __m512 vVm = _mm512_loadu_ps(Vm);
+    __m512 vU = _mm512_loadu_ps(u);
+    __m512 vC3 = _mm512_loadu_ps(&pNeuronsProps->C3[iNeuron]);
+
+    __mmask16 refractory = _mm512_cmpgt_epi32_mask(vSteps, _mm512_setzero_si512());
+    __mmask16 aboveThresh = _mm512_cmp_ps_mask(vVm, _mm512_loadu_ps(&pNeuronsProps->Vthresh[iNeuron]), _CMP_GE_OQ);
+    unsigned int fires = aboveThresh & ~refractory;
+    __mmask16 integrates = ~(refractory | aboveThresh);
+
+    // summationPoint += I0, then += noise * Inoise
+    __m512 vSum = _mm512_add_ps(_mm512_loadu_ps(summationPoint), _mm512_loadu_ps(&pNeuronsProps->I0[iNeuron]));
+    vSum = _mm512_add_ps(vSum, _mm512_mul_ps(_mm512_loadu_ps(&noise[iNeuron]), _mm512_loadu_ps(&pNeuronsProps->Inoise[iNeuron])));
+
+    __m512 vVint = _mm512_mul_ps(vVm, _mm512_set1_ps(1000));
+    __m512 vVb = joinHalves(izhikevichVb(lowHalf(vVint), lowHalf(vU), lowHalf(vC3)), izhikevichVb(highHalf(vVint), highHalf(vU), highHalf(vC3)));
+
+    // u = u + C3 * a * (b * Vint - u)
+    __m512 vBVint = _mm512_mul_ps(_mm512_loadu_ps(&pNeuronsProps->Bconst[iNeuron]), vVint);
+    __m512 vUNext = _mm512_add_ps(vU, _mm512_mul_ps(_mm512_mul_ps(vC3, _mm512_loadu_ps(&pNeuronsProps->Aconst[iNeuron])), _mm512_sub_ps(vBVint, vU)));
+
+    // Vm = Vb * 0.001 + C2 * summationPoint
+    __m512 vInput = _mm512_mul_ps(_mm512_loadu_ps(&pNeuronsProps->C2[iNeuron]), vSum);
+    __m512 vVmNext = joinHalves(izhikevichVm(lowHalf(vVb), lowHalf(vInput)), izhikevichVm(highHalf(vVb), highHalf(vInput)));
+
+    _mm512_storeu_ps(Vm, _mm512_mask_mov_ps(vVm, integrates, vVmNext));
+    _mm512_storeu_ps(u, _mm512_mask_mov_ps(vU, integrates, vUNext));
+    _mm512_storeu_si512(nStepsInRefr, _mm512_mask_sub_epi32(vSteps, refractory, vSteps, _mm512_set1_epi32(1)));
+    _mm512_storeu_ps(summationPoint, _mm512_setzero_ps());
+#else // IF_NEURONS_SIMD_WIDTH == 8
+    __m256i vSteps = _mm256_loadu_si256(reinterpret_cast<__m256i*>(nStepsInRefr));
+    __m256 vVm = _mm256_loadu_ps(Vm);
+    __m256 vU = _mm256_loadu_ps(u);
+    __m256 vC3 = _mm256_loadu_ps(&pNeuronsProps->C3[iNeuron]);
+
+    __m256 refractory = _mm256_castsi256_ps(_mm256_cmpgt_epi32(vSteps, _mm256_setzero_si256()));
+    __m256 aboveThresh = _mm256_cmp_ps(vVm, _mm256_loadu_ps(&pNeuronsProps->Vthresh[iNeuron]), _CMP_GE_OQ);
+    unsigned int fires = _mm256_movemask_ps(_mm256_andnot_ps(refractory, aboveThresh));
+    __m256 notIntegrates = _mm256_or_ps(refractory, aboveThresh);
+
+    // summationPoint += I0, then += noise * Inoise
+    __m256 vSum = _mm256_add_ps(_mm256_loadu_ps(summationPoint), _mm256_loadu_ps(&pNeuronsProps->I0[iNeuron]));
+    vSum = _mm256_add_ps(vSum, _mm256_mul_ps(_mm256_loadu_ps(&noise[iNeuron]), _mm256_loadu_ps(&pNeuronsProps->Inoise[iNeuron])));
+
+    __m256 vVint = _mm256_mul_ps(vVm, _mm256_set1_ps(1000));
+    __m256 vVb = joinHalves(izhikevichVb(lowHalf(vVint), lowHalf(vU), lowHalf(vC3)), izhikevichVb(highHalf(vVint), highHalf(vU), highHalf(vC3)));
+
+    // u = u + C3 * a * (b * Vint - u)
+    __m256 vBVint = _mm256_mul_ps(_mm256_loadu_ps(&pNeuronsProps->Bconst[iNeuron]), vVint);
+    __m256 vUNext = _mm256_add_ps(vU, _mm256_mul_ps(_mm256_mul_ps(vC3, _mm256_loadu_ps(&pNeuronsProps->Aconst[iNeuron])), _mm256_sub_ps(vBVint, vU)));
+
+    // Vm = Vb * 0.001 + C2 * summationPoint
+    __m256 vInput = _mm256_mul_ps(_mm256_loadu_ps(&pNeuronsProps->C2[iNeuron]), vSum);
+    __m256 vVmNext = joinHalves(izhikevichVm(lowHalf(vVb), lowHalf(vInput)), izhikevichVm(highHalf(vVb), highHalf(vInput)));
+
+    _mm256_storeu_ps(Vm, _mm256_blendv_ps(vVmNext, vVm, notIntegrates));
+    _mm256_storeu_ps(u, _mm256_blendv_ps(vUNext, vU, notIntegrates));
+    // a refractory lane of the mask is -1
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(nStepsInRefr), _mm256_add_epi32(vSteps, _mm256_castps_si256(refractory)));
+    _mm256_storeu_ps(summationPoint, _mm256_setzero_ps());
+#endif
+
+    fill(&pNeuronsProps->hasFired[iNeuron], &pNeuronsProps->hasFired[iNeuron] + IF_NEURONS_SIMD_WIDTH, false);
+
+    // fire in the descending index order of the scalar reference
+    for (int i = IF_NEURONS_SIMD_WIDTH - 1; i >= 0; --i) {
+        if (fires & (1u << i)) {
+            fire(iNeuron + i, maxSpikes, deltaT, simulationStep, m_pNeuronsProps);
+        }
+    }
+}
+#endif // IF_NEURONS_SIMD_WIDTH
+
 #if defined(USE_GPU)
 
 /*
@@ -145,6 +145,23 @@ class AllIZHNeurons : public AllIFNeurons
 
 #endif // defined(USE_GPU)
 
+#if defined(IF_NEURONS_SIMD_WIDTH)
+    protected:
+        /**
+         *  Advance the IF_NEURONS_SIMD_WIDTH neurons of a block with vector instructions:
+         *  the refractory, firing and integrating neurons are selected by masks,
+         *  and the firing neurons then call fire().
+         *
+         *  @param  iNeuron               Index of the first neuron of the block.
+         *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+         *  @param  deltaT                Inner simulation step duration.
+         *  @param  simulationStep        The current simulation step.
+         *  @param  noise                 The noise of the neurons, by neuron index
+         *                                (only read for the integrating neurons).
+         */
+        virtual void advanceNeuronsBlock(int iNeuron, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, const BGFLOAT *noise);
+#endif // IF_NEURONS_SIMD_WIDTH
+
     protected:
         /**
          *  Initiates a firing of a neuron to connected neurons.
@@ -1,4 +1,5 @@
 #include "AllIZHNeuronsProps.h"
+#include "Checkpoint.h"
 #include "ParseParamError.h"
 #if defined(USE_GPU)
 #include <helper_cuda.h>
@@ -578,3 +579,32 @@ void AllIZHNeuronsProps::initNeuronPropConstsFromParamValues(int neuron_index, c
     C3 = deltaT * 1000;
 }
 
+#if !defined(USE_GPU)
+/*
+ *  Add the state of the neurons that changes during the simulation
+ *  to a periodic checkpoint.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the neurons.
+ */
+void AllIZHNeuronsProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    AllIFNeuronsProps::checkpointState(writer, iCluster);
+
+    writer.addArray(CKPT_NEURON_U, iCluster, u, size);
+}
+
+/*
+ *  Restore the state of the neurons that changes during the simulation
+ *  from a periodic checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the neurons.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllIZHNeuronsProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    return AllIFNeuronsProps::restoreState(reader, iCluster)
+        && reader.restoreArray(CKPT_NEURON_U, iCluster, u, size);
+}
+#endif // !USE_GPU
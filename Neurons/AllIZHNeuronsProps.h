@@ -164,6 +164,27 @@ class AllIZHNeuronsProps : public AllIFNeuronsProps
          */
         virtual void setNeuronPropDefaults(const int index);
 
+#if !defined(USE_GPU)
+        /**
+         *  Add the state of the neurons that changes during the simulation
+         *  to a periodic checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the neurons.
+         */
+        virtual void checkpointState(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore the state of the neurons that changes during the simulation
+         *  from a periodic checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the neurons.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader, int iCluster);
+#endif // !USE_GPU
+
     protected:
         /**
          *  Initializes the Neuron constants at the indexed location.
@@ -3,6 +3,16 @@
 #if defined(USE_GPU)
 #include <helper_cuda.h>
 #endif
+#if defined(IF_NEURONS_SIMD_WIDTH)
+#include <immintrin.h>
+#if (IF_NEURONS_SIMD_WIDTH == 16 && !defined(__AVX512F__)) || (IF_NEURONS_SIMD_WIDTH == 8 && !defined(__AVX2__))
+#error "The vector kernels of the neurons must be compiled with the SIMDFLAGS of the Makefile"
+#endif
+#include <type_traits>
+// the _ps intrinsics of the vector kernels work on floats
+static_assert(std::is_same<BGFLOAT, float>::value,
+              "The vector kernels of the neurons need BGFLOAT to be float (SINGLEPRECISION in BGTypes.h)");
+#endif
 
 // Default constructor
 CUDA_CALLABLE AllLIFNeurons::AllLIFNeurons()
@@ -55,7 +65,7 @@ Norm* normRand)
 #if defined(USE_GPU)
         BGFLOAT noise = randNoise[index];
 #else // defined(USE_GPU)
-        BGFLOAT noise = (*normRand)();
+        BGFLOAT noise = (m_randNoise != NULL) ? m_randNoise[index] : (*normRand)();
 #endif // defined(USE_GPU)
         DEBUG_MID(printf("ADVANCE NEURON[%d] :: noise = %f\n", index, noise);)
         summationPoint += noise * Inoise; // add noise
@@ -102,6 +112,79 @@ CUDA_CALLABLE void AllLIFNeurons::fire(const int index, int maxSpikes, const BGF
     Vm = Vreset;
 }
 
+#if defined(IF_NEURONS_SIMD_WIDTH)
+/*
+ *  Advance the IF_NEURONS_SIMD_WIDTH neurons of a block with vector instructions:
+ *  the refractory, firing and integrating neurons are selected by masks,
+ *  and the firing neurons then call fire().
+ *  The arithmetic is the one of advanceNeuron(), operation by operation.
+ *
+ *  @param  iNeuron               Index of the first neuron of the block.
+ *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+ *  @param  deltaT                Inner simulation step duration.
+ *  @param  simulationStep        The current simulation step.
+ *  @param  noise                 The noise of the neurons, by neuron index
+ *                                (only read for the integrating neurons).
+ */
+void AllLIFNeurons::advanceNeuronsBlock(int iNeuron, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, const BGFLOAT *noise)
+{
+    AllIFNeuronsProps *pNeuronsProps = static_cast<AllIFNeuronsProps*>(m_pNeuronsProps);
+    BGFLOAT *Vm = &pNeuronsProps->Vm[iNeuron];
+    BGFLOAT *summationPoint = &pNeuronsProps->summation_map[iNeuron];
+    int *nStepsInRefr = &pNeuronsProps->nStepsInRefr[iNeuron];
+
+#if IF_NEURONS_SIMD_WIDTH == 16
+    __m512i vSteps = _mm512_loadu_si512(nStepsInRefr);
+    __m512 vVm = _mm512_loadu_ps(Vm);
+
+    __mmask16 refractory = _mm512_cmpgt_epi32_mask(vSteps, _mm512_setzero_si512());
+    __mmask16 aboveThresh = _mm512_cmp_ps_mask(vVm, _mm512_loadu_ps(&pNeuronsProps->Vthresh[iNeuron]), _CMP_GE_OQ);
+    unsigned int fires = aboveThresh & ~refractory;
+    __mmask16 integrates = ~(refractory | aboveThresh);
+
+    // summationPoint += I0, then += noise * Inoise
+    __m512 vSum = _mm512_add_ps(_mm512_loadu_ps(summationPoint), _mm512_loadu_ps(&pNeuronsProps->I0[iNeuron]));
+    vSum = _mm512_add_ps(vSum, _mm512_mul_ps(_mm512_loadu_ps(&noise[iNeuron]), _mm512_loadu_ps(&pNeuronsProps->Inoise[iNeuron])));
+
+    // Vm = C1 * Vm + C2 * summationPoint
+    __m512 vVmNext = _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(&pNeuronsProps->C1[iNeuron]), vVm), _mm512_mul_ps(_mm512_loadu_ps(&pNeuronsProps->C2[iNeuron]), vSum));
+
+    _mm512_storeu_ps(Vm, _mm512_mask_mov_ps(vVm, integrates, vVmNext));
+    _mm512_storeu_si512(nStepsInRefr, _mm512_mask_sub_epi32(vSteps, refractory, vSteps, _mm512_set1_epi32(1)));
+    _mm512_storeu_ps(summationPoint, _mm512_setzero_ps());
+#else // IF_NEURONS_SIMD_WIDTH == 8
+    __m256i vSteps = _mm256_loadu_si256(reinterpret_cast<__m256i*>(nStepsInRefr));
+    __m256 vVm = _mm256_loadu_ps(Vm);
+
+    __m256 refractory = _mm256_castsi256_ps(_mm256_cmpgt_epi32(vSteps, _mm256_setzero_si256()));
+    __m256 aboveThresh = _mm256_cmp_ps(vVm, _mm256_loadu_ps(&pNeuronsProps->Vthresh[iNeuron]), _CMP_GE_OQ);
+    unsigned int fires = _mm256_movemask_ps(_mm256_andnot_ps(refractory, aboveThresh));
+    __m256 notIntegrates = _mm256_or_ps(refractory, aboveThresh);
+
+    // summationPoint += I0, then += noise * Inoise
+    __m256 vSum = _mm256_add_ps(_mm256_loadu_ps(summationPoint), _mm256_loadu_ps(&pNeuronsProps->I0[iNeuron]));
+    vSum = _mm256_add_ps(vSum, _mm256_mul_ps(_mm256_loadu_ps(&noise[iNeuron]), _mm256_loadu_ps(&pNeuronsProps->Inoise[iNeuron])));
+
+    // Vm = C1 * Vm + C2 * summationPoint
+    __m256 vVmNext = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&pNeuronsProps->C1[iNeuron]), vVm), _mm256_mul_ps(_mm256_loadu_ps(&pNeuronsProps->C2[iNeuron]), vSum));
+
+    _mm256_storeu_ps(Vm, _mm256_blendv_ps(vVmNext, vVm, notIntegrates));
+    // a refractory lane of the mask is -1
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(nStepsInRefr), _mm256_add_epi32(vSteps, _mm256_castps_si256(refractory)));
+    _mm256_storeu_ps(summationPoint, _mm256_setzero_ps());
+#endif
+
+    fill(&pNeuronsProps->hasFired[iNeuron], &pNeuronsProps->hasFired[iNeuron] + IF_NEURONS_SIMD_WIDTH, false);
+
+    // fire in the descending index order of the scalar reference
+    for (int i = IF_NEURONS_SIMD_WIDTH - 1; i >= 0; --i) {
+        if (fires & (1u << i)) {
+            fire(iNeuron + i, maxSpikes, deltaT, simulationStep, m_pNeuronsProps);
+        }
+    }
+}
+#endif // IF_NEURONS_SIMD_WIDTH
+
 #if defined(USE_GPU)
 
 /*
@@ -1,4 +1,5 @@
 #include "AllNeuronsProps.h"
+#include "Checkpoint.h"
 #if defined(USE_GPU)
 #include <helper_cuda.h>
 #endif
@@ -203,3 +204,29 @@ void AllNeuronsProps::setNeuronPropDefaults(const int index)
 {
 }
 
+#if !defined(USE_GPU)
+/*
+ *  Add the state of the neurons that changes during the simulation
+ *  to a periodic checkpoint.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the neurons.
+ */
+void AllNeuronsProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    writer.addArray(CKPT_NEURON_SUMMATION, iCluster, summation_map, size);
+}
+
+/*
+ *  Restore the state of the neurons that changes during the simulation
+ *  from a periodic checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the neurons.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllNeuronsProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    return reader.restoreArray(CKPT_NEURON_SUMMATION, iCluster, summation_map, size);
+}
+#endif // !USE_GPU
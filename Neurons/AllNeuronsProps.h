@@ -8,6 +8,9 @@
 
 #include "IAllNeuronsProps.h"
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class AllNeuronsProps : public IAllNeuronsProps
 {
     public:
@@ -141,6 +144,27 @@ class AllNeuronsProps : public IAllNeuronsProps
          */
         virtual void setNeuronPropDefaults(const int index);
 
+#if !defined(USE_GPU)
+        /**
+         *  Add the state of the neurons that changes during the simulation
+         *  to a periodic checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the neurons.
+         */
+        virtual void checkpointState(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore the state of the neurons that changes during the simulation
+         *  from a periodic checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the neurons.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader, int iCluster);
+#endif // !USE_GPU
+
     private:
         /**
          *  Cleanup the class.
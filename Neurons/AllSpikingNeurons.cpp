@@ -6,15 +6,37 @@
 
 // Default constructor
 CUDA_CALLABLE AllSpikingNeurons::AllSpikingNeurons()
+#if !defined(USE_GPU)
+    : m_randNoise(NULL)
+#endif // !USE_GPU
 {
 }
 
 CUDA_CALLABLE AllSpikingNeurons::~AllSpikingNeurons()
 {
+#if !defined(USE_GPU)
+    for (size_t i = 0; i < m_replayNorms.size(); i++) {
+        delete m_replayNorms[i];
+    }
+#endif // !USE_GPU
 }
 
 #if !defined(USE_GPU)
 
+/*
+ *  Setup the internal structure of the class (allocate memories).
+ *  Keeps the noise buffer of the cluster, if it uses the batch noise.
+ *
+ *  @param  sim_info  SimulationInfo class to read information from.
+ *  @param  clr_info  ClusterInfo class to read information from.
+ */
+void AllSpikingNeurons::setupNeurons(SimulationInfo *sim_info, ClusterInfo *clr_info)
+{
+    AllNeurons::setupNeurons(sim_info, clr_info);
+
+    m_randNoise = clr_info->randNoise;
+}
+
 /*
  *  Update internal state of the indexed Neuron (called by every simulation step).
  *  Notify outgoing synapses if neuron has fired.
@@ -27,60 +49,109 @@ CUDA_CALLABLE AllSpikingNeurons::~AllSpikingNeurons()
  */
 void AllSpikingNeurons::advanceNeurons(IAllSynapses &synapses, const SimulationInfo *sim_info, const SynapseIndexMap *synapseIndexMap, const ClusterInfo *clr_info, int iStepOffset)
 {
-    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
+    advanceNeurons(synapses, sim_info, synapseIndexMap, iStepOffset, 0, clr_info->totalClusterNeurons, clr_info->normRand);
+}
 
-    AllSpikingSynapses &spSynapses = dynamic_cast<AllSpikingSynapses&>(synapses);
-    AllSpikingSynapsesProps *pSynapsesProps = dynamic_cast<AllSpikingSynapsesProps*>(spSynapses.m_pSynapsesProps);
-    bool *hasFired = dynamic_cast<AllSpikingNeuronsProps*>(m_pNeuronsProps)->hasFired;
-    int *spikeCount = dynamic_cast<AllSpikingNeuronsProps*>(m_pNeuronsProps)->spikeCount; 
-    const BGFLOAT deltaT = sim_info->deltaT;
-    Norm *normRand = clr_info->normRand;
-    uint64_t simulationStep = g_simulationStep + iStepOffset;
+/*
+ *  Update internal state of the indexed Neuron (called by every simulation step).
+ *  Notify outgoing synapses if neuron has fired.
+ *  The neurons are split into chunks that run on the threads of a pool.
+ *  The noise is drawn by the calling thread in the order of the single
+ *  threaded advance, so the results do not depend on the number of threads.
+ *
+ *  @param  synapses          The Synapse list to search from.
+ *  @param  sim_info          SimulationInfo class to read information from.
+ *  @param  synapseIndexMap   Reference to the SynapseIndexMap.
+ *  @param  clr_info          ClusterInfo class to read information from.
+ *  @param  iStepOffset       Offset from the current simulation step.
+ *  @param  pool              The pool of threads to run the chunks.
+ *  @param  nNeuronsPerChunk  Number of neurons per chunk.
+ */
+void AllSpikingNeurons::advanceNeurons(IAllSynapses &synapses, const SimulationInfo *sim_info, const SynapseIndexMap *synapseIndexMap, const ClusterInfo *clr_info, int iStepOffset, ThreadPool &pool, int nNeuronsPerChunk)
+{
+    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
+    int totalNeurons = clr_info->totalClusterNeurons;
+    BGSIZE nChunks = (totalNeurons + nNeuronsPerChunk - 1) / nNeuronsPerChunk;
+
+    // Draw the noise of the neurons in the order of the single threaded advance.
+    // A chunk advances its neurons in descending order too, so the noise of
+    // a chunk is contiguous in m_noise.
+    m_noise.resize(totalNeurons);
+    m_noiseChunkBegin.resize(nChunks);
+    BGSIZE nNoise = 0;
+    for (int idx = totalNeurons - 1; idx >= 0; --idx) {
+        if (idx == totalNeurons - 1 || idx % nNeuronsPerChunk == nNeuronsPerChunk - 1) {
+            m_noiseChunkBegin[idx / nNeuronsPerChunk] = nNoise;
+        }
+        if (prepareAdvanceNeuron(idx, maxSpikes, clr_info->normRand, m_noise[nNoise])) {
+            nNoise++;
+        }
+    }
 
-    // For each neuron in the network
-    for (int idx = clr_info->totalClusterNeurons - 1; idx >= 0; --idx) {
-        // advance neurons
-        advanceNeuron(idx, maxSpikes, deltaT, simulationStep, m_pNeuronsProps, normRand);
+    while (m_replayNorms.size() < static_cast<size_t>(pool.getNumThreads())) {
+        m_replayNorms.push_back(new ReplayNorm());
+    }
 
-        // notify outgoing/incomming synapses if neuron has fired
-        if (hasFired[idx]) {
-            DEBUG_MID(cout << " !! Neuron" << idx << "has Fired @ t: " << (simulationStep) * sim_info->deltaT << endl;)
+    pool.parallelFor(nChunks, [&](BGSIZE iChunk, int iThread) {
+        ReplayNorm *normRand = m_replayNorms[iThread];
+        normRand->replay(m_noise.data() + m_noiseChunkBegin[iChunk]);
 
-            assert( spikeCount[idx] < maxSpikes );
+        int iNeuronBegin = iChunk * nNeuronsPerChunk;
+        int iNeuronEnd = min(iNeuronBegin + nNeuronsPerChunk, totalNeurons);
+        advanceNeurons(synapses, sim_info, synapseIndexMap, iStepOffset, iNeuronBegin, iNeuronEnd, normRand);
+    });
+}
 
-            if (pSynapsesProps->total_synapse_counts != 0) {
-                // notify outgoing synapses
-                BGSIZE synapse_counts;
+/*
+ *  Update internal state of the neurons in a range, in descending index order.
+ *  Notify outgoing synapses if neuron has fired.
+ *
+ *  @param  synapses          The Synapse list to search from.
+ *  @param  sim_info          SimulationInfo class to read information from.
+ *  @param  synapseIndexMap   Reference to the SynapseIndexMap.
+ *  @param  iStepOffset       Offset from the current simulation step.
+ *  @param  iNeuronBegin      Index of the first neuron of the range.
+ *  @param  iNeuronEnd        Index after the last neuron of the range.
+ *  @param  normRand          Pointer to the normalized random number generator.
+ */
+void AllSpikingNeurons::advanceNeurons(IAllSynapses &synapses, const SimulationInfo *sim_info, const SynapseIndexMap *synapseIndexMap, int iStepOffset, int iNeuronBegin, int iNeuronEnd, Norm *normRand)
+{
+    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
 
-                synapse_counts = synapseIndexMap->outgoingSynapseCount[idx];
-                if (synapse_counts != 0) {
-                    BGSIZE beginIndex = synapseIndexMap->outgoingSynapseBegin[idx];
-                    OUTGOING_SYNAPSE_INDEX_TYPE* outgoingMap_begin = &( synapseIndexMap->outgoingSynapseIndexMap[beginIndex] );
-                    for ( BGSIZE i = 0; i < synapse_counts; i++ ) {
-                        OUTGOING_SYNAPSE_INDEX_TYPE idx = outgoingMap_begin[i];
-                        // outgoing synapse index consists of cluster index + synapse index
-                        CLUSTER_INDEX_TYPE iCluster = SynapseIndexMap::getClusterIndex(idx);
-                        BGSIZE iSyn = SynapseIndexMap::getSynapseIndex(idx);
-                        spSynapses.preSpikeHit(iSyn, iCluster, iStepOffset);
-                    }
-                }
+    AllSpikingSynapses &spSynapses = dynamic_cast<AllSpikingSynapses&>(synapses);
+    AllSpikingSynapsesProps *pSynapsesProps = dynamic_cast<AllSpikingSynapsesProps*>(spSynapses.m_pSynapsesProps);
+    AllSpikingNeuronsProps *pNeuronsProps = dynamic_cast<AllSpikingNeuronsProps*>(m_pNeuronsProps);
+    const BGFLOAT deltaT = sim_info->deltaT;
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
 
-                // notify incomming synapses
-                synapse_counts = synapseIndexMap->incomingSynapseIndexMap[idx];
+    // advance neurons
+    advanceNeuronsBatch(iNeuronBegin, iNeuronEnd, maxSpikes, deltaT, simulationStep, normRand);
 
-                if (spSynapses.allowBackPropagation() && synapse_counts != 0) {
-                    int beginIndex = synapseIndexMap->incomingSynapseBegin[idx];
-                    BGSIZE* incomingMap_begin = &( synapseIndexMap->incomingSynapseIndexMap[beginIndex] );
-          
-                    for ( BGSIZE i = 0; i < synapse_counts; i++ ) {
-                        BGSIZE iSyn = incomingMap_begin[i];
-                        spSynapses.postSpikeHit(iSyn, iStepOffset);
-                    }
-                }
-            }
+    // notify the synapses of the neurons that have fired
+    notifyFiredNeurons(iNeuronBegin, iNeuronEnd, pNeuronsProps->hasFired, pNeuronsProps->spikeCount, maxSpikes, deltaT, simulationStep, synapseIndexMap,
+                       pSynapsesProps->total_synapse_counts != 0, spSynapses.allowBackPropagation(),
+                       pSynapsesProps->spikeRings, pSynapsesProps->spikeRingsBegin,
+                       [&](BGSIZE iSyn, CLUSTER_INDEX_TYPE iCluster) { spSynapses.preSpikeHit(iSyn, iCluster, iStepOffset); },
+                       [&](int iNeuron, CLUSTER_INDEX_TYPE iCluster) { return spSynapses.preSpikeHitCluster(iNeuron, iCluster, iStepOffset); },
+                       [&](BGSIZE iSyn) { spSynapses.postSpikeHit(iSyn, iStepOffset); });
+}
 
-            hasFired[idx] = false;
-        }
+/*
+ *  Update the state of the neurons in a range for a time step, without
+ *  notifying the synapses. The noise is drawn in descending index order.
+ *  This is the scalar reference, which calls advanceNeuron() for each neuron.
+ *
+ *  @param  iNeuronBegin          Index of the first neuron of the range.
+ *  @param  iNeuronEnd            Index after the last neuron of the range.
+ *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+ *  @param  deltaT                Inner simulation step duration.
+ *  @param  simulationStep        The current simulation step.
+ *  @param  normRand              Pointer to the normalized random number generator.
+ */
+void AllSpikingNeurons::advanceNeuronsBatch(int iNeuronBegin, int iNeuronEnd, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, Norm* normRand)
+{
+    for (int idx = iNeuronEnd - 1; idx >= iNeuronBegin; --idx) {
+        advanceNeuron(idx, maxSpikes, deltaT, simulationStep, m_pNeuronsProps, normRand);
     }
 }
 
@@ -100,12 +171,17 @@ CUDA_CALLABLE uint64_t AllSpikingNeurons::getSpikeHistory(int index, int offInde
 
     int *spikeCountOffset = pNeuronsProps->spikeCountOffset;
     int *spikeCount = pNeuronsProps->spikeCount; 
-    uint64_t **spike_history = pNeuronsProps->spike_history;
+    int historySize = pNeuronsProps->spikeHistorySize[index];
+
+    // the ring of the neuron keeps the last historySize spikes
+    if (offIndex < -historySize) {
+        return ULONG_MAX;
+    }
 
     // offIndex is a minus offset
-    int idxSp = (spikeCount[index] + spikeCountOffset[index] +  maxSpikes + offIndex) % maxSpikes;
+    int idxSp = (spikeCount[index] + spikeCountOffset[index] +  historySize + offIndex) % historySize;
 
-    return spike_history[index][idxSp];
+    return pNeuronsProps->getSpikeHistoryStep(index, idxSp);
 }
 
 #if defined(USE_GPU)
@@ -225,17 +301,24 @@ __global__ void advanceNeuronsDevice( int totalNeurons, int maxSynapses, int max
  */
 CUDA_CALLABLE void AllSpikingNeurons::fire(const int index, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, IAllNeuronsProps* pINeuronsProps) const
 {
-    bool *hasFired = reinterpret_cast<AllSpikingNeuronsProps*>(m_pNeuronsProps)->hasFired;
-    int *spikeCountOffset = reinterpret_cast<AllSpikingNeuronsProps*>(m_pNeuronsProps)->spikeCountOffset;
-    int *spikeCount = reinterpret_cast<AllSpikingNeuronsProps*>(m_pNeuronsProps)->spikeCount; 
-    uint64_t **spike_history = reinterpret_cast<AllSpikingNeuronsProps*>(m_pNeuronsProps)->spike_history;
+    AllSpikingNeuronsProps *pNeuronsProps = reinterpret_cast<AllSpikingNeuronsProps*>(m_pNeuronsProps);
+    bool *hasFired = pNeuronsProps->hasFired;
+    int *spikeCountOffset = pNeuronsProps->spikeCountOffset;
+    int *spikeCount = pNeuronsProps->spikeCount; 
 
     // Note that the neuron has fired!
     hasFired[index] = true;
+
+#if !defined(USE_GPU)
+    // don't overwrite the spikes of this epoch, which are not recorded yet
+    if (spikeCount[index] >= pNeuronsProps->spikeHistorySize[index]) {
+        pNeuronsProps->growSpikeHistory(index, maxSpikes);
+    }
+#endif // !USE_GPU
     
     // record spike time
-    int idxSp = (spikeCount[index] + spikeCountOffset[index]) % maxSpikes;
-    spike_history[index][idxSp] = simulationStep;
+    int idxSp = (spikeCount[index] + spikeCountOffset[index]) % pNeuronsProps->spikeHistorySize[index];
+    pNeuronsProps->setSpikeHistoryStep(index, idxSp, simulationStep);
 
     DEBUG_SYNAPSE(
         printf("AllSpikingNeurons::fire:\n");
@@ -43,6 +43,11 @@ using namespace std;
 #include "AllNeurons.h"
 #include "AllSpikingSynapses.h"
 #include "AllSpikingNeuronsProps.h"
+#if !defined(USE_GPU)
+#include "ReplayNorm.h"
+#include "ThreadPool.h"
+#include "AxonalSpikeRings.h"
+#endif // !USE_GPU
 
 class AllSpikingNeurons : public AllNeurons
 {
@@ -72,6 +77,15 @@ class AllSpikingNeurons : public AllNeurons
 #else // !defined(USE_GPU)
 
     public:
+        /**
+         *  Setup the internal structure of the class (allocate memories).
+         *  Keeps the noise buffer of the cluster, if it uses the batch noise.
+         *
+         *  @param  sim_info  SimulationInfo class to read information from.
+         *  @param  clr_info  ClusterInfo class to read information from.
+         */
+        virtual void setupNeurons(SimulationInfo *sim_info, ClusterInfo *clr_info);
+
         /**
          *  Update internal state of the indexed Neuron (called by every simulation step).
          *  Notify outgoing synapses if neuron has fired.
@@ -84,8 +98,102 @@ class AllSpikingNeurons : public AllNeurons
          */
         virtual void advanceNeurons(IAllSynapses &synapses, const SimulationInfo *sim_info, const SynapseIndexMap *synapseIndexMap, const ClusterInfo *clr_info, int iStepOffset);
 
+        /**
+         *  Update internal state of the indexed Neuron (called by every simulation step).
+         *  Notify outgoing synapses if neuron has fired.
+         *  The neurons are split into chunks that run on the threads of a pool.
+         *  The noise is drawn by the calling thread in the order of the single
+         *  threaded advance, so the results do not depend on the number of threads.
+         *
+         *  @param  synapses          The Synapse list to search from.
+         *  @param  sim_info          SimulationInfo class to read information from.
+         *  @param  synapseIndexMap   Reference to the SynapseIndexMap.
+         *  @param  clr_info          ClusterInfo class to read information from.
+         *  @param  iStepOffset       Offset from the current simulation step.
+         *  @param  pool              The pool of threads to run the chunks.
+         *  @param  nNeuronsPerChunk  Number of neurons per chunk.
+         */
+        virtual void advanceNeurons(IAllSynapses &synapses, const SimulationInfo *sim_info, const SynapseIndexMap *synapseIndexMap, const ClusterInfo *clr_info, int iStepOffset, ThreadPool &pool, int nNeuronsPerChunk);
+
+        /**
+         *  Update the state of the neurons in a range for a time step, without
+         *  notifying the synapses. The noise is drawn in descending index order.
+         *  This is the scalar reference, which calls advanceNeuron() for each neuron;
+         *  the neuron classes may override it with vectorized kernels that give
+         *  the same results.
+         *
+         *  @param  iNeuronBegin          Index of the first neuron of the range.
+         *  @param  iNeuronEnd            Index after the last neuron of the range.
+         *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+         *  @param  deltaT                Inner simulation step duration.
+         *  @param  simulationStep        The current simulation step.
+         *  @param  normRand              Pointer to the normalized random number generator.
+         */
+        virtual void advanceNeuronsBatch(int iNeuronBegin, int iNeuronEnd, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, Norm* normRand);
+
+        /**
+         *  Notify the outgoing (and, with back propagation, the incoming) synapses
+         *  of the neurons in a range that have fired, in descending index order,
+         *  and clear their hasFired flags. With the ring spike delivery, the
+         *  neurons record the step in their spike rings instead of notifying
+         *  their outgoing synapses. The outgoing synapses of a neuron in another
+         *  cluster are notified at once, by sending the spike to the cluster,
+         *  when the cluster can take it. The synapse notifications are functors,
+         *  so that the generic advance calls the virtual preSpikeHit() and
+         *  postSpikeHit() and a specialized cluster (SpecializedCluster.h) the ones
+         *  of its synapse class directly.
+         *
+         *  @param  iNeuronBegin          Index of the first neuron of the range.
+         *  @param  iNeuronEnd            Index after the last neuron of the range.
+         *  @param  hasFired              The hasFired flags of the neurons.
+         *  @param  spikeCount            The spike counts of the neurons.
+         *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+         *  @param  deltaT                Inner simulation step duration.
+         *  @param  simulationStep        The current simulation step.
+         *  @param  synapseIndexMap       Reference to the SynapseIndexMap.
+         *  @param  hasSynapses           True if the cluster has synapses.
+         *  @param  allowBackPropagation  True if the synapses see the post spikes.
+         *  @param  spikeRings            The spike rings (ring spike delivery), or NULL.
+         *  @param  spikeRingsBegin       Layout index of the first neuron of the cluster.
+         *  @param  preSpikeHit           Functor that notifies an outgoing synapse (synapse and cluster index).
+         *  @param  preSpikeHitCluster    Functor that notifies the outgoing synapses in a cluster
+         *                                (neuron and cluster index), false if it can't.
+         *  @param  postSpikeHit          Functor that notifies an incoming synapse.
+         */
+        template <class PreSpikeHit, class PreSpikeHitCluster, class PostSpikeHit>
+        void notifyFiredNeurons(int iNeuronBegin, int iNeuronEnd, bool *hasFired, const int *spikeCount, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, const SynapseIndexMap *synapseIndexMap, bool hasSynapses, bool allowBackPropagation, AxonalSpikeRings *spikeRings, int spikeRingsBegin, PreSpikeHit preSpikeHit, PreSpikeHitCluster preSpikeHitCluster, PostSpikeHit postSpikeHit);
+
+        /**
+         *  Update internal state of the neurons in a range, in descending index order.
+         *  Notify outgoing synapses if neuron has fired.
+         *
+         *  @param  synapses          The Synapse list to search from.
+         *  @param  sim_info          SimulationInfo class to read information from.
+         *  @param  synapseIndexMap   Reference to the SynapseIndexMap.
+         *  @param  iStepOffset       Offset from the current simulation step.
+         *  @param  iNeuronBegin      Index of the first neuron of the range.
+         *  @param  iNeuronEnd        Index after the last neuron of the range.
+         *  @param  normRand          Pointer to the normalized random number generator.
+         */
+        void advanceNeurons(IAllSynapses &synapses, const SimulationInfo *sim_info, const SynapseIndexMap *synapseIndexMap, int iStepOffset, int iNeuronBegin, int iNeuronEnd, Norm *normRand);
+
+    protected:
+        /**
+         *  Prepare the concurrent advance of a neuron in the current time step:
+         *  draw the noise that the neuron uses, and grow the spike history of the
+         *  neuron if it fires with a full spike history.
+         *
+         *  @param  index                 Index of the Neuron.
+         *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+         *  @param  normRand              Pointer to the normalized random number generator.
+         *  @param  noise                 The noise drawn.
+         *  @return true if the noise is drawn.
+         */
+        virtual bool prepareAdvanceNeuron(const int index, int maxSpikes, Norm* normRand, BGFLOAT &noise) = 0;
+
 #endif // !defined(USE_GPU)
 
+    public:
         /**
          *  Get the spike history of neuron[index] at the location offIndex.
          *
@@ -139,8 +247,116 @@ class AllSpikingNeurons : public AllNeurons
          *  @param  pINeuronsProps        Pointer to the neurons properties.
          */
         CUDA_CALLABLE virtual void fire(const int index, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, IAllNeuronsProps* pINeuronsProps) const;
+
+#if !defined(USE_GPU)
+
+    protected:
+        //! The noise of the neurons in the current step, by neuron index, drawn by
+        //! the cluster with the batch noise generator (NULL if the noise is drawn
+        //! from normRand by each neuron).
+        const BGFLOAT *m_randNoise;
+
+    private:
+        //! The noise drawn for the concurrent advance, in descending neuron index order.
+        vector<BGFLOAT> m_noise;
+
+        //! Index in m_noise of the first noise of each chunk of neurons.
+        vector<BGSIZE> m_noiseChunkBegin;
+
+        //! Random number generators that replay m_noise, one per thread of the pool.
+        vector<ReplayNorm *> m_replayNorms;
+#endif // !defined(USE_GPU)
 };
 
+#if !defined(USE_GPU)
+/*
+ *  Notify the outgoing (and, with back propagation, the incoming) synapses
+ *  of the neurons in a range that have fired, in descending index order,
+ *  and clear their hasFired flags.
+ *
+ *  @param  iNeuronBegin          Index of the first neuron of the range.
+ *  @param  iNeuronEnd            Index after the last neuron of the range.
+ *  @param  hasFired              The hasFired flags of the neurons.
+ *  @param  spikeCount            The spike counts of the neurons.
+ *  @param  maxSpikes             Maximum number of spikes per neuron per epoch.
+ *  @param  deltaT                Inner simulation step duration.
+ *  @param  simulationStep        The current simulation step.
+ *  @param  synapseIndexMap       Reference to the SynapseIndexMap.
+ *  @param  hasSynapses           True if the cluster has synapses.
+ *  @param  allowBackPropagation  True if the synapses see the post spikes.
+ *  @param  spikeRings            The spike rings (ring spike delivery), or NULL.
+ *  @param  spikeRingsBegin       Layout index of the first neuron of the cluster.
+ *  @param  preSpikeHit           Functor that notifies an outgoing synapse (synapse and cluster index).
+ *  @param  preSpikeHitCluster    Functor that notifies the outgoing synapses in a cluster
+ *                                (neuron and cluster index), false if it can't.
+ *  @param  postSpikeHit          Functor that notifies an incoming synapse.
+ */
+template <class PreSpikeHit, class PreSpikeHitCluster, class PostSpikeHit>
+void AllSpikingNeurons::notifyFiredNeurons(int iNeuronBegin, int iNeuronEnd, bool *hasFired, const int *spikeCount, int maxSpikes, const BGFLOAT deltaT, uint64_t simulationStep, const SynapseIndexMap *synapseIndexMap, bool hasSynapses, bool allowBackPropagation, AxonalSpikeRings *spikeRings, int spikeRingsBegin, PreSpikeHit preSpikeHit, PreSpikeHitCluster preSpikeHitCluster, PostSpikeHit postSpikeHit)
+{
+    // record the step of every neuron (which also drops the spike of LENGTH_OF_SPIKE_RING steps before);
+    // the synapses read their source neurons' rings, so the outgoing synapses are not notified
+    if (spikeRings != NULL) {
+        for (int idx = iNeuronEnd - 1; idx >= iNeuronBegin; --idx) {
+            spikeRings->recordStep(spikeRingsBegin + idx, simulationStep, hasFired[idx]);
+        }
+    }
+
+    // For each neuron in the range
+    for (int idx = iNeuronEnd - 1; idx >= iNeuronBegin; --idx) {
+        // notify outgoing/incomming synapses if neuron has fired
+        if (hasFired[idx]) {
+            DEBUG_MID(cout << " !! Neuron" << idx << "has Fired @ t: " << (simulationStep) * deltaT << endl;)
+
+            assert( spikeCount[idx] < maxSpikes );
+
+            if (hasSynapses) {
+                // notify outgoing synapses
+                BGSIZE synapse_counts;
+
+                synapse_counts = synapseIndexMap->outgoingSynapseCount[idx];
+                if (spikeRings == NULL && synapse_counts != 0) {
+                    BGSIZE beginIndex = synapseIndexMap->outgoingSynapseBegin[idx];
+                    OUTGOING_SYNAPSE_INDEX_TYPE* outgoingMap_begin = &( synapseIndexMap->outgoingSynapseIndexMap[beginIndex] );
+                    // the synapses of a cluster are contiguous in the segment (ascending order),
+                    // so the spike is sent once to each cluster
+                    CLUSTER_INDEX_TYPE iSentCluster = 0;
+                    bool sent = false;
+                    for ( BGSIZE i = 0; i < synapse_counts; i++ ) {
+                        OUTGOING_SYNAPSE_INDEX_TYPE iOutSyn = outgoingMap_begin[i];
+                        // outgoing synapse index consists of cluster index + synapse index
+                        CLUSTER_INDEX_TYPE iCluster = SynapseIndexMap::getClusterIndex(iOutSyn);
+                        if (i == 0 || iCluster != iSentCluster) {
+                            iSentCluster = iCluster;
+                            sent = preSpikeHitCluster(idx, iCluster);
+                        }
+                        if (!sent) {
+                            BGSIZE iSyn = SynapseIndexMap::getSynapseIndex(iOutSyn);
+                            preSpikeHit(iSyn, iCluster);
+                        }
+                    }
+                }
+
+                // notify incomming synapses
+                synapse_counts = synapseIndexMap->incomingSynapseCount[idx];
+
+                if (allowBackPropagation && synapse_counts != 0) {
+                    int beginIndex = synapseIndexMap->incomingSynapseBegin[idx];
+                    BGSIZE* incomingMap_begin = &( synapseIndexMap->incomingSynapseIndexMap[beginIndex] );
+
+                    for ( BGSIZE i = 0; i < synapse_counts; i++ ) {
+                        BGSIZE iSyn = incomingMap_begin[i];
+                        postSpikeHit(iSyn);
+                    }
+                }
+            }
+
+            hasFired[idx] = false;
+        }
+    }
+}
+#endif // !USE_GPU
+
 #if defined(USE_GPU)
 
 /**
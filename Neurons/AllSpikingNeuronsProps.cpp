@@ -1,8 +1,11 @@
 #include "AllSpikingNeuronsProps.h"
 #include "GPUSpikingCluster.h"
+#include "Checkpoint.h"
 #if defined(USE_GPU)
 #include <helper_cuda.h>
 #endif
+#include <algorithm>
+#include <cmath>
 
 // Default constructor
 AllSpikingNeuronsProps::AllSpikingNeuronsProps()
@@ -11,6 +14,11 @@ AllSpikingNeuronsProps::AllSpikingNeuronsProps()
     spikeCount = NULL;
     spikeCountOffset = NULL;
     spike_history = NULL;
+    spikeHistoryBegin = NULL;
+    spikeHistorySize = NULL;
+    spikeHistoryBaseStep = 0;
+    spikeHistoryUsed = 0;
+    spikeHistoryAllocated = 0;
 }
 
 AllSpikingNeuronsProps::~AllSpikingNeuronsProps()
@@ -32,14 +40,45 @@ void AllSpikingNeuronsProps::setupNeuronsProps(SimulationInfo *sim_info, Cluster
     hasFired = new bool[size];
     spikeCount = new int[size];
     spikeCountOffset = new int[size];
-    spike_history = new uint64_t*[size];
+    spikeHistoryBegin = new BGSIZE[size];
+    spikeHistorySize = new int[size];
+
+#if defined(USE_GPU)
+    // the rings can't grow in device memory
+    int history_size = static_cast<int> (sim_info->epochDuration * sim_info->maxFiringRate);
+#else
+    int history_size = getMinSpikeHistorySize(sim_info);
+#endif
 
     for (int i = 0; i < size; ++i) {
-        spike_history[i] = NULL;
         hasFired[i] = false;
         spikeCount[i] = 0;
         spikeCountOffset[i] = 0;
+        spikeHistoryBegin[i] = static_cast<BGSIZE>(i) * history_size;
+        spikeHistorySize[i] = history_size;
     }
+
+    spikeHistoryBaseStep = 0;
+    spikeHistoryUsed = spikeHistoryAllocated = static_cast<BGSIZE>(size) * history_size;
+    spike_history = new uint32_t[spikeHistoryAllocated];
+    fill(spike_history, spike_history + spikeHistoryAllocated, NO_SPIKE);
+}
+
+/*
+ *  Get the number of entries of the spike history ring of a neuron
+ *  which keeps the spikes in the look-back window.
+ *
+ *  @param  sim_info  SimulationInfo class to read information from.
+ *  @return the minimum number of entries of a ring.
+ */
+int AllSpikingNeuronsProps::getMinSpikeHistorySize(const SimulationInfo *sim_info)
+{
+    int max_spikes = static_cast<int> (sim_info->epochDuration * sim_info->maxFiringRate);
+
+    // STDP looks back the spikes in the window, and two more spikes before them
+    int min_size = static_cast<int> (ceil(sim_info->spikeHistoryWindow * sim_info->maxFiringRate)) + 2;
+
+    return max(1, min(min_size, max_spikes));
 }
 
 /*
@@ -48,40 +87,93 @@ void AllSpikingNeuronsProps::setupNeuronsProps(SimulationInfo *sim_info, Cluster
 void AllSpikingNeuronsProps::cleanupNeuronsProps()
 {
     if (size != 0) {
-        for(int i = 0; i < size; i++) {
-            delete[] spike_history[i];
-        }
-
         delete[] hasFired;
         delete[] spikeCount;
         delete[] spikeCountOffset;
         delete[] spike_history;
+        delete[] spikeHistoryBegin;
+        delete[] spikeHistorySize;
     }
 
     hasFired = NULL;
     spikeCount = NULL;
     spikeCountOffset = NULL;
     spike_history = NULL;
+    spikeHistoryBegin = NULL;
+    spikeHistorySize = NULL;
+    spikeHistoryUsed = 0;
+    spikeHistoryAllocated = 0;
 }
 
 /*
  *  Clear the spike counts out of all Neurons.
+ *  With an epoch spike history, the spikes of the epoch are handed over to it
+ *  rather than read by the caller: it receives the rings and spike counts of
+ *  the epoch and, on the host only simulation, the spike history buffer itself,
+ *  in exchange for its buffer (see resizeSpikeHistory()).
  *
  *  @param  sim_info  SimulationInfo class to read information from.
  *  @param  clr_info  ClusterInfo class to read information from.
  *  @param  clr       Cluster class to read information from.
+ *  @param  epoch     Receives the spike history of the epoch (NULL if not recorded this way).
  */
-void AllSpikingNeuronsProps::clearSpikeCounts(const SimulationInfo *sim_info, const ClusterInfo *clr_info, Cluster *clr)
+void AllSpikingNeuronsProps::clearSpikeCounts(const SimulationInfo *sim_info, const ClusterInfo *clr_info, Cluster *clr, EpochSpikeHistory *epoch)
 {
     // clear spike counts in host memory
-    int max_spikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
     int numNeurons = clr_info->totalClusterNeurons;
 
+    if (epoch != NULL) {
+        epoch->begin.assign(spikeHistoryBegin, spikeHistoryBegin + numNeurons);
+        epoch->size.assign(spikeHistorySize, spikeHistorySize + numNeurons);
+        epoch->offset.assign(spikeCountOffset, spikeCountOffset + numNeurons);
+        epoch->count.assign(spikeCount, spikeCount + numNeurons);
+        epoch->baseStep = spikeHistoryBaseStep;
+#if defined(USE_GPU)
+        // the buffer is copied from the device, the neurons keep it
+        if (epoch->allocated < spikeHistoryUsed) {
+            delete[] epoch->history;
+            epoch->history = new uint32_t[spikeHistoryUsed];
+            epoch->allocated = spikeHistoryUsed;
+        }
+        copy(spike_history, spike_history + spikeHistoryUsed, epoch->history);
+#endif // USE_GPU
+    }
+
+    for (int i = 0; i < numNeurons; i++) {
+        spikeCountOffset[i] = (spikeCount[i] + spikeCountOffset[i]) % spikeHistorySize[i];
+    }
+
+#if !defined(USE_GPU)
+    // fit the rings to the spikes fired in the epoch (with a quarter more room)
+    int max_spikes = static_cast<int> (sim_info->epochDuration * sim_info->maxFiringRate);
+    int min_size = getMinSpikeHistorySize(sim_info);
+    vector<int> newSize(numNeurons);
+    for (int i = 0; i < numNeurons; i++) {
+        newSize[i] = min(max(min_size, spikeCount[i] + spikeCount[i] / 4), max(max_spikes, 1));
+    }
+    if (sim_info->pinThreads != NO_PINNING) {
+        // on a thread pinned like the advance thread of the cluster, so that the new
+        // buffer is first touched on the NUMA node of the cluster, not of the main thread
+        std::thread thResize([&]() {
+            Cluster::pinCurrentThread(sim_info, clr_info, 0);
+            resizeSpikeHistory(sim_info, &newSize[0], epoch);
+        });
+        thResize.join();
+    } else {
+        resizeSpikeHistory(sim_info, &newSize[0], epoch);
+    }
+#endif // !USE_GPU
+
     for (int i = 0; i < numNeurons; i++) {
-        spikeCountOffset[i] = (spikeCount[i] + spikeCountOffset[i]) % max_spikes;
         spikeCount[i] = 0;
     }
 
+    // keep the step counts of the next epoch in 32 bits
+    bool rebased = g_simulationStep - spikeHistoryBaseStep >= (1ULL << 31);
+    if (rebased) {
+        rebaseSpikeHistory(g_simulationStep - (1ULL << 30));
+    }
+
 #if defined(USE_GPU)
     // Set device ID
     checkCudaErrors( cudaSetDevice( clr_info->deviceId ) );
@@ -93,9 +185,216 @@ void AllSpikingNeuronsProps::clearSpikeCounts(const SimulationInfo *sim_info, co
     checkCudaErrors( cudaMemcpy ( &allNeuronsProps, allNeuronsDeviceProps, sizeof( AllSpikingNeuronsProps ), cudaMemcpyDeviceToHost ) );
     checkCudaErrors( cudaMemset( allNeuronsProps.spikeCount, 0, numNeurons * sizeof( int ) ) );
     checkCudaErrors( cudaMemcpy ( allNeuronsProps.spikeCountOffset, spikeCountOffset, numNeurons * sizeof( int ), cudaMemcpyHostToDevice ) );
+    if (rebased) {
+        checkCudaErrors( cudaMemcpy ( allNeuronsProps.spike_history, spike_history, spikeHistoryUsed * sizeof( uint32_t ), cudaMemcpyHostToDevice ) );
+        allNeuronsProps.spikeHistoryBaseStep = spikeHistoryBaseStep;
+        checkCudaErrors( cudaMemcpy ( allNeuronsDeviceProps, &allNeuronsProps, sizeof( AllSpikingNeuronsProps ), cudaMemcpyHostToDevice ) );
+    }
+
+    // Set size to 0 to avoid illegal memory deallocation
+    // at AllSpikingNeuronsProps deconstructor.
+    allNeuronsProps.size = 0;
 #endif // USE_GPU
 }
 
+#if !defined(USE_GPU)
+/*
+ *  Double the spike history ring of a neuron (up to the maximum number of spikes
+ *  per epoch), when the ring is full of spikes which are not recorded yet.
+ *  The ring is moved to the end of the spike history buffer.
+ *
+ *  @param  index      Index of the neuron.
+ *  @param  maxSpikes  Maximum number of spikes per neuron per epoch.
+ */
+void AllSpikingNeuronsProps::growSpikeHistory(int index, int maxSpikes)
+{
+    int oldSize = spikeHistorySize[index];
+    int newSize = min(2 * oldSize, maxSpikes);
+    if (newSize <= oldSize) {
+        return;
+    }
+
+    // allocate more entries to the buffer
+    if (spikeHistoryUsed + newSize > spikeHistoryAllocated) {
+        BGSIZE allocated = max(2 * spikeHistoryAllocated, spikeHistoryUsed + newSize);
+        uint32_t *history = new uint32_t[allocated];
+        copy(spike_history, spike_history + spikeHistoryUsed, history);
+        delete[] spike_history;
+        spike_history = history;
+        spikeHistoryAllocated = allocated;
+    }
+
+    // unroll the ring from the oldest spike
+    uint32_t *oldRing = spike_history + spikeHistoryBegin[index];
+    uint32_t *newRing = spike_history + spikeHistoryUsed;
+    int offset = spikeCountOffset[index];
+    copy(oldRing + offset, oldRing + oldSize, newRing);
+    copy(oldRing, oldRing + offset, newRing + (oldSize - offset));
+    fill(newRing + oldSize, newRing + newSize, NO_SPIKE);
+
+    spikeHistoryBegin[index] = spikeHistoryUsed;
+    spikeHistorySize[index] = newSize;
+    spikeCountOffset[index] = 0;
+    spikeHistoryUsed += newSize;
+}
+
+/*
+ *  Grow the spike history ring of a neuron beforehand, so that it can record
+ *  a number of spikes without growing (up to the maximum number of spikes
+ *  per epoch).
+ *
+ *  @param  index      Index of the neuron.
+ *  @param  nSpikes    Number of spikes to make room for.
+ *  @param  maxSpikes  Maximum number of spikes per neuron per epoch.
+ */
+void AllSpikingNeuronsProps::reserveSpikeHistory(int index, int nSpikes, int maxSpikes)
+{
+    while (spikeCount[index] + nSpikes > spikeHistorySize[index] && spikeHistorySize[index] < maxSpikes) {
+        growSpikeHistory(index, maxSpikes);
+    }
+}
+
+/*
+ *  Resize the spike history ring of every neuron to the spikes fired in the epoch,
+ *  keeping the last spikes of the neuron, and pack the rings in a new buffer.
+ *  With an epoch spike history, the old buffer is handed over to it instead of
+ *  being freed, and its own buffer (of a previous epoch) becomes the new buffer
+ *  if it is large enough.
+ *
+ *  @param  sim_info  SimulationInfo class to read information from.
+ *  @param  newSize   New number of entries of the ring of each neuron.
+ *  @param  epoch     Receives the old buffer, and gives its buffer as the new one
+ *                    if it is large enough (NULL to free the old buffer).
+ */
+void AllSpikingNeuronsProps::resizeSpikeHistory(const SimulationInfo *sim_info, const int *newSize, EpochSpikeHistory *epoch)
+{
+    BGSIZE used = 0;
+    for (int i = 0; i < size; i++) {
+        used += newSize[i];
+    }
+
+    uint32_t *history;
+    BGSIZE allocated;
+    if (epoch != NULL && epoch->allocated >= used) {
+        history = epoch->history;
+        allocated = epoch->allocated;
+    } else {
+        history = new uint32_t[used];
+        allocated = used;
+        if (epoch != NULL) {
+            delete[] epoch->history;
+        }
+    }
+    BGSIZE begin = 0;
+    for (int i = 0; i < size; i++) {
+        // spikeCountOffset points to the next available position of the ring,
+        // copy the last spikes in order
+        uint32_t *oldRing = spike_history + spikeHistoryBegin[i];
+        int oldSize = spikeHistorySize[i];
+        int nKeep = min(oldSize, newSize[i]);
+        for (int j = 0; j < nKeep; j++) {
+            history[begin + j] = oldRing[(spikeCountOffset[i] - nKeep + j + oldSize) % oldSize];
+        }
+        fill(history + begin + nKeep, history + begin + newSize[i], NO_SPIKE);
+
+        spikeHistoryBegin[i] = begin;
+        spikeHistorySize[i] = newSize[i];
+        spikeCountOffset[i] = nKeep % newSize[i];
+        begin += newSize[i];
+    }
+
+    if (epoch != NULL) {
+        epoch->history = spike_history;
+        epoch->allocated = spikeHistoryAllocated;
+    } else {
+        delete[] spike_history;
+    }
+    spike_history = history;
+    spikeHistoryUsed = used;
+    spikeHistoryAllocated = allocated;
+}
+
+/*
+ *  Add the state of the neurons that changes during the simulation
+ *  to a periodic checkpoint. Only the used part of the spike history
+ *  buffer is written.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the neurons.
+ */
+void AllSpikingNeuronsProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    AllNeuronsProps::checkpointState(writer, iCluster);
+
+    writer.addArray(CKPT_NEURON_HAS_FIRED, iCluster, hasFired, size);
+    writer.addArray(CKPT_NEURON_SPIKE_COUNT, iCluster, spikeCount, size);
+    writer.addArray(CKPT_NEURON_SPIKE_COUNT_OFFSET, iCluster, spikeCountOffset, size);
+    writer.addArray(CKPT_NEURON_SPIKE_HISTORY_BEGIN, iCluster, spikeHistoryBegin, size);
+    writer.addArray(CKPT_NEURON_SPIKE_HISTORY_SIZE, iCluster, spikeHistorySize, size);
+    writer.addArray(CKPT_NEURON_SPIKE_HISTORY, iCluster, spike_history, spikeHistoryUsed);
+
+    uint64_t *state = static_cast<uint64_t *>(writer.allocSection(CKPT_NEURON_SPIKE_HISTORY_STATE, iCluster, sizeof(uint64_t), 3, 1));
+    state[0] = spikeHistoryBaseStep;
+    state[1] = spikeHistoryUsed;
+    state[2] = spikeHistoryAllocated;
+}
+
+/*
+ *  Restore the state of the neurons that changes during the simulation
+ *  from a periodic checkpoint. The spike history buffer is reallocated
+ *  to the size it had when the checkpoint was written.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the neurons.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllSpikingNeuronsProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    uint64_t state[3];
+
+    if (!AllNeuronsProps::restoreState(reader, iCluster)
+            || !reader.restoreArray(CKPT_NEURON_SPIKE_HISTORY_STATE, iCluster, state, 3)
+            || state[1] > state[2]) {
+        return false;
+    }
+
+    uint32_t *history = new uint32_t[state[2]];
+    if (!reader.restoreArray(CKPT_NEURON_SPIKE_HISTORY, iCluster, history, state[1])) {
+        delete[] history;
+        return false;
+    }
+    delete[] spike_history;
+    spike_history = history;
+    spikeHistoryBaseStep = state[0];
+    spikeHistoryUsed = state[1];
+    spikeHistoryAllocated = state[2];
+
+    return reader.restoreArray(CKPT_NEURON_HAS_FIRED, iCluster, hasFired, size)
+        && reader.restoreArray(CKPT_NEURON_SPIKE_COUNT, iCluster, spikeCount, size)
+        && reader.restoreArray(CKPT_NEURON_SPIKE_COUNT_OFFSET, iCluster, spikeCountOffset, size)
+        && reader.restoreArray(CKPT_NEURON_SPIKE_HISTORY_BEGIN, iCluster, spikeHistoryBegin, size)
+        && reader.restoreArray(CKPT_NEURON_SPIKE_HISTORY_SIZE, iCluster, spikeHistorySize, size);
+}
+#endif // !USE_GPU
+
+/*
+ *  Move the base step count of the spike history forward
+ *  so that the step counts of new spikes fit in 32 bits.
+ *  Spikes older than the new base step count are dropped.
+ *
+ *  @param  newBaseStep  New base step count.
+ */
+void AllSpikingNeuronsProps::rebaseSpikeHistory(uint64_t newBaseStep)
+{
+    uint64_t shift = newBaseStep - spikeHistoryBaseStep;
+    for (BGSIZE i = 0; i < spikeHistoryUsed; i++) {
+        if (spike_history[i] != NO_SPIKE) {
+            spike_history[i] = spike_history[i] < shift ? NO_SPIKE : static_cast<uint32_t>(spike_history[i] - shift);
+        }
+    }
+    spikeHistoryBaseStep = newBaseStep;
+}
+
 #if defined(USE_GPU)
 /*
  *  Allocate GPU memories to store all neurons' states.
@@ -107,7 +406,6 @@ void AllSpikingNeuronsProps::clearSpikeCounts(const SimulationInfo *sim_info, co
 void AllSpikingNeuronsProps::allocNeuronsDeviceProps(AllSpikingNeuronsProps &allNeuronsProps, SimulationInfo *sim_info, ClusterInfo *clr_info)
 {
     int size = clr_info->totalClusterNeurons;
-    int max_spikes = static_cast<int> (sim_info->epochDuration * sim_info->maxFiringRate);
 
     AllNeuronsProps::allocNeuronsDeviceProps(allNeuronsProps, sim_info, clr_info);
 
@@ -115,13 +413,11 @@ void AllSpikingNeuronsProps::allocNeuronsDeviceProps(AllSpikingNeuronsProps &all
     checkCudaErrors( cudaMalloc( ( void ** ) &allNeuronsProps.hasFired, size * sizeof( bool ) ) );
     checkCudaErrors( cudaMalloc( ( void ** ) &allNeuronsProps.spikeCount, size * sizeof( int ) ) );
     checkCudaErrors( cudaMalloc( ( void ** ) &allNeuronsProps.spikeCountOffset, size * sizeof( int ) ) );
-    checkCudaErrors( cudaMalloc( ( void ** ) &allNeuronsProps.spike_history, size * sizeof( uint64_t* ) ) );
-
-    uint64_t* pSpikeHistory[size];
-    for (int i = 0; i < size; i++) {
-        checkCudaErrors( cudaMalloc( ( void ** ) &pSpikeHistory[i], max_spikes * sizeof( uint64_t ) ) );
-    }
-    checkCudaErrors( cudaMemcpy ( allNeuronsProps.spike_history, pSpikeHistory, size * sizeof( uint64_t* ), cudaMemcpyHostToDevice ) );
+    checkCudaErrors( cudaMalloc( ( void ** ) &allNeuronsProps.spikeHistoryBegin, size * sizeof( BGSIZE ) ) );
+    checkCudaErrors( cudaMalloc( ( void ** ) &allNeuronsProps.spikeHistorySize, size * sizeof( int ) ) );
+    checkCudaErrors( cudaMalloc( ( void ** ) &allNeuronsProps.spike_history, spikeHistoryUsed * sizeof( uint32_t ) ) );
+    allNeuronsProps.spikeHistoryBaseStep = spikeHistoryBaseStep;
+    allNeuronsProps.spikeHistoryUsed = allNeuronsProps.spikeHistoryAllocated = spikeHistoryUsed;
 }
 
 /*
@@ -132,17 +428,11 @@ void AllSpikingNeuronsProps::allocNeuronsDeviceProps(AllSpikingNeuronsProps &all
  */
 void AllSpikingNeuronsProps::deleteNeuronsDeviceProps(AllSpikingNeuronsProps &allNeuronsProps, ClusterInfo *clr_info)
 {
-    int size = clr_info->totalClusterNeurons;
-
-    uint64_t* pSpikeHistory[size];
-    checkCudaErrors( cudaMemcpy ( pSpikeHistory, allNeuronsProps.spike_history, size * sizeof( uint64_t* ), cudaMemcpyDeviceToHost ) );
-    for (int i = 0; i < size; i++) {
-        checkCudaErrors( cudaFree( pSpikeHistory[i] ) );
-    }
-
     checkCudaErrors( cudaFree( allNeuronsProps.hasFired ) );
     checkCudaErrors( cudaFree( allNeuronsProps.spikeCount ) );
     checkCudaErrors( cudaFree( allNeuronsProps.spikeCountOffset ) );
+    checkCudaErrors( cudaFree( allNeuronsProps.spikeHistoryBegin ) );
+    checkCudaErrors( cudaFree( allNeuronsProps.spikeHistorySize ) );
     checkCudaErrors( cudaFree( allNeuronsProps.spike_history ) );
 
     AllNeuronsProps::deleteNeuronsDeviceProps(allNeuronsProps, clr_info);    
@@ -163,13 +453,9 @@ void AllSpikingNeuronsProps::copyHostToDeviceProps( AllSpikingNeuronsProps& allN
     checkCudaErrors( cudaMemcpy ( allNeuronsProps.hasFired, hasFired, size * sizeof( bool ), cudaMemcpyHostToDevice ) );
     checkCudaErrors( cudaMemcpy ( allNeuronsProps.spikeCount, spikeCount, size * sizeof( int ), cudaMemcpyHostToDevice ) );
     checkCudaErrors( cudaMemcpy ( allNeuronsProps.spikeCountOffset, spikeCountOffset, size * sizeof( int ), cudaMemcpyHostToDevice ) );
-
-    int max_spikes = static_cast<int> (sim_info->epochDuration * sim_info->maxFiringRate);
-    uint64_t* pSpikeHistory[size];
-    checkCudaErrors( cudaMemcpy ( pSpikeHistory, allNeuronsProps.spike_history, size * sizeof( uint64_t* ), cudaMemcpyDeviceToHost ) );
-    for (int i = 0; i < size; i++) {
-            checkCudaErrors( cudaMemcpy ( pSpikeHistory[i], spike_history[i], max_spikes * sizeof( uint64_t ), cudaMemcpyHostToDevice ) );
-    }
+    checkCudaErrors( cudaMemcpy ( allNeuronsProps.spikeHistoryBegin, spikeHistoryBegin, size * sizeof( BGSIZE ), cudaMemcpyHostToDevice ) );
+    checkCudaErrors( cudaMemcpy ( allNeuronsProps.spikeHistorySize, spikeHistorySize, size * sizeof( int ), cudaMemcpyHostToDevice ) );
+    checkCudaErrors( cudaMemcpy ( allNeuronsProps.spike_history, spike_history, spikeHistoryUsed * sizeof( uint32_t ), cudaMemcpyHostToDevice ) );
 }
 
 /*
@@ -187,13 +473,7 @@ void AllSpikingNeuronsProps::copyDeviceToHostProps( AllSpikingNeuronsProps& allN
     checkCudaErrors( cudaMemcpy ( hasFired, allNeuronsProps.hasFired, size * sizeof( bool ), cudaMemcpyDeviceToHost ) );
     checkCudaErrors( cudaMemcpy ( spikeCount, allNeuronsProps.spikeCount, size * sizeof( int ), cudaMemcpyDeviceToHost ) );
     checkCudaErrors( cudaMemcpy ( spikeCountOffset, allNeuronsProps.spikeCountOffset, size * sizeof( int ), cudaMemcpyDeviceToHost ) );
-
-    int max_spikes = static_cast<int> (sim_info->epochDuration * sim_info->maxFiringRate);
-    uint64_t* pSpikeHistory[size];
-    checkCudaErrors( cudaMemcpy ( pSpikeHistory, allNeuronsProps.spike_history, size * sizeof( uint64_t* ), cudaMemcpyDeviceToHost ) );
-    for (int i = 0; i < size; i++) {
-        checkCudaErrors( cudaMemcpy ( spike_history[i], pSpikeHistory[i], max_spikes * sizeof( uint64_t ), cudaMemcpyDeviceToHost ) );
-    }
+    checkCudaErrors( cudaMemcpy ( spike_history, allNeuronsProps.spike_history, spikeHistoryUsed * sizeof( uint32_t ), cudaMemcpyDeviceToHost ) );
 }
 
 /*
@@ -211,15 +491,9 @@ void AllSpikingNeuronsProps::copyNeuronDeviceSpikeHistoryToHost( void* allNeuron
     AllSpikingNeuronsProps allNeuronsProps;
     checkCudaErrors( cudaMemcpy ( &allNeuronsProps, allNeuronsDeviceProps, sizeof( AllSpikingNeuronsProps ), cudaMemcpyDeviceToHost ) );
 
-    int numNeurons = clr_info->totalClusterNeurons;
-    uint64_t* pSpikeHistory[numNeurons];
-    checkCudaErrors( cudaMemcpy ( pSpikeHistory, allNeuronsProps.spike_history, numNeurons * sizeof( uint64_t* ), cudaMemcpyDeviceToHost ) );
-
-    int max_spikes = static_cast<int> (sim_info->epochDuration * sim_info->maxFiringRate);
-    for (int i = 0; i < numNeurons; i++) {
-        checkCudaErrors( cudaMemcpy ( spike_history[i], pSpikeHistory[i],
-                max_spikes * sizeof( uint64_t ), cudaMemcpyDeviceToHost ) );
-    }
+    // the rings are not resized in device memory
+    checkCudaErrors( cudaMemcpy ( spike_history, allNeuronsProps.spike_history,
+            spikeHistoryUsed * sizeof( uint32_t ), cudaMemcpyDeviceToHost ) );
 
     // Set size to 0 to avoid illegal memory deallocation
     // at AllSpikingNeuronsProps deconstructor.
@@ -8,6 +8,55 @@
 
 #include "AllNeuronsProps.h"
 #include "Cluster.h"
+#include <vector>
+
+/**
+ *  The spike history of the neurons of a cluster at the end of an epoch,
+ *  handed over to a recorder by AllSpikingNeuronsProps::clearSpikeCounts():
+ *  the spike history buffer of the epoch itself (on the host only simulation,
+ *  a copy on the GPU), and the rings and spike counts of the epoch. The
+ *  buffer of the previous epoch given back with it is reused by the neurons
+ *  as the buffer of the next epoch when it is large enough.
+ */
+struct EpochSpikeHistory
+{
+    EpochSpikeHistory() : history(NULL), allocated(0), baseStep(0) {}
+    ~EpochSpikeHistory() { delete[] history; }
+
+    /**
+     *  Get the step count of a spike in the spike history ring of a neuron.
+     *
+     *  @param  index    Index of the neuron.
+     *  @param  idxSp    Position in the ring of the neuron.
+     *  @return the step count of the spike.
+     */
+    uint64_t getSpikeStep(int index, int idxSp) const
+    {
+        return baseStep + history[begin[index] + idxSp];
+    }
+
+    //! The spike history buffer (see AllSpikingNeuronsProps::spike_history).
+    uint32_t *history;
+
+    //! Number of entries of the buffer allocated.
+    BGSIZE allocated;
+
+    //! Step count which the step counts of the buffer are relative to.
+    uint64_t baseStep;
+
+    //! Beginning index, number of entries and offset of the oldest spike of the epoch of the ring of each neuron.
+    std::vector<BGSIZE> begin;
+    std::vector<int> size;
+    std::vector<int> offset;
+
+    //! Number of spikes of the epoch of each neuron.
+    std::vector<int> count;
+
+private:
+    // the buffer is owned by one history (swapped, not copied)
+    EpochSpikeHistory(const EpochSpikeHistory &);
+    EpochSpikeHistory &operator=(const EpochSpikeHistory &);
+};
 
 class AllSpikingNeuronsProps : public AllNeuronsProps
 {
@@ -30,8 +79,112 @@ class AllSpikingNeuronsProps : public AllNeuronsProps
          *  @param  sim_info  SimulationInfo class to read information from.
          *  @param  clr_info  ClusterInfo class to read information from.
          *  @param  clr       Cluster class to read information from.
+         *  @param  epoch     Receives the spike history of the epoch (NULL if not recorded this way).
+         */
+        void clearSpikeCounts(const SimulationInfo *sim_info, const ClusterInfo *clr_info, Cluster *clr, EpochSpikeHistory *epoch = NULL);
+
+#if !defined(USE_GPU)
+        /**
+         *  Add the state of the neurons that changes during the simulation
+         *  to a periodic checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the neurons.
+         */
+        virtual void checkpointState(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore the state of the neurons that changes during the simulation
+         *  from a periodic checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the neurons.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader, int iCluster);
+#endif // !USE_GPU
+
+        /**
+         *  Get the step count of a spike in the spike history ring of a neuron.
+         *
+         *  @param  index    Index of the neuron.
+         *  @param  idxSp    Position in the ring of the neuron.
+         *  @return the step count of the spike, or ULONG_MAX if there is no spike.
+         */
+        CUDA_CALLABLE uint64_t getSpikeHistoryStep(int index, int idxSp) const
+        {
+            uint32_t step = spike_history[spikeHistoryBegin[index] + idxSp];
+            return step == NO_SPIKE ? ULONG_MAX : spikeHistoryBaseStep + step;
+        }
+
+        /**
+         *  Set the step count of a spike in the spike history ring of a neuron.
+         *
+         *  @param  index           Index of the neuron.
+         *  @param  idxSp           Position in the ring of the neuron.
+         *  @param  simulationStep  The step count of the spike.
+         */
+        CUDA_CALLABLE void setSpikeHistoryStep(int index, int idxSp, uint64_t simulationStep)
+        {
+            spike_history[spikeHistoryBegin[index] + idxSp] = static_cast<uint32_t>(simulationStep - spikeHistoryBaseStep);
+        }
+
+#if !defined(USE_GPU)
+        /**
+         *  Double the spike history ring of a neuron (up to the maximum number of spikes
+         *  per epoch), when the ring is full of spikes which are not recorded yet.
+         *  The ring is moved to the end of the spike history buffer.
+         *
+         *  @param  index      Index of the neuron.
+         *  @param  maxSpikes  Maximum number of spikes per neuron per epoch.
+         */
+        void growSpikeHistory(int index, int maxSpikes);
+
+        /**
+         *  Grow the spike history ring of a neuron beforehand, so that it can record
+         *  a number of spikes without growing (up to the maximum number of spikes
+         *  per epoch).
+         *
+         *  @param  index      Index of the neuron.
+         *  @param  nSpikes    Number of spikes to make room for.
+         *  @param  maxSpikes  Maximum number of spikes per neuron per epoch.
+         */
+        void reserveSpikeHistory(int index, int nSpikes, int maxSpikes);
+#endif // !USE_GPU
+
+    private:
+        /**
+         *  Get the number of entries of the spike history ring of a neuron
+         *  which keeps the spikes in the look-back window.
+         *
+         *  @param  sim_info  SimulationInfo class to read information from.
+         *  @return the minimum number of entries of a ring.
+         */
+        static int getMinSpikeHistorySize(const SimulationInfo *sim_info);
+
+        /**
+         *  Resize the spike history ring of every neuron to the spikes fired in the epoch,
+         *  keeping the last spikes of the neuron, and pack the rings in a new buffer.
+         *
+         *  @param  sim_info  SimulationInfo class to read information from.
+         *  @param  newSize   New number of entries of the ring of each neuron.
+         *  @param  epoch     Receives the old buffer, and gives its buffer as the new one
+         *                    if it is large enough (NULL to free the old buffer).
+         */
+        void resizeSpikeHistory(const SimulationInfo *sim_info, const int *newSize, EpochSpikeHistory *epoch);
+
+        /**
+         *  Move the base step count of the spike history forward
+         *  so that the step counts of new spikes fit in 32 bits.
+         *  Spikes older than the new base step count are dropped.
+         *
+         *  @param  newBaseStep  New base step count.
          */
-        void clearSpikeCounts(const SimulationInfo *sim_info, const ClusterInfo *clr_info, Cluster *clr);
+        void rebaseSpikeHistory(uint64_t newBaseStep);
+
+    public:
+        //! Value of an empty entry of the spike history.
+        static const uint32_t NO_SPIKE = 0xFFFFFFFF;
 
 #if defined(USE_GPU)
     public:
@@ -110,16 +263,44 @@ class AllSpikingNeuronsProps : public AllNeuronsProps
         int *spikeCount;
 
         /**
-         *  Offset of the spike_history buffer.
+         *  Offset of the spike_history ring of each neuron.
          */
         int *spikeCountOffset;
 
         /**
          *  Step count (history) for each spike fired by each neuron.
-         *  The step counts are stored in a buffer for each neuron, and the pointers
-         *  to the buffer are stored in a list pointed by spike_history.
-         *  Each buffer is a circular, and offset of top location of the buffer i is
-         *  specified by spikeCountOffset[i].
+         *  The step counts of all neurons of the cluster are stored in one buffer,
+         *  relative to spikeHistoryBaseStep in 32 bits (NO_SPIKE for an empty entry).
+         *  The history of neuron i is a circular ring of spikeHistorySize[i] entries
+         *  beginning at spike_history[spikeHistoryBegin[i]], and offset of top location 
+         *  of the ring i is specified by spikeCountOffset[i].
+         *  On the host only simulation, the ring of each neuron is fit to its firing rate
+         *  at every epoch, but keeps the spikes of the last spikeHistoryWindow seconds.
+         */
+        uint32_t *spike_history;
+
+        /**
+         *  Beginning index of the spike history ring of each neuron.
+         */
+        BGSIZE *spikeHistoryBegin;
+
+        /**
+         *  Number of entries of the spike history ring of each neuron.
+         */
+        int *spikeHistorySize;
+
+        /**
+         *  Step count which the spike history step counts are relative to.
+         */
+        uint64_t spikeHistoryBaseStep;
+
+        /**
+         *  Number of entries of the spike_history buffer in use.
+         */
+        BGSIZE spikeHistoryUsed;
+
+        /**
+         *  Number of entries of the spike_history buffer allocated.
          */
-        uint64_t **spike_history;
+        BGSIZE spikeHistoryAllocated;
 };
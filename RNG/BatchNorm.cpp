@@ -0,0 +1,229 @@
+/*!
+  @file BatchNorm.cpp
+  @brief  Normally distributed random numbers generated in batches
+*/
+
+/************************************************************
+   BatchNorm.cpp -- normally distributed random numbers in batches
+
+   The lanes are computed with the GCC vector extensions, which the
+   compiler maps on the vector instructions of the target (SSE2, AVX2
+   or AVX-512). Only additions, multiplications, conversions and bit
+   operations are used, so the results do not depend on the target.
+
+   For each lane, two 32 bits uniform numbers r1 and r2 give:
+
+   1. U1 = (top 23 bits of r1 + 0.5) / 2^23, in (0, 1), and
+      R = sqrt(-2 * ln(U1)).
+   2. The quadrant Q = top 2 bits of r2, and the angle
+      T = Q * pi/2 + F, where F = (next 23 bits of r2 + 0.5) / 2^23 * pi/2 - pi/4.
+   3. X1 = R * cos(T) and X2 = R * sin(T), where cos(T) and sin(T) are
+      computed from cos(F) and sin(F) on [-pi/4, pi/4].
+
+   ln, sin and cos are the polynomials of logf, sinf and cosf of the Cephes
+   library (S. Moshier), and the square root is the inverse square root
+   refined by three Newton iterations.
+
+************************************************************/
+
+#include "BatchNorm.h"
+#include <cstring>
+
+typedef float vfloat __attribute__((vector_size(BATCHNORM_LANES * sizeof(float))));
+typedef int32_t vint __attribute__((vector_size(BATCHNORM_LANES * sizeof(int32_t))));
+typedef uint32_t vuint __attribute__((vector_size(BATCHNORM_LANES * sizeof(uint32_t))));
+
+/*
+ *  Natural logarithm of positive normal numbers (Cephes logf).
+ *  (The vectors are passed by reference, to keep the ABI of the target.)
+ *
+ *  @param  a       The numbers.
+ *  @param  result  The logarithms.
+ */
+static inline void vlog(const vfloat &a, vfloat &result)
+{
+    vint bits = (vint) a;
+
+    // a = m * 2^e, with m in [sqrt(1/2), sqrt(2))
+    vint e = (bits >> 23) - 126;
+    vfloat m = (vfloat) ((bits & 0x007fffff) | 0x3f000000);
+    vint small = m < 0.707106781186547524f;
+    e = e + small;
+    vfloat x = m - 1.0f + (vfloat) ((vint) m & small);
+    vfloat fe = __builtin_convertvector(e, vfloat);
+
+    vfloat z = x * x;
+    vfloat y = 7.0376836292E-2f * x - 1.1514610310E-1f;
+    y = y * x + 1.1676998740E-1f;
+    y = y * x - 1.2420140846E-1f;
+    y = y * x + 1.4249322787E-1f;
+    y = y * x - 1.6668057665E-1f;
+    y = y * x + 2.0000714765E-1f;
+    y = y * x - 2.4999993993E-1f;
+    y = y * x + 3.3333331174E-1f;
+    y = y * x * z;
+
+    y = y + fe * -2.12194440e-4f;
+    y = y - 0.5f * z;
+    x = x + y;
+    result = x + fe * 0.693359375f;
+}
+
+/*
+ *  Square root of positive normal numbers.
+ *
+ *  @param  a       The numbers.
+ *  @param  result  The square roots.
+ */
+static inline void vsqrt(const vfloat &a, vfloat &result)
+{
+    vfloat y = (vfloat) (0x5f3759df - ((vint) a >> 1));
+
+    y = y * (1.5f - 0.5f * a * y * y);
+    y = y * (1.5f - 0.5f * a * y * y);
+    y = y * (1.5f - 0.5f * a * y * y);
+
+    result = a * y;
+}
+
+/*
+ *  Constructor: seed the generators of the lanes with splitmix64.
+ *
+ *  @param seed seed for random number generator
+ */
+BatchNorm::BatchNorm(uint32_t seed) : nSpare(0)
+{
+    uint64_t x = seed;
+
+    for (int i = 0; i < BATCHNORM_LANES; i++) {
+        for (int j = 0; j < 4; j += 2) {
+            uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z = z ^ (z >> 31);
+            state[j][i] = static_cast<uint32_t>(z);
+            state[j + 1][i] = static_cast<uint32_t>(z >> 32);
+        }
+    }
+}
+
+/*
+ *  Generate the next 2 * BATCHNORM_LANES random numbers.
+ *
+ *  @param numbers the buffer to store the numbers to
+ */
+void BatchNorm::generate(float *numbers)
+{
+    vuint s0, s1, s2, s3;
+    memcpy(&s0, state[0], sizeof(vuint));
+    memcpy(&s1, state[1], sizeof(vuint));
+    memcpy(&s2, state[2], sizeof(vuint));
+    memcpy(&s3, state[3], sizeof(vuint));
+
+    vuint r[2];
+    for (int k = 0; k < 2; k++) {
+        // xoshiro128+
+        r[k] = s0 + s3;
+        vuint t = s1 << 9;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = (s3 << 11) | (s3 >> 21);
+    }
+
+    memcpy(state[0], &s0, sizeof(vuint));
+    memcpy(state[1], &s1, sizeof(vuint));
+    memcpy(state[2], &s2, sizeof(vuint));
+    memcpy(state[3], &s3, sizeof(vuint));
+
+    // the radius
+    vfloat u1 = (__builtin_convertvector((vint) (r[0] >> 9), vfloat) + 0.5f) * (1.0f / 8388608.0f);
+    vfloat logU1, radius;
+    vlog(u1, logU1);
+    vsqrt(-2.0f * logU1, radius);
+
+    // the angle in [-pi/4, pi/4) and its quadrant
+    vuint quadrant = r[1] >> 30;
+    vfloat f = (__builtin_convertvector((vint) ((r[1] >> 7) & 0x007fffff), vfloat) + 0.5f) * (1.0f / 8388608.0f);
+    vfloat x = f * 1.57079632679489661923f - 0.78539816339744830962f;
+    vfloat z = x * x;
+
+    // Cephes sinf and cosf on [-pi/4, pi/4]
+    vfloat sinx = -1.9515295891E-4f * z + 8.3321608736E-3f;
+    sinx = sinx * z - 1.6666654611E-1f;
+    sinx = sinx * z * x + x;
+
+    vfloat cosx = 2.443315711809948E-5f * z - 1.388731625493765E-3f;
+    cosx = cosx * z + 4.166664568298827E-2f;
+    cosx = cosx * z * z - 0.5f * z + 1.0f;
+
+    // rotate by the quadrant: (sin, cos) of Q * pi/2 + x are
+    // (sin, cos), (cos, -sin), (-sin, -cos), (-cos, sin)
+    vuint odd = -(quadrant & 1);
+    vuint sinBits = ((vuint) cosx & odd) | ((vuint) sinx & ~odd);
+    vuint cosBits = ((vuint) sinx & odd) | ((vuint) cosx & ~odd);
+    sinBits ^= (quadrant & 2) << 30;
+    cosBits ^= ((quadrant + 1) & 2) << 30;
+
+    vfloat x1 = radius * (vfloat) cosBits;
+    vfloat x2 = radius * (vfloat) sinBits;
+    memcpy(numbers, &x1, sizeof(vfloat));
+    memcpy(numbers + BATCHNORM_LANES, &x2, sizeof(vfloat));
+}
+
+/*
+ *  Fill a buffer with normally distributed random numbers.
+ *
+ *  @param numbers the buffer to fill
+ *  @param count the number of random numbers
+ */
+void BatchNorm::fill(BGFLOAT *numbers, int count)
+{
+    int i = 0;
+
+    // the numbers left over by the last fill
+    for (; i < count && nSpare > 0; i++, nSpare--) {
+        numbers[i] = spare[2 * BATCHNORM_LANES - nSpare];
+    }
+
+    alignas(64) float block[2 * BATCHNORM_LANES];
+    for (; i + 2 * BATCHNORM_LANES <= count; i += 2 * BATCHNORM_LANES) {
+        generate(block);
+        for (int j = 0; j < 2 * BATCHNORM_LANES; j++) {
+            numbers[i + j] = block[j];
+        }
+    }
+
+    if (i < count) {
+        generate(spare);
+        for (nSpare = 2 * BATCHNORM_LANES; i < count; i++, nSpare--) {
+            numbers[i] = spare[2 * BATCHNORM_LANES - nSpare];
+        }
+    }
+}
+
+/*
+ *  Save the state of the generator.
+ *
+ *  @param saveArray array of SAVE words
+ */
+void BatchNorm::save(uint32_t *saveArray) const
+{
+    memcpy(saveArray, state, sizeof(state));
+    memcpy(saveArray + 4 * BATCHNORM_LANES, spare, sizeof(spare));
+    saveArray[SAVE - 1] = nSpare;
+}
+
+/*
+ *  Load the state of the generator.
+ *
+ *  @param loadArray array of SAVE words written by save()
+ */
+void BatchNorm::load(const uint32_t *loadArray)
+{
+    memcpy(state, loadArray, sizeof(state));
+    memcpy(spare, loadArray + 4 * BATCHNORM_LANES, sizeof(spare));
+    nSpare = loadArray[SAVE - 1];
+}
@@ -0,0 +1,80 @@
+/*!
+  @file BatchNorm.h
+  @brief  Normally distributed random numbers generated in batches
+*/
+
+
+#ifndef _BATCHNORM_H_
+#define _BATCHNORM_H_
+
+#include "BGTypes.h"
+#include <inttypes.h>
+
+//! Number of random numbers generated together by one generator step (per transform output).
+#define BATCHNORM_LANES 16
+
+/*!
+  @class BatchNorm
+  @brief Fill buffers with normally distributed random numbers
+
+   This class fills buffers with normally distributed random numbers
+   with mean of 0 and variance of 1, 2 * BATCHNORM_LANES numbers at a time,
+   with vector instructions.
+
+   The uniform numbers come from BATCHNORM_LANES independent xoshiro128+
+   generators (Blackman and Vigna, "Scrambled Linear Pseudorandom Number
+   Generators", 2018) seeded with splitmix64. Each lane turns a pair of
+   uniform numbers into a pair of normal numbers with the Box-Muller
+   transform, using the Cephes polynomial approximations of log, sin and cos.
+
+   The numbers only depend on the seed: they are the same whatever the
+   instruction set, and whatever the sizes of the buffers that are filled
+   (the numbers left over by a fill are returned by the next one).
+*/
+class BatchNorm {
+public:
+  /*!
+    @param seed seed for random number generator
+  */
+  BatchNorm(uint32_t seed = 0);
+
+  /*!
+    Fill a buffer with normally distributed random numbers.
+    @param numbers the buffer to fill
+    @param count the number of random numbers
+  */
+  void fill(BGFLOAT *numbers, int count);
+
+  /*! length of array for save(): the state, the spare numbers and nSpare */
+  static const int SAVE = 4 * BATCHNORM_LANES + 2 * BATCHNORM_LANES + 1;
+
+  /*!
+    Save the state of the generator.
+    @param saveArray array of SAVE words
+  */
+  void save(uint32_t *saveArray) const;
+
+  /*!
+    Load the state of the generator.
+    @param loadArray array of SAVE words written by save()
+  */
+  void load(const uint32_t *loadArray);
+
+private:
+  /*!
+    Generate the next 2 * BATCHNORM_LANES random numbers.
+    @param numbers the buffer to store the numbers to
+  */
+  void generate(float *numbers);
+
+  /*! State of the xoshiro128+ generators, one word of all lanes per row */
+  uint32_t state[4][BATCHNORM_LANES];
+
+  /*! The numbers generated by the last call to generate() */
+  float spare[2 * BATCHNORM_LANES];
+
+  /*! The number of numbers of spare not returned yet (at its end) */
+  int nSpare;
+};
+
+#endif
@@ -127,8 +127,8 @@ class MTRand {
   inline void seed();
 
   // Saving and loading generator state
-  inline void save( uint32_t* saveArray ) const;  // to array of size SAVE
-  inline void load( uint32_t *const loadArray );  // from such array
+  void save( uint32_t* saveArray ) const;  // to array of size SAVE
+  void load( uint32_t *const loadArray );  // from such array
   friend std::ostream& operator<<( std::ostream& os, const MTRand& mtrand );
   friend std::istream& operator>>( std::istream& is, MTRand& mtrand );
 
@@ -53,6 +53,7 @@
 //
 
 #include "Norm.h"
+#include <cstring>
 
 using namespace std;
 
@@ -84,3 +85,33 @@ BGFLOAT Norm::operator() ()
   // Return X1 this time, X2 next time
   return(mu + sigma * X1);
 }
+
+/*
+ *  Save the state of the generator: the MTRand state, then odd and
+ *  X2 (as a double, so that the layout does not depend on BGFLOAT).
+ *
+ *  @param saveArray array of SAVE words
+ */
+void Norm::save(uint32_t *saveArray) const
+{
+  double x2 = X2;
+
+  MTRand::save(saveArray);
+  saveArray[MTRand::SAVE] = odd;
+  memcpy(&saveArray[MTRand::SAVE + 1], &x2, sizeof(x2));
+}
+
+/*
+ *  Load the state of the generator.
+ *
+ *  @param loadArray array of SAVE words written by save()
+ */
+void Norm::load(uint32_t *const loadArray)
+{
+  double x2;
+
+  MTRand::load(loadArray);
+  odd = loadArray[MTRand::SAVE] != 0;
+  memcpy(&x2, &loadArray[MTRand::SAVE + 1], sizeof(x2));
+  X2 = static_cast<BGFLOAT>(x2);
+}
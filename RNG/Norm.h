@@ -75,6 +75,21 @@ public:
     @return pseudorandom number drawn from a normal distribution.
   */
   virtual BGFLOAT operator() (void);
+
+  /*! length of array for save(): the MTRand state, odd and X2 */
+  static const int SAVE = MTRand::SAVE + 3;
+
+  /*!
+    Save the state of the generator.
+    @param saveArray array of SAVE words
+  */
+  void save(uint32_t *saveArray) const;
+
+  /*!
+    Load the state of the generator.
+    @param loadArray array of SAVE words written by save()
+  */
+  void load(uint32_t *const loadArray);
 private:
   // Additional state information
 
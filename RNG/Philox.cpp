@@ -0,0 +1,108 @@
+/*!
+  @file Philox.cpp
+  @brief  Counter-based random numbers
+*/
+
+/************************************************************
+   Philox.cpp -- Philox4x32-10 counter-based generator
+
+   Counter: (index, step low word, step high word, sample).
+   Key: (seed, stream).
+
+   Each of the 10 rounds multiplies the words 0 and 2 of the counter
+   by two constants, and mixes the high and low halves of the products
+   with the words 1 and 3 and the key; the key is bumped by the Weyl
+   constants between the rounds.
+
+************************************************************/
+
+#include "Philox.h"
+#include <cmath>
+
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+/*
+ *  Constructor
+ *
+ *  @param seed seed for random number generator (the low 32 bits are used)
+ */
+Philox::Philox(uint64_t seed) : m_seed(static_cast<uint32_t>(seed))
+{
+}
+
+/*
+ *  Generate the four random words of a counter.
+ *
+ *  @param stream the stream id
+ *  @param index the neuron layout index
+ *  @param step the simulation step
+ *  @param sample the index of the sample within the step
+ *  @param words the four random words
+ */
+void Philox::generate(uint32_t stream, uint32_t index, uint64_t step, uint32_t sample, uint32_t words[4]) const
+{
+    uint32_t c0 = index;
+    uint32_t c1 = static_cast<uint32_t>(step);
+    uint32_t c2 = static_cast<uint32_t>(step >> 32);
+    uint32_t c3 = sample;
+    uint32_t k0 = m_seed;
+    uint32_t k1 = stream;
+
+    for (int i = 0; i < PHILOX_ROUNDS; i++) {
+        uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+        uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+        c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        c1 = static_cast<uint32_t>(p1);
+        c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c3 = static_cast<uint32_t>(p0);
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    words[0] = c0;
+    words[1] = c1;
+    words[2] = c2;
+    words[3] = c3;
+}
+
+/*
+ *  Uniformly distributed random number in (0, 1), from 53 random bits.
+ *
+ *  @param stream the stream id
+ *  @param index the neuron layout index
+ *  @param step the simulation step
+ *  @param sample the index of the sample within the step
+ */
+double Philox::uniform(uint32_t stream, uint32_t index, uint64_t step, uint32_t sample) const
+{
+    uint32_t words[4];
+    generate(stream, index, step, sample, words);
+
+    uint64_t bits = (static_cast<uint64_t>(words[0]) << 21) ^ (words[1] >> 11);
+    return (bits + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ *  Normally distributed random number with mean of 0 and variance of 1,
+ *  with the Box-Muller transform of two uniform numbers of 53 bits.
+ *
+ *  @param stream the stream id
+ *  @param index the neuron layout index
+ *  @param step the simulation step
+ */
+BGFLOAT Philox::normal(uint32_t stream, uint32_t index, uint64_t step) const
+{
+    uint32_t words[4];
+    generate(stream, index, step, 0, words);
+
+    uint64_t bits1 = (static_cast<uint64_t>(words[0]) << 21) ^ (words[1] >> 11);
+    uint64_t bits2 = (static_cast<uint64_t>(words[2]) << 21) ^ (words[3] >> 11);
+    double u1 = (bits1 + 0.5) * (1.0 / 9007199254740992.0);
+    double u2 = bits2 * (1.0 / 9007199254740992.0);
+
+    return static_cast<BGFLOAT>(sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2));
+}
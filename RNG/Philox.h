@@ -0,0 +1,73 @@
+/*!
+  @file Philox.h
+  @brief  Counter-based random numbers
+*/
+
+
+#ifndef _PHILOX_H_
+#define _PHILOX_H_
+
+#include "BGTypes.h"
+#include <inttypes.h>
+
+//! Stream of the noise of the neurons.
+#define PHILOX_STREAM_NOISE 0
+
+//! Stream of the inter-spike intervals of the Poisson stimulus input.
+#define PHILOX_STREAM_POISSON 1
+
+/*!
+  @class Philox
+  @brief Generate random numbers that are pure functions of global indices
+
+   This class implements the Philox4x32-10 counter-based generator
+   (Salmon, Moraes, Dror and Shaw, "Parallel Random Numbers: As Easy
+   as 1, 2, 3", SC 2011). Each call encrypts a counter made of
+   (neuron layout index, simulation step, sample index) with a key made
+   of (seed, stream id), so a number does not depend on which cluster
+   or thread draws it, nor on the numbers drawn before it.
+
+   The object only keeps the seed, and all its methods are const: it
+   can be shared by any number of threads.
+*/
+class Philox {
+public:
+  /*!
+    @param seed seed for random number generator (the low 32 bits are used)
+  */
+  Philox(uint64_t seed = 0);
+
+  /*!
+    Generate the four random words of a counter.
+    @param stream the stream id
+    @param index the neuron layout index
+    @param step the simulation step
+    @param sample the index of the sample within the step
+    @param words the four random words
+  */
+  void generate(uint32_t stream, uint32_t index, uint64_t step, uint32_t sample, uint32_t words[4]) const;
+
+  /*!
+    Uniformly distributed random number in (0, 1).
+    @param stream the stream id
+    @param index the neuron layout index
+    @param step the simulation step
+    @param sample the index of the sample within the step
+  */
+  double uniform(uint32_t stream, uint32_t index, uint64_t step, uint32_t sample) const;
+
+  /*!
+    Normally distributed random number with mean of 0 and variance of 1
+    (the first number of the Box-Muller transform of the counter).
+    @param stream the stream id
+    @param index the neuron layout index
+    @param step the simulation step
+  */
+  BGFLOAT normal(uint32_t stream, uint32_t index, uint64_t step) const;
+
+private:
+  /*! The seed, the first word of the key */
+  uint32_t m_seed;
+};
+
+#endif
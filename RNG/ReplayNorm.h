@@ -0,0 +1,45 @@
+/*!
+  @file ReplayNorm.h
+  @brief  Replay of normally distributed random numbers drawn in advance
+*/
+
+
+#ifndef _REPLAYNORM_H_
+#define _REPLAYNORM_H_
+
+#include "Norm.h"
+
+/*!
+  @class ReplayNorm
+  @brief Return normally distributed random numbers drawn in advance
+
+   This class returns, in order, a sequence of numbers drawn in advance
+   from a Norm object. Threads that advance neurons concurrently replay
+   their parts of the sequence drawn by one thread, so that each neuron
+   gets the same random numbers as in a single threaded advance.
+*/
+class ReplayNorm : public Norm {
+public:
+  inline virtual ~ReplayNorm() {}
+
+  ReplayNorm() : Norm(), next(NULL) {}
+
+  /*!
+    Start the replay of a sequence of numbers.
+    @param numbers the first number of the sequence
+  */
+  void replay(const BGFLOAT *numbers) { next = numbers; }
+
+  /*!
+    Return the next number of the sequence.
+    @return pseudorandom number drawn in advance from a normal distribution.
+  */
+  virtual BGFLOAT operator() (void) { return *next++; }
+
+private:
+
+  /*! The next number of the sequence */
+  const BGFLOAT *next;
+};
+
+#endif
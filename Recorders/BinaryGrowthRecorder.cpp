@@ -0,0 +1,168 @@
+/*
+ *      @file BinaryGrowthRecorder.cpp
+ *
+ *      @brief An implementation for streaming spikes history to a binary file
+ */
+//! An implementation for streaming spikes history to a binary file
+
+#include "BinaryGrowthRecorder.h"
+#include "ConnGrowth.h"
+
+//! THe constructor and destructor
+BinaryGrowthRecorder::BinaryGrowthRecorder(const SimulationInfo* sim_info) :
+        BinaryRecorder(sim_info),
+        initialRates(sim_info->totalNeurons, 0),
+        initialRadii(sim_info->totalNeurons, 0),
+        initialWritten(false)
+{
+}
+
+BinaryGrowthRecorder::~BinaryGrowthRecorder()
+{
+}
+
+/*
+ * Init radii and rates history matrices with default values
+ */
+void BinaryGrowthRecorder::initDefaultValues()
+{
+    Connections* pConn = m_model->getConnections();
+    BGFLOAT startRadius = dynamic_cast<ConnGrowth*>(pConn)->m_growth.startRadius;
+
+    for (int i = 0; i < m_sim_info->totalNeurons; i++)
+    {
+        initialRadii[i] = startRadius;
+        initialRates[i] = 0;
+    }
+}
+
+/*
+ * Init radii and rates history matrices with current radii and rates
+ */
+void BinaryGrowthRecorder::initValues()
+{
+    Connections* pConn = m_model->getConnections();
+
+    for (int i = 0; i < m_sim_info->totalNeurons; i++)
+    {
+#if defined(USE_GPU)
+        initialRadii[i] = dynamic_cast<ConnGrowth*>(pConn)->radii[i];
+        initialRates[i] = dynamic_cast<ConnGrowth*>(pConn)->rates[i];
+#else // !USE_GPU
+        initialRadii[i] = (*dynamic_cast<ConnGrowth*>(pConn)->radii)[i];
+        initialRates[i] = (*dynamic_cast<ConnGrowth*>(pConn)->rates)[i];
+#endif // !USE_GPU
+    }
+}
+
+/*
+ * Append the initial rates and radii (epoch 0), if they aren't yet.
+ */
+void BinaryGrowthRecorder::writeInitialValues()
+{
+    if (initialWritten)
+        return;
+
+    writeColumn(SPK_RATES, 0, initialRates.data(), sizeof(BGFLOAT), m_sim_info->totalNeurons);
+    writeColumn(SPK_RADII, 0, initialRadii.data(), sizeof(BGFLOAT), m_sim_info->totalNeurons);
+    initialWritten = true;
+}
+
+/*
+ * Compile history information in every epoch
+ *
+ * @param[in] vtClr      Vector of pointer to the Cluster object.
+ * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+ */
+void BinaryGrowthRecorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
+{
+    writeInitialValues();
+
+    BinaryRecorder::compileHistories(vtClr, vtClrInfo);
+}
+
+/*
+ * Collect the histories of the epoch from the clusters, and the firing rates
+ * and radii of the neurons (on the simulation thread).
+ *
+ * @param[in] vtClr      Vector of pointer to the Cluster object.
+ * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+ * @param[out] histories The histories of the epoch.
+ */
+void BinaryGrowthRecorder::collectHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo, EpochHistories &histories)
+{
+    BinaryRecorder::collectHistories(vtClr, vtClrInfo, histories);
+
+    Connections* pConn = m_model->getConnections();
+
+    BGFLOAT minRadius = dynamic_cast<ConnGrowth*>(pConn)->m_growth.minRadius;
+#if defined(USE_GPU)
+    BGFLOAT* rates = dynamic_cast<ConnGrowth*>(pConn)->rates;
+    BGFLOAT* radii = dynamic_cast<ConnGrowth*>(pConn)->radii;
+#else // !USE_GPU
+    VectorMatrix& rates = (*dynamic_cast<ConnGrowth*>(pConn)->rates);
+    VectorMatrix& radii = (*dynamic_cast<ConnGrowth*>(pConn)->radii);
+#endif // !USE_GPU
+
+    // Cap minimum radius size (as the XmlGrowthRecorder)
+    for (int neuronLayoutIndex = 0; neuronLayoutIndex < m_sim_info->totalNeurons; neuronLayoutIndex++)
+    {
+        if (radii[neuronLayoutIndex] < minRadius)
+            radii[neuronLayoutIndex] = minRadius;
+    }
+
+    // firing rates and radii of the epoch, by original index
+    Layout *layout = m_model->getLayout();
+    histories.rates.resize(m_sim_info->totalNeurons);
+    histories.radii.resize(m_sim_info->totalNeurons);
+    for (int neuronLayoutIndex = 0; neuronLayoutIndex < m_sim_info->totalNeurons; neuronLayoutIndex++)
+    {
+        histories.rates[layout->getOriginalIndex(neuronLayoutIndex)] = rates[neuronLayoutIndex];
+        histories.radii[layout->getOriginalIndex(neuronLayoutIndex)] = radii[neuronLayoutIndex];
+    }
+}
+
+/*
+ * Append the histories of an epoch, and the firing rates and radii,
+ * to the spike stream file.
+ *
+ * @param[in] histories  The histories of the epoch.
+ */
+void BinaryGrowthRecorder::writeHistories(const EpochHistories &histories)
+{
+    BinaryRecorder::writeHistories(histories);
+
+    writeColumn(SPK_RATES, histories.epoch, histories.rates.data(), sizeof(BGFLOAT), histories.rates.size());
+    writeColumn(SPK_RADII, histories.epoch, histories.radii.data(), sizeof(BGFLOAT), histories.radii.size());
+}
+
+/*
+ * Writes simulation results to an output destination.
+ *
+ * @param[in] vtClr      Vector of pointer to the Cluster object.
+ * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+ **/
+void BinaryGrowthRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
+{
+    waitHistories();
+    writeInitialValues();
+
+    BinaryRecorder::saveSimData(vtClr, vtClrInfo);
+}
+
+/*
+ * Restore the spike stream file from a periodic checkpoint
+ * (the initial rates and radii are already in the file).
+ *
+ * @param[in] reader     The checkpoint reader.
+ * @return true if successful, false otherwise.
+ */
+bool BinaryGrowthRecorder::restore(const CheckpointReader &reader)
+{
+    if (!BinaryRecorder::restore(reader)) {
+        return false;
+    }
+    initialWritten = true;
+
+    return true;
+}
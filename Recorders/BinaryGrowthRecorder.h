@@ -0,0 +1,101 @@
+/**
+ *      @file BinaryGrowthRecorder.h
+ *
+ *      @brief Header file for BinaryGrowthRecorder.h
+ */
+//! An implementation for streaming spikes history to a binary file
+
+/**
+ ** \class BinaryGrowthRecorder BinaryGrowthRecorder.h "BinaryGrowthRecorder.h"
+ **
+ ** \latexonly  \subsubsection*{Implementation} \endlatexonly
+ ** \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ **
+ ** The BinaryGrowthRecorder streams the histories of the BinaryRecorder and
+ ** the growth histories to a binary spike stream file (.bgspk):
+ **     -# individual neuron's spike rate in epochs,
+ **     -# individual neuron's radius history of every epoch.
+ ** The rates and radii of an epoch are appended at the end of the epoch,
+ ** and the initial ones before the first epoch.
+ **/
+
+#pragma once
+
+#include "BinaryRecorder.h"
+
+class BinaryGrowthRecorder : public BinaryRecorder
+{
+public:
+    //! THe constructor and destructor
+    BinaryGrowthRecorder(const SimulationInfo* sim_info);
+    ~BinaryGrowthRecorder();
+
+    /**
+     * Init radii and rates history matrices with default values
+     */
+    virtual void initDefaultValues();
+
+    /**
+     * Init radii and rates history matrices with current radii and rates
+     */
+    virtual void initValues();
+
+    /**
+     * Compile history information in every epoch
+     *
+     * @param[in] vtClr      Vector of pointer to the Cluster object.
+     * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+     */
+    virtual void compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
+
+    /**
+     * Writes simulation results to an output destination.
+     *
+     * @param[in] vtClr      Vector of pointer to the Cluster object.
+     * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+     **/
+    virtual void saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
+
+    /**
+     * Restore the spike stream file from a periodic checkpoint
+     * (the initial rates and radii are already in the file).
+     *
+     * @param[in] reader     The checkpoint reader.
+     * @return true if successful, false otherwise.
+     */
+    virtual bool restore(const CheckpointReader &reader);
+
+protected:
+    /**
+     * Collect the histories of the epoch from the clusters, and the firing rates
+     * and radii of the neurons (on the simulation thread).
+     *
+     * @param[in] vtClr      Vector of pointer to the Cluster object.
+     * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+     * @param[out] histories The histories of the epoch.
+     */
+    virtual void collectHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo, EpochHistories &histories);
+
+    /**
+     * Append the histories of an epoch, and the firing rates and radii,
+     * to the spike stream file.
+     *
+     * @param[in] histories  The histories of the epoch.
+     */
+    virtual void writeHistories(const EpochHistories &histories);
+
+private:
+    /**
+     * Append the initial rates and radii (epoch 0), if they aren't yet.
+     */
+    void writeInitialValues();
+
+    // initial firing rates
+    vector<BGFLOAT> initialRates;
+
+    // initial radii
+    vector<BGFLOAT> initialRadii;
+
+    // true if the initial rates and radii are written
+    bool initialWritten;
+};
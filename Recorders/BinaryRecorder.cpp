@@ -0,0 +1,401 @@
+/*
+ *      @file BinaryRecorder.cpp
+ *
+ *      @brief An implementation for streaming spikes history to a binary file
+ */
+//! An implementation for streaming spikes history to a binary file
+
+#include "BinaryRecorder.h"
+#include "AllIFNeurons.h"      // TODO: remove LIF model specific code
+#include "Checkpoint.h"
+#include <algorithm>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//! THe constructor and destructor
+BinaryRecorder::BinaryRecorder(const SimulationInfo* sim_info) :
+        m_streamFailed(false),
+        m_iHistories(0),
+        m_writer(sim_info->asyncRecorder ? new RecorderThread() : NULL),
+        m_sim_info(sim_info),
+        m_model(dynamic_cast<Model*> (sim_info->model))
+{
+}
+
+BinaryRecorder::~BinaryRecorder()
+{
+    delete m_writer;
+}
+
+/*
+ * Initialize data
+ * Create a new spike stream file and write its header.
+ *
+ * @param[in] stateOutputFileName	File name to save histories
+ */
+void BinaryRecorder::init(const string& stateOutputFileName)
+{
+    m_fileName = stateOutputFileName;
+
+#if !defined(USE_GPU)
+    // a resumed simulation appends to the file of the interrupted run (see restore())
+    if (!m_sim_info->checkpointFileName.empty() && ifstream(m_sim_info->checkpointFileName.c_str()).good()) {
+        return;
+    }
+#endif // !USE_GPU
+
+    stateOut.open(stateOutputFileName.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!stateOut) {
+        cerr << "Failed creating the spike stream file " << stateOutputFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    writeSpikeStreamHeader(stateOut, sizeof(BGFLOAT), m_sim_info->totalNeurons, m_sim_info->maxSteps,
+                           m_sim_info->deltaT, m_sim_info->epochDuration);
+    checkStream();
+}
+
+/*
+ * Init radii and rates history matrices with default values
+ */
+void BinaryRecorder::initDefaultValues()
+{
+}
+
+/*
+ * Init radii and rates history matrices with current radii and rates
+ */
+void BinaryRecorder::initValues()
+{
+}
+
+/*
+ * Get the current radii and rates values
+ */
+void BinaryRecorder::getValues()
+{
+}
+
+/*
+ * Terminate process
+ * The simulation fails if the spike stream file has not been written completely.
+ */
+void BinaryRecorder::term()
+{
+    waitHistories();
+    stateOut.close();
+    checkStream();
+    if (m_streamFailed) {
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Report a failed write of the spike stream file (once, the stream then stays failed).
+ */
+void BinaryRecorder::checkStream()
+{
+    if (!stateOut && !m_streamFailed) {
+        cerr << "Failed writing the spike stream file " << m_fileName << endl;
+        m_streamFailed = true;
+    }
+}
+
+/*
+ * Append a column to the spike stream file.
+ *
+ * @param[in] type         Type of the column (spikeStreamColumnType).
+ * @param[in] epoch        Epoch of the column.
+ * @param[in] data         The elements.
+ * @param[in] elementSize  Size of an element in bytes.
+ * @param[in] count        Number of elements.
+ * @param[in] base         Base value of the column.
+ */
+void BinaryRecorder::writeColumn(spikeStreamColumnType type, int epoch, const void *data, uint32_t elementSize, uint64_t count, uint64_t base)
+{
+    writeSpikeStreamColumn(stateOut, type, epoch, data, elementSize, count, base);
+    checkStream();
+}
+
+/*
+ * Bin the spikes of the epoch and append the counts to the spike stream file.
+ * The bins are computed as in the XmlRecorder, and the column holds the bins
+ * from the first to the last one with a spike.
+ *
+ * @param[in] type           Type of the column.
+ * @param[in] histories      The histories of the epoch.
+ * @param[in] binsPerSecond  Number of bins per second.
+ */
+void BinaryRecorder::writeBins(spikeStreamColumnType type, const EpochHistories &histories, int binsPerSecond)
+{
+    const vector<uint32_t> &spikeSteps = histories.spikeSteps;
+
+    uint64_t firstBin = 0, lastBin = 0;
+    for (size_t i = 0; i < spikeSteps.size(); i++) {
+        uint64_t spikeStep = histories.beginStep + spikeSteps[i];
+        uint64_t bin = static_cast<uint64_t>( static_cast<double>( spikeStep ) * m_sim_info->deltaT * binsPerSecond );
+        if (i == 0 || bin < firstBin) firstBin = bin;
+        if (i == 0 || bin > lastBin) lastBin = bin;
+    }
+
+    binCounts.assign(spikeSteps.empty() ? 0 : lastBin - firstBin + 1, 0);
+    for (size_t i = 0; i < spikeSteps.size(); i++) {
+        uint64_t spikeStep = histories.beginStep + spikeSteps[i];
+        uint64_t bin = static_cast<uint64_t>( static_cast<double>( spikeStep ) * m_sim_info->deltaT * binsPerSecond );
+        binCounts[bin - firstBin]++;
+    }
+
+    writeColumn(type, histories.epoch, binCounts.data(), sizeof(uint32_t), binCounts.size(), firstBin);
+}
+
+/*
+ * Compile history information in every epoch: collect the spikes of the
+ * epoch, and list and append them to the spike stream file, on the recorder
+ * thread in the asynchronous mode.
+ *
+ * @param[in] vtClr      Vector of pointer to the Cluster object.
+ * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+ */
+void BinaryRecorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
+{
+    EpochHistories &histories = m_histories[m_iHistories];
+    collectHistories(vtClr, vtClrInfo, histories);
+
+    if (m_writer == NULL) {
+        listSpikes(histories);
+        writeHistories(histories);
+        return;
+    }
+
+    // the other histories are written while these are collected at the end of the next epoch
+    m_writer->post([this, &histories] {
+        listSpikes(histories);
+        writeHistories(histories);
+    });
+    m_iHistories = 1 - m_iHistories;
+}
+
+/*
+ * Collect the histories of the epoch from the clusters (on the simulation thread).
+ * The spike history of each cluster is handed over as it is, in exchange for
+ * the buffer of the epoch before the previous one: the spikes are only listed
+ * by listSpikes().
+ *
+ * @param[in] vtClr      Vector of pointer to the Cluster object.
+ * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+ * @param[out] histories The histories of the epoch.
+ */
+void BinaryRecorder::collectHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo, EpochHistories &histories)
+{
+    // the epoch started epochDuration / deltaT steps ago (see Simulator::advanceUntilGrowth())
+    histories.epoch = m_sim_info->currentStep;
+    histories.beginStep = g_simulationStep - static_cast<uint64_t>(m_sim_info->epochDuration / m_sim_info->deltaT);
+
+    if (histories.clusterSpikes.size() != vtClr.size()) {
+        vector<EpochSpikeHistory>(vtClr.size()).swap(histories.clusterSpikes);
+        histories.clusterNeuronsBegin.resize(vtClr.size());
+    }
+
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++)
+    {
+        AllSpikingNeurons *neurons = dynamic_cast<AllSpikingNeurons*>(vtClr[iCluster]->m_neurons);
+        AllSpikingNeuronsProps *pNeuronsProps = dynamic_cast<AllSpikingNeuronsProps*>(neurons->m_pNeuronsProps);
+
+        // clear spike count, the spikes go to the histories
+        histories.clusterNeuronsBegin[iCluster] = vtClrInfo[iCluster]->clusterNeuronsBegin;
+        pNeuronsProps->clearSpikeCounts(m_sim_info, vtClrInfo[iCluster], vtClr[iCluster], &histories.clusterSpikes[iCluster]);
+    }
+}
+
+/*
+ * List the spikes of the epoch from the spike histories of the clusters
+ * (on the recorder thread in the asynchronous mode).
+ *
+ * @param[in,out] histories  The histories of the epoch.
+ */
+void BinaryRecorder::listSpikes(EpochHistories &histories)
+{
+    Layout *layout = m_model->getLayout();
+    histories.spikeNeurons.clear();
+    histories.spikeSteps.clear();
+
+    for (size_t iCluster = 0; iCluster < histories.clusterSpikes.size(); iCluster++)
+    {
+        const EpochSpikeHistory &clusterSpikes = histories.clusterSpikes[iCluster];
+
+        // collect spikes
+        int neuronLayoutIndex = histories.clusterNeuronsBegin[iCluster];
+        int totalClusterNeurons = clusterSpikes.count.size();
+        for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++, neuronLayoutIndex++)
+        {
+            int history_size = clusterSpikes.size[iNeuron];
+            int spike_count = clusterSpikes.count[iNeuron];
+            for (int i = 0, idxSp = clusterSpikes.offset[iNeuron]; i < spike_count; i++, idxSp++)
+            {
+                if (idxSp >= history_size) idxSp = 0;
+                uint64_t spikeStep = clusterSpikes.getSpikeStep(iNeuron, idxSp);
+
+                histories.spikeNeurons.push_back(layout->getOriginalIndex(neuronLayoutIndex));
+                histories.spikeSteps.push_back(static_cast<uint32_t>(spikeStep - histories.beginStep));
+            }
+        }
+    }
+
+    // list the spikes by original index of the neurons, as the contiguous clusters do
+    if (layout->getOriginalIndices() != NULL) {
+        BGSIZE nSpikes = histories.spikeNeurons.size();
+        vector<uint64_t> keys(nSpikes);
+        for (BGSIZE i = 0; i < nSpikes; i++) {
+            keys[i] = (static_cast<uint64_t>(histories.spikeNeurons[i]) << 32) | i;
+        }
+        sort(keys.begin(), keys.end());
+
+        vector<uint32_t> spikeSteps(nSpikes);
+        for (BGSIZE i = 0; i < nSpikes; i++) {
+            histories.spikeNeurons[i] = static_cast<uint32_t>(keys[i] >> 32);
+            spikeSteps[i] = histories.spikeSteps[keys[i] & 0xffffffff];
+        }
+        histories.spikeSteps.swap(spikeSteps);
+    }
+}
+
+/*
+ * Append the histories of an epoch to the spike stream file
+ * (on the recorder thread in the asynchronous mode).
+ *
+ * @param[in] histories  The histories of the epoch.
+ */
+void BinaryRecorder::writeHistories(const EpochHistories &histories)
+{
+    writeColumn(SPK_SPIKE_NEURONS, histories.epoch, histories.spikeNeurons.data(), sizeof(uint32_t), histories.spikeNeurons.size());
+    writeColumn(SPK_SPIKE_STEPS, histories.epoch, histories.spikeSteps.data(), sizeof(uint32_t), histories.spikeSteps.size(), histories.beginStep);
+
+    // compile network wide burstiness index data in 1s bins
+    writeBins(SPK_BURSTINESS_BINS, histories, 1);
+
+    // compile network wide spike count in 10ms bins
+    writeBins(SPK_SPIKES_BINS, histories, 100);
+}
+
+/*
+ * Wait until the histories of the last epoch are written.
+ */
+void BinaryRecorder::waitHistories()
+{
+    if (m_writer != NULL) {
+        m_writer->wait();
+    }
+}
+
+/*
+ * Writes simulation results to an output destination.
+ *
+ * @param[in] vtClr      Vector of pointer to the Cluster object.
+ * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+ **/
+void BinaryRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
+{
+    waitHistories();
+
+    int epoch = m_sim_info->maxSteps;
+    int totalNeurons = m_sim_info->totalNeurons;
+    Layout *layout = m_model->getLayout();
+
+    // the neurons by original index
+    vector<BGFLOAT> xloc(totalNeurons), yloc(totalNeurons);
+    for (int i = 0; i < totalNeurons; i++) {
+        xloc[layout->getOriginalIndex(i)] = layout->xloc[i];
+        yloc[layout->getOriginalIndex(i)] = layout->yloc[i];
+    }
+    writeColumn(SPK_XLOC, epoch, xloc.data(), sizeof(BGFLOAT), totalNeurons);
+    writeColumn(SPK_YLOC, epoch, yloc.data(), sizeof(BGFLOAT), totalNeurons);
+
+    // create Neuron Types matrix
+    vector<int32_t> neuronTypes(totalNeurons);
+    for (int i = 0; i < totalNeurons; i++) {
+        neuronTypes[layout->getOriginalIndex(i)] = layout->neuron_type_map[i];
+    }
+    writeColumn(SPK_NEURON_TYPES, epoch, neuronTypes.data(), sizeof(int32_t), totalNeurons);
+
+    // create starter nuerons matrix
+    vector<int32_t> starterNeurons;
+    for (int i = 0; i < totalNeurons; i++) {
+        if (layout->starter_map[layout->getLayoutIndex(i)]) {
+            starterNeurons.push_back(i);
+        }
+    }
+    writeColumn(SPK_STARTER_NEURONS, epoch, starterNeurons.data(), sizeof(int32_t), starterNeurons.size());
+
+    // create neuron threshold matrix
+    vector<BGFLOAT> neuronThresh(totalNeurons);
+    for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++) {
+        AllIFNeurons *neurons = dynamic_cast<AllIFNeurons*>(vtClr[iCluster]->m_neurons);
+        AllIFNeuronsProps *pNeuronsProps = dynamic_cast<AllIFNeuronsProps*>(neurons->m_pNeuronsProps);
+
+        int neuronLayoutIndex = vtClrInfo[iCluster]->clusterNeuronsBegin;
+        int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
+        for (int iNeurons = 0; iNeurons < totalClusterNeurons; iNeurons++, neuronLayoutIndex++) {
+            neuronThresh[layout->getOriginalIndex(neuronLayoutIndex)] = pNeuronsProps->Vthresh[iNeurons];
+        }
+    }
+    writeColumn(SPK_NEURON_THRESH, epoch, neuronThresh.data(), sizeof(BGFLOAT), totalNeurons);
+
+    // write simulation end step
+    writeColumn(SPK_END_STEP, epoch, NULL, 0, 0, g_simulationStep);
+
+    stateOut.flush();
+    checkStream();
+}
+
+/*
+ * Add the size of the spike stream file written so far to a periodic checkpoint
+ * (after the histories of the epoch are written).
+ *
+ * @param[in] writer     The checkpoint writer.
+ */
+void BinaryRecorder::checkpoint(CheckpointWriter &writer)
+{
+    waitHistories();
+    stateOut.flush();
+    checkStream();
+    if (m_streamFailed) {
+        // the checkpoint would resume a truncated spike stream file
+        exit(EXIT_FAILURE);
+    }
+
+    writer.addValue(CKPT_SPIKE_STREAM_OFFSET, 0, static_cast<uint64_t>(stateOut.tellp()));
+}
+
+/*
+ * Restore the spike stream file from a periodic checkpoint: the file is
+ * truncated to its size at the checkpoint, and appended to from there.
+ *
+ * @param[in] reader     The checkpoint reader.
+ * @return true if successful, false otherwise.
+ */
+bool BinaryRecorder::restore(const CheckpointReader &reader)
+{
+    uint64_t offset;
+    if (!reader.restoreValue(CKPT_SPIKE_STREAM_OFFSET, 0, offset)) {
+        return false;
+    }
+
+    struct stat st;
+    if (stat(m_fileName.c_str(), &st) != 0 || static_cast<uint64_t>(st.st_size) < offset) {
+        cerr << "The spike stream file " << m_fileName << " is missing or shorter than at the checkpoint ("
+             << offset << " bytes)" << endl;
+        return false;
+    }
+    if (truncate(m_fileName.c_str(), static_cast<off_t>(offset)) != 0) {
+        cerr << "Failed truncating the spike stream file " << m_fileName << endl;
+        return false;
+    }
+
+    stateOut.open(m_fileName.c_str(), ios::out | ios::binary | ios::app);
+    if (!stateOut) {
+        cerr << "Failed opening the spike stream file " << m_fileName << endl;
+        return false;
+    }
+
+    return true;
+}
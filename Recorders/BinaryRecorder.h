@@ -0,0 +1,218 @@
+/**
+ *      @file BinaryRecorder.h
+ *
+ *      @brief Header file for BinaryRecorder.h
+ */
+//! An implementation for streaming spikes history to a binary file
+
+/**
+ ** \class BinaryRecorder BinaryRecorder.h "BinaryRecorder.h"
+ **
+ ** \latexonly  \subsubsection*{Implementation} \endlatexonly
+ ** \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ **
+ ** The BinaryRecorder streams the spikes history to a binary spike stream
+ ** file (.bgspk, see SpikeStream.h) at the end of every epoch:
+ **     -# the spikes of the epoch (neuron layout index and step),
+ **     -# network wide spike count of the epoch in 1s bins,
+ **     -# network wide spike count of the epoch in 10ms bins,
+ ** and the neuron's locations, type map and thresholds at the end of the simulation.
+ **
+ ** Unlike the XmlRecorder, it does not keep the histories of the whole simulation
+ ** in memory: its memory only depends on the number of spikes of an epoch.
+ ** Tools/SpikeStreamToXml.cpp converts the file into the xml file of the XmlRecorder.
+ **
+ ** Between the epochs, the spike history of each cluster is only handed over
+ ** to the recorder (AllSpikingNeuronsProps::clearSpikeCounts() swaps its buffer
+ ** with the buffer of a previous epoch). In the asynchronous mode
+ ** (SimulationInfo::asyncRecorder), the spikes are then listed, binned and
+ ** written by a RecorderThread, while the clusters simulate the next epoch,
+ ** and the next epoch is handed over into the other histories.
+ **
+ ** The file is only appended to, so a periodic checkpoint just records its
+ ** size: a resumed simulation truncates the file of the interrupted run to
+ ** that size and appends the next epochs to it.
+ **/
+
+#pragma once
+
+#include "IRecorder.h"
+#include "Model.h"
+#include "SpikeStream.h"
+#include "RecorderThread.h"
+#include "AllSpikingNeuronsProps.h"
+#include <fstream>
+
+//! The histories of an epoch, from the simulation to the spike stream file.
+struct EpochHistories {
+    //! Epoch.
+    int epoch;
+
+    //! First simulation step of the epoch.
+    uint64_t beginStep;
+
+    //! Spike history of the epoch of each cluster, and layout index of its first neuron.
+    vector<EpochSpikeHistory> clusterSpikes;
+    vector<int> clusterNeuronsBegin;
+
+    //! Neuron layout indexes of the spikes of the epoch.
+    vector<uint32_t> spikeNeurons;
+
+    //! Steps of the spikes of the epoch (from the first step of the epoch).
+    vector<uint32_t> spikeSteps;
+
+    //! Firing rates and radii at the end of the epoch (growth only).
+    vector<BGFLOAT> rates;
+    vector<BGFLOAT> radii;
+};
+
+class BinaryRecorder : public IRecorder
+{
+public:
+    //! THe constructor and destructor
+    BinaryRecorder(const SimulationInfo* sim_info);
+    ~BinaryRecorder();
+
+    /**
+     * Initialize data
+     *
+     * @param[in] stateOutputFileName       File name to save histories
+     */
+    virtual void init(const string& stateOutputFileName);
+
+    /**
+     * Init radii and rates history matrices with default values
+     */
+    virtual void initDefaultValues();
+
+    /**
+     * Init radii and rates history matrices with current radii and rates
+     */
+    virtual void initValues();
+
+    /**
+     * Get the current radii and rates vlaues
+     */
+    virtual void getValues();
+
+    /**
+     * Terminate process
+     */
+    virtual void term();
+
+    /**
+     * Compile history information in every epoch
+     *
+     * @param[in] vtClr      Vector of pointer to the Cluster object.
+     * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+     */
+    virtual void compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
+
+    /**
+     * Writes simulation results to an output destination.
+     *
+     * @param[in] vtClr      Vector of pointer to the Cluster object.
+     * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+     **/
+    virtual void saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
+
+    /**
+     * Add the size of the spike stream file written so far to a periodic checkpoint.
+     *
+     * @param[in] writer     The checkpoint writer.
+     */
+    virtual void checkpoint(CheckpointWriter &writer);
+
+    /**
+     * Restore the spike stream file from a periodic checkpoint: the file is
+     * truncated to its size at the checkpoint, and appended to from there.
+     *
+     * @param[in] reader     The checkpoint reader.
+     * @return true if successful, false otherwise.
+     */
+    virtual bool restore(const CheckpointReader &reader);
+
+protected:
+    /**
+     * Collect the histories of the epoch from the clusters (on the simulation thread).
+     *
+     * @param[in] vtClr      Vector of pointer to the Cluster object.
+     * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
+     * @param[out] histories The histories of the epoch.
+     */
+    virtual void collectHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo, EpochHistories &histories);
+
+    /**
+     * List the spikes of the epoch from the spike histories of the clusters
+     * (on the recorder thread in the asynchronous mode).
+     *
+     * @param[in,out] histories  The histories of the epoch.
+     */
+    void listSpikes(EpochHistories &histories);
+
+    /**
+     * Append the histories of an epoch to the spike stream file
+     * (on the recorder thread in the asynchronous mode).
+     *
+     * @param[in] histories  The histories of the epoch.
+     */
+    virtual void writeHistories(const EpochHistories &histories);
+
+    /**
+     * Wait until the histories of the last epoch are written.
+     */
+    void waitHistories();
+
+    /**
+     * Append a column to the spike stream file.
+     *
+     * @param[in] type         Type of the column (spikeStreamColumnType).
+     * @param[in] epoch        Epoch of the column.
+     * @param[in] data         The elements.
+     * @param[in] elementSize  Size of an element in bytes.
+     * @param[in] count        Number of elements.
+     * @param[in] base         Base value of the column.
+     */
+    void writeColumn(spikeStreamColumnType type, int epoch, const void *data, uint32_t elementSize, uint64_t count, uint64_t base = 0);
+
+    /**
+     * Bin the spikes of the epoch and append the counts to the spike stream file.
+     *
+     * @param[in] type           Type of the column.
+     * @param[in] histories      The histories of the epoch.
+     * @param[in] binsPerSecond  Number of bins per second.
+     */
+    void writeBins(spikeStreamColumnType type, const EpochHistories &histories, int binsPerSecond);
+
+    /**
+     * Report a failed write of the spike stream file (once, the stream then stays failed).
+     */
+    void checkStream();
+
+    // a file stream for the binary output
+    ofstream stateOut;
+
+    // name of the spike stream file
+    string m_fileName;
+
+    // true once a failed write of the spike stream file has been reported
+    bool m_streamFailed;
+
+    // the histories of the epoch being collected, and of the epoch being written
+    EpochHistories m_histories[2];
+
+    // index of the histories of the next epoch to collect
+    int m_iHistories;
+
+    // spike counts of the epoch
+    vector<uint32_t> binCounts;
+
+    // thread that writes the histories in the asynchronous mode (NULL otherwise)
+    RecorderThread *m_writer;
+
+    // Struct that holds information about a simulation
+    const SimulationInfo *m_sim_info;
+
+    // The model of the simulation, to map the neurons to their original indexes
+    Model *m_model;
+};
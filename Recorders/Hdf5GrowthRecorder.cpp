@@ -75,18 +75,25 @@ void Hdf5GrowthRecorder::initDataSet()
 {
     Hdf5Recorder::initDataSet();
 
-    // create the data space & dataset for rates history
-    hsize_t dims[2];
-    dims[0] = static_cast<hsize_t>(m_sim_info->maxSteps + 1);
+    // the rates and radii histories are extendible datasets of one row per epoch,
+    // stored in chunks of one row, which grow as the epochs are written
+    hsize_t dims[2], maxdims[2], chunkdims[2];
+    dims[0] = 0;
     dims[1] = static_cast<hsize_t>(m_sim_info->totalNeurons);
-    DataSpace dsRatesHist(2, dims);
-    dataSetRatesHist = new DataSet(stateOut->createDataSet(nameRatesHist, H5_FLOAT, dsRatesHist));
+    maxdims[0] = H5S_UNLIMITED;
+    maxdims[1] = static_cast<hsize_t>(m_sim_info->totalNeurons);
+    chunkdims[0] = 1;
+    chunkdims[1] = static_cast<hsize_t>(m_sim_info->totalNeurons);
+    DSetCreatPropList propList;
+    propList.setChunk(2, chunkdims);
+
+    // create the data space & dataset for rates history
+    DataSpace dsRatesHist(2, dims, maxdims);
+    dataSetRatesHist = new DataSet(stateOut->createDataSet(nameRatesHist, H5_FLOAT, dsRatesHist, propList));
 
     // create the data space & dataset for radii history
-    dims[0] = static_cast<hsize_t>(m_sim_info->maxSteps + 1);
-    dims[1] = static_cast<hsize_t>(m_sim_info->totalNeurons);
-    DataSpace dsRadiiHist(2, dims);
-    dataSetRadiiHist = new DataSet(stateOut->createDataSet(nameRadiiHist, H5_FLOAT, dsRadiiHist));
+    DataSpace dsRadiiHist(2, dims, maxdims);
+    dataSetRadiiHist = new DataSet(stateOut->createDataSet(nameRadiiHist, H5_FLOAT, dsRadiiHist, propList));
 
     // allocate data memories
     ratesHistory = new BGFLOAT[m_sim_info->totalNeurons];
@@ -190,8 +197,10 @@ void Hdf5GrowthRecorder::compileHistories(vector<Cluster *> &vtClr, vector<Clust
     // output spikes
     for (int neuronLayoutIndex = 0; neuronLayoutIndex < m_sim_info->totalNeurons; neuronLayoutIndex++)
     {
+        int neuronOriginalIndex = m_model->getLayout()->getOriginalIndex(neuronLayoutIndex);
+
         // record firing rate to history matrix
-        ratesHistory[neuronLayoutIndex] = rates[neuronLayoutIndex];
+        ratesHistory[neuronOriginalIndex] = rates[neuronLayoutIndex];
 
         // Cap minimum radius size and record radii to history matrix
         // TODO: find out why we cap this here.
@@ -199,7 +208,7 @@ void Hdf5GrowthRecorder::compileHistories(vector<Cluster *> &vtClr, vector<Clust
             radii[neuronLayoutIndex] = minRadius;
 
         // record radius to history matrix
-        radiiHistory[neuronLayoutIndex] = radii[neuronLayoutIndex];
+        radiiHistory[neuronOriginalIndex] = radii[neuronLayoutIndex];
 
         DEBUG_MID(cout << "radii[" << neuronLayoutIndex << ":" << radii[neuronLayoutIndex] << "]" << endl;)
     }
@@ -208,7 +217,9 @@ void Hdf5GrowthRecorder::compileHistories(vector<Cluster *> &vtClr, vector<Clust
 }
 
 /*
- * Incrementaly write radii and rates histories
+ * Incrementaly write radii and rates histories: extend the datasets
+ * to the current epoch and write its row, then flush the file
+ * so that the epochs written so far can be read while the simulation runs.
  */
 void Hdf5GrowthRecorder::writeRadiiRates()
 {
@@ -217,9 +228,20 @@ void Hdf5GrowthRecorder::writeRadiiRates()
         // Write radii and rates histories information:
         hsize_t offset[2], count[2];
         hsize_t dimsm[2];
+        hsize_t dims[2];
         DataSpace* dataspace;
         DataSpace* memspace;
 
+        // extend the datasets to the current epoch
+        dims[0] = static_cast<hsize_t>(m_sim_info->currentStep + 1);
+        dims[1] = static_cast<hsize_t>(m_sim_info->totalNeurons);
+        hsize_t curdims[2];
+        dataSetRadiiHist->getSpace().getSimpleExtentDims(curdims);
+        if (curdims[0] < dims[0]) {
+            dataSetRadiiHist->extend(dims);
+            dataSetRatesHist->extend(dims);
+        }
+
         // write radii history
         offset[0] = m_sim_info->currentStep;
         offset[1] = 0;
@@ -242,11 +264,13 @@ void Hdf5GrowthRecorder::writeRadiiRates()
         dimsm[0] = 1;
         dimsm[1] = m_sim_info->totalNeurons;
         memspace = new DataSpace(2, dimsm, NULL);
-        dataspace = new DataSpace(dataSetRadiiHist->getSpace());
+        dataspace = new DataSpace(dataSetRatesHist->getSpace());
         dataspace->selectHyperslab(H5S_SELECT_SET, count, offset);
         dataSetRatesHist->write(ratesHistory, H5_FLOAT, *memspace, *dataspace); 
         delete dataspace;
         delete memspace;
+
+        stateOut->flush(H5F_SCOPE_LOCAL);
     }
     
     // catch failure caused by the H5File operations
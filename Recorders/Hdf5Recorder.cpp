@@ -7,6 +7,7 @@
 
 #include "Hdf5Recorder.h"
 #include "AllIFNeurons.h"      // TODO: remove LIF model specific code
+#include <algorithm>
 
 // hdf5 dataset name
 const H5std_string  nameBurstHist("burstinessHist");
@@ -229,8 +230,7 @@ void Hdf5Recorder::term()
  */
 void Hdf5Recorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
 {
-    int max_spikes = (int) ((m_sim_info->epochDuration * m_sim_info->maxFiringRate));
-
+    const vector<int> &probedNeurons = m_model->getLayout()->m_probed_neuron_list;
     unsigned int iProbe = 0;    // index of the probedNeuronsLayout vector
     bool fProbe = false;
 
@@ -244,10 +244,12 @@ void Hdf5Recorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo
         int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
         for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++, neuronLayoutIndex++)
         {
-            // true if this is a probed neuron
-            fProbe = ((iProbe < m_model->getLayout()->m_probed_neuron_list.size()) && (neuronLayoutIndex == m_model->getLayout()->m_probed_neuron_list[iProbe]));
+            // true if this is a probed neuron (the list holds the original indices in ascending order)
+            int neuronOriginalIndex = m_model->getLayout()->getOriginalIndex(neuronLayoutIndex);
+            iProbe = lower_bound(probedNeurons.begin(), probedNeurons.end(), neuronOriginalIndex) - probedNeurons.begin();
+            fProbe = ((iProbe < probedNeurons.size()) && (neuronOriginalIndex == probedNeurons[iProbe]));
 
-            uint64_t* pSpikes = pNeuronsProps->spike_history[iNeuron];
+            int history_size = pNeuronsProps->spikeHistorySize[iNeuron];
 
             int& spike_count = pNeuronsProps->spikeCount[iNeuron];
             int& offset = pNeuronsProps->spikeCountOffset[iNeuron];
@@ -259,15 +261,17 @@ void Hdf5Recorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo
                 // Therefore, single precision can only handle 2^23 = 8,388,608 simulation steps 
                 // or 8 epochs (1 epoch = 100s, 1 simulation step = 0.1ms).
 
-                if (idxSp >= max_spikes) idxSp = 0;
+                if (idxSp >= history_size) idxSp = 0;
+                uint64_t spikeStep = pNeuronsProps->getSpikeHistoryStep(iNeuron, idxSp);
+
                 // compile network wide burstiness index data in 1s bins
-                int idx1 = static_cast<int>( static_cast<double>( pSpikes[idxSp] ) *  m_sim_info->deltaT
+                int idx1 = static_cast<int>( static_cast<double>( spikeStep ) *  m_sim_info->deltaT
                     - ( (m_sim_info->currentStep - 1) * m_sim_info->epochDuration ) );
                 assert(idx1 >= 0 && idx1 < m_sim_info->epochDuration);
                 burstinessHist[idx1]++;
 
                 // compile network wide spike count in 10ms bins
-                int idx2 = static_cast<int>( static_cast<double>( pSpikes[idxSp] ) * m_sim_info->deltaT * 100
+                int idx2 = static_cast<int>( static_cast<double>( spikeStep ) * m_sim_info->deltaT * 100
                     - ( (m_sim_info->currentStep - 1) * m_sim_info->epochDuration * 100 ) );
                 assert(idx2 >= 0 && idx2 < m_sim_info->epochDuration * 100);
                 spikesHistory[idx2]++;
@@ -275,14 +279,10 @@ void Hdf5Recorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo
                 // compile spikes time of the probed neuron (append spikes time)
                 if (fProbe)
                 {
-                    spikesProbedNeurons[iProbe].insert(spikesProbedNeurons[iProbe].end(), pSpikes[idxSp]);
+                    spikesProbedNeurons[iProbe].insert(spikesProbedNeurons[iProbe].end(), spikeStep);
                 }
             }
 
-            if (fProbe)
-            {
-                iProbe++;
-            }
         }
 
         // clear spike count
@@ -402,7 +402,7 @@ void Hdf5Recorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &
         // create Neuron Types matrix
         VectorMatrix neuronTypes(MATRIX_TYPE, MATRIX_INIT, 1, m_sim_info->totalNeurons, EXC);
         for (int i = 0; i < m_sim_info->totalNeurons; i++) {
-            neuronTypes[i] = m_model->getLayout()->neuron_type_map[i];
+            neuronTypes[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->neuron_type_map[i];
         }
 
         // create neuron threshold matrix
@@ -414,7 +414,7 @@ void Hdf5Recorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &
             int neuronLayoutIndex = vtClrInfo[iCluster]->clusterNeuronsBegin;
             int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
             for (int iNeurons = 0; iNeurons < totalClusterNeurons; iNeurons++, neuronLayoutIndex++) {
-                neuronThresh[neuronLayoutIndex] = pNeuronsProps->Vthresh[iNeurons];
+                neuronThresh[m_model->getLayout()->getOriginalIndex(neuronLayoutIndex)] = pNeuronsProps->Vthresh[iNeurons];
             }
         }
 
@@ -423,8 +423,8 @@ void Hdf5Recorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &
         int* iYloc = new int[m_sim_info->totalNeurons];
         for (int i = 0; i < m_sim_info->totalNeurons; i++) {
             // convert VectorMatrix to int array
-            iXloc[i] = m_model->getLayout()->xloc[i];
-            iYloc[i] = m_model->getLayout()->yloc[i];
+            iXloc[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->xloc[i];
+            iYloc[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->yloc[i];
         }
         dataSetXloc->write(iXloc, PredType::NATIVE_INT);
         dataSetYloc->write(iYloc, PredType::NATIVE_INT);
@@ -527,9 +527,10 @@ void Hdf5Recorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &
  */
 void Hdf5Recorder::getStarterNeuronMatrix(VectorMatrix& matrix, const bool* starter_map, const SimulationInfo *sim_info)
 {
+    // the starter neurons by original index
     int cur = 0;
     for (int i = 0; i < sim_info->totalNeurons; i++) {
-        if (starter_map[i]) {
+        if (starter_map[m_model->getLayout()->getLayoutIndex(i)]) {
             matrix[cur] = i;
             cur++;
         }
@@ -32,6 +32,9 @@
 #include "SimulationInfo.h"
 #include "AllSpikingNeurons.h"
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class IRecorder
 {
 public:
@@ -79,6 +82,28 @@ public:
      * @param[in] vtClrInfo  Vecttor of pointer to the ClusterInfo object.
      **/
     virtual void saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo) = 0;
+
+    /**
+     * Add the histories compiled so far to a periodic checkpoint.
+     * By default, this method does nothing.
+     *
+     * @param[in] writer     The checkpoint writer.
+     */
+    virtual void checkpoint(CheckpointWriter &writer) {}
+
+    /**
+     * Restore the histories compiled so far from a periodic checkpoint
+     * (sim_info->currentStep must be the epoch of the checkpoint).
+     * By default, the recorder can't resume a simulation.
+     *
+     * @param[in] reader     The checkpoint reader.
+     * @return true if successful, false otherwise.
+     */
+    virtual bool restore(const CheckpointReader &reader)
+    {
+        cerr << "The recorder doesn't support resuming a simulation from a checkpoint" << endl;
+        return false;
+    }
 };
 
 #endif // _IRECORDER_H_
@@ -0,0 +1,69 @@
+#include "RecorderThread.h"
+
+/*
+ *  Constructor
+ */
+RecorderThread::RecorderThread() :
+    m_stop(false)
+{
+    m_thread = std::thread(&RecorderThread::run, this);
+}
+
+/*
+ *  Destructor
+ */
+RecorderThread::~RecorderThread()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+}
+
+/*
+ *  Wait for the previous job to complete, and run a job on the thread.
+ *
+ *  @param  job   The job.
+ */
+void RecorderThread::post(const std::function<void()> &job)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return !m_job; });
+    m_job = job;
+    lock.unlock();
+    m_cond.notify_all();
+}
+
+/*
+ *  Wait for the last job to complete.
+ */
+void RecorderThread::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return !m_job; });
+}
+
+/*
+ *  Main loop of the thread.
+ */
+void RecorderThread::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cond.wait(lock, [this] { return m_stop || m_job; });
+        if (!m_job) {
+            return;
+        }
+
+        // run the job without the lock, and clear it only when it completes
+        lock.unlock();
+        m_job();
+        lock.lock();
+        m_job = nullptr;
+        m_cond.notify_all();
+    }
+}
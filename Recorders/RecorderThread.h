@@ -0,0 +1,69 @@
+/**
+ *      @file RecorderThread.h
+ *
+ *      @brief A background thread that runs the write jobs of a recorder.
+ */
+
+/**
+ **
+ ** @class RecorderThread RecorderThread.h "RecorderThread.h"
+ **
+ ** \latexonly  \subsubsection*{Implementation} \endlatexonly
+ ** \htmlonly   <h3>Implementation</h3> \endhtmlonly
+ **
+ ** The RecorderThread class runs the jobs of a recorder (binning and writing
+ ** the histories of an epoch) on a background thread, one at a time, while
+ ** the clusters simulate the next epoch. A job is posted after the previous
+ ** one completes, so that the jobs run in order, and the recorder owns the
+ ** buffers of a job until wait() returns.
+ **/
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class RecorderThread
+{
+    public:
+        //! The constructor for RecorderThread.
+        RecorderThread();
+
+        //! The destructor for RecorderThread (waits for the last job).
+        ~RecorderThread();
+
+        /**
+         *  Wait for the previous job to complete, and run a job on the thread.
+         *
+         *  @param  job   The job.
+         */
+        void post(const std::function<void()> &job);
+
+        /**
+         *  Wait for the last job to complete.
+         */
+        void wait();
+
+    private:
+        /**
+         *  Main loop of the thread.
+         */
+        void run();
+
+        //! The thread.
+        std::thread m_thread;
+
+        //! Protects m_job and m_stop.
+        std::mutex m_mutex;
+
+        //! Signaled when a job is posted or completed.
+        std::condition_variable m_cond;
+
+        //! The job to run (empty if none).
+        std::function<void()> m_job;
+
+        //! True when the thread must exit.
+        bool m_stop;
+};
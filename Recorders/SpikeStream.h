@@ -0,0 +1,160 @@
+/**
+ *      @file SpikeStream.h
+ *
+ *      @brief Binary spike stream files (.bgspk) of the BinaryRecorder.
+ */
+
+/**
+ ** A spike stream file is made of a header followed by a sequence of columns,
+ ** which are appended as the simulation runs:
+ **
+ ** - The header (SpikeStreamHeader) holds the magic "BGSPK", the version of
+ **   the format and the parameters of the simulation needed to interpret
+ **   the columns (number of neurons and epochs, deltaT, epoch duration and
+ **   size of the floating point values).
+ ** - Each column starts with a SpikeStreamColumn, which gives its type, the
+ **   epoch it belongs to, the size and number of its elements and a base
+ **   value (e.g. the first simulation step of the epoch), followed by the
+ **   raw elements in the byte order of the machine.
+ **
+ ** At the end of each epoch, the recorder appends the spikes of the epoch,
+ ** as two columns of the same length (the neuron layout indexes, and the
+ ** steps relative to the first step of the epoch), and the spike counts of
+ ** the epoch in 1s and 10ms bins. The growth recorder also appends the rates
+ ** and radii of the epoch (epoch 0 holds the initial values). At the end of
+ ** the simulation, the recorder appends the layout and the end step.
+ **
+ ** The XmlGrowthRecorder uses the same format for its growth history file,
+ ** which only holds the rates and radii columns of the epochs.
+ **
+ ** A reader skips the columns it doesn't know. See Tools/SpikeStreamToXml.cpp.
+ **/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <ostream>
+
+//! Version of the spike stream file format.
+#define SPIKE_STREAM_VERSION 1
+
+//! Magic of the spike stream file ("BGSPK" followed by three zero bytes).
+#define SPIKE_STREAM_MAGIC "BGSPK\0\0"
+
+//! Types of the columns of the spike stream file.
+enum spikeStreamColumnType {
+    // epochs
+    SPK_SPIKE_NEURONS = 1,          //!< Neuron layout indexes of the spikes (uint32_t)
+    SPK_SPIKE_STEPS = 2,            //!< Steps of the spikes from base, the first step of the epoch (uint32_t)
+    SPK_BURSTINESS_BINS = 3,        //!< Spike counts in 1s bins, from bin base (uint32_t)
+    SPK_SPIKES_BINS = 4,            //!< Spike counts in 10ms bins, from bin base (uint32_t)
+    SPK_RATES = 5,                  //!< Firing rates of the neurons (BGFLOAT)
+    SPK_RADII = 6,                  //!< Radii of the neurons (BGFLOAT)
+
+    // end of the simulation
+    SPK_XLOC = 16,                  //!< Layout::xloc (BGFLOAT)
+    SPK_YLOC = 17,                  //!< Layout::yloc (BGFLOAT)
+    SPK_NEURON_TYPES = 18,          //!< Layout::neuron_type_map (int32_t)
+    SPK_STARTER_NEURONS = 19,       //!< Layout indexes of the endogenously active neurons (int32_t)
+    SPK_NEURON_THRESH = 20,         //!< Thresholds of the neurons (BGFLOAT)
+    SPK_END_STEP = 21               //!< No element, base is the last simulation step
+};
+
+//! Header of the spike stream file.
+struct SpikeStreamHeader
+{
+    //! SPIKE_STREAM_MAGIC.
+    char magic[8];
+
+    //! Version of the file format (SPIKE_STREAM_VERSION).
+    uint32_t version;
+
+    //! Size of the floating point values (sizeof(BGFLOAT)).
+    uint32_t floatSize;
+
+    //! Number of neurons.
+    uint32_t totalNeurons;
+
+    //! Number of epochs.
+    uint32_t maxSteps;
+
+    //! Simulation time step size.
+    double deltaT;
+
+    //! Duration of an epoch (in seconds).
+    double epochDuration;
+};
+
+//! Header of a column of the spike stream file.
+struct SpikeStreamColumn
+{
+    //! Type of the column (spikeStreamColumnType).
+    uint32_t type;
+
+    //! Epoch of the column (0 for the initial values, maxSteps for the end of the simulation).
+    uint32_t epoch;
+
+    //! Size of an element in bytes.
+    uint32_t elementSize;
+
+    //! Padding (0).
+    uint32_t reserved;
+
+    //! Base value of the column (first step or first bin).
+    uint64_t base;
+
+    //! Number of elements.
+    uint64_t count;
+};
+
+/**
+ *  Write the header of a spike stream file.
+ *
+ *  @param  out             The spike stream file.
+ *  @param  floatSize       Size of the floating point values.
+ *  @param  totalNeurons    Number of neurons.
+ *  @param  maxSteps        Number of epochs.
+ *  @param  deltaT          Simulation time step size.
+ *  @param  epochDuration   Duration of an epoch (in seconds).
+ */
+inline void writeSpikeStreamHeader(std::ostream &out, uint32_t floatSize, uint32_t totalNeurons, uint32_t maxSteps, double deltaT, double epochDuration)
+{
+    SpikeStreamHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SPIKE_STREAM_MAGIC, sizeof(header.magic));
+    header.version = SPIKE_STREAM_VERSION;
+    header.floatSize = floatSize;
+    header.totalNeurons = totalNeurons;
+    header.maxSteps = maxSteps;
+    header.deltaT = deltaT;
+    header.epochDuration = epochDuration;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+/**
+ *  Append a column to a spike stream file.
+ *
+ *  @param  out           The spike stream file.
+ *  @param  type          Type of the column (spikeStreamColumnType).
+ *  @param  epoch         Epoch of the column.
+ *  @param  data          The elements.
+ *  @param  elementSize   Size of an element in bytes.
+ *  @param  count         Number of elements.
+ *  @param  base          Base value of the column.
+ */
+inline void writeSpikeStreamColumn(std::ostream &out, spikeStreamColumnType type, uint32_t epoch, const void *data, uint32_t elementSize, uint64_t count, uint64_t base)
+{
+    SpikeStreamColumn column;
+    column.type = type;
+    column.epoch = epoch;
+    column.elementSize = elementSize;
+    column.reserved = 0;
+    column.base = base;
+    column.count = count;
+
+    out.write(reinterpret_cast<const char *>(&column), sizeof(column));
+    if (count > 0) {
+        out.write(static_cast<const char *>(data), elementSize * count);
+    }
+}
@@ -8,12 +8,13 @@
 #include "XmlGrowthRecorder.h"
 #include "AllIFNeurons.h"      // TODO: remove LIF model specific code
 #include "ConnGrowth.h"
+#include "Checkpoint.h"
 
 //! THe constructor and destructor
 XmlGrowthRecorder::XmlGrowthRecorder(const SimulationInfo* sim_info) :
         XmlRecorder(sim_info),
-        ratesHistory(MATRIX_TYPE, MATRIX_INIT, static_cast<int>(sim_info->maxSteps + 1), sim_info->totalNeurons),
-        radiiHistory(MATRIX_TYPE, MATRIX_INIT, static_cast<int>(sim_info->maxSteps + 1), sim_info->totalNeurons)
+        ratesEpoch(sim_info->totalNeurons, 0),
+        radiiEpoch(sim_info->totalNeurons, 0)
 {
 }
 
@@ -21,6 +22,182 @@ XmlGrowthRecorder::~XmlGrowthRecorder()
 {
 }
 
+/*
+ * Initialize data
+ * Create a new xml file, and the growth history file.
+ *
+ * @param[in] stateOutputFileName	File name to save histories
+ */
+void XmlGrowthRecorder::init(const string& stateOutputFileName)
+{
+    XmlRecorder::init(stateOutputFileName);
+
+    // results/out.xml -> results/out_growth.bggrw (not a spike stream file of the BinaryRecorder)
+    growthFileName = stateOutputFileName;
+    size_t ext = growthFileName.rfind(".xml");
+    if (ext != string::npos && ext + 4 == growthFileName.size()) {
+        growthFileName.erase(ext);
+    }
+    growthFileName += "_growth.bggrw";
+
+    openGrowthHistory();
+}
+
+/*
+ * Create the growth history file and write its header.
+ */
+void XmlGrowthRecorder::openGrowthHistory()
+{
+    if (growthOut.is_open()) {
+        growthOut.close();
+    }
+    growthOut.open(growthFileName.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!growthOut) {
+        cerr << "Failed creating the growth history file " << growthFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    writeSpikeStreamHeader(growthOut, sizeof(BGFLOAT), m_sim_info->totalNeurons, m_sim_info->maxSteps,
+                           m_sim_info->deltaT, m_sim_info->epochDuration);
+    growthOut.flush();
+    if (!growthOut) {
+        cerr << "Failed writing the growth history file " << growthFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Append the rates and radii of an epoch to the growth history file.
+ * The simulation stops if they cannot be written, since the file is
+ * the only copy of the histories.
+ *
+ * @param[in] epoch      Epoch of the rates and radii.
+ * @param[in] rates      Firing rates of the neurons.
+ * @param[in] radii      Radii of the neurons.
+ */
+void XmlGrowthRecorder::appendGrowthHistory(int epoch, const BGFLOAT *rates, const BGFLOAT *radii)
+{
+    int nNeurons = m_sim_info->totalNeurons;
+    writeSpikeStreamColumn(growthOut, SPK_RATES, epoch, rates, sizeof(BGFLOAT), nNeurons, 0);
+    writeSpikeStreamColumn(growthOut, SPK_RADII, epoch, radii, sizeof(BGFLOAT), nNeurons, 0);
+
+    // the epochs written so far can be read while the simulation runs
+    growthOut.flush();
+    if (!growthOut) {
+        cerr << "Failed writing the growth history file " << growthFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Read the rates or the radii of the epochs from the growth history file.
+ *
+ * @param[in] type       SPK_RATES or SPK_RADII.
+ * @param[in] row        Function called with the epoch and the values of each epoch, in the file order.
+ * @return true if successful, false otherwise.
+ */
+bool XmlGrowthRecorder::readGrowthHistory(spikeStreamColumnType type, const std::function<void(int, const vector<BGFLOAT>&)> &row)
+{
+    growthOut.flush();
+
+    ifstream in(growthFileName.c_str(), ios::in | ios::binary);
+    SpikeStreamHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+        cerr << "Failed reading the growth history file " << growthFileName << endl;
+        return false;
+    }
+
+    vector<BGFLOAT> values(m_sim_info->totalNeurons);
+    SpikeStreamColumn column;
+    while (in.read(reinterpret_cast<char *>(&column), sizeof(column))) {
+        if (column.type != static_cast<uint32_t>(type) || column.count != values.size()) {
+            in.seekg(column.elementSize * column.count, ios::cur);
+            continue;
+        }
+        if (!in.read(reinterpret_cast<char *>(values.data()), sizeof(BGFLOAT) * values.size())) {
+            cerr << "Failed reading the growth history file " << growthFileName << endl;
+            return false;
+        }
+        row(column.epoch, values);
+    }
+
+    return true;
+}
+
+/*
+ * Find the offsets of the rates or the radii of the epochs in the growth history file.
+ *
+ * @param[in] type       SPK_RATES or SPK_RADII.
+ * @param[in] offsets    Receives the offset of the values of each epoch
+ *                       (CHECKPOINT_NO_ROW for the epochs not in the file).
+ */
+void XmlGrowthRecorder::findGrowthHistory(spikeStreamColumnType type, vector<uint64_t> &offsets)
+{
+    growthOut.flush();
+    fill(offsets.begin(), offsets.end(), CHECKPOINT_NO_ROW);
+
+    // only the column headers are read, the values are skipped
+    ifstream in(growthFileName.c_str(), ios::in | ios::binary);
+    in.seekg(sizeof(SpikeStreamHeader));
+    SpikeStreamColumn column;
+    while (in.read(reinterpret_cast<char *>(&column), sizeof(column))) {
+        if (column.type == static_cast<uint32_t>(type) && column.count == static_cast<uint64_t>(m_sim_info->totalNeurons)
+                && column.epoch < offsets.size()) {
+            offsets[column.epoch] = static_cast<uint64_t>(in.tellg());
+        }
+        in.seekg(column.elementSize * column.count, ios::cur);
+    }
+}
+
+/*
+ * Write the rates or the radii of the epochs as a complete matrix element
+ * of the xml file (as CompleteMatrix::toXML()), from the growth history file.
+ * The epochs not in the file are written as zeros.
+ *
+ * @param[in] type       SPK_RATES or SPK_RADII.
+ * @param[in] name       Name of the matrix.
+ * @return true if successful, false if the growth history file cannot be read.
+ */
+bool XmlGrowthRecorder::writeGrowthHistory(spikeStreamColumnType type, const string &name)
+{
+    int nEpochs = m_sim_info->maxSteps + 1;
+    int nNeurons = m_sim_info->totalNeurons;
+
+    stateOut << "   <Matrix name=\"" << name << "\" type=\"complete\" rows=\"" << nEpochs
+             << "\" columns=\"" << nNeurons << "\" multiplier=\"1.0\">" << endl;
+    stateOut << "   ";
+
+    int nextEpoch = 0;
+    auto writeRow = [this, nNeurons](const BGFLOAT *values) {
+        for (int i = 0; i < nNeurons; i++)
+            stateOut << (values != NULL ? values[i] : static_cast<BGFLOAT>(0)) << " ";
+        stateOut << endl;
+    };
+    bool success = readGrowthHistory(type, [&](int epoch, const vector<BGFLOAT> &values) {
+        if (epoch < nextEpoch || epoch >= nEpochs)
+            return;
+        for (; nextEpoch < epoch; nextEpoch++)
+            writeRow(NULL);
+        writeRow(values.data());
+        nextEpoch++;
+    });
+    for (; nextEpoch < nEpochs; nextEpoch++)
+        writeRow(NULL);
+
+    stateOut << endl << "</Matrix>" << endl;
+
+    return success;
+}
+
+/*
+ * Terminate process
+ */
+void XmlGrowthRecorder::term()
+{
+    XmlRecorder::term();
+    growthOut.close();
+}
+
 /*
  * Init radii and rates history matrices with default values
  */
@@ -31,9 +208,11 @@ void XmlGrowthRecorder::initDefaultValues()
 
     for (int i = 0; i < m_sim_info->totalNeurons; i++)
     {
-        radiiHistory(0, i) = startRadius;
-        ratesHistory(0, i) = 0;
+        radiiEpoch[i] = startRadius;
+        ratesEpoch[i] = 0;
     }
+
+    appendGrowthHistory(0, ratesEpoch.data(), radiiEpoch.data());
 }
 
 /*
@@ -46,13 +225,15 @@ void XmlGrowthRecorder::initValues()
     for (int i = 0; i < m_sim_info->totalNeurons; i++)
     {
 #if defined(USE_GPU)
-        radiiHistory(0, i) = dynamic_cast<ConnGrowth*>(pConn)->radii[i];
-        ratesHistory(0, i) = dynamic_cast<ConnGrowth*>(pConn)->rates[i];
+        radiiEpoch[i] = dynamic_cast<ConnGrowth*>(pConn)->radii[i];
+        ratesEpoch[i] = dynamic_cast<ConnGrowth*>(pConn)->rates[i];
 #else // !USE_GPU
-        radiiHistory(0, i) = (*dynamic_cast<ConnGrowth*>(pConn)->radii)[i];
-        ratesHistory(0, i) = (*dynamic_cast<ConnGrowth*>(pConn)->rates)[i];
+        radiiEpoch[i] = (*dynamic_cast<ConnGrowth*>(pConn)->radii)[i];
+        ratesEpoch[i] = (*dynamic_cast<ConnGrowth*>(pConn)->rates)[i];
 #endif // !USE_GPU
     }
+
+    appendGrowthHistory(0, ratesEpoch.data(), radiiEpoch.data());
 }
 
 /*
@@ -62,14 +243,20 @@ void XmlGrowthRecorder::getValues()
 {
     Connections* pConn = m_model->getConnections();
 
+    int epoch = m_sim_info->currentStep;
+    if (!readGrowthHistory(SPK_RADII, [&](int e, const vector<BGFLOAT> &values) { if (e == epoch) radiiEpoch = values; })
+            || !readGrowthHistory(SPK_RATES, [&](int e, const vector<BGFLOAT> &values) { if (e == epoch) ratesEpoch = values; })) {
+        exit(EXIT_FAILURE);
+    }
+
     for (int i = 0; i < m_sim_info->totalNeurons; i++)
     {
 #if defined(USE_GPU)
-        dynamic_cast<ConnGrowth*>(pConn)->radii[i] = radiiHistory(m_sim_info->currentStep, i);
-        dynamic_cast<ConnGrowth*>(pConn)->rates[i] = ratesHistory(m_sim_info->currentStep, i);
+        dynamic_cast<ConnGrowth*>(pConn)->radii[i] = radiiEpoch[i];
+        dynamic_cast<ConnGrowth*>(pConn)->rates[i] = ratesEpoch[i];
 #else // !USE_GPU
-        (*dynamic_cast<ConnGrowth*>(pConn)->radii)[i] = radiiHistory(m_sim_info->currentStep, i);
-        (*dynamic_cast<ConnGrowth*>(pConn)->rates)[i] = ratesHistory(m_sim_info->currentStep, i);
+        (*dynamic_cast<ConnGrowth*>(pConn)->radii)[i] = radiiEpoch[i];
+        (*dynamic_cast<ConnGrowth*>(pConn)->rates)[i] = ratesEpoch[i];
 #endif // !USE_GPU
     }
 }
@@ -97,19 +284,24 @@ void XmlGrowthRecorder::compileHistories(vector<Cluster *> &vtClr, vector<Cluste
 
     for (int neuronLayoutIndex = 0; neuronLayoutIndex < m_sim_info->totalNeurons; neuronLayoutIndex++)
     {
-        // record firing rate to history matrix
-        ratesHistory(m_sim_info->currentStep, neuronLayoutIndex) = rates[neuronLayoutIndex];
+        int neuronOriginalIndex = m_model->getLayout()->getOriginalIndex(neuronLayoutIndex);
+
+        // record firing rate
+        ratesEpoch[neuronOriginalIndex] = rates[neuronLayoutIndex];
 
-        // Cap minimum radius size and record radii to history matrix
+        // Cap minimum radius size and record radii
         // TODO: find out why we cap this here.
         if (radii[neuronLayoutIndex] < minRadius)
             radii[neuronLayoutIndex] = minRadius;
 
-        // record radius to history matrix
-        radiiHistory(m_sim_info->currentStep, neuronLayoutIndex) = radii[neuronLayoutIndex];
+        // record radius
+        radiiEpoch[neuronOriginalIndex] = radii[neuronLayoutIndex];
 
         DEBUG_MID(cout << "radii[" << neuronLayoutIndex << ":" << radii[neuronLayoutIndex] << "]" << endl;)
     }
+
+    // append them to the growth history file
+    appendGrowthHistory(m_sim_info->currentStep, ratesEpoch.data(), radiiEpoch.data());
 }
 
 /*
@@ -123,7 +315,7 @@ void XmlGrowthRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo
     // create Neuron Types matrix
     VectorMatrix neuronTypes(MATRIX_TYPE, MATRIX_INIT, 1, m_sim_info->totalNeurons, EXC);
     for (int i = 0; i < m_sim_info->totalNeurons; i++) {
-        neuronTypes[i] = m_model->getLayout()->neuron_type_map[i];
+        neuronTypes[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->neuron_type_map[i];
     }
 
     // create neuron threshold matrix
@@ -135,7 +327,7 @@ void XmlGrowthRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo
         int neuronLayoutIndex = vtClrInfo[iCluster]->clusterNeuronsBegin;
         int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
         for (int iNeurons = 0; iNeurons < totalClusterNeurons; iNeurons++, neuronLayoutIndex++) {
-            neuronThresh[neuronLayoutIndex] = pNeuronsProps->Vthresh[iNeurons];
+            neuronThresh[m_model->getLayout()->getOriginalIndex(neuronLayoutIndex)] = pNeuronsProps->Vthresh[iNeurons];
         }
     }
 
@@ -147,13 +339,15 @@ void XmlGrowthRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo
     VectorMatrix* xloc = new VectorMatrix(MATRIX_TYPE, MATRIX_INIT, 1, m_sim_info->totalNeurons);
     VectorMatrix* yloc = new VectorMatrix(MATRIX_TYPE, MATRIX_INIT, 1, m_sim_info->totalNeurons);
     for (int i = 0; i < m_sim_info->totalNeurons; i++) {
-        (*xloc)[i] = m_model->getLayout()->xloc[i];    
-        (*yloc)[i] = m_model->getLayout()->yloc[i];    
+        (*xloc)[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->xloc[i];    
+        (*yloc)[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->yloc[i];    
     }
 
     stateOut << "<SimState>\n";
-    stateOut << "   " << radiiHistory.toXML("radiiHistory") << endl;
-    stateOut << "   " << ratesHistory.toXML("ratesHistory") << endl;
+    if (!writeGrowthHistory(SPK_RADII, "radiiHistory") || !writeGrowthHistory(SPK_RATES, "ratesHistory")) {
+        cerr << "Failed saving the radii and rates histories in " << m_sim_info->stateOutputFileName << endl;
+        exit(EXIT_FAILURE);
+    }
     stateOut << "   " << burstinessHist.toXML("burstinessHist") << endl;
     stateOut << "   " << spikesHistory.toXML("spikesHistory") << endl;
     stateOut << "   " << xloc->toXML("xloc") << endl;
@@ -187,3 +381,51 @@ void XmlGrowthRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo
     stateOut << "</SimState>" << endl;
 }
 
+/*
+ * Add the histories compiled so far to a periodic checkpoint
+ * (the radii and rates of the epochs 0 to sim_info->currentStep).
+ * They are copied from the growth history file when the checkpoint
+ * is written, rather than read in memory.
+ *
+ * @param[in] writer     The checkpoint writer.
+ */
+void XmlGrowthRecorder::checkpoint(CheckpointWriter &writer)
+{
+    XmlRecorder::checkpoint(writer);
+
+    vector<uint64_t> offsets(m_sim_info->currentStep + 1);
+    findGrowthHistory(SPK_RATES, offsets);
+    writer.addFileSection(CKPT_RATES_HISTORY, 0, growthFileName, offsets, sizeof(BGFLOAT), m_sim_info->totalNeurons);
+    findGrowthHistory(SPK_RADII, offsets);
+    writer.addFileSection(CKPT_RADII_HISTORY, 0, growthFileName, offsets, sizeof(BGFLOAT), m_sim_info->totalNeurons);
+}
+
+/*
+ * Restore the histories compiled so far from a periodic checkpoint
+ * (sim_info->currentStep must be the epoch of the checkpoint).
+ *
+ * @param[in] reader     The checkpoint reader.
+ * @return true if successful, false otherwise.
+ */
+bool XmlGrowthRecorder::restore(const CheckpointReader &reader)
+{
+    int nEpochs = m_sim_info->currentStep + 1;
+    int nNeurons = m_sim_info->totalNeurons;
+
+    if (!XmlRecorder::restore(reader)) {
+        return false;
+    }
+    const BGFLOAT *rates = static_cast<const BGFLOAT *>(reader.getSection(CKPT_RATES_HISTORY, 0, sizeof(BGFLOAT), nEpochs, nNeurons));
+    const BGFLOAT *radii = static_cast<const BGFLOAT *>(reader.getSection(CKPT_RADII_HISTORY, 0, sizeof(BGFLOAT), nEpochs, nNeurons));
+    if (rates == NULL || radii == NULL) {
+        return false;
+    }
+
+    // rewrite the growth history file up to the epoch of the checkpoint, from the mapped checkpoint
+    openGrowthHistory();
+    for (int epoch = 0; epoch < nEpochs; epoch++) {
+        appendGrowthHistory(epoch, rates + static_cast<size_t>(epoch) * nNeurons, radii + static_cast<size_t>(epoch) * nNeurons);
+    }
+
+    return true;
+}
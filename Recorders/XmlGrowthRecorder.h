@@ -19,6 +19,13 @@
  **     -# network wide spike count in 10ms bins,
  **     -# individual neuron's radius history of every epoch.
  **
+ ** The rates and radii of an epoch are not kept in memory: they are appended
+ ** to a growth history file (the state output file name with "_growth.bggrw"
+ ** instead of ".xml", in the format of SpikeStream.h, but without spike
+ ** columns) at the end of the epoch, so that they can be read while the
+ ** simulation runs, and are copied from it into the xml file at the end of
+ ** the simulation.
+ **
  ** \latexonly  \subsubsection*{Credits} \endlatexonly
  ** \htmlonly   <h3>Credits</h3> \endhtmlonly
  **
@@ -33,7 +40,9 @@
 
 #include "XmlRecorder.h"
 #include "Model.h"
+#include "SpikeStream.h"
 #include <fstream>
+#include <functional>
 
 class XmlGrowthRecorder : public XmlRecorder
 {
@@ -42,6 +51,13 @@ public:
     XmlGrowthRecorder(const SimulationInfo* sim_info);
     ~XmlGrowthRecorder();
 
+    /**
+     * Initialize data
+     *
+     * @param[in] stateOutputFileName       File name to save histories
+     */
+    virtual void init(const string& stateOutputFileName);
+
     /**
      * Init radii and rates history matrices with default values
      */
@@ -57,6 +73,11 @@ public:
      */
     virtual void getValues();
 
+    /**
+     * Terminate process
+     */
+    virtual void term();
+
     /**
      * Compile history information in every epoch
      *
@@ -73,11 +94,75 @@ public:
      **/
     virtual void saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
 
+    /**
+     * Add the histories compiled so far to a periodic checkpoint.
+     *
+     * @param[in] writer     The checkpoint writer.
+     */
+    virtual void checkpoint(CheckpointWriter &writer);
+
+    /**
+     * Restore the histories compiled so far from a periodic checkpoint
+     * (sim_info->currentStep must be the epoch of the checkpoint).
+     *
+     * @param[in] reader     The checkpoint reader.
+     * @return true if successful, false otherwise.
+     */
+    virtual bool restore(const CheckpointReader &reader);
+
 private:
-    // track firing rate
-    CompleteMatrix ratesHistory;
+    /**
+     * Create the growth history file and write its header.
+     */
+    void openGrowthHistory();
 
-    // track radii
-    CompleteMatrix radiiHistory;
-};
+    /**
+     * Append the rates and radii of an epoch to the growth history file.
+     * The simulation stops if they cannot be written.
+     *
+     * @param[in] epoch      Epoch of the rates and radii.
+     * @param[in] rates      Firing rates of the neurons.
+     * @param[in] radii      Radii of the neurons.
+     */
+    void appendGrowthHistory(int epoch, const BGFLOAT *rates, const BGFLOAT *radii);
+
+    /**
+     * Read the rates or the radii of the epochs from the growth history file.
+     *
+     * @param[in] type       SPK_RATES or SPK_RADII.
+     * @param[in] row        Function called with the epoch and the values of each epoch, in the file order.
+     * @return true if successful, false otherwise.
+     */
+    bool readGrowthHistory(spikeStreamColumnType type, const std::function<void(int, const vector<BGFLOAT>&)> &row);
 
+    /**
+     * Find the offsets of the rates or the radii of the epochs in the growth history file.
+     *
+     * @param[in] type       SPK_RATES or SPK_RADII.
+     * @param[in] offsets    Receives the offset of the values of each epoch
+     *                       (CHECKPOINT_NO_ROW for the epochs not in the file).
+     */
+    void findGrowthHistory(spikeStreamColumnType type, vector<uint64_t> &offsets);
+
+    /**
+     * Write the rates or the radii of the epochs as a complete matrix element
+     * of the xml file (as CompleteMatrix::toXML()), from the growth history file.
+     *
+     * @param[in] type       SPK_RATES or SPK_RADII.
+     * @param[in] name       Name of the matrix.
+     * @return true if successful, false if the growth history file cannot be read.
+     */
+    bool writeGrowthHistory(spikeStreamColumnType type, const string &name);
+
+    // name of the growth history file
+    string growthFileName;
+
+    // the growth history file
+    ofstream growthOut;
+
+    // firing rates of the epoch
+    vector<BGFLOAT> ratesEpoch;
+
+    // radii of the epoch
+    vector<BGFLOAT> radiiEpoch;
+};
@@ -8,6 +8,7 @@
 #include "XmlRecorder.h"
 #include "AllIFNeurons.h"      // TODO: remove LIF model specific code
 #include "ConnGrowth.h"
+#include "Checkpoint.h"
 
 //! THe constructor and destructor
 XmlRecorder::XmlRecorder(const SimulationInfo* sim_info) :
@@ -71,8 +72,6 @@ void XmlRecorder::term()
  */
 void XmlRecorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo)
 {
-    int max_spikes = (int) ((m_sim_info->epochDuration * m_sim_info->maxFiringRate));
-
     for (CLUSTER_INDEX_TYPE iCluster = 0; iCluster < vtClr.size(); iCluster++)
     { 
         AllSpikingNeurons *neurons = dynamic_cast<AllSpikingNeurons*>(vtClr[iCluster]->m_neurons);
@@ -83,7 +82,7 @@ void XmlRecorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo
         int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
         for (int iNeuron = 0; iNeuron < totalClusterNeurons; iNeuron++, neuronLayoutIndex++)
         {
-            uint64_t* pSpikes = pNeuronsProps->spike_history[iNeuron];
+            int history_size = pNeuronsProps->spikeHistorySize[iNeuron];
 
             int& spike_count = pNeuronsProps->spikeCount[iNeuron];
             int& offset = pNeuronsProps->spikeCountOffset[iNeuron];
@@ -95,13 +94,15 @@ void XmlRecorder::compileHistories(vector<Cluster *> &vtClr, vector<ClusterInfo
                 // Therefore, single precision can only handle 2^23 = 8,388,608 simulation steps 
                 // or 8 epochs (1 epoch = 100s, 1 simulation step = 0.1ms).
 
-                if (idxSp >= max_spikes) idxSp = 0;
+                if (idxSp >= history_size) idxSp = 0;
+                uint64_t spikeStep = pNeuronsProps->getSpikeHistoryStep(iNeuron, idxSp);
+
                 // compile network wide burstiness index data in 1s bins
-                int idx1 = static_cast<int>( static_cast<double>( pSpikes[idxSp] ) * m_sim_info->deltaT );
+                int idx1 = static_cast<int>( static_cast<double>( spikeStep ) * m_sim_info->deltaT );
                 burstinessHist[idx1] = burstinessHist[idx1] + 1.0;
 
                 // compile network wide spike count in 10ms bins
-                int idx2 = static_cast<int>( static_cast<double>( pSpikes[idxSp] ) * m_sim_info->deltaT * 100 );
+                int idx2 = static_cast<int>( static_cast<double>( spikeStep ) * m_sim_info->deltaT * 100 );
                 spikesHistory[idx2] = spikesHistory[idx2] + 1.0;
             }
         }
@@ -121,7 +122,7 @@ void XmlRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &v
     // create Neuron Types matrix
     VectorMatrix neuronTypes(MATRIX_TYPE, MATRIX_INIT, 1, m_sim_info->totalNeurons, EXC);
     for (int i = 0; i < m_sim_info->totalNeurons; i++) {
-        neuronTypes[i] = m_model->getLayout()->neuron_type_map[i];
+        neuronTypes[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->neuron_type_map[i];
     }
 
     // create neuron threshold matrix
@@ -133,7 +134,7 @@ void XmlRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &v
         int neuronLayoutIndex = vtClrInfo[iCluster]->clusterNeuronsBegin;
         int totalClusterNeurons = vtClrInfo[iCluster]->totalClusterNeurons;
         for (int iNeurons = 0; iNeurons < totalClusterNeurons; iNeurons++, neuronLayoutIndex++) {
-            neuronThresh[neuronLayoutIndex] = pNeuronsProps->Vthresh[iNeurons];
+            neuronThresh[m_model->getLayout()->getOriginalIndex(neuronLayoutIndex)] = pNeuronsProps->Vthresh[iNeurons];
         }
     }
 
@@ -145,8 +146,8 @@ void XmlRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &v
     VectorMatrix* xloc = new VectorMatrix(MATRIX_TYPE, MATRIX_INIT, 1, m_sim_info->totalNeurons);
     VectorMatrix* yloc = new VectorMatrix(MATRIX_TYPE, MATRIX_INIT, 1, m_sim_info->totalNeurons);
     for (int i = 0; i < m_sim_info->totalNeurons; i++) {
-        (*xloc)[i] = m_model->getLayout()->xloc[i];
-        (*yloc)[i] = m_model->getLayout()->yloc[i];
+        (*xloc)[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->xloc[i];
+        (*yloc)[m_model->getLayout()->getOriginalIndex(i)] = m_model->getLayout()->yloc[i];
     }
 
     stateOut << "<SimState>\n";
@@ -192,11 +193,51 @@ void XmlRecorder::saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &v
  */
 void XmlRecorder::getStarterNeuronMatrix(VectorMatrix& matrix, const bool* starter_map, const SimulationInfo *sim_info)
 {
+    // the starter neurons by original index
     int cur = 0;
     for (int i = 0; i < sim_info->totalNeurons; i++) {
-        if (starter_map[i]) {
+        if (starter_map[m_model->getLayout()->getLayoutIndex(i)]) {
             matrix[cur] = i;
             cur++;
         }
     }
 }
+
+/*
+ * Get the number of bins of a history that the epochs simulated so far
+ * may have filled (with one more bin for the rounding of the spike times).
+ *
+ * @param[in] history        The history.
+ * @param[in] binsPerSecond  Number of bins per second of the history.
+ * @return the number of bins.
+ */
+int XmlRecorder::getCompiledLength(const VectorMatrix& history, int binsPerSecond) const
+{
+    int length = static_cast<int>(m_sim_info->epochDuration * m_sim_info->currentStep * binsPerSecond) + 1;
+
+    return min(length, history.Size());
+}
+
+/*
+ * Add the histories compiled so far to a periodic checkpoint.
+ *
+ * @param[in] writer     The checkpoint writer.
+ */
+void XmlRecorder::checkpoint(CheckpointWriter &writer)
+{
+    writer.addArray(CKPT_BURSTINESS_HIST, 0, &burstinessHist[0], getCompiledLength(burstinessHist, 1));
+    writer.addArray(CKPT_SPIKES_HISTORY, 0, &spikesHistory[0], getCompiledLength(spikesHistory, 100));
+}
+
+/*
+ * Restore the histories compiled so far from a periodic checkpoint
+ * (sim_info->currentStep must be the epoch of the checkpoint).
+ *
+ * @param[in] reader     The checkpoint reader.
+ * @return true if successful, false otherwise.
+ */
+bool XmlRecorder::restore(const CheckpointReader &reader)
+{
+    return reader.restoreArray(CKPT_BURSTINESS_HIST, 0, &burstinessHist[0], getCompiledLength(burstinessHist, 1))
+        && reader.restoreArray(CKPT_SPIKES_HISTORY, 0, &spikesHistory[0], getCompiledLength(spikesHistory, 100));
+}
@@ -83,9 +83,35 @@ public:
      **/
     virtual void saveSimData(vector<Cluster *> &vtClr, vector<ClusterInfo *> &vtClrInfo);
 
+    /**
+     * Add the histories compiled so far to a periodic checkpoint.
+     *
+     * @param[in] writer     The checkpoint writer.
+     */
+    virtual void checkpoint(CheckpointWriter &writer);
+
+    /**
+     * Restore the histories compiled so far from a periodic checkpoint
+     * (sim_info->currentStep must be the epoch of the checkpoint).
+     *
+     * @param[in] reader     The checkpoint reader.
+     * @return true if successful, false otherwise.
+     */
+    virtual bool restore(const CheckpointReader &reader);
+
 protected:
     void getStarterNeuronMatrix(VectorMatrix& matrix, const bool* starter_map, const SimulationInfo *sim_info);
 
+    /**
+     * Get the number of bins of a history that the epochs simulated so far
+     * may have filled.
+     *
+     * @param[in] history        The history.
+     * @param[in] binsPerSecond  Number of bins per second of the history.
+     * @return the number of bins.
+     */
+    int getCompiledLength(const VectorMatrix& history, int binsPerSecond) const;
+
     // a file stream for xml output
     ofstream stateOut;
 
@@ -1,4 +1,5 @@
 #include "AllDSSynapsesProps.h"
+#include "Checkpoint.h"
 #if defined(USE_GPU)
 #include <helper_cuda.h>
 #endif
@@ -34,12 +35,12 @@ void AllDSSynapsesProps::setupSynapsesProps(const int num_neurons, const int max
     BGSIZE max_total_synapses = maxSynapsesPerNeuron * count_neurons;
 
     if (max_total_synapses != 0) {
-        lastSpike = new uint64_t[max_total_synapses];
-        r = new BGFLOAT[max_total_synapses];
-        u = new BGFLOAT[max_total_synapses];
-        D = new BGFLOAT[max_total_synapses];
-        U = new BGFLOAT[max_total_synapses];
-        F = new BGFLOAT[max_total_synapses];
+        lastSpike = new uint64_t[max_total_synapses]();
+        r = new BGFLOAT[max_total_synapses]();
+        u = new BGFLOAT[max_total_synapses]();
+        D = new BGFLOAT[max_total_synapses]();
+        U = new BGFLOAT[max_total_synapses]();
+        F = new BGFLOAT[max_total_synapses]();
     }
 }
 
@@ -467,3 +468,40 @@ void AllDSSynapsesProps::printGPUSynapsesProps( void* allSynapsesDeviceProps ) c
 }
 #endif // USE_GPU
 
+#if !defined(USE_GPU)
+/*
+ *  Add the complete state of the synapses to a periodic checkpoint.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ */
+void AllDSSynapsesProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    AllSpikingSynapsesProps::checkpointState(writer, iCluster);
+
+    writer.addArray(CKPT_SYNAPSE_LAST_SPIKE, iCluster, lastSpike, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_R, iCluster, r, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_U, iCluster, u, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_D, iCluster, D, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_USE, iCluster, U, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_F, iCluster, F, count_neurons, maxSynapsesPerNeuron);
+}
+
+/*
+ *  Restore the complete state of the synapses from a periodic checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllDSSynapsesProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    return AllSpikingSynapsesProps::restoreState(reader, iCluster)
+        && reader.restoreArray(CKPT_SYNAPSE_LAST_SPIKE, iCluster, lastSpike, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_R, iCluster, r, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_U, iCluster, u, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_D, iCluster, D, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_USE, iCluster, U, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_F, iCluster, F, count_neurons, maxSynapsesPerNeuron);
+}
+#endif // !USE_GPU
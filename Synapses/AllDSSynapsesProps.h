@@ -127,6 +127,25 @@ class AllDSSynapsesProps : public AllSpikingSynapsesProps
          */
         virtual void writeSynapseProps(ostream& output, const BGSIZE iSyn) const;
 
+#if !defined(USE_GPU)
+        /**
+         *  Add the complete state of the synapses to a periodic checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         */
+        virtual void checkpointState(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore the complete state of the synapses from a periodic checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader, int iCluster);
+#endif // !USE_GPU
+
     private:
         /**
          *  Cleanup the class.
@@ -1,4 +1,5 @@
 #include "AllDynamicSTDPSynapsesProps.h"
+#include "Checkpoint.h"
 #if defined(USE_GPU)
 #include <helper_cuda.h>
 #endif
@@ -34,12 +35,12 @@ void AllDynamicSTDPSynapsesProps::setupSynapsesProps(const int num_neurons, cons
     BGSIZE max_total_synapses = maxSynapsesPerNeuron * count_neurons;
 
     if (max_total_synapses != 0) {
-        lastSpike = new uint64_t[max_total_synapses];
-        r = new BGFLOAT[max_total_synapses];
-        u = new BGFLOAT[max_total_synapses];
-        D = new BGFLOAT[max_total_synapses];
-        U = new BGFLOAT[max_total_synapses];
-        F = new BGFLOAT[max_total_synapses];
+        lastSpike = new uint64_t[max_total_synapses]();
+        r = new BGFLOAT[max_total_synapses]();
+        u = new BGFLOAT[max_total_synapses]();
+        D = new BGFLOAT[max_total_synapses]();
+        U = new BGFLOAT[max_total_synapses]();
+        F = new BGFLOAT[max_total_synapses]();
     }
 }
 
@@ -525,3 +526,41 @@ void AllDynamicSTDPSynapsesProps::printGPUSynapsesProps( void* allSynapsesDevice
     }
 }
 #endif // USE_GPU
+
+#if !defined(USE_GPU)
+/*
+ *  Add the complete state of the synapses to a periodic checkpoint.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ */
+void AllDynamicSTDPSynapsesProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    AllSTDPSynapsesProps::checkpointState(writer, iCluster);
+
+    writer.addArray(CKPT_SYNAPSE_LAST_SPIKE, iCluster, lastSpike, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_R, iCluster, r, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_U, iCluster, u, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_D, iCluster, D, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_USE, iCluster, U, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_F, iCluster, F, count_neurons, maxSynapsesPerNeuron);
+}
+
+/*
+ *  Restore the complete state of the synapses from a periodic checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllDynamicSTDPSynapsesProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    return AllSTDPSynapsesProps::restoreState(reader, iCluster)
+        && reader.restoreArray(CKPT_SYNAPSE_LAST_SPIKE, iCluster, lastSpike, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_R, iCluster, r, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_U, iCluster, u, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_D, iCluster, D, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_USE, iCluster, U, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_F, iCluster, F, count_neurons, maxSynapsesPerNeuron);
+}
+#endif // !USE_GPU
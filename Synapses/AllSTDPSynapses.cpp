@@ -360,4 +360,17 @@ CUDA_CALLABLE bool AllSTDPSynapses::allowBackPropagation()
     return true;
 }
 
+#if !defined(USE_GPU)
+/*
+ *  Check if the synapse class changes the synapse weights by itself
+ *  (e.g. by a learning rule) during the simulation.
+ *
+ *  @return true if the synapse weights are plastic.
+ */
+bool AllSTDPSynapses::isWeightPlastic() const
+{
+    return true;
+}
+#endif // !USE_GPU
+
 
@@ -115,7 +115,17 @@ class AllSTDPSynapses : public AllSpikingSynapses
          */
         virtual void createAllSynapsesInDevice(IAllSynapses** pAllSynapses_d, IAllSynapsesProps *pAllSynapsesProps_d);
 
-#endif // USE_GPU
+#else // !defined(USE_GPU)
+    public:
+        /**
+         *  Check if the synapse class changes the synapse weights by itself
+         *  (e.g. by a learning rule) during the simulation.
+         *
+         *  @return true if the synapse weights are plastic.
+         */
+        virtual bool isWeightPlastic() const;
+
+#endif // !defined(USE_GPU)
 
     public:
         /*
@@ -1,4 +1,5 @@
 #include "AllSTDPSynapsesProps.h"
+#include "Checkpoint.h"
 #include "EventQueue.h"
 #if defined(USE_GPU)
 #include <helper_cuda.h>
@@ -42,18 +43,18 @@ void AllSTDPSynapsesProps::setupSynapsesProps(const int num_neurons, const int m
     BGSIZE max_total_synapses = maxSynapsesPerNeuron * count_neurons;
 
     if (max_total_synapses != 0) {
-        total_delayPost = new int[max_total_synapses];
-        tauspost = new BGFLOAT[max_total_synapses];
-        tauspre = new BGFLOAT[max_total_synapses];
-        taupos = new BGFLOAT[max_total_synapses];
-        tauneg = new BGFLOAT[max_total_synapses];
-        STDPgap = new BGFLOAT[max_total_synapses];
-        Wex = new BGFLOAT[max_total_synapses];
-        Aneg = new BGFLOAT[max_total_synapses];
-        Apos = new BGFLOAT[max_total_synapses];
-        mupos = new BGFLOAT[max_total_synapses];
-        muneg = new BGFLOAT[max_total_synapses];
-        useFroemkeDanSTDP = new bool[max_total_synapses];
+        total_delayPost = new int[max_total_synapses]();
+        tauspost = new BGFLOAT[max_total_synapses]();
+        tauspre = new BGFLOAT[max_total_synapses]();
+        taupos = new BGFLOAT[max_total_synapses]();
+        tauneg = new BGFLOAT[max_total_synapses]();
+        STDPgap = new BGFLOAT[max_total_synapses]();
+        Wex = new BGFLOAT[max_total_synapses]();
+        Aneg = new BGFLOAT[max_total_synapses]();
+        Apos = new BGFLOAT[max_total_synapses]();
+        mupos = new BGFLOAT[max_total_synapses]();
+        muneg = new BGFLOAT[max_total_synapses]();
+        useFroemkeDanSTDP = new bool[max_total_synapses]();
 
         // create a post synapse spike queue & initialize it
         postSpikeQueue = new EventQueue();
@@ -63,6 +64,11 @@ void AllSTDPSynapsesProps::setupSynapsesProps(const int num_neurons, const int m
 #else // USE_GPU
         // initializes the post synapse spike queue
         postSpikeQueue->initEventQueue(clr_info->clusterID, max_total_synapses);
+
+        // the spikes are added with their delay
+        if (timingWheelQueue) {
+            postSpikeQueue->enableTimingWheel(NULL);
+        }
 #endif // USE_GPU
     }
 }
@@ -598,3 +604,60 @@ void AllSTDPSynapsesProps::printGPUSynapsesProps( void* allSynapsesDeviceProps )
 
 }
 #endif // USE_GPU
+
+#if !defined(USE_GPU)
+/*
+ *  Add the complete state of the synapses to a periodic checkpoint.
+ *  The post spike queue is written in CHECKPOINT_QUEUE_SECTIONS sections
+ *  from CKPT_POST_SPIKE_QUEUE.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ */
+void AllSTDPSynapsesProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    AllSpikingSynapsesProps::checkpointState(writer, iCluster);
+
+    writer.addArray(CKPT_STDP_TOTAL_DELAY_POST, iCluster, total_delayPost, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_TAUSPOST, iCluster, tauspost, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_TAUSPRE, iCluster, tauspre, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_TAUPOS, iCluster, taupos, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_TAUNEG, iCluster, tauneg, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_GAP, iCluster, STDPgap, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_WEX, iCluster, Wex, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_ANEG, iCluster, Aneg, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_APOS, iCluster, Apos, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_MUPOS, iCluster, mupos, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_MUNEG, iCluster, muneg, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_STDP_FROEMKE_DAN, iCluster, useFroemkeDanSTDP, count_neurons, maxSynapsesPerNeuron);
+
+    if (postSpikeQueue != NULL) {
+        postSpikeQueue->checkpoint(writer, CKPT_POST_SPIKE_QUEUE, iCluster);
+    }
+}
+
+/*
+ *  Restore the complete state of the synapses from a periodic checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllSTDPSynapsesProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    return AllSpikingSynapsesProps::restoreState(reader, iCluster)
+        && reader.restoreArray(CKPT_STDP_TOTAL_DELAY_POST, iCluster, total_delayPost, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_TAUSPOST, iCluster, tauspost, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_TAUSPRE, iCluster, tauspre, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_TAUPOS, iCluster, taupos, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_TAUNEG, iCluster, tauneg, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_GAP, iCluster, STDPgap, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_WEX, iCluster, Wex, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_ANEG, iCluster, Aneg, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_APOS, iCluster, Apos, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_MUPOS, iCluster, mupos, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_MUNEG, iCluster, muneg, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_STDP_FROEMKE_DAN, iCluster, useFroemkeDanSTDP, count_neurons, maxSynapsesPerNeuron)
+        && (postSpikeQueue == NULL || postSpikeQueue->restore(reader, CKPT_POST_SPIKE_QUEUE, iCluster));
+}
+#endif // !USE_GPU
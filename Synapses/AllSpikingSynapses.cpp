@@ -1,11 +1,18 @@
 #include "AllSpikingSynapses.h"
+#include "Checkpoint.h"
+#include <algorithm>
 #if defined(USE_GPU)
 #include <helper_cuda.h>
+#else // USE_GPU
+#include "AxonalSpikeRings.h"
 #endif // USE_GPU
 
 // Default constructor
 CUDA_CALLABLE AllSpikingSynapses::AllSpikingSynapses() 
 {
+#if !defined(USE_GPU)
+    m_nextActiveStep = 0;
+#endif // !USE_GPU
 }
 
 CUDA_CALLABLE AllSpikingSynapses::~AllSpikingSynapses()
@@ -81,12 +88,55 @@ CUDA_CALLABLE void AllSpikingSynapses::createSynapse(const BGSIZE iSyn, int sour
     }
 
     pSynapsesProps->tau[iSyn] = tau;
-    pSynapsesProps->total_delay[iSyn] = static_cast<int>( delay / deltaT ) + 1;
-
+    pSynapsesProps->total_delay[iSyn] = static_cast<int>( ( delay + pSynapsesProps->axonalDelay ) / deltaT ) + 1;
+
+#if !defined(USE_GPU)
+    // a neuron fires up to minSynapticTransDelay - 1 steps ahead of the synapses of the other
+    // clusters, so a shorter delay would put its spikes in steps these synapses have passed,
+    // and without the timing wheel the bitmask of the queue must hold the delay plus that offset
+    int minSynapticTransDelay = pSynapsesProps->minSynapticTransDelay;
+    if (pSynapsesProps->total_delay[iSyn] < minSynapticTransDelay) {
+        cerr << "The transmission delay of the synapses (" << pSynapsesProps->total_delay[iSyn]
+            << " steps) is shorter than minSynapticTransDelay (" << minSynapticTransDelay << " steps)." << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (pSynapsesProps->preSpikeQueue != NULL && !pSynapsesProps->timingWheelQueue
+            && pSynapsesProps->total_delay[iSyn] + minSynapticTransDelay > static_cast<int>(LENGTH_OF_DELAYQUEUE)) {
+        cerr << "The transmission delay of the synapses (" << pSynapsesProps->total_delay[iSyn]
+            << " steps) plus minSynapticTransDelay (" << minSynapticTransDelay << " steps) exceeds the "
+            << LENGTH_OF_DELAYQUEUE << " steps of the bitmask spikeQueue; use the wheel spikeQueue." << endl;
+        exit(EXIT_FAILURE);
+    }
+#else // !USE_GPU
     assert( pSynapsesProps->total_delay[iSyn] >= MIN_SYNAPTIC_TRANS_DELAY );
+    assert( pSynapsesProps->timingWheelQueue || pSynapsesProps->total_delay[iSyn] < static_cast<int>(LENGTH_OF_DELAYQUEUE) );
+#endif // !USE_GPU
+
+#if !defined(USE_GPU)
+    if (pSynapsesProps->spikeRings != NULL) {
+        // the synapse reads the ring of its source neuron at its delay before the current step
+        if (pSynapsesProps->total_delay[iSyn] > pSynapsesProps->spikeRings->getMaxDelay()) {
+            cerr << "The transmission delay of the synapses (" << pSynapsesProps->total_delay[iSyn]
+                << " steps) exceeds the " << pSynapsesProps->spikeRings->getMaxDelay() << " steps of the ring spikeDelivery ("
+                << LENGTH_OF_SPIKE_RING << " steps less minSynapticTransDelay); use the queue spikeDelivery with the wheel spikeQueue." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        // the synapse ignores the spikes that its source neuron has fired before it was created,
+        // as a new queue does (the synapses are created between the epochs, at the same step)
+        if (pSynapsesProps->ringCreatedStep != g_simulationStep) {
+            BGSIZE max_total_synapses = pSynapsesProps->maxSynapsesPerNeuron * pSynapsesProps->count_neurons;
+            fill_n(pSynapsesProps->ringNewSynapse, max_total_synapses, false);
+            pSynapsesProps->ringCreatedStep = g_simulationStep;
+        }
+        pSynapsesProps->ringNewSynapse[iSyn] = true;
+    }
+#endif // !USE_GPU
 
     // initializes the queues for the Synapses
-    pSynapsesProps->preSpikeQueue->clearAnEvent(iSyn);
+    if (pSynapsesProps->preSpikeQueue != NULL) {
+        pSynapsesProps->preSpikeQueue->clearAnEvent(iSyn);
+    }
 
     // reset time varying state vars and recompute decay
     resetSynapse(iSyn, deltaT);
@@ -104,6 +154,20 @@ CUDA_CALLABLE bool AllSpikingSynapses::isSpikeQueue(const BGSIZE iSyn, int iStep
 {
     int &total_delay = pSynapsesProps->total_delay[iSyn];
 
+#if !defined(USE_GPU)
+    // Checks if the source neuron has fired total_delay steps before.
+    if (pSynapsesProps->spikeRings != NULL) {
+        uint64_t simulationStep = g_simulationStep + iStepOffset;
+        if (simulationStep < static_cast<uint64_t>(total_delay)) {
+            return false;
+        }
+
+        uint64_t spikeStep = simulationStep - total_delay;
+        return pSynapsesProps->spikeRings->hasFired(pSynapsesProps->sourceNeuronLayoutIndex[iSyn], spikeStep)
+            && (spikeStep >= pSynapsesProps->ringCreatedStep || !pSynapsesProps->ringNewSynapse[iSyn]);
+    }
+#endif // !USE_GPU
+
     // Checks if there is an event in the queue.
     return pSynapsesProps->preSpikeQueue->checkAnEvent(iSyn, total_delay, iStepOffset);
 }
@@ -123,6 +187,24 @@ CUDA_CALLABLE void AllSpikingSynapses::preSpikeHit(const BGSIZE iSyn, const CLUS
     pSynapsesProps->preSpikeQueue->addAnEvent(iSyn, iCluster, iStepOffset);
 }
 
+#if !defined(USE_GPU)
+/*
+ *  Sends the spike of a source neuron of the cluster to its synapses in another
+ *  cluster at once.
+ *
+ *  @param  iNeuron          Index of the source neuron in the cluster.
+ *  @param  iCluster         Cluster ID of cluster of the synapses.
+ *  @param  iStepOffset      Offset from the current simulation step.
+ *  @return false if the spike is not sent, and preSpikeHit() has to be called for each synapse.
+ */
+bool AllSpikingSynapses::preSpikeHitCluster(int iNeuron, const CLUSTER_INDEX_TYPE iCluster, int iStepOffset)
+{
+    AllSpikingSynapsesProps *pSynapsesProps = static_cast<AllSpikingSynapsesProps*>(m_pSynapsesProps);
+
+    return pSynapsesProps->preSpikeQueue->addAnInterClustersSpike(iNeuron, iCluster, iStepOffset);
+}
+#endif // !USE_GPU
+
 /*
  *  Prepares Synapse for a spike hit (for back propagation).
  *
@@ -142,8 +224,272 @@ CUDA_CALLABLE void AllSpikingSynapses::advanceSpikeQueue(int iStep)
 {
     AllSpikingSynapsesProps *pSynapsesProps = reinterpret_cast<AllSpikingSynapsesProps*>(m_pSynapsesProps);
 
+#if !defined(USE_GPU)
+    // the rings need no advance
+    if (pSynapsesProps->preSpikeQueue == NULL) {
+        return;
+    }
+#endif // !USE_GPU
+
     pSynapsesProps->preSpikeQueue->advanceEventQueue(iStep);
+
+#if !defined(USE_GPU)
+    // all clusters have completed the synaptic transmission delay loop,
+    // so no spike is being added to the queue now
+    if (pSynapsesProps->eventDrivenAdvance && !m_isActiveSynapse.empty()) {
+        activateRecordedSynapses(g_simulationStep + iStep - 1);
+    }
+#endif // !USE_GPU
+}
+
+#if !defined(USE_GPU)
+/*
+ *  Advance all the Synapses in the simulation.
+ *  Update the state of all synapses for a time step.
+ *  In the event driven advance mode, only the active synapses (the synapses
+ *  that have pending spikes or a psr above psrEpsilon) are advanced.
+ *
+ *  @param  sim_info         SimulationInfo class to read information from.
+ *  @param  neurons          The Neuron list to search from.
+ *  @param  synapseIndexMap  Pointer to the synapse index map.
+ *  @param  iStepOffset      Offset from the current simulation step.
+ */
+void AllSpikingSynapses::advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset)
+{
+    AllSpikingSynapsesProps *pSynapsesProps = dynamic_cast<AllSpikingSynapsesProps*>(m_pSynapsesProps);
+
+    // the back propagation (STDP) needs every synapse to see the post spikes
+    if (!pSynapsesProps->eventDrivenAdvance || allowBackPropagation()) {
+        AllSynapses::advanceSynapses(sim_info, neurons, synapseIndexMap, iStepOffset);
+        return;
+    }
+
+    if (synapseIndexMap == NULL) {
+        return;
+    }
+
+    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
+    IAllNeuronsProps *pINeuronsProps = dynamic_cast<AllNeurons*>(neurons)->m_pNeuronsProps;
+    BGFLOAT *summation_map = dynamic_cast<AllNeuronsProps*>(pINeuronsProps)->summation_map;
+    const BGFLOAT deltaT = sim_info->deltaT;
+
+    advanceEventDriven(summation_map, simulationStep, [&](BGSIZE iSyn) {
+        advanceSynapse(iSyn, deltaT, neurons, simulationStep, iStepOffset, maxSpikes, pINeuronsProps);
+    });
+}
+
+/*
+ *  Advance all the Synapses in the simulation.
+ *  Update the state of all synapses for a time step.
+ *  The destination neurons are split into chunks that run on the threads of a pool.
+ *  In the event driven advance mode, a chunk advances the active synapses of
+ *  its neurons.
+ *
+ *  @param  sim_info          SimulationInfo class to read information from.
+ *  @param  neurons           The Neuron list to search from.
+ *  @param  synapseIndexMap   Pointer to the synapse index map.
+ *  @param  iStepOffset       Offset from the current simulation step.
+ *  @param  pool              The pool of threads to run the chunks.
+ *  @param  nNeuronsPerChunk  Number of destination neurons per chunk.
+ */
+void AllSpikingSynapses::advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset, ThreadPool &pool, int nNeuronsPerChunk)
+{
+    AllSpikingSynapsesProps *pSynapsesProps = dynamic_cast<AllSpikingSynapsesProps*>(m_pSynapsesProps);
+
+    // the back propagation (STDP) needs every synapse to see the post spikes
+    if (!pSynapsesProps->eventDrivenAdvance || allowBackPropagation()) {
+        AllSynapses::advanceSynapses(sim_info, neurons, synapseIndexMap, iStepOffset, pool, nNeuronsPerChunk);
+        return;
+    }
+
+    if (synapseIndexMap == NULL) {
+        return;
+    }
+
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
+    if (simulationStep != m_nextActiveStep || m_isActiveSynapse.empty()) {
+        buildActiveSynapses(simulationStep);
+    }
+    m_nextActiveStep = simulationStep + 1;
+
+    // The synapses of a neuron have contiguous indexes, so the active synapses
+    // (in ascending order) of a chunk of neurons are contiguous too.
+    BGSIZE synapsesPerChunk = static_cast<BGSIZE>(nNeuronsPerChunk) * pSynapsesProps->maxSynapsesPerNeuron;
+    BGSIZE nChunks = (pSynapsesProps->count_neurons + nNeuronsPerChunk - 1) / nNeuronsPerChunk;
+    m_activeChunkBegin.resize(nChunks + 1);
+    m_activeChunkCount.resize(nChunks);
+    for (BGSIZE iChunk = 0; iChunk < nChunks; iChunk++) {
+        m_activeChunkBegin[iChunk] = lower_bound(m_activeSynapses.begin(), m_activeSynapses.end(), iChunk * synapsesPerChunk) - m_activeSynapses.begin();
+    }
+    m_activeChunkBegin[nChunks] = m_activeSynapses.size();
+
+    pool.parallelFor(nChunks, [&](BGSIZE iChunk, int iThread) {
+        m_activeChunkCount[iChunk] = advanceActiveSynapses(sim_info, neurons, iStepOffset, m_activeChunkBegin[iChunk], m_activeChunkBegin[iChunk + 1]);
+    });
+
+    // pack the synapses that stay active
+    BGSIZE nActive = 0;
+    for (BGSIZE iChunk = 0; iChunk < nChunks; iChunk++) {
+        vector<BGSIZE>::iterator chunkBegin = m_activeSynapses.begin() + m_activeChunkBegin[iChunk];
+        copy(chunkBegin, chunkBegin + m_activeChunkCount[iChunk], m_activeSynapses.begin() + nActive);
+        nActive += m_activeChunkCount[iChunk];
+    }
+    m_activeSynapses.resize(nActive);
+}
+
+/*
+ *  Advance the active synapses m_activeSynapses[iBegin, iEnd), and move the
+ *  ones that stay active to the front of the range (in order).
+ *
+ *  @param  sim_info         SimulationInfo class to read information from.
+ *  @param  neurons          The Neuron list to search from.
+ *  @param  iStepOffset      Offset from the current simulation step.
+ *  @param  iBegin           Index in m_activeSynapses of the first synapse to advance.
+ *  @param  iEnd             Index in m_activeSynapses after the last synapse to advance.
+ *  @return the number of synapses that stay active.
+ */
+BGSIZE AllSpikingSynapses::advanceActiveSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, int iStepOffset, BGSIZE iBegin, BGSIZE iEnd)
+{
+    int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
+    uint64_t simulationStep = g_simulationStep + iStepOffset;
+    IAllNeuronsProps *pINeuronsProps = dynamic_cast<AllNeurons*>(neurons)->m_pNeuronsProps;
+    BGFLOAT *summation_map = dynamic_cast<AllNeuronsProps*>(pINeuronsProps)->summation_map;
+    const BGFLOAT deltaT = sim_info->deltaT;
+
+    return advanceActiveRange(summation_map, simulationStep, iBegin, iEnd, [&](BGSIZE iSyn) {
+        advanceSynapse(iSyn, deltaT, neurons, simulationStep, iStepOffset, maxSpikes, pINeuronsProps);
+    });
+}
+
+/*
+ *  Collect the active synapses by scanning all synapses
+ *  (at the first time step or when the simulation step is not contiguous).
+ *
+ *  @param  simulationStep   The current simulation step.
+ */
+void AllSpikingSynapses::buildActiveSynapses(uint64_t simulationStep)
+{
+    AllSpikingSynapsesProps *pSynapsesProps = dynamic_cast<AllSpikingSynapsesProps*>(m_pSynapsesProps);
+    BGSIZE max_total_synapses = pSynapsesProps->maxSynapsesPerNeuron * pSynapsesProps->count_neurons;
+
+    m_isActiveSynapse.assign(max_total_synapses, false);
+    m_idleStep.assign(max_total_synapses, simulationStep - 1);
+    m_activeSynapses.clear();
+    if (max_total_synapses == 0) {
+        return;
+    }
+
+    for (BGSIZE iSyn = 0; iSyn < max_total_synapses; iSyn++) {
+        if (pSynapsesProps->in_use[iSyn] &&
+            (fabs(pSynapsesProps->psr[iSyn]) > pSynapsesProps->psrEpsilon || pSynapsesProps->preSpikeQueue->hasEvents(iSyn))) {
+            m_isActiveSynapse[iSyn] = true;
+            m_activeSynapses.push_back(iSyn);
+        }
+    }
+
+    // the scan has found the synapses recorded so far
+    m_recordedSynapses.clear();
+    pSynapsesProps->preSpikeQueue->takeRecordedEvents(m_recordedSynapses);
+}
+
+/*
+ *  Add the synapses that received spikes to the active synapses,
+ *  and apply the decay of their psr since they became idle.
+ *
+ *  @param  lastStep   The last simulation step advanced.
+ */
+void AllSpikingSynapses::activateRecordedSynapses(uint64_t lastStep)
+{
+    AllSpikingSynapsesProps *pSynapsesProps = dynamic_cast<AllSpikingSynapsesProps*>(m_pSynapsesProps);
+
+    m_recordedSynapses.clear();
+    pSynapsesProps->preSpikeQueue->takeRecordedEvents(m_recordedSynapses);
+
+    BGSIZE nActive = m_activeSynapses.size();
+    for (BGSIZE i = 0; i < m_recordedSynapses.size(); i++) {
+        BGSIZE iSyn = m_recordedSynapses[i];
+        if (m_isActiveSynapse[iSyn]) {
+            continue;
+        }
+        m_isActiveSynapse[iSyn] = true;
+        m_activeSynapses.push_back(iSyn);
+
+        // psr *= decay every time step while the synapse was idle
+        uint64_t nIdleSteps = lastStep - m_idleStep[iSyn];
+        if (nIdleSteps != 0) {
+            pSynapsesProps->psr[iSyn] *= pow(pSynapsesProps->decay[iSyn], static_cast<BGFLOAT>(nIdleSteps));
+        }
+    }
+
+    // keep the ascending index order
+    sort(m_activeSynapses.begin() + nActive, m_activeSynapses.end());
+    inplace_merge(m_activeSynapses.begin(), m_activeSynapses.begin() + nActive, m_activeSynapses.end());
+}
+
+/*
+ *  Add the complete state of the synapses to a periodic checkpoint,
+ *  with the active synapses of the event driven advance. The psr of an
+ *  idle synapse is decayed when it becomes active, so the steps when the
+ *  synapses became idle are part of the state (no rows if the active
+ *  synapses are not collected yet).
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ */
+void AllSpikingSynapses::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    AllSynapses::checkpointState(writer, iCluster);
+
+    writer.addArray(CKPT_SYNAPSE_ACTIVE, iCluster, m_activeSynapses.data(), m_activeSynapses.size());
+    writer.addArray(CKPT_SYNAPSE_IDLE_STEP, iCluster, m_idleStep.data(), m_idleStep.size());
+    writer.addValue(CKPT_SYNAPSE_NEXT_ACTIVE_STEP, iCluster, m_nextActiveStep);
+}
+
+/*
+ *  Restore the complete state of the synapses from a periodic checkpoint,
+ *  with the active synapses of the event driven advance.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ *  @param  clr_info  ClusterInfo of the cluster (for the summation points).
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllSpikingSynapses::restoreState(const CheckpointReader &reader, int iCluster, const ClusterInfo *clr_info)
+{
+    if (!AllSynapses::restoreState(reader, iCluster, clr_info)) {
+        return false;
+    }
+
+    BGSIZE nActive = reader.getRows(CKPT_SYNAPSE_ACTIVE, iCluster);
+    BGSIZE nIdleStep = reader.getRows(CKPT_SYNAPSE_IDLE_STEP, iCluster);
+    BGSIZE max_total_synapses = m_pSynapsesProps->maxSynapsesPerNeuron * m_pSynapsesProps->count_neurons;
+    if (nIdleStep != 0 && nIdleStep != max_total_synapses) {
+        cerr << "The active synapses of cluster " << iCluster << " of the checkpoint do not match the synapses" << endl;
+        return false;
+    }
+
+    m_activeSynapses.resize(nActive);
+    m_idleStep.resize(nIdleStep);
+    if (!reader.restoreArray(CKPT_SYNAPSE_ACTIVE, iCluster, m_activeSynapses.data(), nActive)
+            || !reader.restoreArray(CKPT_SYNAPSE_IDLE_STEP, iCluster, m_idleStep.data(), nIdleStep)
+            || !reader.restoreValue(CKPT_SYNAPSE_NEXT_ACTIVE_STEP, iCluster, m_nextActiveStep)) {
+        return false;
+    }
+
+    // an empty m_isActiveSynapse makes the next advance collect the active synapses
+    m_isActiveSynapse.assign(nIdleStep, false);
+    for (BGSIZE i = 0; i < nActive; i++) {
+        if (m_activeSynapses[i] >= nIdleStep) {
+            cerr << "The active synapses of cluster " << iCluster << " of the checkpoint do not match the synapses" << endl;
+            return false;
+        }
+        m_isActiveSynapse[m_activeSynapses[i]] = true;
+    }
+
+    return true;
 }
+#endif // !USE_GPU
 
 /*
  *  Advance one specific Synapse.
@@ -134,6 +134,19 @@ public:
          */
         CUDA_CALLABLE virtual void preSpikeHit(const BGSIZE iSyn, const CLUSTER_INDEX_TYPE iCluster, int iStepOffset);
 
+#if !defined(USE_GPU)
+        /**
+         *  Sends the spike of a source neuron of the cluster to its synapses in another
+         *  cluster at once (EventQueue::addAnInterClustersSpike()).
+         *
+         *  @param  iNeuron          Index of the source neuron in the cluster.
+         *  @param  iCluster         Cluster ID of cluster of the synapses.
+         *  @param  iStepOffset      Offset from the current simulation step.
+         *  @return false if the spike is not sent, and preSpikeHit() has to be called for each synapse.
+         */
+        bool preSpikeHitCluster(int iNeuron, const CLUSTER_INDEX_TYPE iCluster, int iStepOffset);
+#endif // !USE_GPU
+
         /**
          *  Prepares Synapse for a spike hit (for back propagation).
          *
@@ -149,6 +162,135 @@ public:
          */
         CUDA_CALLABLE virtual void advanceSpikeQueue(int iStep);
 
+#if !defined(USE_GPU)
+        /**
+         *  Advance all the Synapses in the simulation.
+         *  Update the state of all synapses for a time step.
+         *  In the event driven advance mode, only the active synapses (the synapses
+         *  that have pending spikes or a psr above psrEpsilon) are advanced.
+         *
+         *  @param  sim_info         SimulationInfo class to read information from.
+         *  @param  neurons          The Neuron list to search from.
+         *  @param  synapseIndexMap  Pointer to the synapse index map.
+         *  @param  iStepOffset      Offset from the current simulation step.
+         */
+        virtual void advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset);
+
+        /**
+         *  Advance all the Synapses in the simulation.
+         *  Update the state of all synapses for a time step.
+         *  The destination neurons are split into chunks that run on the threads of a pool.
+         *  In the event driven advance mode, a chunk advances the active synapses of
+         *  its neurons.
+         *
+         *  @param  sim_info          SimulationInfo class to read information from.
+         *  @param  neurons           The Neuron list to search from.
+         *  @param  synapseIndexMap   Pointer to the synapse index map.
+         *  @param  iStepOffset       Offset from the current simulation step.
+         *  @param  pool              The pool of threads to run the chunks.
+         *  @param  nNeuronsPerChunk  Number of destination neurons per chunk.
+         */
+        virtual void advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset, ThreadPool &pool, int nNeuronsPerChunk);
+
+        /**
+         *  Add the complete state of the synapses to a periodic checkpoint,
+         *  with the active synapses of the event driven advance.
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         */
+        virtual void checkpointState(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore the complete state of the synapses from a periodic checkpoint,
+         *  with the active synapses of the event driven advance.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         *  @param  clr_info  ClusterInfo of the cluster (for the summation points).
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader, int iCluster, const ClusterInfo *clr_info);
+
+        /**
+         *  Advance the active synapses for a time step in the event driven advance
+         *  mode (single threaded). The synapse update is a functor, so that a
+         *  specialized cluster (SpecializedCluster.h) calls the advanceSynapse() of
+         *  its synapse class directly, with the same arithmetic as advanceSynapses().
+         *
+         *  @param  summation_map    The summation points of the neurons.
+         *  @param  simulationStep   The current simulation step.
+         *  @param  advanceSynapse   Functor that advances the synapse of the given index.
+         */
+        template <class AdvanceSynapse>
+        void advanceEventDriven(BGFLOAT *summation_map, uint64_t simulationStep, AdvanceSynapse advanceSynapse);
+
+    private:
+        /**
+         *  Advance the active synapses m_activeSynapses[iBegin, iEnd) with a functor,
+         *  and move the ones that stay active to the front of the range (in order).
+         *
+         *  @param  summation_map    The summation points of the neurons.
+         *  @param  simulationStep   The current simulation step.
+         *  @param  iBegin           Index in m_activeSynapses of the first synapse to advance.
+         *  @param  iEnd             Index in m_activeSynapses after the last synapse to advance.
+         *  @param  advanceSynapse   Functor that advances the synapse of the given index.
+         *  @return the number of synapses that stay active.
+         */
+        template <class AdvanceSynapse>
+        BGSIZE advanceActiveRange(BGFLOAT *summation_map, uint64_t simulationStep, BGSIZE iBegin, BGSIZE iEnd, AdvanceSynapse advanceSynapse);
+
+        /**
+         *  Advance the active synapses m_activeSynapses[iBegin, iEnd), and move the
+         *  ones that stay active to the front of the range (in order).
+         *
+         *  @param  sim_info         SimulationInfo class to read information from.
+         *  @param  neurons          The Neuron list to search from.
+         *  @param  iStepOffset      Offset from the current simulation step.
+         *  @param  iBegin           Index in m_activeSynapses of the first synapse to advance.
+         *  @param  iEnd             Index in m_activeSynapses after the last synapse to advance.
+         *  @return the number of synapses that stay active.
+         */
+        BGSIZE advanceActiveSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, int iStepOffset, BGSIZE iBegin, BGSIZE iEnd);
+
+        /**
+         *  Collect the active synapses by scanning all synapses
+         *  (at the first time step or when the simulation step is not contiguous).
+         *
+         *  @param  simulationStep   The current simulation step.
+         */
+        void buildActiveSynapses(uint64_t simulationStep);
+
+        /**
+         *  Add the synapses that received spikes to the active synapses,
+         *  and apply the decay of their psr since they became idle.
+         *
+         *  @param  lastStep   The last simulation step advanced.
+         */
+        void activateRecordedSynapses(uint64_t lastStep);
+
+        //! Indexes of the active synapses (ascending order).
+        vector<BGSIZE> m_activeSynapses;
+
+        //! Indexes of the synapses that received spikes (temporary buffer).
+        vector<BGSIZE> m_recordedSynapses;
+
+        //! True if the synapse is in m_activeSynapses.
+        vector<uint8_t> m_isActiveSynapse;
+
+        //! The simulation step when the synapse became idle (the psr is up to date at this step).
+        vector<uint64_t> m_idleStep;
+
+        //! The simulation step expected at the next advance of the active synapses.
+        uint64_t m_nextActiveStep;
+
+        //! Index in m_activeSynapses of the first active synapse of each chunk of neurons.
+        vector<BGSIZE> m_activeChunkBegin;
+
+        //! Number of active synapses of each chunk of neurons that stay active.
+        vector<BGSIZE> m_activeChunkCount;
+#endif // !USE_GPU
+
     protected:
         /**
          *  Checks if there is an input spike in the queue.
@@ -171,6 +313,97 @@ public:
         CUDA_CALLABLE virtual void changePSR(const BGSIZE iSyn, const BGFLOAT deltaT, uint64_t simulationStep, AllSpikingSynapsesProps* pSpikingSynapsesProps);
 };
 
+#if !defined(USE_GPU)
+/*
+ *  Advance the active synapses for a time step in the event driven advance
+ *  mode (single threaded).
+ *
+ *  @param  summation_map    The summation points of the neurons.
+ *  @param  simulationStep   The current simulation step.
+ *  @param  advanceSynapse   Functor that advances the synapse of the given index.
+ */
+template <class AdvanceSynapse>
+void AllSpikingSynapses::advanceEventDriven(BGFLOAT *summation_map, uint64_t simulationStep, AdvanceSynapse advanceSynapse)
+{
+    if (simulationStep != m_nextActiveStep || m_isActiveSynapse.empty()) {
+        buildActiveSynapses(simulationStep);
+    }
+    m_nextActiveStep = simulationStep + 1;
+
+    BGSIZE nActive = advanceActiveRange(summation_map, simulationStep, 0, m_activeSynapses.size(), advanceSynapse);
+    m_activeSynapses.resize(nActive);
+}
+
+/*
+ *  Advance the active synapses m_activeSynapses[iBegin, iEnd) with a functor,
+ *  and move the ones that stay active to the front of the range (in order).
+ *
+ *  @param  summation_map    The summation points of the neurons.
+ *  @param  simulationStep   The current simulation step.
+ *  @param  iBegin           Index in m_activeSynapses of the first synapse to advance.
+ *  @param  iEnd             Index in m_activeSynapses after the last synapse to advance.
+ *  @param  advanceSynapse   Functor that advances the synapse of the given index.
+ *  @return the number of synapses that stay active.
+ */
+template <class AdvanceSynapse>
+BGSIZE AllSpikingSynapses::advanceActiveRange(BGFLOAT *summation_map, uint64_t simulationStep, BGSIZE iBegin, BGSIZE iEnd, AdvanceSynapse advanceSynapse)
+{
+    AllSpikingSynapsesProps *pSynapsesProps = static_cast<AllSpikingSynapsesProps*>(m_pSynapsesProps);
+    EventQueue *preSpikeQueue = pSynapsesProps->preSpikeQueue;
+    BGFLOAT psrEpsilon = pSynapsesProps->psrEpsilon;
+    BGSIZE maxSynapsesPerNeuron = pSynapsesProps->maxSynapsesPerNeuron;
+
+    // The synapses of a destination neuron have contiguous indexes, so the
+    // post spike responses of a neuron are summed in a register and written
+    // once, when the next active synapse belongs to another neuron.
+    BGSIZE iNeuron = 0;
+    BGSIZE iNeuronSynapsesEnd = 0;
+    BGFLOAT summationPoint = 0;
+
+    // advance the active synapses in ascending index order (the order of the
+    // dense advance), and remove the idle ones in place
+    BGSIZE nActive = 0;
+    for (BGSIZE i = iBegin; i < iEnd; i++) {
+        BGSIZE iSyn = m_activeSynapses[i];
+        if (!pSynapsesProps->in_use[iSyn]) {
+            m_isActiveSynapse[iSyn] = false;
+            continue;
+        }
+
+        if (iSyn >= iNeuronSynapsesEnd) {
+            if (iNeuronSynapsesEnd != 0) {
+                summation_map[iNeuron] = summationPoint;
+            }
+            iNeuron = iSyn / maxSynapsesPerNeuron;
+            iNeuronSynapsesEnd = (iNeuron + 1) * maxSynapsesPerNeuron;
+            summationPoint = summation_map[iNeuron];
+        }
+
+        // advance one specific Synapse
+        advanceSynapse(iSyn);
+
+        // and apply the post spike response to the summation point
+        BGFLOAT &psr = pSynapsesProps->psr[iSyn];
+        summationPoint += psr;
+
+        // the synapse becomes idle when the psr is negligible and no spike is pending
+        if (fabs(psr) <= psrEpsilon && !preSpikeQueue->hasEvents(iSyn)) {
+            m_isActiveSynapse[iSyn] = false;
+            m_idleStep[iSyn] = simulationStep;
+            continue;
+        }
+
+        m_activeSynapses[iBegin + nActive++] = iSyn;
+    }
+
+    if (iNeuronSynapsesEnd != 0) {
+        summation_map[iNeuron] = summationPoint;
+    }
+
+    return nActive;
+}
+#endif // !USE_GPU
+
 #if defined(USE_GPU)
 
 /* -------------------------------------*\
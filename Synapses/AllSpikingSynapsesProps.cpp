@@ -1,7 +1,11 @@
 #include "AllSpikingSynapsesProps.h"
+#include "Checkpoint.h"
 #include "EventQueue.h"
+#include "ParseParamError.h"
 #if defined(USE_GPU)
 #include <helper_cuda.h>
+#else // USE_GPU
+#include "AxonalSpikeRings.h"
 #endif
 
 // Default constructor
@@ -11,6 +15,18 @@ AllSpikingSynapsesProps::AllSpikingSynapsesProps()
     total_delay = NULL;
     tau = NULL;
     preSpikeQueue = NULL;
+    eventDrivenAdvance = false;
+    psrEpsilon = DEFAULT_PSR_EPSILON;
+    timingWheelQueue = false;
+    axonalDelay = 0;
+    ringSpikeDelivery = false;
+#if !defined(USE_GPU)
+    minSynapticTransDelay = MIN_SYNAPTIC_TRANS_DELAY;
+    spikeRings = NULL;
+    spikeRingsBegin = 0;
+    ringNewSynapse = NULL;
+    ringCreatedStep = 0;
+#endif // !USE_GPU
 }
 
 AllSpikingSynapsesProps::~AllSpikingSynapsesProps()
@@ -32,10 +48,37 @@ void AllSpikingSynapsesProps::setupSynapsesProps(const int num_neurons, const in
 
     BGSIZE max_total_synapses = maxSynapsesPerNeuron * count_neurons;
 
+#if !defined(USE_GPU)
+    minSynapticTransDelay = sim_info->minSynapticTransDelay;
+
+    // the synapses read the spikes from the rings of their source neurons instead of a queue
+    // (the neurons of the cluster record their spikes even if the cluster has no synapses)
+    if (ringSpikeDelivery) {
+        if (eventDrivenAdvance || timingWheelQueue) {
+            cerr << "The ring spikeDelivery requires the dense advanceMode and the bitmask spikeQueue." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        spikeRings = clr_info->spikeRings;
+        spikeRings->enableSpikeRings();
+        spikeRingsBegin = clr_info->clusterNeuronsBegin;
+        ringCreatedStep = 0;
+
+        if (max_total_synapses != 0) {
+            decay = new BGFLOAT[max_total_synapses]();
+            total_delay = new int[max_total_synapses]();
+            tau = new BGFLOAT[max_total_synapses]();
+            ringNewSynapse = new bool[max_total_synapses];
+            fill_n(ringNewSynapse, max_total_synapses, false);
+        }
+        return;
+    }
+#endif // !USE_GPU
+
     if (max_total_synapses != 0) {
-        decay = new BGFLOAT[max_total_synapses];
-        total_delay = new int[max_total_synapses];
-        tau = new BGFLOAT[max_total_synapses];
+        decay = new BGFLOAT[max_total_synapses]();
+        total_delay = new int[max_total_synapses]();
+        tau = new BGFLOAT[max_total_synapses]();
 
         // create a pre synapse spike queue & initialize it
         preSpikeQueue = new EventQueue();
@@ -50,6 +93,16 @@ void AllSpikingSynapsesProps::setupSynapsesProps(const int num_neurons, const in
 #else // USE_GPU
         // initializes the pre synapse spike queue
         preSpikeQueue->initEventQueue(clr_info->clusterID, max_total_synapses);
+
+        // the event driven advance finds the synapses that receive spikes from the queue
+        if (eventDrivenAdvance) {
+            preSpikeQueue->enableEventRecording();
+        }
+
+        // the spikes are keyed by the step they arrive at the synapse
+        if (timingWheelQueue) {
+            preSpikeQueue->enableTimingWheel(total_delay);
+        }
 #endif // USE_GPU
 
         // register the queue to the event handler
@@ -77,6 +130,13 @@ void AllSpikingSynapsesProps::cleanupSynapsesProps()
     total_delay = NULL;
     tau = NULL;
 
+#if !defined(USE_GPU)
+    if (ringNewSynapse != NULL) {
+        delete[] ringNewSynapse;
+        ringNewSynapse = NULL;
+    }
+#endif // !USE_GPU
+
     if (preSpikeQueue != NULL) {
         delete preSpikeQueue;
         preSpikeQueue = NULL;
@@ -365,6 +425,110 @@ void AllSpikingSynapsesProps::processInterClustesIncomingSpikes(void* allSynapse
 }
 #endif // USE_GPU
 
+/*
+ *  Attempts to read parameters from a XML file.
+ *
+ *  @param  element TiXmlElement to examine.
+ *  @return true if successful, false otherwise.
+ */
+bool AllSpikingSynapsesProps::readParameters(const TiXmlElement& element)
+{
+    if (element.ValueStr().compare("advanceMode") == 0) {
+        string mode = element.GetText();
+        if (mode.compare("event") == 0) {
+            eventDrivenAdvance = true;
+        } else if (mode.compare("dense") == 0) {
+            eventDrivenAdvance = false;
+        } else {
+            throw ParseParamError("advanceMode", "Invalid advanceMode value (must be event or dense).");
+        }
+        return true;
+    }
+
+    if (element.ValueStr().compare("psrEpsilon") == 0) {
+        psrEpsilon = atof(element.GetText());
+        if (psrEpsilon < 0) {
+            throw ParseParamError("psrEpsilon", "Invalid negative psrEpsilon value.");
+        }
+        return true;
+    }
+
+    if (element.ValueStr().compare("spikeQueue") == 0) {
+        string queue = element.GetText();
+        if (queue.compare("wheel") == 0) {
+#if defined(USE_GPU)
+            throw ParseParamError("spikeQueue", "The wheel spikeQueue is not supported by the GPU implementation.");
+#endif // USE_GPU
+            timingWheelQueue = true;
+        } else if (queue.compare("bitmask") == 0) {
+            timingWheelQueue = false;
+        } else {
+            throw ParseParamError("spikeQueue", "Invalid spikeQueue value (must be bitmask or wheel).");
+        }
+        return true;
+    }
+
+    if (element.ValueStr().compare("spikeDelivery") == 0) {
+        string delivery = element.GetText();
+        if (delivery.compare("ring") == 0) {
+#if defined(USE_GPU)
+            throw ParseParamError("spikeDelivery", "The ring spikeDelivery is not supported by the GPU implementation.");
+#endif // USE_GPU
+            ringSpikeDelivery = true;
+        } else if (delivery.compare("queue") == 0) {
+            ringSpikeDelivery = false;
+        } else {
+            throw ParseParamError("spikeDelivery", "Invalid spikeDelivery value (must be queue or ring).");
+        }
+        return true;
+    }
+
+    if (element.ValueStr().compare("axonalDelay") == 0) {
+        axonalDelay = atof(element.GetText());
+        if (axonalDelay < 0) {
+            throw ParseParamError("axonalDelay", "Invalid negative axonalDelay value.");
+        }
+        return true;
+    }
+
+    return AllSynapsesProps::readParameters(element);
+}
+
+/*
+ *  Prints out all parameters of the synapses to ostream.
+ *
+ *  @param  output  ostream to send output to.
+ */
+void AllSpikingSynapsesProps::printParameters(ostream &output) const
+{
+    AllSynapsesProps::printParameters(output);
+
+    output << "advanceMode: " << (eventDrivenAdvance ? "event" : "dense")
+           << ", psrEpsilon: " << psrEpsilon
+           << ", spikeQueue: " << (timingWheelQueue ? "wheel" : "bitmask")
+           << ", spikeDelivery: " << (ringSpikeDelivery ? "ring" : "queue")
+           << ", axonalDelay: " << axonalDelay
+           << endl;
+}
+
+/*
+ *  Copy synapses parameters.
+ *
+ *  @param  r_synapsesProps  Synapses properties class object to copy from.
+ */
+void AllSpikingSynapsesProps::copyParameters(const AllSynapsesProps *r_synapsesProps)
+{
+    AllSynapsesProps::copyParameters(r_synapsesProps);
+
+    const AllSpikingSynapsesProps *pProps = dynamic_cast<const AllSpikingSynapsesProps*>(r_synapsesProps);
+
+    eventDrivenAdvance = pProps->eventDrivenAdvance;
+    psrEpsilon = pProps->psrEpsilon;
+    timingWheelQueue = pProps->timingWheelQueue;
+    axonalDelay = pProps->axonalDelay;
+    ringSpikeDelivery = pProps->ringSpikeDelivery;
+}
+
 /*
  *  Sets the data for Synapse to input's data.
  *
@@ -408,7 +572,10 @@ void AllSpikingSynapsesProps::printSynapsesProps() const
             cout << "decay[" << i << "] = " << decay[i];
             cout << " tau: " << tau[i];
             cout << " total_delay: " << total_delay[i];
-            cout << " preSpikeQueue: " << preSpikeQueue->m_queueEvent[i] << endl;
+            if (preSpikeQueue != NULL) {
+                cout << " preSpikeQueue: " << preSpikeQueue->m_queueEvent[i];
+            }
+            cout << endl;
         }
     }
 }
@@ -530,3 +697,51 @@ void AllSpikingSynapsesProps::printGPUSynapsesProps( void* allSynapsesDeviceProp
     }
 }
 #endif // USE_GPU
+
+#if !defined(USE_GPU)
+/*
+ *  Add the complete state of the synapses to a periodic checkpoint.
+ *  The pre spike queue is written in CHECKPOINT_QUEUE_SECTIONS sections
+ *  from CKPT_PRE_SPIKE_QUEUE.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ */
+void AllSpikingSynapsesProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    AllSynapsesProps::checkpointState(writer, iCluster);
+
+    writer.addArray(CKPT_SYNAPSE_DECAY, iCluster, decay, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_TAU, iCluster, tau, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_TOTAL_DELAY, iCluster, total_delay, count_neurons, maxSynapsesPerNeuron);
+
+    if (preSpikeQueue != NULL) {
+        preSpikeQueue->checkpoint(writer, CKPT_PRE_SPIKE_QUEUE, iCluster);
+    }
+
+    if (spikeRings != NULL) {
+        spikeRings->checkpoint(writer, iCluster, spikeRingsBegin, count_neurons);
+        writer.addArray(CKPT_SYNAPSE_RING_NEW, iCluster, ringNewSynapse, count_neurons, maxSynapsesPerNeuron);
+        writer.addValue(CKPT_SYNAPSE_RING_CREATED_STEP, iCluster, ringCreatedStep);
+    }
+}
+
+/*
+ *  Restore the complete state of the synapses from a periodic checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllSpikingSynapsesProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    return AllSynapsesProps::restoreState(reader, iCluster)
+        && reader.restoreArray(CKPT_SYNAPSE_DECAY, iCluster, decay, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_TAU, iCluster, tau, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_TOTAL_DELAY, iCluster, total_delay, count_neurons, maxSynapsesPerNeuron)
+        && (preSpikeQueue == NULL || preSpikeQueue->restore(reader, CKPT_PRE_SPIKE_QUEUE, iCluster))
+        && (spikeRings == NULL || (spikeRings->restore(reader, iCluster, spikeRingsBegin, count_neurons)
+                                   && reader.restoreArray(CKPT_SYNAPSE_RING_NEW, iCluster, ringNewSynapse, count_neurons, maxSynapsesPerNeuron)
+                                   && reader.restoreValue(CKPT_SYNAPSE_RING_CREATED_STEP, iCluster, ringCreatedStep)));
+}
+#endif // !USE_GPU
@@ -8,6 +8,10 @@
 
 #include "AllSynapsesProps.h"
 
+#if !defined(USE_GPU)
+class AxonalSpikeRings;
+#endif // !USE_GPU
+
 class AllSpikingSynapsesProps : public AllSynapsesProps
 {
     public:
@@ -29,6 +33,28 @@ class AllSpikingSynapsesProps : public AllSynapsesProps
          */
         virtual void printSynapsesProps() const;
 
+        /**
+         *  Attempts to read parameters from a XML file.
+         *
+         *  @param  element TiXmlElement to examine.
+         *  @return true if successful, false otherwise.
+         */
+        virtual bool readParameters(const TiXmlElement& element);
+
+        /**
+         *  Prints out all parameters of the synapses to ostream.
+         *
+         *  @param  output  ostream to send output to.
+         */
+        virtual void printParameters(ostream &output) const;
+
+        /**
+         *  Copy synapses parameters.
+         *
+         *  @param  r_synapsesProps  Synapses properties class object to copy from.
+         */
+        virtual void copyParameters(const AllSynapsesProps *r_synapsesProps);
+
 #if defined(USE_GPU)
     public:
         /**
@@ -162,6 +188,25 @@ class AllSpikingSynapsesProps : public AllSynapsesProps
          */
         virtual void writeSynapseProps(ostream& output, const BGSIZE iSyn) const;
 
+#if !defined(USE_GPU)
+        /**
+         *  Add the complete state of the synapses to a periodic checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         */
+        virtual void checkpointState(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore the complete state of the synapses from a periodic checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader, int iCluster);
+#endif // !USE_GPU
+
     private:
         /**
          *  Cleanup the class.
@@ -189,4 +234,63 @@ class AllSpikingSynapsesProps : public AllSynapsesProps
          * The collection of synaptic transmission delay queue.
          */
         EventQueue *preSpikeQueue;
+
+        /**
+         *  True if the host advances only the synapses that have pending spikes
+         *  or a psr above psrEpsilon (event driven), false if it advances
+         *  all synapses every time step.
+         */
+        bool eventDrivenAdvance;
+
+        /**
+         *  The psr magnitude at or below which a synapse without pending spikes stops being advanced
+         *  (event driven advance only).
+         */
+        BGFLOAT psrEpsilon;
+
+        /**
+         *  True if the spike queues keep the spikes beyond LENGTH_OF_DELAYQUEUE steps
+         *  in a timing wheel (host only), false if the delays are limited by the bitmask.
+         */
+        bool timingWheelQueue;
+
+        /**
+         *  The axonal conduction delay added to the synaptic transmission delay of every synapse [units=sec].
+         */
+        BGFLOAT axonalDelay;
+
+        /**
+         *  True if the synapses read the spikes from the rings of their source neurons
+         *  (spikeDelivery ring, host only), false if the spikes are delivered through preSpikeQueue.
+         */
+        bool ringSpikeDelivery;
+
+#if !defined(USE_GPU)
+        /**
+         *  Number of steps the clusters advance between the spike exchanges
+         *  (SimInfo minSynapticTransDelay), the lower bound of total_delay.
+         */
+        int minSynapticTransDelay;
+
+        /**
+         *  The spike rings of the neurons (ring spike delivery only, NULL otherwise).
+         */
+        AxonalSpikeRings *spikeRings;
+
+        /**
+         *  Layout index of the first neuron of the cluster (its slice of the spike rings).
+         */
+        int spikeRingsBegin;
+
+        /**
+         *  True if the synapse was created at ringCreatedStep, and ignores the spikes
+         *  recorded in the rings before it (ring spike delivery only).
+         */
+        bool *ringNewSynapse;
+
+        /**
+         *  The step of the last creation of synapses (ring spike delivery only).
+         */
+        uint64_t ringCreatedStep;
+#endif // !USE_GPU
 };
\ No newline at end of file
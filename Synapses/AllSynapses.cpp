@@ -131,22 +131,114 @@ void AllSynapses::advanceSynapses(void* allNeuronsProps, void* synapseIndexMapDe
  *  @param  iStepOffset      Offset from the current simulation step.
  */
 void AllSynapses::advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset)
+{
+    if (synapseIndexMap == NULL) {
+        return;
+    }
+
+    advanceSynapses(sim_info, neurons, synapseIndexMap, iStepOffset, 0, synapseIndexMap->num_neurons);
+}
+
+/*
+ *  Advance all the Synapses in the simulation.
+ *  Update the state of all synapses for a time step.
+ *  The destination neurons are split into chunks that run on the threads
+ *  of a pool. A chunk advances the incoming synapses of its neurons, so
+ *  each summation point is updated by one thread, in the order of the
+ *  single threaded advance.
+ *
+ *  @param  sim_info          SimulationInfo class to read information from.
+ *  @param  neurons           The Neuron list to search from.
+ *  @param  synapseIndexMap   Pointer to the synapse index map.
+ *  @param  iStepOffset       Offset from the current simulation step.
+ *  @param  pool              The pool of threads to run the chunks.
+ *  @param  nNeuronsPerChunk  Number of destination neurons per chunk.
+ */
+void AllSynapses::advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset, ThreadPool &pool, int nNeuronsPerChunk)
+{
+    if (synapseIndexMap == NULL) {
+        return;
+    }
+
+    BGSIZE totalNeurons = synapseIndexMap->num_neurons;
+    BGSIZE nChunks = (totalNeurons + nNeuronsPerChunk - 1) / nNeuronsPerChunk;
+
+    pool.parallelFor(nChunks, [&](BGSIZE iChunk, int iThread) {
+        BGSIZE iNeuronBegin = iChunk * nNeuronsPerChunk;
+        BGSIZE iNeuronEnd = min(iNeuronBegin + nNeuronsPerChunk, totalNeurons);
+        advanceSynapses(sim_info, neurons, synapseIndexMap, iStepOffset, iNeuronBegin, iNeuronEnd);
+    });
+}
+
+/*
+ *  Advance the incoming synapses of the neurons in a range.
+ *
+ *  @param  sim_info          SimulationInfo class to read information from.
+ *  @param  neurons           The Neuron list to search from.
+ *  @param  synapseIndexMap   Pointer to the synapse index map.
+ *  @param  iStepOffset       Offset from the current simulation step.
+ *  @param  iNeuronBegin      Index of the first destination neuron of the range.
+ *  @param  iNeuronEnd        Index after the last destination neuron of the range.
+ */
+void AllSynapses::advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset, BGSIZE iNeuronBegin, BGSIZE iNeuronEnd)
 {
     int maxSpikes = (int) ((sim_info->epochDuration * sim_info->maxFiringRate));
-    AllSynapsesProps* pSynapsesProps = m_pSynapsesProps;
     uint64_t simulationStep = g_simulationStep + iStepOffset;
     IAllNeuronsProps *pINeuronsProps = dynamic_cast<AllNeurons*>(neurons)->m_pNeuronsProps;
+    BGFLOAT *summation_map = dynamic_cast<AllNeuronsProps*>(pINeuronsProps)->summation_map;
+    const BGFLOAT deltaT = sim_info->deltaT;
 
-    for (BGSIZE i = 0; i < m_pSynapsesProps->total_synapse_counts; i++) {
-        // advance one specific Synapse
-        BGSIZE iSyn = synapseIndexMap->incomingSynapseIndexMap[i];
-        advanceSynapse(iSyn, sim_info->deltaT, neurons, simulationStep, iStepOffset, maxSpikes, pINeuronsProps);
+    advanceIncomingSynapses(synapseIndexMap, summation_map, iNeuronBegin, iNeuronEnd, [&](BGSIZE iSyn) {
+        advanceSynapse(iSyn, deltaT, neurons, simulationStep, iStepOffset, maxSpikes, pINeuronsProps);
+    });
+}
 
-        // and apply the post spike response to the summation point
-        BGFLOAT &summationPoint = *(pSynapsesProps->summationPoint[iSyn]);
-        BGFLOAT &psr = pSynapsesProps->psr[iSyn];
-        summationPoint += psr;
+/*
+ *  Check if the synapse class changes the synapse weights by itself
+ *  (e.g. by a learning rule) during the simulation.
+ *
+ *  @return true if the synapse weights are plastic.
+ */
+bool AllSynapses::isWeightPlastic() const
+{
+    return false;
+}
+
+/*
+ *  Add the complete state of the synapses to a periodic checkpoint.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ */
+void AllSynapses::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    m_pSynapsesProps->checkpointState(writer, iCluster);
+}
+
+/*
+ *  Restore the complete state of the synapses from a periodic checkpoint.
+ *  The summation points of the synapses in use are set to the summation map
+ *  of the cluster, and the synapse index map must be recreated afterwards.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ *  @param  clr_info  ClusterInfo of the cluster (for the summation points).
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllSynapses::restoreState(const CheckpointReader &reader, int iCluster, const ClusterInfo *clr_info)
+{
+    if (!m_pSynapsesProps->restoreState(reader, iCluster)) {
+        return false;
+    }
+
+    BGSIZE max_total_synapses = m_pSynapsesProps->maxSynapsesPerNeuron * m_pSynapsesProps->count_neurons;
+    for (BGSIZE iSyn = 0; iSyn < max_total_synapses; iSyn++) {
+        m_pSynapsesProps->summationPoint[iSyn] = m_pSynapsesProps->in_use[iSyn] ?
+            &clr_info->pClusterSummationMap[iSyn / m_pSynapsesProps->maxSynapsesPerNeuron] : NULL;
     }
+    m_synapseDeltas.clear();
+
+    return true;
 }
 
 #endif // !USE_GPU
@@ -162,6 +254,12 @@ CUDA_CALLABLE void AllSynapses::eraseSynapse(const int neuron_index, const BGSIZ
     m_pSynapsesProps->synapse_counts[neuron_index]--;
     m_pSynapsesProps->in_use[iSyn] = false;
     m_pSynapsesProps->summationPoint[iSyn] = NULL;
+
+#if !defined(USE_GPU)
+    // record the change for the synapse index map
+    SynapseDelta delta = { iSyn, m_pSynapsesProps->sourceNeuronLayoutIndex[iSyn], false };
+    m_synapseDeltas.push_back(delta);
+#endif // !USE_GPU
 }
 
 /*
@@ -195,6 +293,12 @@ CUDA_CALLABLE void AllSynapses::addSynapse(BGSIZE &iSyn, synapseType type, const
 
     // create a synapse
     createSynapse(iSyn, src_neuron, dest_neuron, sum_point, deltaT, type );
+
+#if !defined(USE_GPU)
+    // record the change for the synapse index map
+    SynapseDelta delta = { iSyn, src_neuron, true };
+    m_synapseDeltas.push_back(delta);
+#endif // !USE_GPU
 }
 
 /*
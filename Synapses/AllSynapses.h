@@ -42,6 +42,10 @@
 #include "SimulationInfo.h"
 #include "IAllSynapses.h"
 #include "AllSynapsesProps.h"
+#if !defined(USE_GPU)
+#include "ThreadPool.h"
+#include "SynapseIndexMap.h"
+#endif // !USE_GPU
 
 #ifdef _WIN32
 typedef unsigned _int8 uint8_t;
@@ -184,6 +188,97 @@ class AllSynapses : public IAllSynapses
          */
         virtual void advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset);
 
+        /**
+         *  Advance all the Synapses in the simulation.
+         *  Update the state of all synapses for a time step.
+         *  The destination neurons are split into chunks that run on the threads
+         *  of a pool. A chunk advances the incoming synapses of its neurons, so
+         *  each summation point is updated by one thread, in the order of the
+         *  single threaded advance.
+         *
+         *  @param  sim_info          SimulationInfo class to read information from.
+         *  @param  neurons           The Neuron list to search from.
+         *  @param  synapseIndexMap   Pointer to the synapse index map.
+         *  @param  iStepOffset       Offset from the current simulation step.
+         *  @param  pool              The pool of threads to run the chunks.
+         *  @param  nNeuronsPerChunk  Number of destination neurons per chunk.
+         */
+        virtual void advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset, ThreadPool &pool, int nNeuronsPerChunk);
+
+        /**
+         *  Advance the incoming synapses of the neurons in a range.
+         *
+         *  @param  sim_info          SimulationInfo class to read information from.
+         *  @param  neurons           The Neuron list to search from.
+         *  @param  synapseIndexMap   Pointer to the synapse index map.
+         *  @param  iStepOffset       Offset from the current simulation step.
+         *  @param  iNeuronBegin      Index of the first destination neuron of the range.
+         *  @param  iNeuronEnd        Index after the last destination neuron of the range.
+         */
+        void advanceSynapses(const SimulationInfo *sim_info, IAllNeurons *neurons, SynapseIndexMap *synapseIndexMap, int iStepOffset, BGSIZE iNeuronBegin, BGSIZE iNeuronEnd);
+
+    public:
+        /**
+         *  Advance the incoming synapses of the neurons in a range, and apply their
+         *  post spike responses to the summation points of the neurons.
+         *  The synapse update is a functor, so that the generic advance calls the
+         *  virtual advanceSynapse() and a specialized cluster (SpecializedCluster.h)
+         *  the one of its synapse class directly, with the same arithmetic.
+         *
+         *  @param  synapseIndexMap   Pointer to the synapse index map.
+         *  @param  summation_map     The summation points of the neurons.
+         *  @param  iNeuronBegin      Index of the first destination neuron of the range.
+         *  @param  iNeuronEnd        Index after the last destination neuron of the range.
+         *  @param  advanceSynapse    Functor that advances the synapse of the given index.
+         */
+        template <class AdvanceSynapse>
+        void advanceIncomingSynapses(const SynapseIndexMap *synapseIndexMap, BGFLOAT *summation_map, BGSIZE iNeuronBegin, BGSIZE iNeuronEnd, AdvanceSynapse advanceSynapse);
+
+    public:
+        /**
+         *  Check if the synapse class changes the synapse weights by itself
+         *  (e.g. by a learning rule) during the simulation.
+         *
+         *  @return true if the synapse weights are plastic.
+         */
+        virtual bool isWeightPlastic() const;
+
+        /**
+         *  Add the complete state of the synapses to a periodic checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         */
+        virtual void checkpointState(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore the complete state of the synapses from a periodic checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         *  @param  clr_info  ClusterInfo of the cluster (for the summation points).
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader, int iCluster, const ClusterInfo *clr_info);
+
+        /**
+         *  A synapse added to or removed from the network.
+         */
+        struct SynapseDelta
+        {
+            //! Index of the synapse.
+            BGSIZE iSyn;
+
+            //! Layout index of the source neuron of the synapse.
+            int src_neuron;
+
+            //! True if the synapse was added, false if it was removed.
+            bool added;
+        };
+
+        //! Synapses added or removed since the synapse index map was created (in order).
+        vector<SynapseDelta> m_synapseDeltas;
+
 #endif // !USE_GPU
 
     public:
@@ -249,6 +344,43 @@ __global__ void advanceSynapsesDevice ( int total_synapse_counts, SynapseIndexMa
 
 #endif // USE_GPU
 
+#if !defined(USE_GPU)
+/*
+ *  Advance the incoming synapses of the neurons in a range, and apply their
+ *  post spike responses to the summation points of the neurons.
+ *
+ *  @param  synapseIndexMap   Pointer to the synapse index map.
+ *  @param  summation_map     The summation points of the neurons.
+ *  @param  iNeuronBegin      Index of the first destination neuron of the range.
+ *  @param  iNeuronEnd        Index after the last destination neuron of the range.
+ *  @param  advanceSynapse    Functor that advances the synapse of the given index.
+ */
+template <class AdvanceSynapse>
+void AllSynapses::advanceIncomingSynapses(const SynapseIndexMap *synapseIndexMap, BGFLOAT *summation_map, BGSIZE iNeuronBegin, BGSIZE iNeuronEnd, AdvanceSynapse advanceSynapse)
+{
+    const BGFLOAT *psr = m_pSynapsesProps->psr;
+
+    // the incoming synapse index map has free space after the synapses of each neuron
+    for (BGSIZE iNeuron = iNeuronBegin; iNeuron < iNeuronEnd; iNeuron++) {
+        const BGSIZE* incomingMap_begin = &( synapseIndexMap->incomingSynapseIndexMap[synapseIndexMap->incomingSynapseBegin[iNeuron]] );
+        BGSIZE synapse_counts = synapseIndexMap->incomingSynapseCount[iNeuron];
+
+        // advance the incoming synapses of the neuron
+        for (BGSIZE i = 0; i < synapse_counts; i++) {
+            advanceSynapse(incomingMap_begin[i]);
+        }
+
+        // and apply their post spike responses to the summation point of the neuron,
+        // in the same order, with a single write
+        BGFLOAT summationPoint = summation_map[iNeuron];
+        for (BGSIZE i = 0; i < synapse_counts; i++) {
+            summationPoint += psr[incomingMap_begin[i]];
+        }
+        summation_map[iNeuron] = summationPoint;
+    }
+}
+#endif // !USE_GPU
+
 /**
  *  Cereal serialization and deserialization method
  *  (Serializes/deserializes SynapseProps)
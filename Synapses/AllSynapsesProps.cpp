@@ -1,4 +1,6 @@
 #include "AllSynapsesProps.h"
+#include "Checkpoint.h"
+#include <cstring>
 #if defined(USE_GPU)
 #include <helper_cuda.h>
 #endif
@@ -42,12 +44,14 @@ void AllSynapsesProps::setupSynapsesProps(const int num_neurons, const int max_s
     total_synapse_counts = 0;
 
     if (max_total_synapses != 0) {
-        destNeuronLayoutIndex = new int[max_total_synapses];
-        W = new BGFLOAT[max_total_synapses];
+        // the arrays are value-initialized, so that their pages are first touched by the
+        // thread that sets up the cluster, on its NUMA node (see Model::setupClusters())
+        destNeuronLayoutIndex = new int[max_total_synapses]();
+        W = new BGFLOAT[max_total_synapses]();
         summationPoint = new BGFLOAT*[max_total_synapses];
-        sourceNeuronLayoutIndex = new int[max_total_synapses];
-        psr = new BGFLOAT[max_total_synapses];
-        type = new synapseType[max_total_synapses];
+        sourceNeuronLayoutIndex = new int[max_total_synapses]();
+        psr = new BGFLOAT[max_total_synapses]();
+        type = new synapseType[max_total_synapses]();
         in_use = new bool[max_total_synapses];
         synapse_counts = new BGSIZE[num_neurons];
 
@@ -94,6 +98,89 @@ void AllSynapsesProps::cleanupSynapsesProps()
     maxSynapsesPerNeuron = 0;
 }
 
+/*
+ *  Add synapse weights, source neurons, and destination neurons
+ *  to a binary checkpoint. The arrays are written as count_neurons
+ *  rows of maxSynapsesPerNeuron columns.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ */
+void AllSynapsesProps::checkpoint(CheckpointWriter &writer, int iCluster) const
+{
+    writer.addSection(CKPT_SYNAPSE_W, iCluster, W, sizeof(BGFLOAT), count_neurons, maxSynapsesPerNeuron);
+    writer.addSection(CKPT_SYNAPSE_SOURCE, iCluster, sourceNeuronLayoutIndex, sizeof(int), count_neurons, maxSynapsesPerNeuron);
+    writer.addSection(CKPT_SYNAPSE_DEST, iCluster, destNeuronLayoutIndex, sizeof(int), count_neurons, maxSynapsesPerNeuron);
+}
+
+/*
+ *  Restore synapse weights, source neurons, and destination neurons
+ *  from a binary checkpoint. The arrays are copied straight from the
+ *  mapped file.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ *  @return true if successful, false if the sections are missing or
+ *          do not match maxSynapsesPerNeuron and count_neurons.
+ */
+bool AllSynapsesProps::restore(const CheckpointReader &reader, int iCluster)
+{
+    const void *WData = reader.getSection(CKPT_SYNAPSE_W, iCluster, sizeof(BGFLOAT), count_neurons, maxSynapsesPerNeuron);
+    const void *sourceData = reader.getSection(CKPT_SYNAPSE_SOURCE, iCluster, sizeof(int), count_neurons, maxSynapsesPerNeuron);
+    const void *destData = reader.getSection(CKPT_SYNAPSE_DEST, iCluster, sizeof(int), count_neurons, maxSynapsesPerNeuron);
+
+    if (WData == NULL || sourceData == NULL || destData == NULL) {
+        cerr << "Failed restoring synapse weights, source neurons, and/or destination neurons. Please verify maxSynapsesPerNeuron and count_neurons data members in AllSynapsesProps class." << endl;
+        return false;
+    }
+
+    BGSIZE max_total_synapses = maxSynapsesPerNeuron * count_neurons;
+    memcpy(W, WData, max_total_synapses * sizeof(BGFLOAT));
+    memcpy(sourceNeuronLayoutIndex, sourceData, max_total_synapses * sizeof(int));
+    memcpy(destNeuronLayoutIndex, destData, max_total_synapses * sizeof(int));
+
+    return true;
+}
+
+#if !defined(USE_GPU)
+/*
+ *  Add the complete state of the synapses to a periodic checkpoint (the
+ *  arrays of checkpoint(), and the arrays that change during the
+ *  simulation or are set when a synapse is created).
+ *  The summation points are addresses, and are not written.
+ *
+ *  @param  writer    The checkpoint writer.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ */
+void AllSynapsesProps::checkpointState(CheckpointWriter &writer, int iCluster) const
+{
+    checkpoint(writer, iCluster);
+
+    writer.addArray(CKPT_SYNAPSE_TYPE, iCluster, type, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_PSR, iCluster, psr, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_IN_USE, iCluster, in_use, count_neurons, maxSynapsesPerNeuron);
+    writer.addArray(CKPT_SYNAPSE_COUNTS, iCluster, synapse_counts, count_neurons);
+    writer.addValue(CKPT_SYNAPSE_TOTAL_COUNT, iCluster, total_synapse_counts);
+}
+
+/*
+ *  Restore the complete state of the synapses from a periodic checkpoint.
+ *
+ *  @param  reader    The checkpoint reader.
+ *  @param  iCluster  Index of the cluster of the synapses.
+ *  @return true if successful, false if a section is missing or does not match.
+ */
+bool AllSynapsesProps::restoreState(const CheckpointReader &reader, int iCluster)
+{
+    return restore(reader, iCluster)
+        && reader.restoreArray(CKPT_SYNAPSE_TYPE, iCluster, type, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_PSR, iCluster, psr, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_IN_USE, iCluster, in_use, count_neurons, maxSynapsesPerNeuron)
+        && reader.restoreArray(CKPT_SYNAPSE_COUNTS, iCluster, synapse_counts, count_neurons)
+        && reader.restoreValue(CKPT_SYNAPSE_TOTAL_COUNT, iCluster, total_synapse_counts);
+}
+#endif // !USE_GPU
+
 #if defined(USE_GPU)
 /*
  *  Allocate GPU memories to store all synapses' states.
@@ -14,6 +14,9 @@
 #include <cereal/types/vector.hpp>
 #include <vector>
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class AllSynapsesProps : public IAllSynapsesProps
 {
     public:
@@ -49,6 +52,47 @@ class AllSynapsesProps : public IAllSynapsesProps
         template<class Archive>
         void load(Archive & archive);
 
+        /**
+         *  Add synapse weights, source neurons, and destination neurons
+         *  to a binary checkpoint.
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         */
+        void checkpoint(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore synapse weights, source neurons, and destination neurons
+         *  from a binary checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         *  @return true if successful, false if the sections are missing or
+         *          do not match maxSynapsesPerNeuron and count_neurons.
+         */
+        bool restore(const CheckpointReader &reader, int iCluster);
+
+#if !defined(USE_GPU)
+        /**
+         *  Add the complete state of the synapses to a periodic checkpoint (the
+         *  arrays of checkpoint(), and the arrays that change during the
+         *  simulation or are set when a synapse is created).
+         *
+         *  @param  writer    The checkpoint writer.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         */
+        virtual void checkpointState(CheckpointWriter &writer, int iCluster) const;
+
+        /**
+         *  Restore the complete state of the synapses from a periodic checkpoint.
+         *
+         *  @param  reader    The checkpoint reader.
+         *  @param  iCluster  Index of the cluster of the synapses.
+         *  @return true if successful, false if a section is missing or does not match.
+         */
+        virtual bool restoreState(const CheckpointReader &reader, int iCluster);
+#endif // !USE_GPU
+
 #if defined(USE_GPU)
     protected:
         /**
@@ -174,6 +218,8 @@ class AllSynapsesProps : public IAllSynapsesProps
 
         /**
          *  This synapse's summation point's address.
+         *  (The host advance sums the synapses of a neuron into the summation
+         *  map directly, by destination neuron, and does not use it.)
          */
         BGFLOAT **summationPoint;
 
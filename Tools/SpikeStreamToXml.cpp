@@ -0,0 +1,232 @@
+/**
+ *      @file SpikeStreamToXml.cpp
+ *
+ *      @brief Converts a binary spike stream file into the xml state output file.
+ *
+ *      Reads a spike stream file (.bgspk) written by the BinaryRecorder or the
+ *      BinaryGrowthRecorder (see Recorders/SpikeStream.h), and writes the xml
+ *      file that the XmlRecorder or the XmlGrowthRecorder would have written
+ *      for the same simulation: the burstiness and spikes histories (summed
+ *      from the binned counts of the epochs), the radii and rates histories
+ *      (with the growth recorder), the layout, the neuron thresholds, Tsim and
+ *      the simulation end time, as Matrix elements.
+ *
+ *      The spikes of the epochs (neuron and step of each spike) are only
+ *      counted, to check them against the bins.
+ *
+ *      TO USE:
+ *
+ *      $ make bgspk2xml
+ *      $ ./bgspk2xml results/run.bgspk results/run.xml
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "Global.h"
+#include "CompleteMatrix.h"
+#include "VectorMatrix.h"
+#include "SpikeStream.h"
+
+using namespace std;
+
+/*
+ *  Read the elements of a column.
+ *
+ *  @param  in        The spike stream file.
+ *  @param  column    The column.
+ *  @param  values    The elements read.
+ *  @return true if successful.
+ */
+template <typename T>
+static bool readColumn(ifstream &in, const SpikeStreamColumn &column, vector<T> &values)
+{
+    if (column.elementSize != sizeof(T)) {
+        cerr << "Column " << column.type << " of epoch " << column.epoch << " has elements of "
+             << column.elementSize << " bytes instead of " << sizeof(T) << endl;
+        return false;
+    }
+
+    values.resize(column.count);
+    in.read(reinterpret_cast<char *>(values.data()), sizeof(T) * column.count);
+    return in.good();
+}
+
+/*
+ *  Write a vector of values as a VectorMatrix.
+ *
+ *  @param  out       The xml file.
+ *  @param  name      Name of the matrix.
+ *  @param  values    The values.
+ */
+template <typename T>
+static void writeVector(ofstream &out, const char *name, const vector<T> &values)
+{
+    VectorMatrix matrix(MATRIX_TYPE, MATRIX_INIT, 1, values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        matrix[i] = values[i];
+    }
+    out << "   " << matrix.toXML(name) << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <spike stream file (.bgspk)> <xml output file>" << endl;
+        return -1;
+    }
+
+    ifstream in(argv[1], ios::in | ios::binary);
+    SpikeStreamHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))
+            || memcmp(header.magic, SPIKE_STREAM_MAGIC, sizeof(header.magic)) != 0) {
+        cerr << "Failed reading the spike stream file " << argv[1] << endl;
+        return -1;
+    }
+    if (header.version != SPIKE_STREAM_VERSION || header.floatSize != sizeof(BGFLOAT)) {
+        cerr << "The spike stream file " << argv[1] << " has version " << header.version
+             << " and values of " << header.floatSize << " bytes (expected version "
+             << SPIKE_STREAM_VERSION << " and " << sizeof(BGFLOAT) << " bytes)" << endl;
+        return -1;
+    }
+
+    // the histories are sized and printed as by the XmlRecorder
+    int totalNeurons = header.totalNeurons;
+    int maxSteps = header.maxSteps;
+    BGFLOAT deltaT = header.deltaT;
+    BGFLOAT epochDuration = header.epochDuration;
+    VectorMatrix burstinessHist(MATRIX_TYPE, MATRIX_INIT, 1, static_cast<int>(epochDuration * maxSteps), 0);
+    VectorMatrix spikesHistory(MATRIX_TYPE, MATRIX_INIT, 1, static_cast<int>(epochDuration * maxSteps * 100), 0);
+    CompleteMatrix *ratesHistory = NULL;
+    CompleteMatrix *radiiHistory = NULL;
+
+    vector<uint32_t> counts;
+    vector<BGFLOAT> xloc, yloc, neuronThresh, values;
+    vector<int32_t> neuronTypes, starterNeurons;
+    uint64_t endStep = 0;
+    uint64_t nSpikes = 0, nBurstinessSpikes = 0, nSpikesSpikes = 0;
+    bool hasSpikeColumns = false;
+
+    SpikeStreamColumn column;
+    while (in.read(reinterpret_cast<char *>(&column), sizeof(column))) {
+        bool ok = true;
+        switch (column.type) {
+        case SPK_SPIKE_NEURONS:
+            hasSpikeColumns = true;
+            nSpikes += column.count;
+            in.seekg(column.elementSize * column.count, ios::cur);
+            break;
+
+        case SPK_BURSTINESS_BINS:
+        case SPK_SPIKES_BINS: {
+            VectorMatrix &history = column.type == SPK_BURSTINESS_BINS ? burstinessHist : spikesHistory;
+            uint64_t &nBinned = column.type == SPK_BURSTINESS_BINS ? nBurstinessSpikes : nSpikesSpikes;
+            ok = readColumn(in, column, counts);
+            for (size_t i = 0; ok && i < counts.size(); i++) {
+                uint64_t bin = column.base + i;
+                if (bin < static_cast<uint64_t>(history.Size())) {
+                    history[bin] = history[bin] + counts[i];
+                }
+                nBinned += counts[i];
+            }
+            break;
+        }
+
+        case SPK_RATES:
+        case SPK_RADII: {
+            if (ratesHistory == NULL) {
+                ratesHistory = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, maxSteps + 1, totalNeurons);
+                radiiHistory = new CompleteMatrix(MATRIX_TYPE, MATRIX_INIT, maxSteps + 1, totalNeurons);
+            }
+            CompleteMatrix &history = column.type == SPK_RATES ? *ratesHistory : *radiiHistory;
+            ok = readColumn(in, column, values) && column.count == static_cast<uint64_t>(totalNeurons)
+                && column.epoch <= static_cast<uint32_t>(maxSteps);
+            for (int i = 0; ok && i < totalNeurons; i++) {
+                history(column.epoch, i) = values[i];
+            }
+            break;
+        }
+
+        case SPK_XLOC:
+            ok = readColumn(in, column, xloc);
+            break;
+        case SPK_YLOC:
+            ok = readColumn(in, column, yloc);
+            break;
+        case SPK_NEURON_TYPES:
+            ok = readColumn(in, column, neuronTypes);
+            break;
+        case SPK_STARTER_NEURONS:
+            ok = readColumn(in, column, starterNeurons);
+            break;
+        case SPK_NEURON_THRESH:
+            ok = readColumn(in, column, neuronThresh);
+            break;
+        case SPK_END_STEP:
+            endStep = column.base;
+            break;
+
+        default:
+            // the steps of the spikes, and the columns of later versions
+            in.seekg(column.elementSize * column.count, ios::cur);
+            break;
+        }
+
+        if (!ok) {
+            cerr << "Failed reading column " << column.type << " of epoch " << column.epoch << endl;
+            return -1;
+        }
+    }
+
+    if (!hasSpikeColumns) {
+        // every epoch of a simulation has a spike column, even without spikes
+        cerr << "The file " << argv[1] << " has no spike columns (a growth history file of the xml recorder?)" << endl;
+        return -1;
+    }
+    if (xloc.empty() || neuronTypes.empty()) {
+        cerr << "The spike stream file " << argv[1] << " is incomplete (the simulation did not end)" << endl;
+        return -1;
+    }
+    if (nBurstinessSpikes != nSpikes || nSpikesSpikes != nSpikes) {
+        cerr << "The binned spike counts (" << nBurstinessSpikes << ", " << nSpikesSpikes
+             << ") don't match the number of spikes (" << nSpikes << ")" << endl;
+        return -1;
+    }
+
+    ofstream out(argv[2]);
+
+    // Write XML header information:
+    out << "<?xml version=\"1.0\" standalone=\"no\"?>\n" << "<!-- State output file for the DCT growth modeling-->\n";
+
+    out << "<SimState>\n";
+    if (ratesHistory != NULL) {
+        out << "   " << radiiHistory->toXML("radiiHistory") << endl;
+        out << "   " << ratesHistory->toXML("ratesHistory") << endl;
+    }
+    out << "   " << burstinessHist.toXML("burstinessHist") << endl;
+    out << "   " << spikesHistory.toXML("spikesHistory") << endl;
+    writeVector(out, "xloc", xloc);
+    writeVector(out, "yloc", yloc);
+    writeVector(out, "neuronTypes", neuronTypes);
+    if (starterNeurons.size() > 0) {
+        writeVector(out, "starterNeurons", starterNeurons);
+    }
+    writeVector(out, "neuronThresh", neuronThresh);
+
+    // write time between growth cycles
+    out << "   <Matrix name=\"Tsim\" type=\"complete\" rows=\"1\" columns=\"1\" multiplier=\"1.0\">" << endl;
+    out << "   " << epochDuration << endl;
+    out << "</Matrix>" << endl;
+
+    // write simulation end time
+    out << "   <Matrix name=\"simulationEndTime\" type=\"complete\" rows=\"1\" columns=\"1\" multiplier=\"1.0\">" << endl;
+    out << "   " << endStep * deltaT << endl;
+    out << "</Matrix>" << endl;
+    out << "</SimState>" << endl;
+
+    delete ratesHistory;
+    delete radiiHistory;
+
+    cout << nSpikes << " spikes of " << maxSteps << " epochs converted" << endl;
+    return 0;
+}
@@ -134,6 +134,12 @@ enum synapseType { II = 0, IE = 1, EI = 2, EE = 3, STYPE_UNDEF = -1 };
 // Synaptic transmission delay = (int)(minimum synaptic transmission delay / delta_t) + 1
 #define MIN_SYNAPTIC_TRANS_DELAY	(9)
 
+//! The default length (in seconds) of the spike history kept beyond an epoch (STDP look-back window).
+#define DEFAULT_SPIKE_HISTORY_WINDOW	(1.0)
+
+//! The default psr magnitude at or below which a synapse without pending spikes stops being advanced (event driven advance).
+#define DEFAULT_PSR_EPSILON	(1.0e-15)
+
 //! Converts a 1-d index into a coordinate string.
 string index2dToString(int i, int width, int height);
 //! Converts a 2-d coordinate into a string.
@@ -0,0 +1,62 @@
+#!/bin/bash
+
+# This script benchmarks the scaling of the simulation with the number of
+# clusters, with and without the NUMA placement of the clusters:
+#		- Build growth
+#		- Run the config file with each number of clusters, first with
+#		  unpinned threads (-p no), then with the threads of each cluster
+#		  bound to its NUMA node and its state placed there (-p node)
+#		- Print the simulation speed (ssps), the placement report of the
+#		  clusters and compare the state outputs of the two runs
+#
+#
+# TO USE:
+#
+#	$ ./bench-clusters.sh [config file] [numbers of clusters] [number of epochs]
+#
+# The config file defaults to configfiles/test-medium-100.xml, and the
+# numbers of clusters to "1 2 4" (e.g. "2 4 8 16" on a machine with more
+# sockets and cores). The number of epochs overrides numSims of the config
+# file, and defaults to 2. With a number of clusters that is a multiple of
+# the number of NUMA nodes, the clusters are spread evenly over the nodes
+# (see /sys/devices/system/node or numactl --hardware).
+#
+# Run this script from the BrainGrid directory.
+
+
+CONFIG=${1:-configfiles/test-medium-100.xml}
+CLUSTERS=${2:-"1 2 4"}
+EPOCHS=${3:-2}
+
+BENCH_DIR=`mktemp -d /tmp/bench-clusters.XXXXXX`
+
+# Build
+###############################################################################
+echo "Building growth"
+echo "---------------------------------------------------------------------------------"
+make -j growth > $BENCH_DIR/make.out 2>&1 || { cat $BENCH_DIR/make.out; exit 1; }
+
+sed -e "s|<numSims name=\"numSims\">[0-9]*</numSims>|<numSims name=\"numSims\">$EPOCHS</numSims>|" \
+    $CONFIG > $BENCH_DIR/config.xml
+
+# Run the config file and print the simulation speed
+# $1: name, $2: number of clusters, $3: thread pinning
+run()
+{
+	./growth -t $BENCH_DIR/config.xml -c $2 -p $3 -o $BENCH_DIR/$1-out.xml > $BENCH_DIR/$1.out 2>&1
+	echo "$1: `grep "ssps" $BENCH_DIR/$1.out`"
+}
+
+for NCLUSTERS in $CLUSTERS
+do
+	echo ""
+	echo "$NCLUSTERS clusters"
+	echo "---------------------------------------------------------------------------------"
+	run c$NCLUSTERS-no $NCLUSTERS no
+	run c$NCLUSTERS-node $NCLUSTERS node
+	grep "^Cluster [0-9]*: CPU" $BENCH_DIR/c$NCLUSTERS-node.out
+	cmp $BENCH_DIR/c$NCLUSTERS-no-out.xml $BENCH_DIR/c$NCLUSTERS-node-out.xml && echo "outputs are identical"
+done
+
+echo ""
+echo "Outputs are in $BENCH_DIR"
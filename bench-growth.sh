@@ -0,0 +1,97 @@
+#!/bin/bash
+
+# This script benchmarks the synapse weights update of the growth model
+# ("Host adjustSynapses" in the performance metrics):
+#		- Build growth of HEAD with CPMETRICS=yes in a git worktree
+#		- Run the config file with the dense and the sparse growth engines
+#		- Optionally build and run a baseline revision in a git worktree
+#		- Print the adjustSynapses times and compare the state outputs
+#
+#
+# TO USE:
+#
+#	$ ./bench-growth.sh [config file] [number of epochs] [baseline revision]
+#
+# The config file defaults to configfiles/test-medium-500.xml. The number of
+# epochs overrides numSims of the config file (500 epochs of test-medium-500
+# take several hours), and defaults to 20. The baseline revision (e.g. a commit
+# hash) is built in a temporary worktree and runs the config file unmodified.
+#
+# Both binaries are built in the bench directory, so the build of the working
+# tree is left untouched (and its uncommitted changes are not benchmarked).
+#
+# Run this script from the BrainGrid directory.
+
+
+CONFIG=${1:-configfiles/test-medium-500.xml}
+EPOCHS=${2:-20}
+BASELINE=$3
+
+BRAINGRID=`pwd`
+BENCH_DIR=`mktemp -d /tmp/bench-growth.XXXXXX`
+
+# Build
+###############################################################################
+echo "Building growth (CPMETRICS=yes)"
+echo "---------------------------------------------------------------------------------"
+git worktree add --detach $BENCH_DIR/head HEAD > /dev/null 2>&1 || exit 1
+(cd $BENCH_DIR/head && make -j CPMETRICS=yes growth > $BENCH_DIR/make.out 2>&1) || { cat $BENCH_DIR/make.out; exit 1; }
+
+# Generate a config file of the given growth mode in the bench directory
+# $1: growth mode, $2: state output file
+make_config()
+{
+	sed -e "s|<numSims name=\"numSims\">[0-9]*</numSims>|<numSims name=\"numSims\">$EPOCHS</numSims>|" \
+	    -e "s|<stateOutputFileName name=\"stateOutputFileName\">.*</stateOutputFileName>|<stateOutputFileName name=\"stateOutputFileName\">$2</stateOutputFileName>|" \
+	    -e "/<growthMode/d" \
+	    -e "s|<GrowthParams\([^>]*\)>|<GrowthParams\1>\n      <growthMode name=\"growthMode\">$1</growthMode>|" \
+	    $CONFIG
+}
+
+# Run a config file and print the performance metrics of the weights update
+# $1: name, $2: growth binary, $3: config file
+run()
+{
+	echo ""
+	echo "$1"
+	echo "---------------------------------------------------------------------------------"
+	TIMEFORMAT="Wall time: %R seconds"
+	time $2 -t $3 > $BENCH_DIR/$1.out 2>&1
+	# the metrics are cumulative, keep the ones of the last epoch
+	grep "Host adjustSynapses" $BENCH_DIR/$1.out | tail -1
+}
+
+for MODE in dense sparse
+do
+	make_config $MODE $BENCH_DIR/$MODE-out.xml > $BENCH_DIR/$MODE.xml
+	run $MODE $BENCH_DIR/head/growth $BENCH_DIR/$MODE.xml
+done
+git worktree remove --force $BENCH_DIR/head
+
+if [ -n "$BASELINE" ]
+then
+	echo ""
+	echo "Building baseline $BASELINE"
+	echo "---------------------------------------------------------------------------------"
+	git worktree add $BENCH_DIR/baseline $BASELINE > /dev/null 2>&1 || exit 1
+	(cd $BENCH_DIR/baseline && make -j CPMETRICS=yes growth > $BENCH_DIR/make-baseline.out 2>&1) || exit 1
+	sed -e "s|<numSims name=\"numSims\">[0-9]*</numSims>|<numSims name=\"numSims\">$EPOCHS</numSims>|" \
+	    -e "s|<stateOutputFileName name=\"stateOutputFileName\">.*</stateOutputFileName>|<stateOutputFileName name=\"stateOutputFileName\">$BENCH_DIR/baseline-out.xml</stateOutputFileName>|" \
+	    $CONFIG > $BENCH_DIR/baseline.xml
+	run baseline $BENCH_DIR/baseline/growth $BENCH_DIR/baseline.xml
+	git worktree remove --force $BENCH_DIR/baseline
+fi
+
+# Compare the state outputs
+###############################################################################
+echo ""
+echo "Comparing outputs"
+echo "---------------------------------------------------------------------------------"
+cmp $BENCH_DIR/dense-out.xml $BENCH_DIR/sparse-out.xml && echo "dense and sparse outputs are identical"
+if [ -n "$BASELINE" ]
+then
+	cmp $BENCH_DIR/baseline-out.xml $BENCH_DIR/sparse-out.xml && echo "baseline and sparse outputs are identical"
+fi
+
+echo ""
+echo "Outputs are in $BENCH_DIR"